@@ -400,6 +400,7 @@ namespace SimTK {
 %include <OpenSim/Analyses/StatesReporter.h>
 %include <OpenSim/Analyses/InducedAccelerations.h>
 %include <OpenSim/Analyses/ProbeReporter.h>
+%include <OpenSim/Analyses/OutputReporter.h>
 
 //osimActuators
 %include <OpenSim/Actuators/osimActuatorsDLL.h>
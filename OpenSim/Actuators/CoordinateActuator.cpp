@@ -119,6 +119,12 @@ double CoordinateActuator::getOptimalForce() const
 {
     return get_optimal_force();
 }
+
+bool CoordinateActuator::canUpdateSystemInPlace() const
+{
+    return !_coord.empty() && !getProperty_coordinate().empty()
+        && _coord->getName() == get_coordinate();
+}
 //_____________________________________________________________________________
 /**
  * Get the stress of the force. This would be the force or torque provided by 
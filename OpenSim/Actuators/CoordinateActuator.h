@@ -73,6 +73,10 @@ public:
     /** Get the current setting of the 'optimal_force' property. **/
     double getOptimalForce() const override; // part of Actuator interface
 
+    /** True unless the 'coordinate' property no longer names the Coordinate
+    this actuator was connected to. **/
+    bool canUpdateSystemInPlace() const override;
+
     //--------------------------------------------------------------------------
     // UTILITY
     //--------------------------------------------------------------------------
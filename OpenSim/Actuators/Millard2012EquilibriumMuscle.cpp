@@ -180,6 +180,7 @@ void Millard2012EquilibriumMuscle::extendFinalizeFromProperties()
 {
     Super::extendFinalizeFromProperties();
     buildMuscle();
+    _fiberEquilibriumTable.clear();
 }
 
 //==============================================================================
@@ -433,8 +434,8 @@ computeInitialFiberEquilibrium(SimTK::State& s) const
         double pathLengtheningSpeed = getLengtheningSpeed(s);
 
         SimTK::Vector soln;
-        soln = estimateMuscleFiberState(clampedActivation, pathLength,
-                                        pathLengtheningSpeed, tol, maxIter);
+        soln = solveMuscleFiberState(clampedActivation, pathLength,
+                                     pathLengtheningSpeed, tol, maxIter);
         flag_status   = (int)soln[0];
         solnErr       = soln[1];
         iterations    = (int)soln[2];
@@ -545,9 +546,8 @@ computeFiberEquilibriumAtZeroVelocity(SimTK::State& s) const
         double activation = getActivation(s);
 
         SimTK::Vector soln;
-        soln = estimateMuscleFiberState(activation, pathLength,
-                                        pathLengtheningSpeed, tol, maxIter,
-                                        true);
+        soln = solveMuscleFiberState(activation, pathLength,
+                                     pathLengtheningSpeed, tol, maxIter, true);
         flag_status   = (int)soln[0];
         solnErr       = soln[1];
         iterations    = (int)soln[2];
@@ -1389,13 +1389,57 @@ isFiberStateClamped(double lce, double dlceN) const
 double Millard2012EquilibriumMuscle::clampFiberLength(double lce) const
 {   return max(lce, getMinimumFiberLength()); }
 
+SimTK::Vector Millard2012EquilibriumMuscle::
+solveMuscleFiberState(double aActivation,
+                      double pathLength,
+                      double pathLengtheningSpeed,
+                      double aSolTolerance,
+                      int aMaxIterations,
+                      bool staticSolution) const
+{
+    if(!_fiberEquilibriumTable.isBuilt()) {
+        // Static solutions over the range of path lengths spanning the
+        // shortest fiber and a tendon stretched well beyond its strain at
+        // maximum isometric force.
+        double tsl = getTendonSlackLength();
+        double tol = aSolTolerance;
+        _fiberEquilibriumTable.ensureBuilt(getMinimumActivation(),
+            tsl + getMinimumFiberLengthAlongTendon(),
+            1.1*tsl + 2.0*getOptimalFiberLength(),
+            [this,tol,aMaxIterations](double a, double ml, double lce0,
+                                      double& lce) {
+                SimTK::Vector soln = estimateMuscleFiberState(a, ml, 0.0,
+                                        tol, aMaxIterations, true, lce0);
+                lce = soln[3];
+                return soln[0] == 0;
+            });
+    }
+
+    double guess = _fiberEquilibriumTable.lookup(aActivation, pathLength);
+    bool warmStarted = !SimTK::isNaN(guess);
+    SimTK::Vector soln = estimateMuscleFiberState(aActivation, pathLength,
+        pathLengtheningSpeed, aSolTolerance, aMaxIterations, staticSolution,
+        guess);
+    if(warmStarted && soln[0] != 0) {
+        warmStarted = false;
+        soln = estimateMuscleFiberState(aActivation, pathLength,
+            pathLengtheningSpeed, aSolTolerance, aMaxIterations,
+            staticSolution);
+    }
+
+    _fiberEquilibriumStatistics = FiberEquilibriumStatistics(
+        (int)soln[0], (int)soln[2], soln[1], warmStarted);
+    return soln;
+}
+
 SimTK::Vector Millard2012EquilibriumMuscle::
 estimateMuscleFiberState(double aActivation,
                          double pathLength,
                          double pathLengtheningSpeed,
                          double aSolTolerance,
                          int aMaxIterations,
-                         bool staticSolution) const
+                         bool staticSolution,
+                         double aInitialFiberLength) const
 {
     // If seeking a static solution, set velocities to zero and avoid the
     // velocity-sharing algorithm below, as it can produce nonzero fiber and
@@ -1439,7 +1483,13 @@ estimateMuscleFiberState(double aActivation,
     double lce = 0.0;
     double tl  = getTendonSlackLength()*1.01;  // begin with small tendon force
 
-    lce = clampFiberLength(penMdl.calcFiberLength(ml,tl));
+    if(SimTK::isNaN(aInitialFiberLength)) {
+        lce = clampFiberLength(penMdl.calcFiberLength(ml,tl));
+    } else {
+        lce = clampFiberLength(aInitialFiberLength);
+        tl  = penMdl.calcTendonLength(cos(penMdl.calcPennationAngle(lce)),
+                                      lce,ml);
+    }
 
     double phi    = penMdl.calcPennationAngle(lce);
     double cosphi = cos(phi);
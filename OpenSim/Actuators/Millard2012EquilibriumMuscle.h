@@ -710,13 +710,29 @@ private:
         @param aMaxIterations the maximum number of Newton steps allowed before
     we give up attempting to initialize the model and throw an exception
         @param staticSolution set to true to calculate the static equilibrium
-    solution, setting fiber and tendon velocities to zero */
+    solution, setting fiber and tendon velocities to zero
+        @param aInitialFiberLength the fiber length from which to start the
+    Newton iterations; if NaN, start from a slightly stretched tendon */
     SimTK::Vector estimateMuscleFiberState(double aActivation,
                                            double pathLength,
                                            double pathLengtheningSpeed,
                                            double aSolTolerance,
                                            int aMaxIterations,
-                                           bool staticSolution=false) const;
+                                           bool staticSolution=false,
+                                           double aInitialFiberLength=SimTK::NaN)
+                                           const;
+
+    /* Calls estimateMuscleFiberState(), starting from the static equilibrium
+    fiber length interpolated from _fiberEquilibriumTable (which is built on
+    first use) when it is enabled. If the warm-started solve fails, it is
+    repeated from the default starting point. Records the convergence
+    statistics of the solve. */
+    SimTK::Vector solveMuscleFiberState(double aActivation,
+                                        double pathLength,
+                                        double pathLengtheningSpeed,
+                                        double aSolTolerance,
+                                        int aMaxIterations,
+                                        bool staticSolution=false) const;
 
 };
 } //end of namespace OpenSim
@@ -42,6 +42,8 @@
 #include <OpenSim/Actuators/osimActuators.h>
 #include <OpenSim/Analyses/osimAnalyses.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <exception>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -105,6 +107,7 @@ void testMillard2012EquilibriumMuscle();
 void testMillard2012AccelerationMuscle();
 void testSchutte1993Muscle();
 void testDelp1990Muscle();
+void testFiberEquilibriumWarmStart();
 
 int main()
 {
@@ -164,6 +167,12 @@ int main()
         e.print(cerr);
         failures.push_back("testMillard2012AccelerationMuscle");
     }
+    try { testFiberEquilibriumWarmStart();
+        cout << "FiberEquilibriumWarmStart Test passed" << endl; 
+    }catch (const Exception& e){ 
+        e.print(cerr);
+        failures.push_back("testFiberEquilibriumWarmStart");
+    }
 
     printf("\n\n");
     cout <<"************************************************************"<<endl;
@@ -373,6 +382,21 @@ void simulateMuscle(
     model.getMultibodySystem().realize(si,SimTK::Stage::Dynamics);
     model.equilibrateMuscles(si);
 
+    // Muscles that solve for fiber equilibrium iteratively report whether
+    // (and how quickly) the solve converged.
+    const Muscle* equilibratedMuscle = 
+        dynamic_cast<const Muscle*>(&model.getActuators().get("muscle"));
+    if(equilibratedMuscle && 
+            equilibratedMuscle->getFiberEquilibriumStatistics().status >= 0){
+        const Muscle::FiberEquilibriumStatistics& stats = 
+            equilibratedMuscle->getFiberEquilibriumStatistics();
+        cout << "Fiber equilibrium: " << stats.iterations << " iterations"
+             << (stats.warmStarted ? " (warm started)" : "") 
+             << ", error " << stats.error << " N" << endl;
+        ASSERT(stats.status == 0, __FILE__, __LINE__,
+            "testMuscles: fiber equilibrium failed to converge.");
+    }
+
     CoordinateSet& modelCoordinateSet = model.updCoordinateSet();
 
     // Define non-zero (defaults are 0) states for the free joint
@@ -983,3 +1007,137 @@ void testDelp1990Muscle()
         false);
 
 }
+
+/*==============================================================================
+    Fiber equilibrium warm starts: a solve started from the table of static
+    solutions must find the same fiber length as a cold solve, in no more
+    iterations, and the table must build correctly when the first solves
+    happen on several threads at once.
+================================================================================
+*/
+// Equilibrate the muscle at a grid of slider positions and activations,
+// recording the fiber lengths and the total number of Newton iterations.
+// Only touches the state, so it may run on several threads at once.
+static void equilibrateOverGrid(const Model& model, const Coordinate& tx,
+                                const Muscle& muscle, const SimTK::State& s0,
+                                std::vector<double>& fiberLengths,
+                                int& iterations)
+{
+    const double positions[] = {0.0, 0.02, 0.05, 0.08};
+    const double activations[] = {0.1, 0.45, 0.9};
+
+    SimTK::State s(s0);
+    fiberLengths.clear();
+    iterations = 0;
+    for (double x : positions) {
+        for (double a : activations) {
+            tx.setValue(s, x, false);
+            muscle.setActivation(s, a);
+            model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+            muscle.equilibrate(s);
+            Muscle::FiberEquilibriumStatistics stats =
+                muscle.getFiberEquilibriumStatistics();
+            ASSERT(stats.status == 0, __FILE__, __LINE__,
+                "testFiberEquilibriumWarmStart: solve failed to converge.");
+            fiberLengths.push_back(muscle.getFiberLength(s));
+            iterations += stats.iterations;
+        }
+    }
+}
+
+static void testFiberEquilibriumWarmStart(const Muscle& aMuscle)
+{
+    using SimTK::Vec3;
+    cout << "Warm starts of " << aMuscle.getConcreteClassName() << endl;
+
+    // The block of simulateMuscle(), without prescribed motion.
+    double anchorWidth = 0.1;
+    double xSinG = aMuscle.getOptimalFiberLength()
+        *cos(aMuscle.getPennationAngleAtOptimalFiberLength())
+        + aMuscle.getTendonSlackLength();
+
+    Model model;
+    Ground& ground = model.updGround();
+    OpenSim::Body* ball = new OpenSim::Body("ball", 10, Vec3(0),
+                                10*SimTK::Inertia::sphere(0.05));
+    SliderJoint* slider = new SliderJoint("slider",
+        ground, Vec3(anchorWidth/2 + xSinG, 0, 0), Vec3(0),
+        *ball, Vec3(0), Vec3(0));
+    slider->upd_CoordinateSet()[0].setName("tx");
+    model.addBody(ball);
+    model.addJoint(slider);
+
+    Muscle* muscle = aMuscle.clone();
+    muscle->setName("muscle");
+    muscle->addNewPathPoint("muscle-box", ground, Vec3(anchorWidth/2,0,0));
+    muscle->addNewPathPoint("muscle-ball", *ball, Vec3(-0.05,0,0));
+    model.addForce(muscle);
+
+    SimTK::State& s0 = model.initSystem();
+    const Coordinate& tx = model.getCoordinateSet().get("tx");
+
+    // Cold: every solve starts from the muscle's default guess, as it does
+    // unless the table is asked for.
+    ASSERT(!muscle->getUseFiberEquilibriumTable(), __FILE__, __LINE__,
+        "testFiberEquilibriumWarmStart: the table should be off by default.");
+    std::vector<double> coldLengths;
+    int coldIterations = 0;
+    equilibrateOverGrid(model, tx, *muscle, s0, coldLengths, coldIterations);
+
+    // Warm: the first solve builds the table, whose cost is not counted.
+    muscle->setUseFiberEquilibriumTable(true);
+    std::vector<double> warmLengths;
+    int warmIterations = 0;
+    equilibrateOverGrid(model, tx, *muscle, s0, warmLengths, warmIterations);
+
+    cout << "  " << coldIterations << " iterations cold, " 
+         << warmIterations << " warm started" << endl;
+    for (size_t i = 0; i < coldLengths.size(); ++i)
+        ASSERT_EQUAL(coldLengths[i], warmLengths[i],
+            1e-6*aMuscle.getOptimalFiberLength(), __FILE__, __LINE__,
+            "testFiberEquilibriumWarmStart: warm and cold solves differ.");
+    ASSERT(warmIterations < coldIterations, __FILE__, __LINE__,
+        "testFiberEquilibriumWarmStart: warm starts did not save iterations.");
+
+    // A copy of the muscle, whose table (which is not copied) is first
+    // needed by two threads at once.
+    Model threadedModel(model);
+    SimTK::State& t0 = threadedModel.initSystem();
+    const Coordinate& threadedTx = threadedModel.getCoordinateSet().get("tx");
+    const Muscle& threadedMuscle =
+        dynamic_cast<const Muscle&>(threadedModel.getActuators().get("muscle"));
+
+    std::vector<double> threadLengths[2];
+    int threadIterations[2] = {0, 0};
+    std::exception_ptr threadErrors[2];
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 2; ++i) {
+        threads.emplace_back([&, i]() {
+            try {
+                equilibrateOverGrid(threadedModel, threadedTx, threadedMuscle,
+                                    t0, threadLengths[i], threadIterations[i]);
+            } catch (...) {
+                threadErrors[i] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    for (int i = 0; i < 2; ++i) {
+        if (threadErrors[i]) std::rethrow_exception(threadErrors[i]);
+        for (size_t j = 0; j < warmLengths.size(); ++j)
+            ASSERT_EQUAL(warmLengths[j], threadLengths[i][j],
+                1e-6*aMuscle.getOptimalFiberLength(), __FILE__, __LINE__,
+                "testFiberEquilibriumWarmStart: threaded solves differ.");
+    }
+}
+
+void testFiberEquilibriumWarmStart()
+{
+    Thelen2003Muscle thelen("muscle", MaxIsometricForce0, 
+        OptimalFiberLength0, TendonSlackLength0, PennationAngle0);
+    testFiberEquilibriumWarmStart(thelen);
+
+    Millard2012EquilibriumMuscle millard("muscle", MaxIsometricForce0,
+        OptimalFiberLength0, TendonSlackLength0, PennationAngle0);
+    testFiberEquilibriumWarmStart(millard);
+}
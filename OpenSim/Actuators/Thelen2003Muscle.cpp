@@ -112,6 +112,8 @@ void Thelen2003Muscle::extendFinalizeFromProperties()
     pennMdl.set_optimal_fiber_length(getOptimalFiberLength());
     pennMdl.set_pennation_angle_at_optimal(
         getPennationAngleAtOptimalFiberLength());
+
+    _fiberEquilibriumTable.clear();
 }
 
 //====================================================================
@@ -902,6 +904,52 @@ SimTK::Vector Thelen2003Muscle::
                         double aActivation, 
                         double aSolTolerance, 
                         int aMaxIterations) const
+{
+    const MuscleFixedWidthPennationModel& pennMdl = 
+        get_MuscleFixedWidthPennationModel();
+    if(!_fiberEquilibriumTable.isBuilt()){
+        //Static solutions over the range of path lengths spanning the 
+        //shortest fiber and a tendon stretched well beyond its strain at 
+        //maximum isometric force
+        double tsl = getTendonSlackLength();
+        _fiberEquilibriumTable.ensureBuilt(getMinimumActivation(),
+            tsl + pennMdl.getMinimumFiberLengthAlongTendon(),
+            1.1*tsl + 2.0*getOptimalFiberLength(),
+            [this,aSolTolerance,aMaxIterations](double a, double ml, 
+                                                double lce0, double& lce){
+                SimTK::Vector soln = initMuscleState(a, ml, 0.0, 
+                                        aSolTolerance, aMaxIterations, lce0);
+                lce = soln[3];
+                return soln[0] == 0;
+            });
+    }
+
+    double ml = getLength(s);
+    double dml= getLengtheningSpeed(s);
+    double guess = _fiberEquilibriumTable.lookup(aActivation, ml);
+    bool warmStarted = !SimTK::isNaN(guess);
+
+    SimTK::Vector soln = initMuscleState(aActivation, ml, dml, 
+                                         aSolTolerance, aMaxIterations, guess);
+    if(warmStarted && soln[0] != 0){
+        //Fall back on the default starting point
+        warmStarted = false;
+        soln = initMuscleState(aActivation, ml, dml, 
+                               aSolTolerance, aMaxIterations, SimTK::NaN);
+    }
+
+    _fiberEquilibriumStatistics = FiberEquilibriumStatistics(
+        (int)soln[0], (int)soln[2], soln[1], warmStarted);
+    return soln;
+}
+
+SimTK::Vector Thelen2003Muscle::
+    initMuscleState(    double aActivation, 
+                        double pathLength,
+                        double pathLengtheningSpeed,
+                        double aSolTolerance, 
+                        int aMaxIterations,
+                        double aInitialFiberLength) const
 {
     //results vector format
     //1: flag (0 = converged 
@@ -920,8 +968,8 @@ SimTK::Vector Thelen2003Muscle::
     //I'm using smaller variable names here to make it possible to write out 
     //lengthy equations
     double ma = aActivation;
-    double ml = getLength(s);
-    double dml= getLengtheningSpeed(s);
+    double ml = pathLength;
+    double dml= pathLengtheningSpeed;
 
     //Shorter version of the constants
     double tsl = getTendonSlackLength();
@@ -947,8 +995,16 @@ SimTK::Vector Thelen2003Muscle::
     double lce = 0;
     double tl  = getTendonSlackLength()*1.01;
 
-   
-    lce = get_MuscleFixedWidthPennationModel().calcFiberLength( ml, tl);    
+
+    if(SimTK::isNaN(aInitialFiberLength)){
+        lce = get_MuscleFixedWidthPennationModel().calcFiberLength( ml, tl);
+    }else{
+        lce = std::max(aInitialFiberLength,
+                get_MuscleFixedWidthPennationModel().getMinimumFiberLength());
+        tl  = get_MuscleFixedWidthPennationModel().calcTendonLength(
+                cos(get_MuscleFixedWidthPennationModel()
+                    .calcPennationAngle(lce)), lce, ml);
+    }
     
     double phi      = get_MuscleFixedWidthPennationModel().calcPennationAngle(lce);
     double cosphi   = cos(phi);
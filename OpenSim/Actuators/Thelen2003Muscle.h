@@ -297,9 +297,17 @@ private:
     //      -Computes curve values, derivatives and integrals
     //=====================================================================
 
-    //Initialization
+    //Initialization: solves for the fiber length at the path length and
+    //lengthening speed in s, warm started from _fiberEquilibriumTable
+    //if it is enabled
     SimTK::Vector initMuscleState(SimTK::State& s, double aActivation,
                              double aSolTolerance, int aMaxIterations) const;
+    //Newton iterations for fiber equilibrium, starting from
+    //aInitialFiberLength if it is not NaN
+    SimTK::Vector initMuscleState(double aActivation, double pathLength,
+                             double pathLengtheningSpeed,
+                             double aSolTolerance, int aMaxIterations,
+                             double aInitialFiberLength) const;
 
     
     double calcFm(double ma, double fal, double fv, 
@@ -31,6 +31,7 @@
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include <OpenSim/Simulation/Model/BodySet.h>
 #include "BodyKinematics.h"
+#include "KinematicsExtractor.h"
 
 
 
@@ -320,6 +321,25 @@ updateBodiesToRecord()
     if(_kin.getSize()==0) cout << "WARNING: BodyKinematics analysis has no bodies to record kinematics for" << endl;
 }
 
+//_____________________________________________________________________________
+/**
+ * Request the kinematics of the bodies to record from the extractor shared
+ * by the kinematics analyses of the model.
+ */
+void BodyKinematics::
+requestKinematics()
+{
+    // Let go of the extractor of a previous model first.
+    _extractor.reset();
+    _extractor = KinematicsExtractor::getShared(*_model);
+    const BodySet& bs = _model->getBodySet();
+    _bodySlots.setSize(_bodyIndices.getSize());
+    for(int i=0; i<_bodyIndices.getSize(); i++)
+        _bodySlots[i] = _extractor->addBody(bs.get(_bodyIndices[i]));
+    if(_recordCenterOfMass) _extractor->addMassCenter();
+    _extractor->requireAccelerations();
+}
+
 
 
 //=============================================================================
@@ -344,6 +364,8 @@ setModel(Model& aModel)
 
     deleteStorage();
     allocateStorage();
+
+    requestKinematics();
 }
 
 //-----------------------------------------------------------------------------
@@ -442,28 +464,18 @@ getExpressResultsInLocalFrame()
 int BodyKinematics::
 record(const SimTK::State& s)
 {
+    if(!KinematicsExtractor::isShared(_extractor, *_model)) requestKinematics();
+    _extractor->update(s);
 
-    // Realize to Acceleration first since we'll ask for Accelerations 
-    _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
     // VARIABLES
-    double dirCos[3][3];
     SimTK::Vec3 vec,angVec;
-    double Mass = 0.0;
-
-    // GROUND BODY
-    const Ground &ground = _model->getGround();
+    const int nBodies = _bodyIndices.getSize();
 
     // POSITION
-    BodySet& bs = _model->updBodySet();
-
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
+    for(int i=0;i<nBodies;i++) {
         // GET POSITIONS AND EULER ANGLES
-        _model->getSimbodyEngine().getPosition(s, body,com,vec);
-        _model->getSimbodyEngine().getDirectionCosines(s, body,dirCos);
-        _model->getSimbodyEngine().convertDirectionCosinesToAngles(dirCos,
-            &angVec[0],&angVec[1],&angVec[2]);
+        vec = _extractor->getBodyPosition(_bodySlots[i]);
+        angVec = _extractor->getBodyAngles(_bodySlots[i]);
 
         // CONVERT TO DEGREES?
         if(getInDegrees()) {
@@ -479,40 +491,18 @@ record(const SimTK::State& s)
     }
 
     if(_recordCenterOfMass) {
-        double rP[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getPosition(s, body,com,vec);
-            // ADD TO WHOLE BODY MASS
-            Mass += body.get_mass();
-            rP[0] += body.get_mass() * vec[0];
-            rP[1] += body.get_mass() * vec[1];
-            rP[2] += body.get_mass() * vec[2];
-        }
-
-        //COMPUTE COM OF WHOLE BODY AND ADD TO ARRAY
-        rP[0] /= Mass;
-        rP[1] /= Mass;
-        rP[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rP,3*sizeof(double));
+        memcpy(&_kin[6*nBodies],&_extractor->getMassCenterPosition()[0],3*sizeof(double));
     }
     
     _pStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
 
     // VELOCITY
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
+    // Angular velocities and accelerations are expressed in ground in
+    // both frames, as SimbodyEngine::getAngularVelocityBodyLocal() gives them.
+    for(int i=0;i<nBodies;i++) {
         // GET VELOCITIES AND ANGULAR VELOCITIES
-        _model->getSimbodyEngine().getVelocity(s, body,com,vec);
-        if(_expressInLocalFrame) {
-            _model->getSimbodyEngine().transform(s, ground,vec,body,vec);
-            _model->getSimbodyEngine().getAngularVelocityBodyLocal(s, body,angVec);
-        } else {
-            _model->getSimbodyEngine().getAngularVelocity(s, body,angVec);
-        }
+        vec = _extractor->getBodyVelocity(_bodySlots[i], _expressInLocalFrame);
+        angVec = _extractor->getBodyAngularVelocity(_bodySlots[i]);
 
         // CONVERT TO DEGREES?
         if(getInDegrees()) {
@@ -528,39 +518,16 @@ record(const SimTK::State& s)
     }
 
     if(_recordCenterOfMass) {
-        double rV[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getVelocity(s, body,com,vec);
-            rV[0] += body.get_mass() * vec[0];
-            rV[1] += body.get_mass() * vec[1];
-            rV[2] += body.get_mass() * vec[2];
-        }
-
-        //COMPUTE VELOCITY OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rV[0] /= Mass;
-        rV[1] /= Mass;
-        rV[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rV,3*sizeof(double));
+        memcpy(&_kin[6*nBodies],&_extractor->getMassCenterVelocity()[0],3*sizeof(double));
     }
 
     _vStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
 
     // ACCELERATIONS
-    for(int i=0;i<_bodyIndices.getSize();i++) {
-        Body& body = bs.get(_bodyIndices[i]);
-        const SimTK::Vec3& com = body.get_mass_center();
-
+    for(int i=0;i<nBodies;i++) {
         // GET ACCELERATIONS AND ANGULAR ACCELERATIONS
-        _model->getSimbodyEngine().getAcceleration(s, body,com,vec);
-        if(_expressInLocalFrame) {
-            _model->getSimbodyEngine().transform(s, ground,vec,body,vec);
-            _model->getSimbodyEngine().getAngularAccelerationBodyLocal(s, body,angVec);
-        } else {
-            _model->getSimbodyEngine().getAngularAcceleration(s, body,angVec);
-        }
+        vec = _extractor->getBodyAcceleration(_bodySlots[i], _expressInLocalFrame);
+        angVec = _extractor->getBodyAngularAcceleration(_bodySlots[i]);
 
         // CONVERT TO DEGREES?
         if(getInDegrees()) {
@@ -576,27 +543,11 @@ record(const SimTK::State& s)
     }
 
     if(_recordCenterOfMass) {
-        double rA[3] = { 0.0, 0.0, 0.0 };
-        for(int i=0;i<bs.getSize();i++) {
-            Body& body = bs.get(i);
-            const SimTK::Vec3& com = body.get_mass_center();
-            _model->getSimbodyEngine().getAcceleration(s, body,com,vec);
-            rA[0] += body.get_mass() * vec[0];
-            rA[1] += body.get_mass() * vec[1];
-            rA[2] += body.get_mass() * vec[2];
-        }
-
-        //COMPUTE ACCELERATION OF COM OF WHOLE BODY AND ADD TO ARRAY
-        rA[0] /= Mass;
-        rA[1] /= Mass;
-        rA[2] /= Mass;
-        int I = 6*_bodyIndices.getSize();
-        memcpy(&_kin[I],rA,3*sizeof(double));
+        memcpy(&_kin[6*nBodies],&_extractor->getMassCenterAcceleration()[0],3*sizeof(double));
     }
 
     _aStore->append(s.getTime(),_kin.getSize(),&_kin[0]);
 
-    //printf("BodyKinematics:\taT:\t%.16f\trA[1]:\t%.16f\n",s.getTime(),rA[1]);
     return(0);
 }
 //_____________________________________________________________________________
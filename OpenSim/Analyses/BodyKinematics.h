@@ -29,6 +29,7 @@
 //=============================================================================
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
+#include <memory>
 
 
 //=============================================================================
@@ -36,10 +37,14 @@
 namespace OpenSim { 
 
 class Model;
+class KinematicsExtractor;
 /**
  * A class for recording the kinematics of the bodies
  * of a model during a simulation.
  *
+ * The values are read from the KinematicsExtractor the model's kinematics
+ * analyses share, so a state is realized and swept once for all of them.
+ *
  * @author Frank C. Anderson
  * @version 1.0
  */
@@ -66,6 +71,9 @@ protected:
     bool _recordCenterOfMass;
     Array<double> _kin;
 
+    std::shared_ptr<KinematicsExtractor> _extractor;
+    Array<int> _bodySlots;
+
     Storage *_pStore;
     Storage *_vStore;
     Storage *_aStore;
@@ -94,6 +102,7 @@ private:
     void allocateStorage();
     void deleteStorage();
     void updateBodiesToRecord();
+    void requestKinematics();
 
 public:
     //--------------------------------------------------------------------------
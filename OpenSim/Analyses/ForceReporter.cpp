@@ -262,7 +262,9 @@ int ForceReporter::record(const SimTK::State& s)
     // MAKE SURE ALL ForceReporter QUANTITIES ARE VALID
     _model->getMultibodySystem().realize(s, SimTK::Stage::Dynamics );
 
-    StateVector nextRow = StateVector(s.getTime());
+    StateVector& nextRow = _forceRow;
+    nextRow.setTime(s.getTime());
+    nextRow.getData().setSize(0);
 
     // NUMBER OF Forces
     const ForceSet& forces = _model->getForceSet(); // This does not contain gravity
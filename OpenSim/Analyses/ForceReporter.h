@@ -65,6 +65,10 @@ protected:
     /** Force storage. */
     Storage _forceStore;
 
+    /** Work row of record(), kept so its data is not regrown at every
+    step. */
+    StateVector _forceRow;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -507,11 +507,10 @@ void InducedAccelerations::setModel(Model &aModel)
  */
 int InducedAccelerations::record(const SimTK::State& s)
 {
-    int nu = _model->getNumSpeeds();
     double aT = s.getTime();
     cout << "time = " << aT << endl;
 
-    SimTK::Vector Q = s.getQ();
+    const SimTK::Vector& Q = s.getQ();
 
     // Reset Accelerations for coordinates at this time step
     for(int i=0;i<_coordSet.getSize();i++) {
@@ -636,7 +635,7 @@ int InducedAccelerations::record(const SimTK::State& s)
             s_analysis.setQ(Q);
 
             // zero velocity
-            s_analysis.setU(SimTK::Vector(nu,0.0));
+            s_analysis.updU() = 0;
             s_analysis.setZ(s.getZ());
 
             // disable actuator forces
@@ -676,8 +675,7 @@ int InducedAccelerations::record(const SimTK::State& s)
             s_analysis.setQ(Q);
 
             // zero velocity
-            SimTK::Vector U(nu,0.0);
-            s_analysis.setU(U);
+            s_analysis.updU() = 0;
             s_analysis.setZ(s.getZ());
             // light up the one actuator who's contribution we are looking for
             int ai = _model->getActuators().getIndex(_contributors[c]);
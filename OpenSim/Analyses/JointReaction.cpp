@@ -25,8 +25,11 @@
 //=============================================================================
 // INCLUDES
 //=============================================================================
+#include <algorithm>
 #include <iostream>
 #include <string>
+#include <memory>
+#include <vector>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/Actuator.h>
 #include <OpenSim/Simulation/Model/BodySet.h>
@@ -147,6 +150,7 @@ operator=(const JointReaction &aJointReaction)
     _inFrame = aJointReaction._inFrame;
     _useForceStorage = aJointReaction._useForceStorage;
     _storeActuation = NULL;
+    _sweepIsSetup = false;
     return(*this);
 }
 
@@ -172,7 +176,8 @@ setNull()
     _inFrame[0] = "ground";
 
     _storeActuation = NULL;
-
+    _sweepIsSetup = false;
+    _numActuationColumns = 0;
 }
 //_____________________________________________________________________________
 /**
@@ -410,9 +415,14 @@ void JointReaction::loadForcesFromFile()
         cout << "Found " << storeSize << " actuator forces with time stamps ranging from "
             << _storeActuation->getFirstTime() << " to " << _storeActuation->getLastTime() << "." << endl;
 
-        // check if actuator set and forces file have the same actuators
+        // check if actuator set and forces file have the same actuators, and
+        // find the column of each actuator once rather than at every step
         bool _containsAllActuators = true;
-        int actuatorSetSize = _model->getActuators().getSize();
+        const Set<Actuator>& actuatorSet = _model->getActuators();
+        int actuatorSetSize = actuatorSet.getSize();
+        _overriddenActuators.clear();
+        _actuationColumns.clear();
+        _numActuationColumns = storeSize;
         if(actuatorSetSize > storeSize){
             cout << "The forces file does not contain enough actuators." << endl;
             _containsAllActuators = false;
@@ -420,11 +430,18 @@ void JointReaction::loadForcesFromFile()
         else {
             for(int actuatorIndex=0;actuatorIndex<actuatorSetSize;actuatorIndex++)
             {
-                std::string actuatorName = _model->getActuators().get(actuatorIndex).getName();
+                const std::string& actuatorName = actuatorSet.get(actuatorIndex).getName();
                 int storageIndex = _storeActuation->getStateIndex(actuatorName,0);
                 if(storageIndex == -1) {
                     cout << "\nThe actuator " << actuatorName << " was not found in the forces file." << endl;
                     _containsAllActuators = false;
+                    continue;
+                }
+                const ScalarActuator* act =
+                    dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
+                if (act) {
+                    _overriddenActuators.push_back(act);
+                    _actuationColumns.push_back(storageIndex);
                 }
             }
         }
@@ -468,6 +485,52 @@ setupStorage()
     if(!(_forcesFileName == "")) loadForcesFromFile();
 
 }
+//_____________________________________________________________________________
+/**
+ * Set up the bodies swept to compute the reaction loads.
+ *
+ * The load a mobilizer transmits to its body is what it takes to produce the
+ * motion of that body and all bodies outboard of it, given the loads applied
+ * to them. Only the child bodies of the analyzed joints and the bodies
+ * outboard of them are needed; they are listed here from the tips of the
+ * tree inward, the order in which their loads are accumulated.
+ */
+void JointReaction::
+setupReactionSweep()
+{
+    const SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+    int nmb = matter.getNumBodies();
+
+    // mark the child bodies of the analyzed joints
+    std::vector<bool> isSwept(nmb, false);
+    for(int i=0; i<_reactionList.getSize(); i++) {
+        JointReactionKey& key = _reactionList[i];
+        key.mobilizedBodyIndex =
+            key.joint->getChildFrame().getMobilizedBodyIndex();
+        if(key.mobilizedBodyIndex != 0) isSwept[key.mobilizedBodyIndex] = true;
+    }
+
+    // mark the bodies outboard of them; a parent always has a lower index
+    // than its children
+    _sweepBodies.clear();
+    _sweepParents.clear();
+    for(MobilizedBodyIndex b(1); b < nmb; ++b) {
+        const MobilizedBodyIndex parent =
+            matter.getMobilizedBody(b).getParentMobilizedBody()
+                .getMobilizedBodyIndex();
+        if(isSwept[parent]) isSwept[b] = true;
+        if(!isSwept[b]) continue;
+        _sweepBodies.push_back(b);
+        _sweepParents.push_back(isSwept[parent] ? parent : MobilizedBodyIndex());
+    }
+    std::reverse(_sweepBodies.begin(), _sweepBodies.end());
+    std::reverse(_sweepParents.begin(), _sweepParents.end());
+
+    // loads of bodies that are not swept (e.g. ground) stay zero
+    _transmittedLoads.resize(nmb);
+    _transmittedLoads.setToZero();
+    _sweepIsSetup = true;
+}
 
 
 //=============================================================================
@@ -494,6 +557,7 @@ setModel(Model& aModel)
     setupReactionList();
     constructDescription();
     constructColumnLabels();
+    _sweepIsSetup = false;
 
     int numJoints = _reactionList.getSize();
     // set size of working array of loads.  Each load has 3 components each
@@ -509,10 +573,10 @@ setModel(Model& aModel)
 /**
  * Compute and record the results.
  *
- * This method computes the reaction loads at all joints in the model, then
- * truncates the results to contain only the loads at the requested joints
- * and finally, if necessary, modifies the loads to be acting on the specified
- * body and expressed in the specified frame
+ * This method computes the reaction loads at the requested joints by
+ * sweeping the bodies outboard of them (see setupReactionSweep()) and then,
+ * if necessary, modifies the loads to be acting on the specified body and
+ * expressed in the specified frame
  *
  * @param aT Current time in the simulation.
  * @param aX Current values of the controls.
@@ -521,58 +585,91 @@ setModel(Model& aModel)
 int JointReaction::
 record(const SimTK::State& s)
 {
-    /** if a forces file is specified replace the computed actuation with the 
-        forces from storage.*/
-    SimTK::State s_analysis = s;
+    _scratch.reset();
 
-    _model->updMultibodySystem().realize(s_analysis, s.getSystemStage());
+    /** if a forces file is specified replace the computed actuation with the 
+        forces from storage. This is done in a copy of the state; otherwise the
+        state is only realized further, so it is not copied.*/
+    std::unique_ptr<SimTK::State> s_copy;
+    if(_useForceStorage) {
+        s_copy.reset(new SimTK::State(s));
+        _model->updMultibodySystem().realize(*s_copy, s.getSystemStage());
+    }
+    const SimTK::State& s_analysis = s_copy ? *s_copy : s;
     if(_useForceStorage){
-
-        const Set<Actuator> *actuatorSet = &_model->getActuators();
-        int nA = actuatorSet->getSize();
-        Array<double> forces(0,nA);
-        _storeActuation->getDataAtTime(s.getTime(),nA,forces);
-        int storageIndex = -1;
-        for(int actuatorIndex=0;actuatorIndex<nA;actuatorIndex++)
-        {
-            //Actuator* act = dynamic_cast<Actuator*>(&_forceSet->get(actuatorIndex));
-            std::string actuatorName = actuatorSet->get(actuatorIndex).getName();
-            storageIndex = _storeActuation->getStateIndex(actuatorName, 0);
-            if(storageIndex == -1){
-                cout << "The actuator, " << actuatorName << ", was not found in the forces file." << endl;
-                break;
-            }
-            const ScalarActuator* act = dynamic_cast<const ScalarActuator*>(&actuatorSet[actuatorIndex]);
-            if (act){
-                act->overrideActuation(s_analysis, true);
-                act->setOverrideActuation(s_analysis, forces[storageIndex]);
-            }
+        double *forces = _scratch.allocate(_numActuationColumns);
+        _storeActuation->getDataAtTime(s.getTime(),_numActuationColumns,forces);
+        for(unsigned i=0; i<_overriddenActuators.size(); i++) {
+            _overriddenActuators[i]->overrideActuation(*s_copy, true);
+            _overriddenActuators[i]->setOverrideActuation(*s_copy,
+                forces[_actuationColumns[i]]);
         }
     }
+    if(!_sweepIsSetup) setupReactionSweep();
+
     // VARIABLES
     const Ground& ground = _model->getGround();
-    int numJoints = _model->getNumJoints();
+    const MultibodySystem& system = _model->getMultibodySystem();
+    const SimbodyMatterSubsystem& matter = _model->getMatterSubsystem();
+
+    /* Realize to the acceleration stage. Accelerations already computed for
+    *  this state (e.g., by the integrator or another analysis) are reused.*/
+    system.realize(s_analysis, Stage::Acceleration);
+    const Vector_<SpatialVec>& appliedBodyForces =
+        system.getRigidBodyForces(s_analysis, Stage::Dynamics);
+    const Vector& multipliers = matter.getConstraintMultipliers(s_analysis);
+    const bool hasConstraints = multipliers.size() > 0;
+    if(hasConstraints) {
+        // these are the negative of the loads the constraints apply
+        matter.calcConstraintForcesFromMultipliers(s_analysis, multipliers,
+            _constraintBodyForces, _constraintMobilityForces);
+    }
 
-    /** define 2 variable length vectors of Vec3 vectors to contain calculated  
-    *   forces and moments for all the bodies in the model */
-    Vector_<Vec3> allForcesVec(numJoints);
-    Vector_<Vec3> allMomentsVec(numJoints);
+    /* Load on each swept body, about its origin and in ground, needed to
+    *  produce its motion: its rate of change of momentum less the loads
+    *  applied to it by forces and by constraints.*/
+    for(unsigned i=0; i<_sweepBodies.size(); i++) {
+        const MobilizedBodyIndex b = _sweepBodies[i];
+        const MobilizedBody& mobod = matter.getMobilizedBody(b);
+        const MassProperties& massProps = mobod.getBodyMassProperties(s_analysis);
+        const Mat33 R_GB = mobod.getBodyRotation(s_analysis).asMat33();
+        const Mat33 inertia =
+            R_GB * massProps.calcCentralInertia().toMat33() * ~R_GB;
+        const Vec3& w = mobod.getBodyAngularVelocity(s_analysis);
+        const Vec3& alpha = mobod.getBodyAngularAcceleration(s_analysis);
+        const Vec3 comInGround = R_GB * massProps.getMassCenter();
+        const Vec3 massTimesAcc = massProps.getMass() *
+            mobod.findStationAccelerationInGround(s_analysis,
+                massProps.getMassCenter());
+
+        SpatialVec& load = _transmittedLoads[b];
+        load[0] = inertia*alpha + w % (inertia*w) + comInGround % massTimesAcc;
+        load[1] = massTimesAcc;
+        load -= appliedBodyForces[b];
+        if(hasConstraints) load += _constraintBodyForces[b];
+    }
 
-    /* Calculate All joint reaction forces and moments.
-    *  Applied to child bodies, expressed in ground frame.  
-    *  computeReactions realizes to the acceleration stage internally
-    *  so you don't have to call realize in this analysis.*/ 
-    _model->getSimbodyEngine().computeReactions(s_analysis, allForcesVec, allMomentsVec);
+    /* Accumulate the loads from the tips inward, so that each swept body
+    *  carries the load transmitted by its mobilizer to it and all bodies
+    *  outboard of it.*/
+    for(unsigned i=0; i<_sweepBodies.size(); i++) {
+        const MobilizedBodyIndex parent = _sweepParents[i];
+        if(!parent.isValid()) continue;
+        const MobilizedBodyIndex b = _sweepBodies[i];
+        const SpatialVec& load = _transmittedLoads[b];
+        const Vec3 shift =
+            matter.getMobilizedBody(b).getBodyOriginLocation(s_analysis) -
+            matter.getMobilizedBody(parent).getBodyOriginLocation(s_analysis);
+        _transmittedLoads[parent][0] += load[0] + shift % load[1];
+        _transmittedLoads[parent][1] += load[1];
+    }
 
     /* retrieved desired joint reactions, convert to desired bodies, and convert
     *  to desired reference frames*/
     int numOutputJoints = _reactionList.getSize();
-    Vector_<Vec3> forcesVec(numOutputJoints), momentsVec(numOutputJoints), pointsVec(numOutputJoints);
     for(int i=0; i<numOutputJoints; i++) {
-        JointReactionKey currentKey = _reactionList[i];
+        const JointReactionKey& currentKey = _reactionList[i];
         const Joint& joint = *currentKey.joint;
-        Vec3 force = allForcesVec[currentKey.jointIndex];
-        Vec3 moment = allMomentsVec[currentKey.jointIndex];
         const PhysicalFrame& expressedInBody = *currentKey.expressedInFrame;
         
         // find the point of application of the joint load on the child
@@ -580,6 +677,14 @@ record(const SimTK::State& s)
         Vec3 childLocationInGlobal = joint.getChildFrame().getGroundTransform(s_analysis).p();
         // set the point of application to the joint location in the child body
         Vec3 pointOfApplication(0,0,0);
+
+        // the load transmitted to the child, shifted from the child body
+        // origin to the joint location in the child
+        const SpatialVec& load = _transmittedLoads[currentKey.mobilizedBodyIndex];
+        Vec3 force = load[1];
+        Vec3 moment = load[0] + (matter.getMobilizedBody(
+            currentKey.mobilizedBodyIndex).getBodyOriginLocation(s_analysis)
+            - childLocationInGlobal) % force;
         
         // check if the load on the child needs to be converted to an equivalent
         // load on the parent body.
@@ -607,19 +712,12 @@ record(const SimTK::State& s)
         _model->getSimbodyEngine().transform(s_analysis,ground,moment,expressedInBody,moment);
         _model->getSimbodyEngine().transformPosition(s_analysis,ground,pointOfApplication,expressedInBody,pointOfApplication);
 
-        /* place results in the truncated loads vectors*/
-        forcesVec[i] = force;
-        momentsVec[i] = moment;
-        pointsVec[i] = pointOfApplication;
-    }
-
-    /* fill out row construction array*/
-    for(int i=0;i<numOutputJoints;i++) {
+        /* fill out row construction array*/
         int I = 9*i;
         for(int j=0;j<3;j++) {
-            _Loads[I+j] = forcesVec[i][j];
-            _Loads[I+j+3] = momentsVec[i][j];
-            _Loads[I+j+6] = pointsVec[i][j];
+            _Loads[I+j] = force[j];
+            _Loads[I+j+3] = moment[j];
+            _Loads[I+j+6] = pointOfApplication[j];
         }
     }
     /* Write the reaction data to storage*/
@@ -644,6 +742,7 @@ begin(SimTK::State& s)
     if(!proceed()) return(0);
     // Read forces file here rather than during initialization
     setupStorage();
+    setupReactionSweep();
 
     // RESET STORAGE
     _storeReactionLoads.reset(s.getTime());
@@ -46,6 +46,7 @@ namespace OpenSim {
 
 class Model;
 class Joint;
+class ScalarActuator;
 
 
 /**
@@ -57,6 +58,10 @@ class Joint;
  * the child, parent or ground frames. The default behavior is the force
  * on the child expressed in the ground frame.
  *
+ * Reaction loads are computed only for the joints analyzed, by sweeping the
+ * bodies outboard of them from the tips of the multibody tree inward, so the
+ * cost of analyzing a few joints does not grow with the size of the model.
+ *
  * @author Matt DeMers, Ajay Seth
  * @version 1.0
  */
@@ -85,6 +90,9 @@ private:
         bool isAppliedOnChild;
         /* The reference Frame in which the force should be expressed */
         const PhysicalFrame* expressedInFrame;
+        /* The mobilized body of the joint's child frame, whose mobilizer
+           transmits the reaction load. Set by setupReactionSweep(). */
+        SimTK::MobilizedBodyIndex mobilizedBodyIndex;
     };
 
 protected:
@@ -141,8 +149,30 @@ protected:
     *   desired joints, onBody, and inFrame to be output*/
     Array<JointReactionKey> _reactionList;
 
+    /** Mobilized bodies outboard of (and including) the child bodies of the
+    *   analyzed joints, in the order they are swept: outboard to inboard.
+    *   Only these bodies contribute to the reported reaction loads.*/
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _sweepBodies;
+    /** Parent of each swept body, or an invalid index if it is not swept.*/
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _sweepParents;
+    bool _sweepIsSetup;
+
+    /** Internal work vector for holding, for each swept body, the load its
+    *   mobilizer transmits to it, about the body origin and in ground.*/
+    SimTK::Vector_<SimTK::SpatialVec> _transmittedLoads;
+
+    /** Internal work vectors for holding the loads applied by constraints*/
+    SimTK::Vector_<SimTK::SpatialVec> _constraintBodyForces;
+    SimTK::Vector _constraintMobilityForces;
+
     bool _useForceStorage;
 
+    /** Actuators whose actuation is overridden from the forces storage, and
+    *   the column of each in that storage. Set by loadForcesFromFile().*/
+    SimTK::Array_<const ScalarActuator*> _overriddenActuators;
+    SimTK::Array_<int> _actuationColumns;
+    int _numActuationColumns;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -186,6 +216,8 @@ public:
      /** Public accessors for the inFrame property */
     const Array<std::string>& getInFrame() const { return _inFrame; }
     void setInFrame( Array<std::string>& inFrame) { _inFrame = inFrame; }
+    /** Storage of the recorded reaction loads */
+    const Storage& getLoadsStorage() const { return _storeReactionLoads; }
 
     //-------------------------------------------------------------------------
     // INTEGRATION
@@ -213,6 +245,7 @@ protected:
     void constructDescription();
     void constructColumnLabels();
     void setupStorage();
+    void setupReactionSweep();
     void loadForcesFromFile();
 
 //=============================================================================
@@ -30,6 +30,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include "Kinematics.h"
+#include "KinematicsExtractor.h"
 
 
 
@@ -211,6 +212,24 @@ updateCoordinatesToRecord()
     }
 }
 
+//_____________________________________________________________________________
+/**
+ * Request the kinematics of the coordinates to record from the extractor
+ * shared by the kinematics analyses of the model.
+ */
+void Kinematics::
+requestKinematics()
+{
+    // Let go of the extractor of a previous model first.
+    _extractor.reset();
+    _extractor = KinematicsExtractor::getShared(*_model);
+    const CoordinateSet& cs = _model->getCoordinateSet();
+    _coordinateSlots.setSize(_coordinateIndices.getSize());
+    for(int i=0; i<_coordinateIndices.getSize(); i++)
+        _coordinateSlots[i] = _extractor->addCoordinate(cs[_coordinateIndices[i]]);
+    if(_recordAccelerations) _extractor->requireAccelerations();
+}
+
 //=============================================================================
 // GET AND SET
 //=============================================================================
@@ -314,6 +333,17 @@ getPositionStorage()
     return(_pStore);
 }
 //_____________________________________________________________________________
+/**
+ * Set whether accelerations are recorded. Recording them requires the
+ * dynamics of the model to be realized.
+ */
+void Kinematics::
+setRecordAccelerations(bool aRecordAccelerations)
+{
+    _recordAccelerations = aRecordAccelerations;
+    if(_recordAccelerations && _extractor) _extractor->requireAccelerations();
+}
+//_____________________________________________________________________________
 /**
  * Set the model pointer for analyzing kinematics.
  */
@@ -328,6 +358,8 @@ void Kinematics::setModel(Model& aModel)
     // UPDATE LABELS
     updateCoordinatesToRecord();
     constructColumnLabels();
+
+    requestKinematics();
 }
 
 //-----------------------------------------------------------------------------
@@ -361,24 +393,21 @@ setStorageCapacityIncrements(int aIncrement)
  */
 int Kinematics::record(const SimTK::State& s)
 {
-    if(_recordAccelerations){
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    }
-    else{
-        _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
-    }
+    if(!KinematicsExtractor::isShared(_extractor, *_model)) requestKinematics();
+    _extractor->update(s);
+
     // RECORD RESULTS
     const CoordinateSet& cs = _model->getCoordinateSet();
     int nvalues = _coordinateIndices.getSize();
     for(int i=0;i<nvalues;i++){
-        _values[i] = cs[_coordinateIndices[i]].getValue(s);
+        _values[i] = _extractor->getCoordinateValue(_coordinateSlots[i]);
         if(getInDegrees() && (cs[_coordinateIndices[i]].getMotionType() == Coordinate::Rotational))
             _values[i] *= SimTK_RADIAN_TO_DEGREE;
     }
     _pStore->append(s.getTime(),nvalues,&_values[0]);
 
     for(int i=0;i<nvalues;i++){
-        _values[i] = cs[_coordinateIndices[i]].getSpeedValue(s);
+        _values[i] = _extractor->getCoordinateSpeed(_coordinateSlots[i]);
         if(getInDegrees() && (cs[_coordinateIndices[i]].getMotionType() == Coordinate::Rotational))
             _values[i] *= SimTK_RADIAN_TO_DEGREE;
     }
@@ -387,7 +416,7 @@ int Kinematics::record(const SimTK::State& s)
 
     if(_recordAccelerations) {
         for(int i=0;i<nvalues;i++){
-            _values[i] = cs[_coordinateIndices[i]].getAccelerationValue(s);
+            _values[i] = _extractor->getCoordinateAcceleration(_coordinateSlots[i]);
             if(getInDegrees() && (cs[_coordinateIndices[i]].getMotionType() == Coordinate::Rotational))
                 _values[i] *= SimTK_RADIAN_TO_DEGREE;
         }
@@ -423,11 +452,6 @@ begin( SimTK::State& s )
     // RECORD
     int status = 0;
     if(_pStore->getSize()<=0) {
-        if(_recordAccelerations && s.getSystemStage() < SimTK::Stage::Acceleration ) 
-            _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-        else
-            _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity);
-
         status = record(s);
     }
 
@@ -31,16 +31,22 @@
 #include <OpenSim/Common/PropertyStrArray.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
+#include <memory>
 
 
 //=============================================================================
 //=============================================================================
 namespace OpenSim { 
 
+class KinematicsExtractor;
+
 /**
  * A class for recording the kinematics of the generalized coordinates
  * of a model during a simulation.
  *
+ * The values are read from the KinematicsExtractor the model's kinematics
+ * analyses share, so a state is realized and swept once for all of them.
+ *
  * @author Frank C. Anderson
  * @version 1.0
  */
@@ -60,6 +66,9 @@ protected:
     Array<int> _coordinateIndices;
     Array<double> _values;
 
+    std::shared_ptr<KinematicsExtractor> _extractor;
+    Array<int> _coordinateSlots;
+
     Storage *_pStore;
     Storage *_vStore;
     Storage *_aStore;
@@ -83,6 +92,7 @@ private:
     void allocateStorage();
     void deleteStorage();
     void updateCoordinatesToRecord();
+    void requestKinematics();
 
 public:
     //--------------------------------------------------------------------------
@@ -97,7 +107,7 @@ public:
     // MODEL
     void setModel(Model& aModel) override;
 
-    void setRecordAccelerations(bool aRecordAccelerations) { _recordAccelerations = aRecordAccelerations; } // TODO: re-allocate storage or delete storage
+    void setRecordAccelerations(bool aRecordAccelerations); // TODO: re-allocate storage or delete storage
 
     //--------------------------------------------------------------------------
     // ANALYSIS
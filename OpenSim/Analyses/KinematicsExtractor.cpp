@@ -0,0 +1,238 @@
+/* -------------------------------------------------------------------------- *
+ *                     OpenSim:  KinematicsExtractor.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "KinematicsExtractor.h"
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/BodySet.h>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+shared_ptr<KinematicsExtractor> KinematicsExtractor::getShared(Model& model)
+{
+    AnalysisSet& analyses = model.updAnalysisSet();
+    shared_ptr<KinematicsExtractor> extractor =
+        analyses.getKinematicsExtractor();
+    if (!extractor || &extractor->getModel() != &model) {
+        extractor.reset(new KinematicsExtractor(model));
+        analyses.setKinematicsExtractor(extractor);
+    }
+    return extractor;
+}
+
+bool KinematicsExtractor::isShared(
+        const shared_ptr<KinematicsExtractor>& extractor, const Model& model)
+{
+    return extractor &&
+        extractor == model.getAnalysisSet().getKinematicsExtractor();
+}
+
+KinematicsExtractor::KinematicsExtractor(const Model& model) :
+    _model(model),
+    _massCenter(false),
+    _stateVariables(false),
+    _accelerations(false),
+    _upToDate(false),
+    _time(SimTK::NaN)
+{
+}
+
+//=============================================================================
+// REQUESTS
+//=============================================================================
+void KinematicsExtractor::invalidate()
+{
+    _upToDate = false;
+    _buffer.assign(pointOffset() + PointSize*_points.size(), SimTK::NaN);
+}
+
+int KinematicsExtractor::addCoordinate(const Coordinate& coordinate)
+{
+    for (size_t i = 0; i < _coordinates.size(); ++i)
+        if (_coordinates[i] == &coordinate) return int(i);
+    _coordinates.push_back(&coordinate);
+    invalidate();
+    return int(_coordinates.size()) - 1;
+}
+
+int KinematicsExtractor::addBody(const Body& body)
+{
+    for (size_t i = 0; i < _bodies.size(); ++i)
+        if (_bodies[i] == &body) return int(i);
+    _bodies.push_back(&body);
+    invalidate();
+    return int(_bodies.size()) - 1;
+}
+
+int KinematicsExtractor::addPoint(const PhysicalFrame& frame,
+        const Vec3& point, const PhysicalFrame* relativeTo)
+{
+    for (size_t i = 0; i < _points.size(); ++i)
+        if (_points[i].frame == &frame && _points[i].point == point &&
+                _points[i].relativeTo == relativeTo)
+            return int(i);
+    PointRequest request = {&frame, point, relativeTo};
+    _points.push_back(request);
+    invalidate();
+    return int(_points.size()) - 1;
+}
+
+void KinematicsExtractor::addMassCenter()
+{
+    if (_massCenter) return;
+    _massCenter = true;
+    invalidate();
+}
+
+void KinematicsExtractor::addStateVariableValues()
+{
+    if (_stateVariables) return;
+    _stateVariables = true;
+    invalidate();
+}
+
+void KinematicsExtractor::requireAccelerations()
+{
+    if (_accelerations) return;
+    _accelerations = true;
+    invalidate();
+}
+
+//=============================================================================
+// SWEEP
+//=============================================================================
+bool KinematicsExtractor::isUpToDate(const SimTK::State& s) const
+{
+    if (!_upToDate || s.getTime() != _time) return false;
+    const SimTK::Vector& y = s.getY();
+    if (y.size() != _y.size()) return false;
+    for (int i = 0; i < y.size(); ++i)
+        if (y[i] != _y[i]) return false;
+    // Parameters, modeling options and discrete variables are not in Y;
+    // changing them invalidates a stage, which is realized with a new
+    // version. A stage realized no further than before also differs.
+    return s.getLowestSystemStageDifference(_stageVersions) ==
+        SimTK::Stage::Infinity;
+}
+
+void KinematicsExtractor::update(const SimTK::State& s)
+{
+    if (isUpToDate(s)) return;
+
+    _model.getMultibodySystem().realize(s, _accelerations ?
+        SimTK::Stage::Acceleration : SimTK::Stage::Velocity);
+    const SimTK::MobilizedBody& ground =
+        _model.getMatterSubsystem().getGround();
+    double* values = _buffer.data();
+
+    // COORDINATES
+    for (size_t i = 0; i < _coordinates.size();
+            ++i, values += CoordinateSize) {
+        values[0] = _coordinates[i]->getValue(s);
+        values[1] = _coordinates[i]->getSpeedValue(s);
+        values[2] = _accelerations ?
+            _coordinates[i]->getAccelerationValue(s) : SimTK::NaN;
+    }
+
+    // BODIES
+    for (size_t i = 0; i < _bodies.size(); ++i, values += BodySize) {
+        const SimTK::MobilizedBody& body = _bodies[i]->getMobilizedBody();
+        const Vec3& com = _bodies[i]->get_mass_center();
+        Vec3::updAs(values) = body.findStationLocationInGround(s, com);
+        Vec3::updAs(values + 3) =
+            body.getBodyRotation(s).convertRotationToBodyFixedXYZ();
+        const Vec3 v = body.findStationVelocityInGround(s, com);
+        Vec3::updAs(values + 6) = v;
+        Vec3::updAs(values + 9) =
+            ground.expressVectorInAnotherBodyFrame(s, v, body);
+        Vec3::updAs(values + 12) = body.getBodyAngularVelocity(s);
+        if (_accelerations) {
+            const Vec3 a = body.findStationAccelerationInGround(s, com);
+            Vec3::updAs(values + 15) = a;
+            Vec3::updAs(values + 18) =
+                ground.expressVectorInAnotherBodyFrame(s, a, body);
+            Vec3::updAs(values + 21) = body.getBodyAngularAcceleration(s);
+        }
+    }
+
+    // WHOLE-BODY MASS CENTER, the mass-weighted mean of all bodies
+    if (_massCenter) {
+        const BodySet& bodySet = _model.getBodySet();
+        double mass = 0, rP[3] = {0, 0, 0}, rV[3] = {0, 0, 0},
+               rA[3] = {0, 0, 0};
+        for (int i = 0; i < bodySet.getSize(); ++i) {
+            const Body& body = bodySet[i];
+            const SimTK::MobilizedBody& mobod = body.getMobilizedBody();
+            const Vec3& com = body.get_mass_center();
+            const double m = body.get_mass();
+            const Vec3 p = mobod.findStationLocationInGround(s, com);
+            const Vec3 v = mobod.findStationVelocityInGround(s, com);
+            const Vec3 a = _accelerations ?
+                mobod.findStationAccelerationInGround(s, com) : Vec3(0);
+            mass += m;
+            for (int k = 0; k < 3; ++k) {
+                rP[k] += m * p[k];
+                rV[k] += m * v[k];
+                rA[k] += m * a[k];
+            }
+        }
+        for (int k = 0; k < 3; ++k) {
+            values[k] = rP[k] / mass;
+            values[3 + k] = rV[k] / mass;
+            values[6 + k] = _accelerations ? rA[k] / mass : SimTK::NaN;
+        }
+        values += MassCenterSize;
+    }
+
+    // POINTS
+    for (size_t i = 0; i < _points.size(); ++i, values += PointSize) {
+        const PointRequest& request = _points[i];
+        const SimTK::MobilizedBody& body = request.frame->getMobilizedBody();
+        Vec3 p = body.findStationLocationInGround(s, request.point);
+        Vec3 v = body.findStationVelocityInGround(s, request.point);
+        Vec3 a = _accelerations ?
+            body.findStationAccelerationInGround(s, request.point) : Vec3(0);
+        if (request.relativeTo) {
+            const SimTK::MobilizedBody& relativeTo =
+                request.relativeTo->getMobilizedBody();
+            p = ground.findStationLocationInAnotherBody(s, p, relativeTo);
+            v = ground.expressVectorInAnotherBodyFrame(s, v, relativeTo);
+            a = ground.expressVectorInAnotherBodyFrame(s, a, relativeTo);
+        }
+        Vec3::updAs(values) = p;
+        Vec3::updAs(values + 3) = v;
+        Vec3::updAs(values + 6) = _accelerations ? a : Vec3(SimTK::NaN);
+    }
+
+    // STATE VARIABLES
+    if (_stateVariables)
+        _stateVariableValues = _model.getStateVariableValues(s);
+
+    _time = s.getTime();
+    _y = s.getY();
+    s.getSystemStageVersions(_stageVersions);
+    _upToDate = true;
+}
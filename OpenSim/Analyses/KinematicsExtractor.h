@@ -0,0 +1,194 @@
+#ifndef OPENSIM_KINEMATICS_EXTRACTOR_H_
+#define OPENSIM_KINEMATICS_EXTRACTOR_H_
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  KinematicsExtractor.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimAnalysesDLL.h"
+#include "SimTKcommon.h"
+#include <memory>
+#include <vector>
+
+namespace OpenSim {
+
+class Model;
+class Body;
+class Coordinate;
+class PhysicalFrame;
+
+/**
+ * Computes the kinematics requested by the kinematics analyses of a model
+ * (Kinematics, BodyKinematics, PointKinematics and StatesReporter) in one
+ * sweep per state.
+ *
+ * The analyses of a model share one extractor, held by the model's
+ * AnalysisSet (see getShared()). Each
+ * analysis adds the coordinates, bodies and points it records and gets back
+ * a slot for each; duplicate requests share a slot. update() realizes the
+ * state once, to Stage::Acceleration only if some analysis records
+ * accelerations, and fills one buffer with the values of all slots. It does
+ * nothing if the state has the same time and continuous state values as the
+ * last one, and the state was not changed or realized again since, so only
+ * the first analysis to record a state pays for the sweep and the others
+ * read their values from the buffer.
+ *
+ * Values are computed with the same Simbody calls as the analyses made
+ * themselves, so their results are unchanged. Angles are in radians.
+ * Requests are never removed; an extractor lives as long as the model or
+ * the analyses holding it.
+ */
+class OSIMANALYSES_API KinematicsExtractor {
+public:
+    /** The extractor of a model, created for the first analysis that asks
+    for it and shared with the others. It is kept by the model's AnalysisSet,
+    so it goes away with the model and is never handed to another model. */
+    static std::shared_ptr<KinematicsExtractor> getShared(Model& model);
+    /** Whether an analysis's extractor is the one shared by the analyses of
+    its model, which is not the case if the analysis was given another
+    model. */
+    static bool isShared(const std::shared_ptr<KinematicsExtractor>& extractor,
+                         const Model& model);
+
+    explicit KinematicsExtractor(const Model& model);
+
+    const Model& getModel() const { return _model; }
+
+    //--------------------------------------------------------------------------
+    // REQUESTS
+    //--------------------------------------------------------------------------
+    /** Value, speed and acceleration of a coordinate. */
+    int addCoordinate(const Coordinate& coordinate);
+    /** Kinematics of the mass center and orientation of a body. */
+    int addBody(const Body& body);
+    /** Position, velocity and acceleration of a point fixed on a frame,
+    expressed in ground or, if relativeTo is given, in that frame. */
+    int addPoint(const PhysicalFrame& frame, const SimTK::Vec3& point,
+                 const PhysicalFrame* relativeTo=nullptr);
+    /** Kinematics of the mass center of the whole model. */
+    void addMassCenter();
+    /** Values of all state variables, as Model::getStateVariableValues(). */
+    void addStateVariableValues();
+    /** Compute accelerations. Without this, update() realizes the state to
+    Stage::Velocity only and accelerations are not available. */
+    void requireAccelerations();
+
+    //--------------------------------------------------------------------------
+    // SWEEP
+    //--------------------------------------------------------------------------
+    /** Compute all requested values for a state, unless they were computed
+    for the same time and continuous state values already and the state's
+    stages have not been invalidated or realized again since. */
+    void update(const SimTK::State& s);
+
+    //--------------------------------------------------------------------------
+    // VALUES (of the last update)
+    //--------------------------------------------------------------------------
+    double getCoordinateValue(int slot) const
+    {   return _buffer[CoordinateSize*slot]; }
+    double getCoordinateSpeed(int slot) const
+    {   return _buffer[CoordinateSize*slot + 1]; }
+    double getCoordinateAcceleration(int slot) const
+    {   return _buffer[CoordinateSize*slot + 2]; }
+
+    /** Mass center location in ground. */
+    const SimTK::Vec3& getBodyPosition(int slot) const
+    {   return body(slot, 0); }
+    /** Body-fixed X-Y-Z Euler angles of the body in ground. */
+    const SimTK::Vec3& getBodyAngles(int slot) const
+    {   return body(slot, 3); }
+    /** Mass center velocity, expressed in ground or in the body. */
+    const SimTK::Vec3& getBodyVelocity(int slot, bool inBody=false) const
+    {   return body(slot, inBody ? 9 : 6); }
+    /** Angular velocity of the body in ground, expressed in ground. */
+    const SimTK::Vec3& getBodyAngularVelocity(int slot) const
+    {   return body(slot, 12); }
+    const SimTK::Vec3& getBodyAcceleration(int slot, bool inBody=false) const
+    {   return body(slot, inBody ? 18 : 15); }
+    const SimTK::Vec3& getBodyAngularAcceleration(int slot) const
+    {   return body(slot, 21); }
+
+    const SimTK::Vec3& getMassCenterPosition() const { return massCenter(0); }
+    const SimTK::Vec3& getMassCenterVelocity() const { return massCenter(3); }
+    const SimTK::Vec3& getMassCenterAcceleration() const
+    {   return massCenter(6); }
+
+    const SimTK::Vec3& getPointPosition(int slot) const
+    {   return point(slot, 0); }
+    const SimTK::Vec3& getPointVelocity(int slot) const
+    {   return point(slot, 3); }
+    const SimTK::Vec3& getPointAcceleration(int slot) const
+    {   return point(slot, 6); }
+
+    const SimTK::Vector& getStateVariableValues() const
+    {   return _stateVariableValues; }
+
+private:
+    KinematicsExtractor(const KinematicsExtractor&);
+    KinematicsExtractor& operator=(const KinematicsExtractor&);
+
+    enum { CoordinateSize = 3, BodySize = 24, MassCenterSize = 9,
+           PointSize = 9 };
+    struct PointRequest {
+        const PhysicalFrame* frame;
+        SimTK::Vec3 point;
+        const PhysicalFrame* relativeTo;
+    };
+
+    // The buffer holds the coordinates, then the bodies, the mass center
+    // and the points.
+    size_t bodyOffset() const
+    {   return CoordinateSize*_coordinates.size(); }
+    size_t massCenterOffset() const
+    {   return bodyOffset() + BodySize*_bodies.size(); }
+    size_t pointOffset() const
+    {   return massCenterOffset() + (_massCenter ? MassCenterSize : 0); }
+    const SimTK::Vec3& body(int slot, int i) const
+    {   return vec3(bodyOffset() + BodySize*slot + i); }
+    const SimTK::Vec3& massCenter(int i) const
+    {   return vec3(massCenterOffset() + i); }
+    const SimTK::Vec3& point(int slot, int i) const
+    {   return vec3(pointOffset() + PointSize*slot + i); }
+    const SimTK::Vec3& vec3(size_t offset) const
+    {   return SimTK::Vec3::getAs(&_buffer[offset]); }
+
+    void invalidate();
+    bool isUpToDate(const SimTK::State& s) const;
+
+    const Model& _model;
+    std::vector<const Coordinate*> _coordinates;
+    std::vector<const Body*> _bodies;
+    std::vector<PointRequest> _points;
+    bool _massCenter;
+    bool _stateVariables;
+    bool _accelerations;
+
+    std::vector<double> _buffer;
+    SimTK::Vector _stateVariableValues;
+    // Identify the state of the last update.
+    bool _upToDate;
+    double _time;
+    SimTK::Vector _y;
+    SimTK::Array_<SimTK::StageVersion> _stageVersions;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_KINEMATICS_EXTRACTOR_H_
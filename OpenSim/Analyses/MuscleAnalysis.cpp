@@ -511,24 +511,33 @@ int MuscleAnalysis::record(const SimTK::State& s)
     // LOOP THROUGH MUSCLES
     int nm = _muscleArray.getSize();
 
+    // WORK ARRAYS, from the scratch memory rather than allocated every step
+    _scratch.reset();
     double nan = SimTK::NaN;
     // Angles and lengths
-    Array<double> penang(nan,nm);
-    Array<double> len(nan,nm), tlen(nan,nm);
-    Array<double> fiblen(nan,nm), normfiblen(nan,nm);
+    double *penang = _scratch.allocate(nm,nan);
+    double *len = _scratch.allocate(nm,nan), *tlen = _scratch.allocate(nm,nan);
+    double *fiblen = _scratch.allocate(nm,nan);
+    double *normfiblen = _scratch.allocate(nm,nan);
 
     // Muscle velocity information
-    Array<double> fibVel(nan,nm), normFibVel(nan,nm);
-    Array<double> penAngVel(nan,nm);
+    double *fibVel = _scratch.allocate(nm,nan);
+    double *normFibVel = _scratch.allocate(nm,nan);
+    double *penAngVel = _scratch.allocate(nm,nan);
 
     // Muscle component forces
-    Array<double> force(nan, nm), fibforce(nan, nm);
-    Array<double> actfibforce(nan,nm), passfibforce(nan,nm);
-    Array<double> actfibforcealongten(nan,nm), passfibforcealongten(nan,nm);
+    double *force = _scratch.allocate(nm,nan);
+    double *fibforce = _scratch.allocate(nm,nan);
+    double *actfibforce = _scratch.allocate(nm,nan);
+    double *passfibforce = _scratch.allocate(nm,nan);
+    double *actfibforcealongten = _scratch.allocate(nm,nan);
+    double *passfibforcealongten = _scratch.allocate(nm,nan);
 
     // Muscle and component powers
-    Array<double> fibActivePower(nan,nm), fibPassivePower(nan,nm),
-                  tendonPower(nan,nm), muscPower(nan,nm);
+    double *fibActivePower = _scratch.allocate(nm,nan);
+    double *fibPassivePower = _scratch.allocate(nm,nan);
+    double *tendonPower = _scratch.allocate(nm,nan);
+    double *muscPower = _scratch.allocate(nm,nan);
 
     double sysMass = _model->getMatterSubsystem().calcSystemMass(s);
     bool hasMass = sysMass > SimTK::Eps;
@@ -616,41 +625,34 @@ int MuscleAnalysis::record(const SimTK::State& s)
     }
 
     // APPEND TO STORAGE
-    _pennationAngleStore->append(tReal,penang.getSize(),&penang[0]);
-    _lengthStore->append(tReal,len.getSize(),&len[0]);
-    _fiberLengthStore->append(tReal,fiblen.getSize(),&fiblen[0]);
-    _normalizedFiberLengthStore
-        ->append(tReal,normfiblen.getSize(),&normfiblen[0]);
-    _tendonLengthStore->append(tReal,tlen.getSize(),&tlen[0]);
-
-    _fiberVelocityStore->append(tReal,fibVel.getSize(),&fibVel[0]);
-    _normFiberVelocityStore->append(tReal,normFibVel.getSize(),&normFibVel[0]);
-    _pennationAngularVelocityStore
-        ->append(tReal,penAngVel.getSize(),&penAngVel[0]);
-
-    _forceStore->append(tReal,force.getSize(),&force[0]);
-    _fiberForceStore->append(tReal,fibforce.getSize(),&fibforce[0]);
-    _activeFiberForceStore->append(tReal,actfibforce.getSize(),&actfibforce[0]);
-    _passiveFiberForceStore
-        ->append(tReal,passfibforce.getSize(),&passfibforce[0]);
-    _activeFiberForceAlongTendonStore
-        ->append(tReal,actfibforcealongten.getSize(),&actfibforcealongten[0]);
-    _passiveFiberForceAlongTendonStore
-        ->append(tReal,passfibforcealongten.getSize(),&passfibforcealongten[0]);
-
-    _fiberActivePowerStore
-        ->append(tReal,fibActivePower.getSize(),&fibActivePower[0]);
-    _fiberPassivePowerStore
-        ->append(tReal,fibPassivePower.getSize(),&fibPassivePower[0]);
-    _tendonPowerStore->append(tReal,tendonPower.getSize(),&tendonPower[0]);
-    _musclePowerStore->append(tReal,muscPower.getSize(),&muscPower[0]);
+    _pennationAngleStore->append(tReal,nm,penang);
+    _lengthStore->append(tReal,nm,len);
+    _fiberLengthStore->append(tReal,nm,fiblen);
+    _normalizedFiberLengthStore->append(tReal,nm,normfiblen);
+    _tendonLengthStore->append(tReal,nm,tlen);
+
+    _fiberVelocityStore->append(tReal,nm,fibVel);
+    _normFiberVelocityStore->append(tReal,nm,normFibVel);
+    _pennationAngularVelocityStore->append(tReal,nm,penAngVel);
+
+    _forceStore->append(tReal,nm,force);
+    _fiberForceStore->append(tReal,nm,fibforce);
+    _activeFiberForceStore->append(tReal,nm,actfibforce);
+    _passiveFiberForceStore->append(tReal,nm,passfibforce);
+    _activeFiberForceAlongTendonStore->append(tReal,nm,actfibforcealongten);
+    _passiveFiberForceAlongTendonStore->append(tReal,nm,passfibforcealongten);
+
+    _fiberActivePowerStore->append(tReal,nm,fibActivePower);
+    _fiberPassivePowerStore->append(tReal,nm,fibPassivePower);
+    _tendonPowerStore->append(tReal,nm,tendonPower);
+    _musclePowerStore->append(tReal,nm,muscPower);
 
     if (_computeMoments){
         // LOOP OVER ACTIVE MOMENT ARM STORAGE OBJECTS
         Coordinate *q = NULL;
         Storage *maStore=NULL, *mStore=NULL;
         int nq = _momentArmStorageArray.getSize();
-        Array<double> ma(0.0,nm),m(0.0,nm);
+        double *ma = _scratch.allocate(nm), *m = _scratch.allocate(nm);
 
         for(int i=0; i<nq; i++) {
 
@@ -666,8 +668,8 @@ int MuscleAnalysis::record(const SimTK::State& s)
                 ma[j] = _muscleArray[j]->computeMomentArm(s,*q);
                 m[j] = ma[j] * force[j];
             }
-            maStore->append(s.getTime(),nm,&ma[0]);
-            mStore->append(s.getTime(),nm,&m[0]);
+            maStore->append(s.getTime(),nm,ma);
+            mStore->append(s.getTime(),nm,m);
         }
     }
     return 0;
@@ -692,6 +694,8 @@ int MuscleAnalysis::begin(SimTK::State& s )
     if(!proceed()) return 0;
 
     allocateStorageObjects();
+    // WORK ARRAYS used by record(): 18 per muscle, plus 2 for moments
+    _scratch.reserve(20*_muscleArray.getSize());
 
     // RESET STORAGE
     Storage *store;
@@ -0,0 +1,436 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  OutputReporter.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <OpenSim/Common/ComponentOutput.h>
+#include <OpenSim/Simulation/Model/Model.h>
+#include "OutputReporter.h"
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// CONSTRUCTOR(S) AND DESTRUCTOR
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Destructor.
+ */
+OutputReporter::~OutputReporter()
+{
+}
+//_____________________________________________________________________________
+/**
+ * Construct an OutputReporter for recording the Outputs of a model's
+ * components during a simulation.
+ *
+ * @param aModel Model whose Outputs are to be recorded.
+ */
+OutputReporter::OutputReporter(Model *aModel) : Analysis(aModel),
+    _outputPaths(_outputPathsProp.getValueStrArray()),
+    _writeBinary(_writeBinaryProp.getValueBool())
+{
+    setNull();
+}
+//_____________________________________________________________________________
+/**
+ * Construct an object from file.
+ *
+ * @param aFileName File name of the document.
+ */
+OutputReporter::OutputReporter(const std::string &aFileName) :
+    Analysis(aFileName, false),
+    _outputPaths(_outputPathsProp.getValueStrArray()),
+    _writeBinary(_writeBinaryProp.getValueBool())
+{
+    setNull();
+
+    // Serialize from XML
+    updateFromXMLDocument();
+}
+//_____________________________________________________________________________
+/**
+ * Copy constructor.
+ */
+OutputReporter::OutputReporter(const OutputReporter &aReporter) :
+    Analysis(aReporter),
+    _outputPaths(_outputPathsProp.getValueStrArray()),
+    _writeBinary(_writeBinaryProp.getValueBool())
+{
+    setNull();
+    *this = aReporter;
+}
+
+
+//=============================================================================
+// CONSTRUCTION METHODS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Set NULL values for all member variables.
+ */
+void OutputReporter::setNull()
+{
+    setName("OutputReporter");
+    _stage = SimTK::Stage::Time;
+    _capacity = 0;
+
+    setupProperties();
+    _outputPaths.setSize(0);
+    _writeBinary = false;
+}
+//_____________________________________________________________________________
+/**
+ * Set up the properties.
+ */
+void OutputReporter::setupProperties()
+{
+    _outputPathsProp.setComment("Paths of the component Outputs to record, "
+        "e.g. r_elbow_flex/value or BIClong/fiber_force.");
+    _outputPathsProp.setName("output_paths");
+    _propertySet.append(&_outputPathsProp);
+
+    _writeBinaryProp.setComment("Flag indicating whether to print the "
+        "results in a binary file (.bin) instead of a storage file.");
+    _writeBinaryProp.setName("write_binary");
+    _propertySet.append(&_writeBinaryProp);
+}
+
+//--------------------------------------------------------------------------
+// OPERATORS
+//--------------------------------------------------------------------------
+OutputReporter& OutputReporter::operator=(const OutputReporter &aReporter)
+{
+    // BASE CLASS
+    Analysis::operator=(aReporter);
+
+    _outputPaths = aReporter._outputPaths;
+    _writeBinary = aReporter._writeBinary;
+    _capacity = aReporter._capacity;
+
+    // Outputs are looked up again in begin(), for this reporter's model.
+    _channels.clear();
+    _columnLabels.clear();
+    _times.clear();
+    _columns.clear();
+
+    return(*this);
+}
+//_____________________________________________________________________________
+/**
+ * Allocate the buffers for a number of rows.
+ */
+void OutputReporter::reserve(int numRows)
+{
+    _capacity = numRows;
+    _times.reserve(numRows);
+    for (auto& column : _columns)
+        column.reserve(numRows);
+}
+
+//_____________________________________________________________________________
+/**
+ * Look up the Outputs in the model and lay out their columns.
+ */
+void OutputReporter::connectToOutputs(const SimTK::State& s)
+{
+    _channels.clear();
+    _columnLabels.clear();
+    _stage = SimTK::Stage::Time;
+
+    int column = 0;
+    for (int i = 0; i < _outputPaths.getSize(); ++i) {
+        const string& path = _outputPaths[i];
+        const AbstractOutput& output = _model->getOutput(path);
+        Channel channel = {&output, ScalarOutput, column, 1};
+        if (dynamic_cast<const Output<double>*>(&output)) {
+            _columnLabels.push_back(path);
+        }
+        else if (dynamic_cast<const Output<SimTK::Vec3>*>(&output)) {
+            channel.type = Vec3Output;
+            channel.width = 3;
+            for (const char* suffix : {"_x", "_y", "_z"})
+                _columnLabels.push_back(path + suffix);
+        }
+        else if (dynamic_cast<const Output<SimTK::SpatialVec>*>(&output)) {
+            channel.type = SpatialVecOutput;
+            channel.width = 6;
+            for (const char* suffix : {"_rx", "_ry", "_rz", "_tx", "_ty", "_tz"})
+                _columnLabels.push_back(path + suffix);
+        }
+        else if (auto vectorOutput =
+                dynamic_cast<const Output<SimTK::Vector>*>(&output)) {
+            // The number of columns is the size of the Vector now.
+            _model->getMultibodySystem().realize(s,
+                                                 output.getDependsOnStage());
+            channel.type = VectorOutput;
+            channel.width = vectorOutput->getValue(s).size();
+            for (int j = 0; j < channel.width; ++j)
+                _columnLabels.push_back(path + "_" + to_string(j));
+        }
+        else {
+            throw Exception("OutputReporter: Output '" + path + "' is of type "
+                + output.getTypeName() + ", which cannot be recorded.",
+                __FILE__, __LINE__);
+        }
+        if (output.getDependsOnStage() > _stage)
+            _stage = output.getDependsOnStage();
+        _channels.push_back(channel);
+        column += channel.width;
+    }
+
+    _columns.resize(column);
+    reserve(_capacity);
+}
+
+//_____________________________________________________________________________
+/**
+ * Replace the contents of a Storage with the recorded values.
+ */
+void OutputReporter::exportToStorage(Storage &rStorage) const
+{
+    Array<string> labels("", 0, int(_columnLabels.size()) + 1);
+    labels.append("time");
+    for (const string& label : _columnLabels)
+        labels.append(label);
+
+    rStorage.purge();
+    rStorage.setName(getName());
+    rStorage.setInDegrees(false);
+    rStorage.setColumnLabels(labels);
+
+    const int nc = getNumColumns();
+    SimTK::Vector row(nc);
+    for (int i = 0; i < getNumRows(); ++i) {
+        for (int j = 0; j < nc; ++j)
+            row[j] = _columns[j][i];
+        rStorage.append(_times[i], row, false);
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Write the recorded values in binary.
+ */
+void OutputReporter::printBinary(const std::string &aFileName) const
+{
+    ofstream out(aFileName.c_str(), ios::binary);
+    if (!out)
+        throw Exception("OutputReporter: Could not open " + aFileName + ".",
+                        __FILE__, __LINE__);
+
+    const int32_t nRows = getNumRows(), nCols = getNumColumns() + 1;
+    out.write("OSIMOUT1", 8);
+    out.write((const char*)&nRows, sizeof(nRows));
+    out.write((const char*)&nCols, sizeof(nCols));
+    auto writeLabel = [&out](const string& label) {
+        const int32_t length = int32_t(label.size());
+        out.write((const char*)&length, sizeof(length));
+        out.write(label.data(), length);
+    };
+    writeLabel("time");
+    for (const string& label : _columnLabels)
+        writeLabel(label);
+
+    out.write((const char*)_times.data(), nRows*sizeof(double));
+    for (const auto& column : _columns)
+        out.write((const char*)column.data(), nRows*sizeof(double));
+
+    if (!out)
+        throw Exception("OutputReporter: Could not write " + aFileName + ".",
+                        __FILE__, __LINE__);
+}
+
+//=============================================================================
+// ANALYSIS
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Record the values of the Outputs.
+ */
+int OutputReporter::record(const SimTK::State& s)
+{
+    if(_model==NULL) return(-1);
+
+    _model->getMultibodySystem().realize(s, _stage);
+
+    // A second record at the same time (e.g., begin() and then step 0)
+    // replaces the previous values, as in a Storage.
+    const double t = s.getTime();
+    if (_times.empty() || _times.back() != t) {
+        _times.push_back(t);
+        for (auto& column : _columns)
+            column.push_back(SimTK::NaN);
+    }
+    const int row = getNumRows() - 1;
+
+    for (const Channel& channel : _channels) {
+        switch (channel.type) {
+        case ScalarOutput:
+            _columns[channel.column][row] =
+                static_cast<const Output<double>*>(channel.output)
+                    ->getValue(s);
+            break;
+        case Vec3Output: {
+            const SimTK::Vec3& v =
+                static_cast<const Output<SimTK::Vec3>*>(channel.output)
+                    ->getValue(s);
+            for (int j = 0; j < 3; ++j)
+                _columns[channel.column + j][row] = v[j];
+            break;
+        }
+        case SpatialVecOutput: {
+            const SimTK::SpatialVec& v =
+                static_cast<const Output<SimTK::SpatialVec>*>(channel.output)
+                    ->getValue(s);
+            for (int j = 0; j < 3; ++j) {
+                _columns[channel.column + j][row] = v[0][j];
+                _columns[channel.column + 3 + j][row] = v[1][j];
+            }
+            break;
+        }
+        case VectorOutput: {
+            const SimTK::Vector& v =
+                static_cast<const Output<SimTK::Vector>*>(channel.output)
+                    ->getValue(s);
+            if (v.size() != channel.width)
+                throw Exception("OutputReporter: Output '"
+                    + channel.output->getName() + "' changed size from "
+                    + to_string(channel.width) + " to "
+                    + to_string(v.size()) + ".", __FILE__, __LINE__);
+            for (int j = 0; j < channel.width; ++j)
+                _columns[channel.column + j][row] = v[j];
+            break;
+        }
+        }
+    }
+
+    return(0);
+}
+//_____________________________________________________________________________
+/**
+ * This method is called at the beginning of an analysis so that any
+ * necessary initializations may be performed.
+ *
+ * @param s System state
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+begin(SimTK::State& s)
+{
+    if(!proceed()) return(0);
+
+    connectToOutputs(s);
+
+    // RESET THE BUFFERS, KEEPING THEIR MEMORY
+    _times.clear();
+    for (auto& column : _columns)
+        column.clear();
+
+    return(record(s));
+}
+//_____________________________________________________________________________
+/**
+ * This method is called to perform the analysis.
+ *
+ * @param s System state
+ * @param stepNumber Step number of the integration.
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+step(const SimTK::State& s, int stepNumber)
+{
+    if(!proceed(stepNumber)) return(0);
+
+    record(s);
+
+    return(0);
+}
+//_____________________________________________________________________________
+/**
+ * This method is called at the end of an analysis so that any
+ * necessary finalizations may be performed.
+ *
+ * @param s System state
+ *
+ * @return -1 on error, 0 otherwise.
+ */
+int OutputReporter::
+end(SimTK::State& s)
+{
+    if (!proceed()) return 0;
+
+    record(s);
+
+    return(0);
+}
+
+
+//=============================================================================
+// IO
+//=============================================================================
+//_____________________________________________________________________________
+/**
+ * Print results.
+ *
+ * The file name is constructed as
+ * aDir + "/" + aBaseName + "_" + ComponentName + "_outputs" + aExtension,
+ * where the extension is ".bin" if write_binary is set.
+ *
+ * @param aDir Directory in which the results reside.
+ * @param aBaseName Base file name.
+ * @param aDT Desired time interval between adjacent storage vectors.  Linear
+ * interpolation is used to print the data out at the desired interval.
+ * Not used for binary files.
+ * @param aExtension File extension.
+ *
+ * @return 0 on success, -1 on error.
+ */
+int OutputReporter::
+printResults(const string &aBaseName,const string &aDir,double aDT,
+                 const string &aExtension)
+{
+    if(!getOn()) {
+        printf("OutputReporter.printResults: Off- not printing.\n");
+        return(0);
+    }
+
+    std::string name = aBaseName + "_" + getName() + "_outputs";
+    if (_writeBinary) {
+        printBinary(((aDir=="") ? "." : aDir) + "/" + name + ".bin");
+    }
+    else {
+        Storage storage(getNumRows() + 1);
+        exportToStorage(storage);
+        Storage::printResult(&storage, name, aDir, aDT, aExtension);
+    }
+
+    return(0);
+}
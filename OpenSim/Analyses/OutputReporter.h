@@ -0,0 +1,189 @@
+#ifndef OPENSIM_OUTPUT_REPORTER_H_
+#define OPENSIM_OUTPUT_REPORTER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  OutputReporter.h                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include <string>
+#include <vector>
+#include <OpenSim/Common/PropertyBool.h>
+#include <OpenSim/Common/PropertyStrArray.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Simulation/Model/Analysis.h>
+#include "osimAnalysesDLL.h"
+
+#ifdef SWIG
+    #ifdef OSIMANALYSES_API
+        #undef OSIMANALYSES_API
+        #define OSIMANALYSES_API
+    #endif
+#endif
+//=============================================================================
+//=============================================================================
+namespace OpenSim {
+
+class AbstractOutput;
+
+/**
+ * A class for recording component Outputs during a simulation.
+ *
+ * The Outputs are named by their path in the model, for example
+ * "r_elbow_flex/value" or "BIClong/fiber_force"; Outputs of the model itself
+ * are named by the Output name alone, e.g. "com_position". Outputs of type
+ * double, SimTK::Vec3, SimTK::SpatialVec and SimTK::Vector are supported and
+ * take 1, 3, 6 and (the size of the Vector) columns.
+ *
+ * Values are copied straight from the Outputs into one contiguous buffer per
+ * column, without the string formatting of
+ * AbstractOutput::getValueAsString() or a Storage row per time, so many
+ * Outputs can be recorded at every integration step. Use reserve() to
+ * allocate the buffers for the expected number of rows up front.
+ *
+ * The results are printed as a Storage file or, if write_binary is set, in
+ * a binary file with the extension ".bin" that holds:
+ * - the 8 characters "OSIMOUT1";
+ * - the number of rows and the number of columns (including time), as
+ *   32-bit integers;
+ * - for each column, the length of its label as a 32-bit integer followed
+ *   by the characters of the label;
+ * - the columns one after the other, time first, as doubles.
+ *
+ * Numbers are written in the byte order of the machine that wrote the file.
+ */
+class OSIMANALYSES_API OutputReporter : public Analysis {
+OpenSim_DECLARE_CONCRETE_OBJECT(OutputReporter, Analysis);
+
+//=============================================================================
+// DATA
+//=============================================================================
+protected:
+    /** Paths of the Outputs to record. */
+    PropertyStrArray _outputPathsProp;
+    Array<std::string> &_outputPaths;
+
+    /** Print results in the binary format rather than as a Storage file. */
+    PropertyBool _writeBinaryProp;
+    bool &_writeBinary;
+
+private:
+    enum OutputType { ScalarOutput, Vec3Output, SpatialVecOutput,
+                      VectorOutput };
+    struct Channel {
+        const AbstractOutput* output;
+        OutputType type;
+        int column;
+        int width;
+    };
+    std::vector<Channel> _channels;
+    SimTK::Stage _stage;
+    std::vector<std::string> _columnLabels;
+    std::vector<double> _times;
+    std::vector<std::vector<double> > _columns;
+    int _capacity;
+
+//=============================================================================
+// METHODS
+//=============================================================================
+public:
+    OutputReporter(Model *aModel=0);
+    OutputReporter(const std::string &aFileName);
+    // Copy constructor and virtual copy
+    OutputReporter(const OutputReporter &aObject);
+    virtual ~OutputReporter();
+
+private:
+    void setNull();
+    void setupProperties();
+    void connectToOutputs(const SimTK::State& s);
+
+public:
+    //--------------------------------------------------------------------------
+    // OPERATORS
+    //--------------------------------------------------------------------------
+#ifndef SWIG
+    OutputReporter& operator=(const OutputReporter &aReporter);
+#endif
+    //--------------------------------------------------------------------------
+    // GET AND SET
+    //--------------------------------------------------------------------------
+    /** Add an Output, by its path in the model, to those recorded. */
+    void addToReport(const std::string& outputPath)
+    {   _outputPaths.append(outputPath); }
+    const Array<std::string>& getOutputPaths() const { return _outputPaths; }
+
+    void setWriteBinary(bool aTrueFalse) { _writeBinary = aTrueFalse; }
+    bool getWriteBinary() const { return _writeBinary; }
+
+    /** Allocate the column buffers for numRows rows, so that recording that
+    many rows does not allocate memory. */
+    void reserve(int numRows);
+
+    /** Recorded times and values. Columns are available after begin(), and
+    their labels are the Output paths, with suffixes "_x", "_y", "_z" for
+    Vec3 Outputs, "_rx" ... "_tz" for SpatialVec Outputs and "_0", "_1", ...
+    for Vector Outputs. */
+    int getNumRows() const { return int(_times.size()); }
+    int getNumColumns() const { return int(_columns.size()); }
+    const std::vector<double>& getTimes() const { return _times; }
+    const std::vector<double>& getColumn(int aIndex) const
+    {   return _columns.at(aIndex); }
+    const std::vector<std::string>& getColumnLabels() const
+    {   return _columnLabels; }
+
+    /** Replace the contents of a Storage with the recorded values. */
+    void exportToStorage(Storage &rStorage) const;
+    /** Write the recorded values in the binary format described above. */
+    void printBinary(const std::string &aFileName) const;
+
+    //--------------------------------------------------------------------------
+    // ANALYSIS
+    //--------------------------------------------------------------------------
+    int
+        begin(SimTK::State& s ) override;
+    int
+        step(const SimTK::State& s, int setNumber ) override;
+    int
+        end(SimTK::State& s ) override;
+protected:
+    virtual int
+        record(const SimTK::State& s );
+
+    //--------------------------------------------------------------------------
+    // IO
+    //--------------------------------------------------------------------------
+public:
+    int
+        printResults(const std::string &aBaseName,const std::string &aDir="",
+        double aDT=-1.0,const std::string &aExtension=".sto") override;
+
+//=============================================================================
+};  // END of class OutputReporter
+
+}; //namespace
+//=============================================================================
+//=============================================================================
+
+
+#endif // OPENSIM_OUTPUT_REPORTER_H_
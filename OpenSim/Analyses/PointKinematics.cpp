@@ -29,6 +29,7 @@
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/BodySet.h>
 #include "PointKinematics.h"
+#include "KinematicsExtractor.h"
 
 
 using namespace OpenSim;
@@ -522,37 +523,27 @@ setStorageCapacityIncrements(int aIncrement)
 int PointKinematics::
 record(const SimTK::State& s)
 {
-    const SimbodyEngine& de = _model->getSimbodyEngine();
-
-    // VARIABLES
-    SimTK::Vec3 vec;
+    if(!KinematicsExtractor::isShared(_extractor, *_model)) {
+        // Let go of the extractor of a previous model first.
+        _extractor.reset();
+        _extractor = KinematicsExtractor::getShared(*_model);
+        _extractor->requireAccelerations();
+    }
+    // The body and point can be changed at any time; the request for the
+    // same point is found again rather than added.
+    int slot = _extractor->addPoint(*_body, _point, _relativeToBody);
+    _extractor->update(s);
 
     const double& time = s.getTime();
 
     // POSITION
-    de.getPosition(s, *_body,_point,vec);
-    if(_relativeToBody){
-        de.transformPosition(s, _model->getGround(), vec, *_relativeToBody, vec);
-    }
-
-    _pStore->append(time, vec);
+    _pStore->append(time, _extractor->getPointPosition(slot));
 
     // VELOCITY
-    de.getVelocity(s, *_body,_point,vec);
-    if(_relativeToBody){
-        de.transform(s, _model->getGround(), vec, *_relativeToBody, vec);
-    }
-
-    _vStore->append(time, vec);
+    _vStore->append(time, _extractor->getPointVelocity(slot));
 
     // ACCELERATIONS
-    _model->getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
-    de.getAcceleration(s, *_body,_point,vec);
-    if(_relativeToBody){
-        de.transform(s, _model->getGround(), vec, *_relativeToBody, vec);
-    }
-
-    _aStore->append(time, vec);
+    _aStore->append(time, _extractor->getPointAcceleration(slot));
 
     return(0);
 }
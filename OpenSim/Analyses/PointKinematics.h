@@ -40,6 +40,7 @@
 #include <OpenSim/Common/PropertyDblArray.h>
 #include <OpenSim/Common/PropertyDblVec.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
+#include <memory>
 
 const int PointKinematicsNAME_LENGTH = 256;
 const int PointKinematicsBUFFER_LENGTH = 2048;
@@ -50,11 +51,15 @@ namespace OpenSim {
 
 class Model;
 class Body;
+class KinematicsExtractor;
 
 /**
  * A class for recording the kinematics of a point on a body
  * of a model during a simulation.
  *
+ * The values are read from the KinematicsExtractor the model's kinematics
+ * analyses share, so a state is realized and swept once for all of them.
+ *
  * @author Frank C. Anderson
  * @version 1.0
  */
@@ -87,6 +92,7 @@ protected:
 
     double *_dy;
     double *_kin;
+    std::shared_ptr<KinematicsExtractor> _extractor;
     Storage *_pStore;
     Storage *_vStore;
     Storage *_aStore;
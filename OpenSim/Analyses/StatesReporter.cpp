@@ -29,6 +29,7 @@
 #include <string>
 #include <OpenSim/Simulation/Model/Model.h>
 #include "StatesReporter.h"
+#include "KinematicsExtractor.h"
 
 using namespace OpenSim;
 using namespace std;
@@ -203,9 +204,15 @@ record(const SimTK::State& s)
     if(_model==NULL) return(-1);
 
     // MAKE SURE ALL StatesReporter QUANTITIES ARE VALID
-    _model->getMultibodySystem().realize(s, SimTK::Stage::Velocity );
+    if(!KinematicsExtractor::isShared(_extractor, *_model)) {
+        // Let go of the extractor of a previous model first.
+        _extractor.reset();
+        _extractor = KinematicsExtractor::getShared(*_model);
+        _extractor->addStateVariableValues();
+    }
+    _extractor->update(s);
 
-    SimTK::Vector stateValues = _model->getStateVariableValues(s);
+    const SimTK::Vector& stateValues = _extractor->getStateVariableValues();
     StateVector nextRow(s.getTime(), stateValues.size(), &stateValues[0]);
     _statesStore.append(nextRow);
 
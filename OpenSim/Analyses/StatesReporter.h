@@ -31,6 +31,7 @@
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include "osimAnalysesDLL.h"
 #include "SimTKsimbody.h"
+#include <memory>
 
 
 #ifdef SWIG
@@ -43,10 +44,15 @@
 //=============================================================================
 namespace OpenSim { 
 
+class KinematicsExtractor;
+
 /**
  * A class for recording the states of a model
  * during a simulation.
  *
+ * The values are read from the KinematicsExtractor the model's kinematics
+ * analyses share, so a state is realized and swept once for all of them.
+ *
  * @author Ayman Habib
  * @version 1.0
  */
@@ -62,6 +68,8 @@ protected:
     /** States storage. */
     Storage _statesStore;
 
+    std::shared_ptr<KinematicsExtractor> _extractor;
+
 //=============================================================================
 // METHODS
 //=============================================================================
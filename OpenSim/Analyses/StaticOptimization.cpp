@@ -70,6 +70,7 @@ StaticOptimization::StaticOptimization(Model *aModel) :
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _modelWorkingCopy(NULL),
     _numCoordinateActuators(0)
 {
@@ -91,6 +92,7 @@ StaticOptimization::StaticOptimization(const StaticOptimization &aStaticOptimiza
     _useMusclePhysiology(_useMusclePhysiologyProp.getValueBool()),
     _convergenceCriterion(_convergenceCriterionProp.getValueDbl()),
     _maximumIterations(_maximumIterationsProp.getValueInt()),
+    _optimizerAlgorithm(_optimizerAlgorithmProp.getValueStr()),
     _modelWorkingCopy(NULL),
     _numCoordinateActuators(aStaticOptimization._numCoordinateActuators)
 {
@@ -124,6 +126,7 @@ operator=(const StaticOptimization &aStaticOptimization)
     _activationExponent=aStaticOptimization._activationExponent;
     _convergenceCriterion=aStaticOptimization._convergenceCriterion;
     _maximumIterations=aStaticOptimization._maximumIterations;
+    _optimizerAlgorithm=aStaticOptimization._optimizerAlgorithm;
     _forceReporter = nullptr;
     _useMusclePhysiology=aStaticOptimization._useMusclePhysiology;
     return(*this);
@@ -148,6 +151,7 @@ void StaticOptimization::setNull()
     _numCoordinateActuators = 0;
     _convergenceCriterion = 1e-4;
     _maximumIterations = 100;
+    _optimizerAlgorithm = "ipopt";
     _forceReporter = nullptr;
     setName("StaticOptimization");
 }
@@ -183,6 +187,13 @@ setupProperties()
         "An integer for setting the maximum number of iterations the optimizer can use at each time.  ");
     _maximumIterationsProp.setName("optimizer_max_iterations");
     _propertySet.append(&_maximumIterationsProp);
+
+    _optimizerAlgorithmProp.setComment(
+        "Optimizer algorithm: \"ipopt\" or \"activeset\". \"activeset\" solves each "
+        "time directly as a quadratic program when activation_exponent is 2, "
+        "and falls back to \"ipopt\" when that fails.");
+    _optimizerAlgorithmProp.setName("optimizer_algorithm");
+    _propertySet.append(&_optimizerAlgorithmProp);
 }
 
 //=============================================================================
@@ -335,7 +346,6 @@ record(const SimTK::State& s)
 
     // IPOPT
     _numericalDerivativeStepSize = 0.0001;
-    _optimizerAlgorithm = "ipopt";
     _printLevel = 0;
     //_optimizationConvergenceTolerance = 1e-004;
     //_maxIterations = 2000;
@@ -347,6 +357,11 @@ record(const SimTK::State& s)
     target.setStatesSplineSet(_statesSplineSet);
     target.setActivationExponent(_activationExponent);
     target.setDX(_numericalDerivativeStepSize);
+    if(IO::Uppercase(_optimizerAlgorithm) == "ACTIVESET") {
+        target.setUseActiveSetQP(true);
+    } else if(IO::Uppercase(_optimizerAlgorithm) != "IPOPT") {
+        throw Exception("StaticOptimization: ERROR- Unrecognized optimizer algorithm: '"+_optimizerAlgorithm+"'",__FILE__,__LINE__);
+    }
 
     // Pick optimizer algorithm
     SimTK::OptimizerAlgorithm algorithm = SimTK::InteriorPoint;
@@ -389,7 +404,7 @@ record(const SimTK::State& s)
 
     // Static optimization
     _modelWorkingCopy->getMultibodySystem().realize(sWorkingCopy,SimTK::Stage::Velocity);
-    target.prepareToOptimize(sWorkingCopy, &_parameters[0]);
+    bool directSolution = target.prepareToOptimize(sWorkingCopy, &_parameters[0]);
 
     //LARGE_INTEGER start;
     //LARGE_INTEGER stop;
@@ -400,7 +415,7 @@ record(const SimTK::State& s)
 
     try {
         target.setCurrentState( &sWorkingCopy );
-        optimizer->optimize(_parameters);
+        if(!directSolution) optimizer->optimize(_parameters);
     }
     catch (const SimTK::Exception::Base& ex) {
         cout << ex.getMessage() << endl;
@@ -32,6 +32,7 @@
 #include <OpenSim/Common/PropertyBool.h>
 #include <OpenSim/Common/PropertyDbl.h>
 #include <OpenSim/Common/PropertyInt.h>
+#include <OpenSim/Common/PropertyStr.h>
 #include <OpenSim/Simulation/Model/Analysis.h>
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <SimTKcommon.h>
@@ -80,6 +81,9 @@ protected:
     PropertyInt _maximumIterationsProp;
     int &_maximumIterations;
 
+    PropertyStr _optimizerAlgorithmProp;
+    std::string &_optimizerAlgorithm;
+
     Storage *_activationStorage;
     Storage *_forceStorage;
     GCVSplineSet _statesSplineSet;
@@ -92,7 +96,6 @@ protected:
     ForceSet* _forceSet;
 
     double _numericalDerivativeStepSize;
-    std::string _optimizerAlgorithm;
     int _printLevel;
 
     Model *_modelWorkingCopy;
@@ -139,6 +142,11 @@ public:
     double getConvergenceCriterion() { return _convergenceCriterion; }
     void setMaxIterations( const int maxIt) { _maximumIterations = maxIt; }
     int getMaxIterations() {return _maximumIterations; }
+    /** "ipopt" (default) or "activeset". With "activeset" and an activation
+    exponent of 2, each frame is solved as a quadratic program, falling back
+    to IPOPT for frames where that fails. **/
+    void setOptimizerAlgorithm(const std::string& algorithm) { _optimizerAlgorithm = algorithm; }
+    const std::string& getOptimizerAlgorithm() const { return _optimizerAlgorithm; }
     //--------------------------------------------------------------------------
     // ANALYSIS
     //--------------------------------------------------------------------------
@@ -36,6 +36,7 @@
 #include <OpenSim/Simulation/Model/ForceSet.h>
 #include <OpenSim/Simulation/SimbodyEngine/Coordinate.h>
 #include "StaticOptimizationTarget.h"
+#include <OpenSim/Common/ActiveSetQP.h>
 #include <iostream>
 
 using namespace OpenSim;
@@ -72,6 +73,7 @@ StaticOptimizationTarget(const SimTK::State& s, Model *aModel,int aNP,int aNC, b
     _recipOptForceSquared.setSize(aNP);
     _optimalForce.setSize(aNP);
     _useMusclePhysiology=useMusclePhysiology;
+    _useActiveSetQP = false;
 
     setModel(*aModel);
     setNumParams(aNP);
@@ -142,6 +144,20 @@ prepareToOptimize(SimTK::State& s, double *x)
         for(int c=0; c<nc; c++) _constraintMatrix(c,p) = (cVector[c] - _constraintVector[c]);
         pVector[p] = 0;
     }
+
+    // With an exponent of 2 the objective is quadratic and, the constraints
+    // being linear, the problem can be solved directly.
+    if(_useActiveSetQP && _activationExponent == 2.0 && getHasLimits()) {
+        double *lower, *upper;
+        getParameterLimits(&lower, &upper);
+        Vector solution(np);
+        if(ActiveSetQP().solve(_constraintMatrix, -_constraintVector,
+                Vector(np, 1.0), Vector(np, lower, true),
+                Vector(np, upper, true), solution)) {
+            for(int p=0; p<np; p++) x[p] = solution[p];
+            return true;
+        }
+    }
 #endif
 
     // return false to indicate that we still need to proceed with optimization
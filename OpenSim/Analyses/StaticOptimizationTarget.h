@@ -72,6 +72,7 @@ private:
 protected:
     double _activationExponent;
     bool   _useMusclePhysiology;
+    bool   _useActiveSetQP;
     /** Perturbation size for computing numerical derivatives. */
     Array<double> _dx;
     Array<int> _accelerationIndices;
@@ -95,6 +96,11 @@ public:
     void getActuation(SimTK::State& s, const SimTK::Vector &parameters, SimTK::Vector &forces);
     void setActivationExponent(double aActivationExponent) { _activationExponent=aActivationExponent; }
     double getActivationExponent() const { return _activationExponent; }
+    /** If true and the activation exponent is 2, prepareToOptimize() solves
+    the problem directly as a quadratic program (see ActiveSetQP) and returns
+    true, unless that fails. **/
+    void setUseActiveSetQP(bool useIt) { _useActiveSetQP = useIt; }
+    bool getUseActiveSetQP() const { return _useActiveSetQP; }
     void setCurrentState( const SimTK::State* state) { _currentState = state; }
     const SimTK::State* getCurrentState() const { return _currentState; }
 
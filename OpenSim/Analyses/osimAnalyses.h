@@ -34,6 +34,8 @@
 #include "StatesReporter.h"
 #include "InducedAccelerations.h"
 #include "ProbeReporter.h"
+#include "OutputReporter.h"
+#include "KinematicsExtractor.h"
 #include "RegisterTypes_osimAnalyses.h" // to expose RegisterTypes_Analyses
 
 #endif // _osimAnalyses_h_
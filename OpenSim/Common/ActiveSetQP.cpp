@@ -0,0 +1,186 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ActiveSetQP.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ActiveSetQP.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace OpenSim;
+using SimTK::Matrix;
+using SimTK::Vector;
+
+namespace {
+    enum Bound { Free, AtLower, AtUpper };
+
+    // Factor the symmetric matrix K + shift*I = L*L' in place (lower
+    // triangle). Returns false if it is not positive definite.
+    bool factorCholesky(Matrix& K, double shift)
+    {
+        const int m = K.nrow();
+        for (int j = 0; j < m; ++j) {
+            double d = K(j,j) + shift;
+            for (int k = 0; k < j; ++k) d -= K(j,k)*K(j,k);
+            if (!(d > 0)) return false;
+            K(j,j) = std::sqrt(d);
+            for (int i = j+1; i < m; ++i) {
+                double s = K(i,j);
+                for (int k = 0; k < j; ++k) s -= K(i,k)*K(j,k);
+                K(i,j) = s/K(j,j);
+            }
+        }
+        return true;
+    }
+
+    // Solve L*L'*y = r given the factor from factorCholesky().
+    void solveCholesky(const Matrix& L, const Vector& r, Vector& y)
+    {
+        const int m = L.nrow();
+        y = r;
+        for (int i = 0; i < m; ++i) {
+            for (int k = 0; k < i; ++k) y[i] -= L(i,k)*y[k];
+            y[i] /= L(i,i);
+        }
+        for (int i = m-1; i >= 0; --i) {
+            for (int k = i+1; k < m; ++k) y[i] -= L(k,i)*y[k];
+            y[i] /= L(i,i);
+        }
+    }
+}
+
+bool ActiveSetQP::solve(const Matrix& A, const Vector& b,
+                        const Vector& weights,
+                        const Vector& lower, const Vector& upper,
+                        Vector& x) const
+{
+    const int m = A.nrow(), n = A.ncol();
+    if (b.size() != m || weights.size() != n || lower.size() != n
+            || upper.size() != n)
+        return false;
+    for (int i = 0; i < n; ++i)
+        if (!(weights[i] > 0) || !(lower[i] <= upper[i])) return false;
+
+    // Parameters whose bounds coincide are fixed throughout.
+    std::vector<Bound> bound(n, Free);
+    for (int i = 0; i < n; ++i)
+        if (lower[i] == upper[i]) bound[i] = AtLower;
+
+    Vector solution(n), y(m), r(m);
+    Matrix K(m, m), L(m, m);
+    for (int iteration = 0; iteration < _maxIterations; ++iteration) {
+        // Move the constraint contribution of fixed parameters to the right
+        // hand side, and form K = A_f W_f^-1 A_f' for the free ones.
+        r = b;
+        K.setToZero();
+        for (int i = 0; i < n; ++i) {
+            if (bound[i] == Free) {
+                const double rw = 1.0/weights[i];
+                for (int p = 0; p < m; ++p) {
+                    const double ap = A(p,i)*rw;
+                    if (ap == 0) continue;
+                    for (int q = 0; q <= p; ++q) K(p,q) += ap*A(q,i);
+                }
+            }
+            else {
+                solution[i] = bound[i] == AtLower ? lower[i] : upper[i];
+                for (int p = 0; p < m; ++p) r[p] -= A(p,i)*solution[i];
+            }
+        }
+        // K is rank deficient if the free parameters cannot span the
+        // constraints. Shifting it gives a least squares like step, so that
+        // the iterations can go on to free other parameters.
+        if (m > 0) {
+            L = K;
+            if (!factorCholesky(L, 0)) {
+                double maxDiagonal = 1;
+                for (int p = 0; p < m; ++p)
+                    maxDiagonal = std::max(maxDiagonal, K(p,p));
+                L = K;
+                if (!factorCholesky(L, 1e-12*maxDiagonal)) return false;
+            }
+            solveCholesky(L, r, y);
+        }
+
+        // The free parameters are x_f = W_f^-1 A_f' y, and the multiplier of
+        // a fixed parameter's bound is w_i x_i - a_i' y (sign by bound).
+        // Every parameter on the wrong side of its bound or with a multiplier
+        // of the wrong sign changes set. That can cycle on rare problems, so
+        // after a while only the worst one changes per iteration.
+        const bool changeAll = iteration < _maxIterations/4;
+        bool changed = false;
+        int worst = -1;
+        double worstViolation = 0;
+        for (int i = 0; i < n; ++i) {
+            if (lower[i] == upper[i]) continue;
+            double ay = 0;
+            for (int p = 0; p < m; ++p) ay += A(p,i)*y[p];
+            const double tol = _tolerance*(1 + std::fabs(lower[i])
+                                              + std::fabs(upper[i]));
+            Bound next = bound[i];
+            double violation = 0;
+            if (bound[i] == Free) {
+                solution[i] = ay/weights[i];
+                if (solution[i] < lower[i] - tol) {
+                    next = AtLower;
+                    violation = lower[i] - solution[i];
+                }
+                else if (solution[i] > upper[i] + tol) {
+                    next = AtUpper;
+                    violation = solution[i] - upper[i];
+                }
+            }
+            else {
+                const double multiplier = bound[i] == AtLower
+                    ? weights[i]*lower[i] - ay : ay - weights[i]*upper[i];
+                if (multiplier < -tol*weights[i]) {
+                    next = Free;
+                    violation = -multiplier/weights[i];
+                }
+            }
+            if (next == bound[i]) continue;
+            changed = true;
+            if (changeAll) bound[i] = next;
+            else if (violation > worstViolation) {
+                worst = i;
+                worstViolation = violation;
+            }
+        }
+        if (worst >= 0)
+            bound[worst] = bound[worst] == Free
+                ? (solution[worst] < lower[worst] ? AtLower : AtUpper) : Free;
+
+        if (!changed) {
+            // The constraints are not met if K had to be shifted.
+            for (int p = 0; p < m; ++p) {
+                double residual = -b[p];
+                for (int i = 0; i < n; ++i) residual += A(p,i)*solution[i];
+                if (std::fabs(residual) > 1e-8*(1 + std::fabs(b[p])))
+                    return false;
+            }
+            if (x.size() != n) x.resize(n);
+            for (int i = 0; i < n; ++i)
+                x[i] = std::min(upper[i], std::max(lower[i], solution[i]));
+            return true;
+        }
+    }
+    return false;
+}
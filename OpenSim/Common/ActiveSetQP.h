@@ -0,0 +1,78 @@
+#ifndef OPENSIM_ACTIVE_SET_QP_H_
+#define OPENSIM_ACTIVE_SET_QP_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ActiveSetQP.h                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "SimTKcommon.h"
+
+namespace OpenSim {
+
+/**
+ * Solves the quadratic program
+ *
+ *     minimize    sum_i w_i x_i^2
+ *     subject to  A x = b
+ *                 lower <= x <= upper
+ *
+ * with positive weights w, which is the static optimization problem solved
+ * by StaticOptimization and CMC when the activation exponent is 2.
+ *
+ * The solver uses a primal-dual active set method. Each iteration fixes
+ * some parameters at their bounds and minimizes over the others on the
+ * equality constraints in closed form. That only needs a factorization of
+ * an (m x m) matrix for m constraints. With few constraints and many
+ * parameters (one per actuator), each iteration is far cheaper than an
+ * iteration of a general nonlinear optimizer, and few iterations are needed.
+ *
+ * solve() reports failure rather than trying harder. This happens when the
+ * constraints cannot be met within the bounds, or the iterations do not
+ * settle. Callers fall back to a general optimizer in that case.
+ */
+class OSIMCOMMON_API ActiveSetQP {
+public:
+    ActiveSetQP() : _maxIterations(100), _tolerance(1e-10) {}
+
+    /** The most active set changes to try before giving up. **/
+    void setMaxIterations(int maxIterations)
+    {   _maxIterations = maxIterations; }
+    int getMaxIterations() const { return _maxIterations; }
+
+    /** Relative tolerance for bounds and multipliers. **/
+    void setTolerance(double tolerance) { _tolerance = tolerance; }
+    double getTolerance() const { return _tolerance; }
+
+    /** Solve the problem for \a x. Returns false if no solution was found,
+    in which case \a x is left unchanged. **/
+    bool solve(const SimTK::Matrix& A, const SimTK::Vector& b,
+               const SimTK::Vector& weights,
+               const SimTK::Vector& lower, const SimTK::Vector& upper,
+               SimTK::Vector& x) const;
+
+private:
+    int     _maxIterations;
+    double  _tolerance;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_ACTIVE_SET_QP_H_
@@ -30,6 +30,9 @@
 
 #include "osimCommonDLL.h"
 #include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
 #include "Exception.h"
 
 
@@ -79,6 +82,20 @@ protected:
     /** Array of pointers to objects of type T. */
     T **_array;
 
+private:
+    /** Whether getIndex(name) may use _nameIndex. */
+    bool _useNameIndex;
+    /** Index of the first object with each name, for the first
+    _nameIndexSize objects. Appending leaves the index valid; any other
+    change that moves or replaces objects sets _nameIndexSize to 0, and the
+    index is rebuilt by the next lookup. */
+    mutable std::unordered_map<std::string,int> _nameIndex;
+    mutable int _nameIndexSize;
+    /** Whether two of the indexed objects have the same name. */
+    mutable bool _nameIndexHasDuplicates;
+    /** Guards the index, which is updated by const lookups. */
+    mutable std::mutex _nameIndexMutex;
+
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // METHODS
 //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -144,6 +161,25 @@ void setNull()
     _capacityIncrement = -1;
     _capacity = 0;
     _array = NULL;
+    _useNameIndex = true;
+    _nameIndexSize = 0;
+    _nameIndexHasDuplicates = false;
+}
+//_____________________________________________________________________________
+/**
+ * Bring the name index up to date with the objects in the array.
+ */
+void updateNameIndex() const
+{
+    if(_nameIndexSize==0) {
+        _nameIndex.clear();
+        _nameIndexHasDuplicates = false;
+    }
+    for(;_nameIndexSize<_size;_nameIndexSize++) {
+        if(!_nameIndex.insert(std::make_pair(
+                _array[_nameIndexSize]->getName(),_nameIndexSize)).second)
+            _nameIndexHasDuplicates = true;
+    }
 }
 
 public:
@@ -166,6 +202,7 @@ void clearAndDestroy()
     }
 
     _size = 0;
+    _nameIndexSize = 0;
 }
 
 
@@ -196,6 +233,8 @@ ArrayPtrs<T>& operator=(const ArrayPtrs<T> &aArray)
 
     // COPY MEMBER VARIABLES
     _size = aArray._size;
+    _useNameIndex = aArray._useNameIndex;
+    _nameIndexSize = 0;
     _capacity = aArray._capacity;
     _capacityIncrement = aArray._capacityIncrement;
 
@@ -524,6 +563,7 @@ bool setSize(int aSize)
             }
         }
         _size = aSize;
+        _nameIndexSize = 0;
     }
 
     return(true);
@@ -578,6 +618,17 @@ int getIndex(const T *aObject,int aStartIndex=0) const
 /**
  * Get the index of an object by specifying its name.
  *
+ * Arrays with more than a few objects keep a hash index of the names (see
+ * setUseNameIndex()), so that finding an object does not require comparing
+ * its name with those of all the objects before it. The array is not told
+ * when an object is renamed, so an indexed entry is used only if the object
+ * still has that name, and a name that is not in the index is still
+ * searched for linearly. If an object is found that way the index is
+ * rebuilt by the next lookup. If an object is renamed to the name of
+ * another object in the array, either of the two may be found. The index
+ * is updated under a lock, so an array may be searched from several threads
+ * at once, as long as none of them changes the array or its objects.
+ *
  * @param aName Name of the object whose index is sought.
  * @param aStartIndex Index at which to start searching.  If the object is
  * not found at or following aStartIndex, the array is searched from
@@ -590,18 +641,69 @@ int getIndex(const std::string &aName,int aStartIndex=0) const
     if(aStartIndex<0) aStartIndex=0;
     if(aStartIndex>=getSize()) aStartIndex=0;
 
+    // SEARCH THE NAME INDEX
+    // Below this size a linear search is as fast as hashing the name.
+    const int minSizeToIndex = 16;
+    bool indexed = false;
+    if(_useNameIndex && _size>=minSizeToIndex) {
+        std::lock_guard<std::mutex> lock(_nameIndexMutex);
+        updateNameIndex();
+        // With duplicate names, the first match depends on aStartIndex.
+        if(aStartIndex==0 || !_nameIndexHasDuplicates) {
+            std::unordered_map<std::string,int>::const_iterator found =
+                _nameIndex.find(aName);
+            if(found!=_nameIndex.end() &&
+                    _array[found->second]->getName() == aName)
+                return(found->second);
+            indexed = true;
+        }
+    }
+
     // SEARCH STARTING FROM aStartIndex
     int i;
     for(i=aStartIndex;i<getSize();i++) {
-        if(_array[i]->getName() == aName) return(i);
+        if(_array[i]->getName() == aName) break;
     }
 
     // SEARCH FROM BEGINNING
-    for(i=0;i<aStartIndex;i++) {
-        if(_array[i]->getName() == aName) return(i);
+    if(i==getSize()) {
+        for(i=0;i<aStartIndex;i++) {
+            if(_array[i]->getName() == aName) break;
+        }
+        if(i==aStartIndex) return(-1);
     }
 
-    return(-1);
+    // AN OBJECT WAS RENAMED SINCE IT WAS INDEXED
+    if(indexed) {
+        std::lock_guard<std::mutex> lock(_nameIndexMutex);
+        _nameIndexSize = 0;
+    }
+
+    return(i);
+}
+//_____________________________________________________________________________
+/**
+ * %Set whether getIndex(const std::string&) may use a hash index of the
+ * names of the objects in this array. The index is on by default; turning
+ * it off saves the memory it takes, for large arrays whose objects are
+ * rarely looked up by name.
+ */
+void setUseNameIndex(bool aTrueFalse)
+{
+    _useNameIndex = aTrueFalse;
+    if(!_useNameIndex) {
+        _nameIndex.clear();
+        _nameIndexSize = 0;
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Get whether getIndex(const std::string&) may use a hash index of the
+ * names of the objects in this array.
+ */
+bool getUseNameIndex() const
+{
+    return(_useNameIndex);
 }
 
 //-----------------------------------------------------------------------------
@@ -714,6 +816,7 @@ bool insert(int aIndex,T *aObject)
     // SET
     _array[aIndex] = aObject;
     _size++;
+    if(aIndex<_nameIndexSize) _nameIndexSize = 0;
 
     return(true);
 }
@@ -754,6 +857,7 @@ bool remove(int aIndex)
         _array[i] = _array[i+1];
     }
     _array[_size] = NULL;
+    if(aIndex<_nameIndexSize) _nameIndexSize = 0;
 
     return(true);
 }
@@ -810,6 +914,7 @@ bool set(int aIndex,T *aObject)
     // SET
     if(getMemoryOwner() && (_array[aIndex]!=NULL)) delete _array[aIndex];
     _array[aIndex] = aObject;
+    if(aIndex<_nameIndexSize) _nameIndexSize = 0;
 
     return(true);
 }
@@ -0,0 +1,592 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  C3DFile.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "C3DFile.h"
+#include "Exception.h"
+#include "Logger.h"
+#include "Storage.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+//=============================================================================
+// MAPPED FILE
+//=============================================================================
+// A read-only view of a whole file: a memory mapping where the platform
+// provides one, or else a copy of the file in memory.
+class C3DFile::MappedFile {
+public:
+    explicit MappedFile(const string& fileName)
+    :   data(NULL), size(0), _mapped(NULL)
+    {
+#ifdef _WIN32
+        HANDLE file = CreateFileA(fileName.c_str(), GENERIC_READ,
+            FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file != INVALID_HANDLE_VALUE) {
+            LARGE_INTEGER fileSize;
+            if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+                HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY,
+                                                    0, 0, NULL);
+                if (mapping) {
+                    _mapped = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                    CloseHandle(mapping);
+                    if (_mapped) size = size_t(fileSize.QuadPart);
+                }
+            }
+            CloseHandle(file);
+        }
+#else
+        int fd = open(fileName.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            struct stat status;
+            if (fstat(fd, &status) == 0 && status.st_size > 0) {
+                void* mapped = mmap(NULL, size_t(status.st_size), PROT_READ,
+                                    MAP_PRIVATE, fd, 0);
+                if (mapped != MAP_FAILED) {
+                    _mapped = mapped;
+                    size = size_t(status.st_size);
+                }
+            }
+            close(fd);
+        }
+#endif
+        if (_mapped) {
+            data = static_cast<const unsigned char*>(_mapped);
+            return;
+        }
+        ifstream in(fileName.c_str(), ios::binary);
+        if (!in)
+            throw Exception("C3DFile: could not open file " + fileName + ".",
+                            __FILE__, __LINE__);
+        _buffer.assign(istreambuf_iterator<char>(in),
+                       istreambuf_iterator<char>());
+        data = reinterpret_cast<const unsigned char*>(_buffer.data());
+        size = _buffer.size();
+    }
+
+    ~MappedFile()
+    {
+        if (!_mapped) return;
+#ifdef _WIN32
+        UnmapViewOfFile(_mapped);
+#else
+        munmap(_mapped, size);
+#endif
+    }
+
+    const unsigned char* data;
+    size_t size;
+
+private:
+    void* _mapped;
+    vector<char> _buffer;
+};
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+namespace {
+    string toUpper(string s)
+    {
+        for (size_t i = 0; i < s.size(); ++i)
+            s[i] = char(toupper((unsigned char)s[i]));
+        return s;
+    }
+
+    // Factor converting values in the given units to SI units, e.g. 1e-3
+    // for "mm" or "Nmm"; defaultScale if the units are not recognized.
+    double toSI(const string& units, double defaultScale)
+    {
+        string u;
+        for (size_t i = 0; i < units.size(); ++i)
+            if (isalpha((unsigned char)units[i]))
+                u += char(tolower((unsigned char)units[i]));
+        if (u == "mm" || u == "nmm") return 1e-3;
+        if (u == "cm" || u == "ncm") return 1e-2;
+        if (u == "m" || u == "nm" || u == "n") return 1;
+        return defaultScale;
+    }
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+C3DFile::C3DFile(const string& fileName) :
+    _file(new MappedFile(fileName)),
+    _fileName(fileName),
+    _data(_file->data),
+    _size(_file->size)
+{
+    readHeaderAndParameters();
+    readForcePlates();
+}
+
+C3DFile::~C3DFile()
+{
+}
+
+//=============================================================================
+// DECODING
+//=============================================================================
+void C3DFile::checkRange(size_t offset, size_t size) const
+{
+    if (offset > _size || size > _size - offset)
+        throw Exception("C3DFile: " + _fileName + " is truncated or is not "
+                        "a C3D file.", __FILE__, __LINE__);
+}
+
+int C3DFile::readUInt16(size_t offset) const
+{
+    const unsigned char* b = _data + offset;
+    return _processor == MIPS ? (b[0] << 8) | b[1] : b[0] | (b[1] << 8);
+}
+
+int C3DFile::readInt16(size_t offset) const
+{
+    return int16_t(uint16_t(readUInt16(offset)));
+}
+
+double C3DFile::readFloat(size_t offset) const
+{
+    const unsigned char* b = _data + offset;
+    uint32_t u;
+    if (_processor == MIPS)
+        u = (uint32_t(b[0]) << 24) | (uint32_t(b[1]) << 16) |
+            (uint32_t(b[2]) << 8) | uint32_t(b[3]);
+    else if (_processor == DEC)
+        // VAX F-floating: the two 16-bit halves are swapped and the exponent
+        // is biased by 2 more than in IEEE, hence the division by 4.
+        u = uint32_t(b[2]) | (uint32_t(b[3]) << 8) |
+            (uint32_t(b[0]) << 16) | (uint32_t(b[1]) << 24);
+    else
+        u = uint32_t(b[0]) | (uint32_t(b[1]) << 8) |
+            (uint32_t(b[2]) << 16) | (uint32_t(b[3]) << 24);
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return _processor == DEC ? f/4 : f;
+}
+
+double C3DFile::readWord(size_t offset) const
+{
+    return _isFloat ? readFloat(offset) : readInt16(offset);
+}
+
+//=============================================================================
+// HEADER AND PARAMETERS
+//=============================================================================
+void C3DFile::readHeaderAndParameters()
+{
+    checkRange(0, 512);
+    if (_data[1] != 0x50)
+        throw Exception("C3DFile: " + _fileName + " is not a C3D file.",
+                        __FILE__, __LINE__);
+
+    // The parameter section starts with 4 bytes, the last of which gives
+    // the processor (and so the number formats) that wrote the file.
+    const size_t start = (size_t(std::max(int(_data[0]), 1)) - 1)*512;
+    checkRange(start, 4);
+    const int processor = int(_data[start+3]) - 83;
+    if (processor < Intel || processor > MIPS)
+        throw Exception("C3DFile: " + _fileName + " has an unknown processor "
+                        "type.", __FILE__, __LINE__);
+    _processor = Processor(processor);
+
+    // Groups and parameters, each with a signed name length, an id (negative
+    // for groups), the name and the offset to the next one.
+    map<int, string> groups;
+    vector<pair<pair<int, string>, Parameter> > parameters;
+    size_t pos = start + 4;
+    for (;;) {
+        checkRange(pos, 2);
+        const int nameLength = std::abs(int(int8_t(_data[pos])));
+        if (nameLength == 0) break;
+        const int id = int8_t(_data[pos+1]);
+        checkRange(pos + 2, nameLength + 2);
+        const string name = toUpper(string(
+            reinterpret_cast<const char*>(_data + pos + 2), nameLength));
+        const size_t offsetPos = pos + 2 + nameLength;
+        const int next = readInt16(offsetPos);
+
+        if (id < 0)
+            groups[-id] = name;
+        else if (id > 0) {
+            checkRange(offsetPos + 2, 2);
+            Parameter parameter;
+            parameter.type = int8_t(_data[offsetPos+2]);
+            const int numDims = _data[offsetPos+3];
+            checkRange(offsetPos + 4, numDims);
+            size_t count = 1;
+            for (int d = 0; d < numDims; ++d) {
+                parameter.dims.push_back(_data[offsetPos+4+d]);
+                count *= parameter.dims.back();
+            }
+            parameter.offset = offsetPos + 4 + numDims;
+            checkRange(parameter.offset, count*std::abs(parameter.type));
+            parameters.push_back(make_pair(make_pair(id, name), parameter));
+        }
+        if (next <= 0) break;
+        pos = offsetPos + next;
+    }
+    for (size_t i = 0; i < parameters.size(); ++i) {
+        map<int, string>::const_iterator group =
+            groups.find(parameters[i].first.first);
+        if (group != groups.end())
+            _parameters[group->second + ":" + parameters[i].first.second] =
+                parameters[i].second;
+    }
+
+    // Header, in 16-bit words.
+    _numPoints = readUInt16(2);
+    _firstFrame = readUInt16(6);
+    const int lastFrame = readUInt16(8);
+    _pointScale = readFloat(12);
+    const int dataBlock = readUInt16(16);
+    _analogSamplesPerFrame = readUInt16(18);
+    _pointRate = readFloat(20);
+    _isFloat = _pointScale < 0;
+    _numFrames = lastFrame - _firstFrame + 1;
+    // Trials longer than 65535 frames keep the last frame here.
+    vector<double> endField = getParameterValues("TRIAL", "ACTUAL_END_FIELD");
+    if (endField.size() >= 2) {
+        const int low = int(endField[0]) & 0xffff;
+        const int high = int(endField[1]) & 0xffff;
+        _numFrames = low + 65536*high - _firstFrame + 1;
+    }
+    if (_numFrames < 0) _numFrames = 0;
+
+    vector<string> labels = getParameterStrings("POINT", "LABELS");
+    vector<string> labels2 = getParameterStrings("POINT", "LABELS2");
+    labels.insert(labels.end(), labels2.begin(), labels2.end());
+    for (int i = 0; i < _numPoints; ++i)
+        _pointLabels.push_back(i < int(labels.size()) && !labels[i].empty() ?
+            labels[i] : "P" + to_string(i+1));
+    vector<string> units = getParameterStrings("POINT", "UNITS");
+    _pointUnits = units.empty() || units[0].empty() ? "mm" : units[0];
+
+    // Analog channels.
+    vector<double> used = getParameterValues("ANALOG", "USED");
+    const int analogWords = readUInt16(4);
+    if (!used.empty())
+        _numAnalogChannels = int(used[0]) & 0xffff;
+    else
+        _numAnalogChannels = _analogSamplesPerFrame > 0 ?
+            analogWords/_analogSamplesPerFrame : 0;
+    if (_numAnalogChannels == 0)
+        _analogSamplesPerFrame = 0;
+    else if (_analogSamplesPerFrame == 0)
+        _analogSamplesPerFrame = analogWords/_numAnalogChannels;
+    vector<double> rate = getParameterValues("ANALOG", "RATE");
+    _analogRate = !rate.empty() && rate[0] > 0 ?
+        rate[0] : _pointRate*_analogSamplesPerFrame;
+
+    labels = getParameterStrings("ANALOG", "LABELS");
+    labels2 = getParameterStrings("ANALOG", "LABELS2");
+    labels.insert(labels.end(), labels2.begin(), labels2.end());
+    vector<double> scales = getParameterValues("ANALOG", "SCALE");
+    vector<double> offsets = getParameterValues("ANALOG", "OFFSET");
+    vector<double> genScale = getParameterValues("ANALOG", "GEN_SCALE");
+    vector<string> format = getParameterStrings("ANALOG", "FORMAT");
+    _analogUnsigned = !format.empty() && toUpper(format[0]) == "UNSIGNED";
+    for (int i = 0; i < _numAnalogChannels; ++i) {
+        _analogLabels.push_back(i < int(labels.size()) && !labels[i].empty() ?
+            labels[i] : "A" + to_string(i+1));
+        double offset = i < int(offsets.size()) ? offsets[i] : 0;
+        if (_analogUnsigned && offset < 0) offset += 65536;
+        _analogOffsets.push_back(offset);
+        _analogScales.push_back((i < int(scales.size()) ? scales[i] : 1)*
+                                (genScale.empty() ? 1 : genScale[0]));
+    }
+
+    // Frames of points then analog samples.
+    const size_t wordSize = _isFloat ? 4 : 2;
+    _frameSize = (4*size_t(_numPoints) +
+        size_t(_numAnalogChannels)*_analogSamplesPerFrame)*wordSize;
+    _dataStart = (size_t(std::max(dataBlock, 1)) - 1)*512;
+    if (_frameSize > 0 && _dataStart + _numFrames*_frameSize > _size) {
+        const int available = _dataStart < _size ?
+            int((_size - _dataStart)/_frameSize) : 0;
+        OPENSIM_LOG(Warn) << "C3DFile: " << _fileName << " holds "
+            << available << " of its " << _numFrames << " frames.";
+        _numFrames = available;
+    }
+}
+
+const C3DFile::Parameter* C3DFile::findParameter(const string& group,
+                                                 const string& name) const
+{
+    map<string, Parameter>::const_iterator it =
+        _parameters.find(toUpper(group) + ":" + toUpper(name));
+    return it == _parameters.end() ? NULL : &it->second;
+}
+
+bool C3DFile::hasParameter(const string& group, const string& name) const
+{
+    return findParameter(group, name) != NULL;
+}
+
+vector<double> C3DFile::getParameterValues(const string& group,
+                                           const string& name) const
+{
+    vector<double> values;
+    const Parameter* parameter = findParameter(group, name);
+    if (!parameter || parameter->type < 0) return values;
+    size_t count = 1;
+    for (size_t d = 0; d < parameter->dims.size(); ++d)
+        count *= parameter->dims[d];
+    for (size_t i = 0; i < count; ++i) {
+        const size_t offset = parameter->offset + i*parameter->type;
+        if (parameter->type == 1)
+            values.push_back(int8_t(_data[offset]));
+        else if (parameter->type == 2)
+            values.push_back(readInt16(offset));
+        else
+            values.push_back(readFloat(offset));
+    }
+    return values;
+}
+
+vector<string> C3DFile::getParameterStrings(const string& group,
+                                            const string& name) const
+{
+    vector<string> strings;
+    const Parameter* parameter = findParameter(group, name);
+    if (!parameter || parameter->type != -1) return strings;
+    const vector<int>& dims = parameter->dims;
+    const size_t length = dims.empty() ? 1 : dims[0];
+    size_t count = 1;
+    for (size_t d = 1; d < dims.size(); ++d)
+        count *= dims[d];
+    for (size_t i = 0; i < count; ++i) {
+        string s(reinterpret_cast<const char*>(
+            _data + parameter->offset + i*length), length);
+        s.erase(s.find_last_not_of(" \t\r\n") + 1);
+        strings.push_back(s.c_str());
+    }
+    return strings;
+}
+
+//=============================================================================
+// DATA
+//=============================================================================
+Vec3 C3DFile::getPoint(int frame, int point) const
+{
+    if (frame < 0 || frame >= _numFrames || point < 0 || point >= _numPoints)
+        throw Exception("C3DFile::getPoint: frame or point out of range.",
+                        __FILE__, __LINE__);
+    const size_t w = _isFloat ? 4 : 2;
+    const size_t offset = _dataStart + frame*_frameSize + point*4*w;
+    // A negative residual marks a point that was not seen.
+    if (readWord(offset + 3*w) < 0)
+        return Vec3(SimTK::NaN);
+    const double scale = _isFloat ? 1 : _pointScale;
+    return scale*Vec3(readWord(offset), readWord(offset + w),
+                      readWord(offset + 2*w));
+}
+
+double C3DFile::getAnalog(int sample, int channel) const
+{
+    if (sample < 0 || sample >= _numFrames*_analogSamplesPerFrame ||
+            channel < 0 || channel >= _numAnalogChannels)
+        throw Exception("C3DFile::getAnalog: sample or channel out of range.",
+                        __FILE__, __LINE__);
+    const size_t w = _isFloat ? 4 : 2;
+    const int frame = sample/_analogSamplesPerFrame;
+    const int subsample = sample%_analogSamplesPerFrame;
+    const size_t offset = _dataStart + frame*_frameSize + 4*_numPoints*w +
+        (size_t(subsample)*_numAnalogChannels + channel)*w;
+    const double raw = _isFloat ? readFloat(offset) :
+        _analogUnsigned ? readUInt16(offset) : readInt16(offset);
+    return (raw - _analogOffsets[channel])*_analogScales[channel];
+}
+
+//=============================================================================
+// FORCE PLATES
+//=============================================================================
+/* The plate axes follow from CORNERS, which lists the corners in the
+   quadrants (+x,+y), (-x,+y), (-x,-y), (+x,-y) of the plate frame. ORIGIN is
+   taken as the center of the plate surface relative to the origin of the
+   plate's sensor, in the plate frame; with the plate z axis pointing into
+   the plate, as for AMTI and Bertec plates, its z component is negative. */
+void C3DFile::readForcePlates()
+{
+    const vector<double> types = getParameterValues("FORCE_PLATFORM", "TYPE");
+    vector<double> used = getParameterValues("FORCE_PLATFORM", "USED");
+    int numPlates = used.empty() ? int(types.size()) :
+        std::min(int(used[0]), int(types.size()));
+    if (numPlates <= 0) return;
+
+    const Parameter* channelParameter =
+        findParameter("FORCE_PLATFORM", "CHANNEL");
+    const vector<double> channels =
+        getParameterValues("FORCE_PLATFORM", "CHANNEL");
+    const vector<double> corners =
+        getParameterValues("FORCE_PLATFORM", "CORNERS");
+    const vector<double> origins =
+        getParameterValues("FORCE_PLATFORM", "ORIGIN");
+    const vector<string> units = getParameterStrings("ANALOG", "UNITS");
+    const int rows = channelParameter && !channelParameter->dims.empty() ?
+        channelParameter->dims[0] : 0;
+    const double lengthScale = toSI(_pointUnits, 1e-3);
+
+    for (int i = 0; i < numPlates; ++i) {
+        const int type = int(types[i]);
+        if (type != 1 && type != 2) {
+            OPENSIM_LOG(Warn) << "C3DFile: force plate " << i+1 << " of "
+                << _fileName << " has type " << type
+                << ", which is not supported; it is skipped.";
+            continue;
+        }
+        if (rows < 6 || int(channels.size()) < rows*(i+1) ||
+                int(corners.size()) < 12*(i+1) ||
+                int(origins.size()) < 3*(i+1))
+            throw Exception("C3DFile: the FORCE_PLATFORM parameters of "
+                + _fileName + " are incomplete.", __FILE__, __LINE__);
+
+        ForcePlate plate;
+        plate.type = type;
+        for (int k = 0; k < 6; ++k) {
+            plate.channels[k] = int(channels[rows*i + k]) - 1;
+            if (plate.channels[k] < 0 ||
+                    plate.channels[k] >= _numAnalogChannels)
+                throw Exception("C3DFile: force plate " + to_string(i+1)
+                    + " of " + _fileName + " uses a missing analog channel.",
+                    __FILE__, __LINE__);
+            // Forces in N; moments and (type 1) centers of pressure in the
+            // units of their channel, or else in N and the point units.
+            const string channelUnits = plate.channels[k] < int(units.size()) ?
+                units[plate.channels[k]] : "";
+            plate.scales[k] = toSI(channelUnits, k < 3 ? 1 : lengthScale);
+        }
+
+        Vec3 c[4];
+        for (int j = 0; j < 4; ++j)
+            c[j] = lengthScale*Vec3(corners[12*i + 3*j],
+                corners[12*i + 3*j + 1], corners[12*i + 3*j + 2]);
+        plate.R_LP.setRotationFromTwoAxes(SimTK::UnitVec3(c[0] - c[1]),
+            SimTK::XAxis, c[0] - c[3], SimTK::YAxis);
+        plate.center = (c[0] + c[1] + c[2] + c[3])/4;
+        plate.origin = lengthScale*Vec3(origins[3*i], origins[3*i + 1],
+                                        origins[3*i + 2]);
+        _forcePlates.push_back(plate);
+    }
+}
+
+/* For type 2 plates, the forces F and the moments M are measured about the
+   sensor origin. The center of pressure is the point d on the plate surface,
+   at height h = origin[2], about which the moment is normal to the plate:
+       dx = (h Fx - My)/Fz,  dy = (h Fy + Mx)/Fz,
+   and the free torque is the moment about it, Mz - dx Fy + dy Fx. The
+   reaction on the body is opposite to the load on the plate. */
+void C3DFile::getForcePlateReaction(int plate, int sample, Vec3& force,
+                                    Vec3& point, Vec3& torque,
+                                    double threshold) const
+{
+    const ForcePlate& fp = _forcePlates.at(plate);
+    double v[6];
+    for (int k = 0; k < 6; ++k)
+        v[k] = getAnalog(sample, fp.channels[k])*fp.scales[k];
+    const Vec3 F(v[0], v[1], v[2]);
+    if (std::abs(F[2]) <= threshold) {
+        force = torque = Vec3(0);
+        point = fp.center;
+        return;
+    }
+
+    Vec3 cop(0);
+    double Tz;
+    if (fp.type == 1) {
+        cop = Vec3(v[3], v[4], 0);
+        Tz = v[5];
+    }
+    else {
+        const double h = fp.origin[2];
+        const double dx = (h*F[0] - v[4])/F[2];
+        const double dy = (h*F[1] + v[3])/F[2];
+        cop = Vec3(dx - fp.origin[0], dy - fp.origin[1], 0);
+        Tz = v[5] - dx*F[1] + dy*F[0];
+    }
+    force = -(fp.R_LP*F);
+    point = fp.center + fp.R_LP*cop;
+    torque = -(fp.R_LP*Vec3(0, 0, Tz));
+}
+
+Array<string> C3DFile::getForcePlateColumnLabels() const
+{
+    const int numPlates = getNumForcePlates();
+    static const char* suffixes[] = {"ground_force_vx", "ground_force_vy",
+        "ground_force_vz", "ground_force_px", "ground_force_py",
+        "ground_force_pz", "ground_torque_x", "ground_torque_y",
+        "ground_torque_z"};
+    Array<string> labels("", 1 + 9*numPlates);
+    labels[0] = "time";
+    for (int p = 0; p < numPlates; ++p) {
+        const string prefix = p == 0 ? "" : to_string(p) + "_";
+        for (int k = 0; k < 9; ++k)
+            labels[1 + 9*p + k] = prefix + suffixes[k];
+    }
+    return labels;
+}
+
+void C3DFile::makeForcePlateStorage(Storage& rStorage, double threshold) const
+{
+    const int numPlates = getNumForcePlates();
+    rStorage.purge();
+    rStorage.setName(_fileName);
+    rStorage.setColumnLabels(getForcePlateColumnLabels());
+    if (numPlates == 0) return;
+
+    const int numSamples = _numFrames*_analogSamplesPerFrame;
+    const double startTime = (_firstFrame - 1)/_pointRate;
+    rStorage.setCapacityIncrement(numSamples);
+    vector<double> row(9*numPlates);
+    Vec3 force, point, torque;
+    for (int s = 0; s < numSamples; ++s) {
+        for (int p = 0; p < numPlates; ++p) {
+            getForcePlateReaction(p, s, force, point, torque, threshold);
+            for (int k = 0; k < 3; ++k) {
+                row[9*p + k] = force[k];
+                row[9*p + 3 + k] = point[k];
+                row[9*p + 6 + k] = torque[k];
+            }
+        }
+        rStorage.append(startTime + s/_analogRate, 9*numPlates, &row[0]);
+    }
+}
@@ -0,0 +1,191 @@
+#ifndef OPENSIM_C3D_FILE_H_
+#define OPENSIM_C3D_FILE_H_
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  C3DFile.h                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include "Array.h"
+#include "SimTKcommon.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace OpenSim {
+
+class Storage;
+
+/**
+ * Reads the 3D points (markers), analog channels and force plates of a C3D
+ * file.
+ *
+ * The file is memory-mapped, where the platform allows it, and values are
+ * decoded from it on request, so no text conversion or intermediate copy of
+ * the data is made. Files written by Intel, DEC and MIPS processors are
+ * supported, in both the integer and the floating-point formats. Analog
+ * values are scaled as
+ *
+ *     value = (sample - ANALOG:OFFSET) * ANALOG:SCALE * ANALOG:GEN_SCALE.
+ *
+ * MarkerData reads .c3d files through this class. Storage reads the
+ * ground reactions of the force plates from them (see
+ * makeForcePlateStorage()), so ExternalLoads can name a .c3d file as its
+ * data file.
+ *
+ * Errors in the file are reported by throwing an Exception.
+ */
+class OSIMCOMMON_API C3DFile {
+public:
+    explicit C3DFile(const std::string& fileName);
+    ~C3DFile();
+
+    const std::string& getFileName() const { return _fileName; }
+
+    //--------------------------------------------------------------------------
+    // POINTS
+    //--------------------------------------------------------------------------
+    int getFirstFrame() const { return _firstFrame; }
+    int getNumFrames() const { return _numFrames; }
+    double getPointRate() const { return _pointRate; }
+    int getNumPoints() const { return _numPoints; }
+    const std::vector<std::string>& getPointLabels() const
+    {   return _pointLabels; }
+    /** Units of the point coordinates, POINT:UNITS (usually "mm"). */
+    const std::string& getPointUnits() const { return _pointUnits; }
+    /** Location of a point in a frame (both counted from 0), in the point
+    units. Points that are not visible in the frame are NaN. */
+    SimTK::Vec3 getPoint(int frame, int point) const;
+
+    //--------------------------------------------------------------------------
+    // ANALOG CHANNELS
+    //--------------------------------------------------------------------------
+    int getNumAnalogChannels() const { return _numAnalogChannels; }
+    /** Samples of each channel per point frame. */
+    int getNumAnalogSamplesPerFrame() const { return _analogSamplesPerFrame; }
+    double getAnalogRate() const { return _analogRate; }
+    const std::vector<std::string>& getAnalogLabels() const
+    {   return _analogLabels; }
+    /** Scaled value of a channel at an analog sample, counted from 0 at the
+    first sample of the first frame. */
+    double getAnalog(int sample, int channel) const;
+
+    //--------------------------------------------------------------------------
+    // FORCE PLATES
+    //--------------------------------------------------------------------------
+    /** Number of force plates of type 1 or 2, the types supported. Plates of
+    other types are skipped with a warning. */
+    int getNumForcePlates() const { return int(_forcePlates.size()); }
+    /** Reaction of a force plate on the body it supports at an analog sample,
+    in the laboratory frame of the file and in SI units: the force, the
+    center of pressure on the plate surface and the free torque about the
+    plate normal. While the force normal to the plate is below threshold
+    (in N) the force and torque are zero and the center of pressure is the
+    center of the plate. */
+    void getForcePlateReaction(int plate, int sample,
+                               SimTK::Vec3& force, SimTK::Vec3& point,
+                               SimTK::Vec3& torque,
+                               double threshold=0) const;
+    /** Replace the contents of a Storage with the reactions of all force
+    plates at every analog sample. The columns of the first plate are
+    ground_force_vx, _vy, _vz, ground_force_px, _py, _pz and ground_torque_x,
+    _y, _z; those of the following plates are prefixed by "1_", "2_", ...
+    as in the ground reaction files of the OpenSim examples. */
+    void makeForcePlateStorage(Storage& rStorage, double threshold=0) const;
+    /** The column labels, starting with "time", of the Storage made by
+    makeForcePlateStorage(). */
+    Array<std::string> getForcePlateColumnLabels() const;
+
+    //--------------------------------------------------------------------------
+    // PARAMETERS
+    //--------------------------------------------------------------------------
+    /** Whether the parameter GROUP:NAME exists. Names are not case
+    sensitive. */
+    bool hasParameter(const std::string& group, const std::string& name) const;
+    /** Values of a numeric parameter, in the order stored in the file (first
+    dimension fastest). Empty if the parameter does not exist. */
+    std::vector<double> getParameterValues(const std::string& group,
+                                           const std::string& name) const;
+    /** Values of a character parameter, one string per element of the second
+    and following dimensions, with trailing blanks removed. */
+    std::vector<std::string> getParameterStrings(const std::string& group,
+                                                 const std::string& name) const;
+
+private:
+    C3DFile(const C3DFile&);
+    C3DFile& operator=(const C3DFile&);
+
+    enum Processor { Intel = 1, DEC = 2, MIPS = 3 };
+    struct Parameter {
+        int type;               // -1 char, 1 byte, 2 int16, 4 float
+        std::vector<int> dims;
+        size_t offset;          // of the first value in the file
+    };
+    struct ForcePlate {
+        int type;
+        int channels[6];
+        SimTK::Rotation R_LP;   // plate frame in the laboratory frame
+        SimTK::Vec3 center;     // of the plate surface, laboratory frame, m
+        SimTK::Vec3 origin;     // surface center from the sensor, plate frame, m
+        double scales[6];       // of the channels, to SI units
+    };
+
+    void readHeaderAndParameters();
+    void readForcePlates();
+    const Parameter* findParameter(const std::string& group,
+                                   const std::string& name) const;
+    void checkRange(size_t offset, size_t size) const;
+    int readInt16(size_t offset) const;
+    int readUInt16(size_t offset) const;
+    double readFloat(size_t offset) const;
+    double readWord(size_t offset) const;
+
+    class MappedFile;
+    std::unique_ptr<MappedFile> _file;
+    std::string _fileName;
+    const unsigned char* _data;
+    size_t _size;
+    Processor _processor;
+    std::map<std::string, Parameter> _parameters;
+
+    bool _isFloat;
+    double _pointScale;
+    int _firstFrame;
+    int _numFrames;
+    double _pointRate;
+    int _numPoints;
+    std::vector<std::string> _pointLabels;
+    std::string _pointUnits;
+    int _numAnalogChannels;
+    int _analogSamplesPerFrame;
+    double _analogRate;
+    std::vector<std::string> _analogLabels;
+    std::vector<double> _analogScales;
+    std::vector<double> _analogOffsets;
+    bool _analogUnsigned;
+    size_t _dataStart;
+    size_t _frameSize;
+    std::vector<ForcePlate> _forcePlates;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_C3D_FILE_H_
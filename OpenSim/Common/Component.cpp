@@ -24,6 +24,7 @@
 
 // INCLUDES
 #include "OpenSim/Common/Component.h"
+#include "OpenSim/Common/Profiler.h"
 //#include "OpenSim/Common/ComponentOutput.h"
 
 using namespace SimTK;
@@ -75,29 +76,38 @@ public:
     {   return this->getValueZero(); }
 
     void realizeMeasureTopologyVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeTopology(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeTopology");
+        _Component.extendRealizeTopology(s); }
     void realizeMeasureModelVirtual(SimTK::State& s) const override final
-    {   _Component.extendRealizeModel(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeModel");
+        _Component.extendRealizeModel(s); }
     void realizeMeasureInstanceVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeInstance(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeInstance");
+        _Component.extendRealizeInstance(s); }
     void realizeMeasureTimeVirtual(const SimTK::State& s) const override final
-    {   _Component.extendRealizeTime(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeTime");
+        _Component.extendRealizeTime(s); }
     void realizeMeasurePositionVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizePosition(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizePosition");
+        _Component.extendRealizePosition(s); }
     void realizeMeasureVelocityVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeVelocity(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeVelocity");
+        _Component.extendRealizeVelocity(s); }
     void realizeMeasureDynamicsVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeDynamics(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeDynamics");
+        _Component.extendRealizeDynamics(s); }
     void realizeMeasureAccelerationVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeAcceleration(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeAcceleration");
+        _Component.extendRealizeAcceleration(s); }
     void realizeMeasureReportVirtual(const SimTK::State& s)
         const override final
-    {   _Component.extendRealizeReport(s); }
+    {   OPENSIM_PROFILE_SCOPE(_Component, "realizeReport");
+        _Component.extendRealizeReport(s); }
 
 private:
     const Component& _Component;
@@ -162,6 +172,29 @@ void Component::componentsFinalizeFromProperties() const
     }
 }
 
+void Component::finalizeFromPropertiesInSystem()
+{
+    // As finalizeFromProperties(), without reset().
+    clearComponents();
+    extendFinalizeFromProperties();
+    for (unsigned int i = 0; i<_components.size(); i++){
+        _components[i]->finalizeFromPropertiesInSystem();
+    }
+    setObjectIsUpToDateWithProperties();
+}
+
+void Component::findComponentsNotUpToDate(
+    std::vector<const Component*>& components) const
+{
+    if (!isObjectUpToDateWithProperties()) {
+        components.push_back(this);
+        return;
+    }
+    for (unsigned int i = 0; i<_components.size(); i++){
+        _components[i]->findComponentsNotUpToDate(components);
+    }
+}
+
 // Base class implementation of non virtual connect method.
 void Component::connect(Component &root)
 {
@@ -838,10 +871,20 @@ void Component::constructOutputForStateVariable(const std::string& name)
             SimTK::Stage::Model);
 }
 
+void Component::clearComponentViews() const
+{
+    for (const Component* comp = this; comp != nullptr;
+            comp = comp->hasParent() ? &comp->getParent() : nullptr) {
+        std::lock_guard<std::mutex> lock(comp->_componentViewsMutex);
+        comp->_componentViews.clear();
+    }
+}
+
 // Include another Component as a subcomponent of this one. If already a
 // subcomponent, it is not added to the list again.
 void Component::addComponent(Component* component)
 {
+    clearComponentViews();
     // Only add if the Component is not already a part of the model
     // So, add if empty
     if ( _components.empty() ){
@@ -1034,7 +1077,10 @@ void Component::extendRealizeAcceleration(const SimTK::State& s) const
         const SimTK::Subsystem& subSys = getDefaultSubsystem();
 
         // evaluate and set component state derivative values (in cache) 
-        computeStateVariableDerivatives(s);
+        {
+            OPENSIM_PROFILE_SCOPE(*this, "computeStateVariableDerivatives");
+            computeStateVariableDerivatives(s);
+        }
     
         std::map<std::string, StateVariableInfo>::const_iterator it;
 
@@ -49,7 +49,11 @@
 #include "ComponentList.h"
 #include "Simbody.h"
 #include <functional>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <typeindex>
+#include <vector>
 
 namespace OpenSim {
 
@@ -232,6 +236,24 @@ public:
         Marks the Component as up to date with its properties. */
     void finalizeFromProperties();
 
+    /** Update Component's internal data members based on properties that were
+        edited after it was added to a System, like finalizeFromProperties(),
+        but keep the resources it allocated in the System (state, discrete and
+        cache variables) and its connections. This is only valid if the edits
+        change neither what the Component adds to the System nor what it is
+        connected to. Marks the Component as up to date with its properties.
+        @see Model::updateSystem() */
+    void finalizeFromPropertiesInSystem();
+
+#ifndef SWIG
+    /** Append to `components` this Component and the (sub)components that are
+        not up to date with their properties (see
+        isObjectUpToDateWithProperties()). The (sub)components of a Component
+        that is not up to date are not visited, since they may have changed. */
+    void findComponentsNotUpToDate(
+        std::vector<const Component*>& components) const;
+#endif
+
     /** Connect this Component to its aggregate component, which is the root
         of a tree of components.*/
     void connect(Component& root);
@@ -330,6 +352,30 @@ public:
         return ComponentList<T>(*this);
     }
 
+    /**
+     * Get the subcomponents of type T, in the order of getComponentList<T>(),
+     * as an array of pointers. The array is made by walking the tree the
+     * first time it is requested and is kept until the tree is built again
+     * (initComponentTreeTraversal()) or subcomponents of this Component or of
+     * any Component below it are added or cleared, so code that loops over,
+     * e.g., all the Muscles at
+     * every step does not walk and dynamic_cast the whole tree each time.
+     * The arrays are filled under a lock, so views may be requested from
+     * several threads at once, as long as none of them changes the tree. */
+    template <typename T = Component>
+    const std::vector<const T*>& getComponentView() const {
+        std::lock_guard<std::mutex> lock(_componentViewsMutex);
+        std::unique_ptr<AbstractComponentView>& view =
+            _componentViews[std::type_index(typeid(T))];
+        if (!view) {
+            ComponentView<T>* typedView = new ComponentView<T>();
+            for (const T& comp : getComponentList<T>())
+                typedView->components.push_back(&comp);
+            view.reset(typedView);
+        }
+        return static_cast<const ComponentView<T>&>(*view).components;
+    }
+
     /**
      * Class to hold the list of components/subcomponents to iterate over.
     */
@@ -1015,6 +1061,7 @@ template <class T> friend class ComponentMeasure;
     the next Component in tree pre-order traversal.
     */
     void initComponentTreeTraversal(Component &root) {
+        _componentViews.clear();
         // Going down the tree, node is followed by all its
         // children in order, last child's successor is the parent's successor.
         for (unsigned int i = 0; i < _components.size(); i++){
@@ -1391,6 +1438,7 @@ template <class T> friend class ComponentMeasure;
       * Components are not deleted- the list of references to its components is cleared. */
     void clearComponents() {
         _components.clear();
+        clearComponentViews();
     }
 
     /** Add a modeling option (integer flag stored in the State) for use by 
@@ -1763,6 +1811,22 @@ private:
 
     // Reference pointer to the successor of the current Component in Pre-order traversal
     SimTK::ReferencePtr<Component> _nextComponent;
+
+    // Subcomponents of each type requested from getComponentView(), by type.
+    struct AbstractComponentView {
+        virtual ~AbstractComponentView() {}
+    };
+    template <typename T>
+    struct ComponentView : AbstractComponentView {
+        std::vector<const T*> components;
+    };
+    mutable std::map<std::type_index, std::unique_ptr<AbstractComponentView> >
+        _componentViews;
+    // Guards _componentViews, which getComponentView() fills.
+    mutable std::mutex _componentViewsMutex;
+    // Discard the views of this Component and of its owners, which include
+    // this Component's subcomponents.
+    void clearComponentViews() const;
     // PathName
     std::string _pathName;
 
@@ -90,6 +90,18 @@ public:
     {
         return _value;
     }
+    double calcScalarValue(double xUnused) const override
+    {
+        return _value;
+    }
+    double calcScalarDerivative(int derivOrder, double xUnused) const override
+    {
+        return derivOrder == 0 ? _value : 0.0;
+    }
+    SimTK::Vec3 calcScalarValueAndDerivatives(double xUnused) const override
+    {
+        return SimTK::Vec3(_value, 0, 0);
+    }
     const double getValue() const { return _value; }
     SimTK::Function* createSimTKFunction() const override;
 //=============================================================================
@@ -174,6 +174,39 @@ double Function::calcDerivative(const std::vector<int>& derivComponents, const V
     return _function->calcDerivative(derivComponents, x);
 }
 
+double Function::calcScalarValue(double x) const
+{
+    return calcValue(Vector(1, x));
+}
+
+double Function::calcScalarDerivative(int derivOrder, double x) const
+{
+    // Derivative components for the common orders, so that they are not
+    // reallocated on every call.
+    static const std::vector<int> firstOrder(1, 0);
+    static const std::vector<int> secondOrder(2, 0);
+
+    if (derivOrder == 0)
+        return calcScalarValue(x);
+    const Vector arg(1, x);
+    if (derivOrder == 1)
+        return calcDerivative(firstOrder, arg);
+    if (derivOrder == 2)
+        return calcDerivative(secondOrder, arg);
+    return calcDerivative(std::vector<int>(derivOrder, 0), arg);
+}
+
+SimTK::Vec3 Function::calcScalarValueAndDerivatives(double x) const
+{
+    static const std::vector<int> firstOrder(1, 0);
+    static const std::vector<int> secondOrder(2, 0);
+
+    const Vector arg(1, x);
+    return SimTK::Vec3(calcValue(arg),
+                       calcDerivative(firstOrder, arg),
+                       calcDerivative(secondOrder, arg));
+}
+
 int Function::getArgumentSize() const
 {
     if (_function == NULL)
@@ -120,6 +120,25 @@ public:
      * @param x                the Vector of input arguments.  Its size must equal the value returned by getArgumentSize().
      */
     virtual double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const;
+    /**
+     * Calculate the value of a function of a single argument at x. This is
+     * equivalent to calcValue(SimTK::Vector(1, x)); Functions of a single
+     * argument override it to evaluate without allocating an argument
+     * Vector.
+     */
+    virtual double calcScalarValue(double x) const;
+    /**
+     * Calculate the derivative of order derivOrder (0 for the value) of a
+     * function of a single argument at x, without allocating the argument
+     * Vector or the list of derivative components.
+     */
+    virtual double calcScalarDerivative(int derivOrder, double x) const;
+    /**
+     * Calculate the value and the first and second derivatives of a function
+     * of a single argument at x, returned in that order. Overrides share the
+     * work common to the three (e.g., locating x among a spline's knots).
+     */
+    virtual SimTK::Vec3 calcScalarValueAndDerivatives(double x) const;
     /**
      * Get the number of components expected in the input vector.
      */
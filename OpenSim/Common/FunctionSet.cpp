@@ -113,17 +113,7 @@ setNull()
 double FunctionSet::
 evaluate(int aIndex,int aDerivOrder,double aX) const
 {
-    Function& func = get(aIndex);
-
-    SimTK::Vector arg = SimTK::Vector(1, aX);
-    if (aDerivOrder==0)
-        return (func.calcValue(arg));
-
-    std::vector<int> derivComponents;
-    for(int i=0; i<aDerivOrder; i++)
-        derivComponents.push_back(0);
-
-    return( func.calcDerivative(derivComponents, arg) );
+    return( get(aIndex).calcScalarDerivative(aDerivOrder, aX) );
 }
 
 //_____________________________________________________________________________
@@ -146,16 +136,6 @@ evaluate(Array<double> &rValues,int aDerivOrder,double aX) const
     rValues.setSize(size);
 
     int i;
-    for(i=0;i<size;i++) {
-        Function& func = get(i);
-        if (aDerivOrder==0)
-            rValues[i] = func.calcValue(SimTK::Vector(1,aX));
-        else {
-            std::vector<int> derivComponents;
-            for(int j=0; j<aDerivOrder; j++)
-                derivComponents.push_back(0);
-            rValues[i] = func.calcDerivative(derivComponents, SimTK::Vector(1,aX));
-
-        }
-    }
+    for(i=0;i<size;i++)
+        rValues[i] = get(i).calcScalarDerivative(aDerivOrder, aX);
 }
@@ -583,6 +583,36 @@ addPoint(double aX, double aY)
     return i;
 }
 
+//=============================================================================
+// SCALAR EVALUATION
+//=============================================================================
+const SimTK::Spline& GCVSpline::getSpline() const
+{
+    if (_function == NULL)
+        _function = createSimTKFunction();
+    return *static_cast<const SimTK::Spline*>(_function);
+}
+
+double GCVSpline::calcScalarValue(double x) const
+{
+    return getSpline().calcValue(x);
+}
+
+double GCVSpline::calcScalarDerivative(int derivOrder, double x) const
+{
+    if (derivOrder == 0)
+        return getSpline().calcValue(x);
+    return getSpline().calcDerivative(derivOrder, x);
+}
+
+SimTK::Vec3 GCVSpline::calcScalarValueAndDerivatives(double x) const
+{
+    const SimTK::Spline& spline = getSpline();
+    return SimTK::Vec3(spline.calcValue(x),
+                       spline.calcDerivative(1, x),
+                       spline.calcDerivative(2, x));
+}
+
 SimTK::Function* GCVSpline::createSimTKFunction() const {
     int degree = _halfOrder*2-1;
     Vector x(_x.getSize());
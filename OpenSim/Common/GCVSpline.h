@@ -232,6 +232,13 @@ public:
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    double calcScalarValue(double x) const override;
+    double calcScalarDerivative(int derivOrder, double x) const override;
+    SimTK::Vec3 calcScalarValueAndDerivatives(double x) const override;
+
+private:
+    /** The SimTK::Spline that evaluates this function, created if needed. */
+    const SimTK::Spline& getSpline() const;
 
 //=============================================================================
 };  // END class GCVSpline
@@ -103,6 +103,15 @@ public:
     //--------------------------------------------------------------------------
     // EVALUATION
     //--------------------------------------------------------------------------
+    double calcScalarValue(double x) const override
+    {   return _coefficients[0]*x + _coefficients[1]; }
+    double calcScalarDerivative(int derivOrder, double x) const override
+    {
+        return derivOrder == 0 ? calcScalarValue(x)
+             : derivOrder == 1 ? _coefficients[0] : 0.0;
+    }
+    SimTK::Vec3 calcScalarValueAndDerivatives(double x) const override
+    {   return SimTK::Vec3(calcScalarValue(x), _coefficients[0], 0); }
     SimTK::Function* createSimTKFunction() const override;
 
 //=============================================================================
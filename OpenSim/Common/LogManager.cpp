@@ -72,6 +72,7 @@ LogBuffer::~LogBuffer()
 bool LogBuffer::
 addLogCallback(LogCallback *aLogCallback)
 {
+    std::lock_guard<std::mutex> lock(_callbackMutex);
     if(_logCallbacks.findIndex(aLogCallback) >= 0) return false;
     _logCallbacks.append(aLogCallback); 
     return true;
@@ -80,17 +81,25 @@ addLogCallback(LogCallback *aLogCallback)
 bool LogBuffer::
 removeLogCallback(LogCallback *aLogCallback)
 {
+    std::lock_guard<std::mutex> lock(_callbackMutex);
     int index = _logCallbacks.findIndex(aLogCallback);
     if(index < 0) return false;
     _logCallbacks.remove(index); 
     return true;
 }
 
+void LogBuffer::
+logMessage(const std::string &aStr)
+{
+    std::lock_guard<std::mutex> lock(_callbackMutex);
+    for(int i=0; i<_logCallbacks.getSize(); i++) _logCallbacks[i]->log(aStr);
+}
+
 int LogBuffer::
 sync()
 {
     // Pass current string to all log callbacks
-    for(int i=0; i<_logCallbacks.getSize(); i++) _logCallbacks[i]->log(str());
+    logMessage(str());
     // Reset current buffer contents
     str("");
     return std::stringbuf::sync();
@@ -26,6 +26,7 @@
 #include "Array.h"
 #include "LogCallback.h"
 #include <iostream>
+#include <mutex>
 #include <sstream>
 
 namespace OpenSim {
@@ -54,9 +55,13 @@ public:
     ~LogBuffer();
     bool addLogCallback(LogCallback *aLogCallback);
     bool removeLogCallback(LogCallback *aLogCallback);
+    // Pass a complete message directly to the log callbacks. Safe to call
+    // from any thread.
+    void logMessage(const std::string &aStr);
 
 private:
     Array<LogCallback*> _logCallbacks;
+    std::mutex _callbackMutex;
 
     int sync() override;
 };
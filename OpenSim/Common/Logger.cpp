@@ -0,0 +1,287 @@
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  Logger.cpp                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "Logger.h"
+#include "Exception.h"
+#include "LogManager.h"
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+
+// Messages logged by one thread, waiting to be written. Only the owning
+// thread pushes and only the thread holding LoggerData::writeLock pops, so
+// the ring needs no lock.
+class ThreadBuffer {
+public:
+    static const size_t Capacity = 1024;
+
+    bool push(Logger::Level level, string& message) {
+        size_t tail = _tail.load(memory_order_relaxed);
+        if (tail - _head.load(memory_order_acquire) == Capacity)
+            return false;
+        Entry& entry = _entries[tail % Capacity];
+        entry.level = level;
+        // Swapping hands the slot's old string (and its capacity) back to
+        // the caller instead of copying.
+        entry.message.swap(message);
+        _tail.store(tail + 1, memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _head.load(memory_order_acquire)
+            == _tail.load(memory_order_acquire);
+    }
+
+    template <typename Write>
+    void drain(Write write) {
+        size_t head = _head.load(memory_order_relaxed);
+        size_t tail = _tail.load(memory_order_acquire);
+        for (; head != tail; ++head) {
+            Entry& entry = _entries[head % Capacity];
+            write(entry.level, entry.message);
+            entry.message.clear();
+            _head.store(head + 1, memory_order_release);
+        }
+    }
+
+    // Set when the owning thread exits; the buffer is then dropped once
+    // it has been drained.
+    atomic<bool> finished{false};
+
+private:
+    struct Entry {
+        Logger::Level level;
+        string message;
+    };
+    Entry _entries[Capacity];
+    atomic<size_t> _head{0};
+    atomic<size_t> _tail{0};
+};
+
+// Messages of every level go where the std::cout output they replace went.
+void writeMessage(Logger::Level, const string& message)
+{
+    LogManager::getInstance()->getOutBuffer()->logMessage(message);
+}
+
+struct LoggerData {
+    // Guards the list of buffers.
+    mutex registryLock;
+    vector<shared_ptr<ThreadBuffer>> buffers;
+    // Held while writing so messages from one drain are not interleaved
+    // with those of another.
+    mutex writeLock;
+    // Wakes the writer thread.
+    mutex wakeLock;
+    condition_variable wake;
+    bool stop = false;
+    thread writer;
+    atomic<bool> writerStarted{false};
+    atomic<bool> asynchronous{true};
+
+    void startWriter() {
+        if (writerStarted.load()) return;
+        lock_guard<mutex> guard(wakeLock);
+        if (writerStarted.load() || stop) return;
+        writerStarted = true;
+        atexit(stopWriterAtExit);
+        writer = thread([this] {
+            unique_lock<mutex> lock(wakeLock);
+            while (!stop) {
+                wake.wait_for(lock, chrono::milliseconds(20));
+                lock.unlock();
+                drainAll();
+                lock.lock();
+            }
+        });
+    }
+
+    // Stop the writer thread and write what is left; later messages are
+    // written synchronously. Joining is optional because the thread must
+    // not be waited for while the process is exiting: on Windows, exit
+    // handlers and static destructors of a DLL run under the loader lock,
+    // which the exiting thread needs too.
+    void stopWriter(bool join) {
+        {
+            lock_guard<mutex> guard(wakeLock);
+            stop = true;
+            asynchronous = false;
+        }
+        wake.notify_one();
+        if (join && writer.joinable()) writer.join();
+        drainAll();
+    }
+
+    static void stopWriterAtExit();
+
+    void drainAll() {
+        lock_guard<mutex> writeGuard(writeLock);
+        vector<shared_ptr<ThreadBuffer>> current;
+        {
+            lock_guard<mutex> guard(registryLock);
+            current = buffers;
+        }
+        for (auto& buffer : current)
+            buffer->drain(writeMessage);
+
+        lock_guard<mutex> guard(registryLock);
+        buffers.erase(remove_if(buffers.begin(), buffers.end(),
+            [](const shared_ptr<ThreadBuffer>& buffer) {
+                return buffer->finished.load() && buffer->empty();
+            }), buffers.end());
+    }
+};
+
+LoggerData& data() {
+    // Never destroyed, so that a writer thread that is still running at
+    // exit does not outlive it; see stopWriter().
+    static LoggerData* d = new LoggerData;
+    return *d;
+}
+
+void LoggerData::stopWriterAtExit()
+{
+    data().stopWriter(false);
+}
+
+// This thread's buffer, registered with LoggerData on first use.
+struct ThreadBufferHandle {
+    shared_ptr<ThreadBuffer> buffer;
+    ~ThreadBufferHandle() {
+        if (buffer) buffer->finished = true;
+    }
+    ThreadBuffer& get() {
+        if (!buffer) {
+            buffer = make_shared<ThreadBuffer>();
+            LoggerData& d = data();
+            lock_guard<mutex> guard(d.registryLock);
+            d.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+};
+thread_local ThreadBufferHandle threadBuffer;
+
+int initialLevel()
+{
+    const char* name = getenv("OPENSIM_LOG_LEVEL");
+    if (name) {
+        try {
+            return int(Logger::parseLevel(name));
+        }
+        catch (const Exception&) {}
+    }
+    return int(Logger::Level::Info);
+}
+
+} // anonymous namespace
+
+std::atomic<int> Logger::_level(initialLevel());
+
+//=============================================================================
+// SETTINGS
+//=============================================================================
+void Logger::setLevel(Level level)
+{
+    _level = int(level);
+}
+
+Logger::Level Logger::parseLevel(const std::string& name)
+{
+    string lower(name);
+    transform(lower.begin(), lower.end(), lower.begin(),
+              [](unsigned char c) { return char(tolower(c)); });
+    if (lower == "off") return Level::Off;
+    if (lower == "error") return Level::Error;
+    if (lower == "warn" || lower == "warning") return Level::Warn;
+    if (lower == "info") return Level::Info;
+    if (lower == "debug") return Level::Debug;
+    if (lower == "trace") return Level::Trace;
+    throw Exception("Logger: unrecognized log level '" + name + "'.",
+                    __FILE__, __LINE__);
+}
+
+void Logger::setAsynchronous(bool asynchronous)
+{
+    // Write what was queued so far so messages stay in order.
+    if (!asynchronous) flush();
+    LoggerData& d = data();
+    lock_guard<mutex> guard(d.wakeLock);
+    // The writer thread is not restarted after shutdown().
+    if (!d.stop) d.asynchronous = asynchronous;
+}
+
+bool Logger::isAsynchronous()
+{
+    return data().asynchronous;
+}
+
+//=============================================================================
+// LOGGING
+//=============================================================================
+void Logger::flush()
+{
+    data().drainAll();
+}
+
+void Logger::shutdown()
+{
+    data().stopWriter(true);
+}
+
+void Logger::log(Level level, const std::string& message)
+{
+    if (!shouldLog(level)) return;
+
+    string line(message);
+    if (line.empty() || line.back() != '\n') line += '\n';
+
+    LoggerData& d = data();
+    if (!d.asynchronous) {
+        lock_guard<mutex> guard(d.writeLock);
+        writeMessage(level, line);
+        return;
+    }
+
+    d.startWriter();
+    ThreadBuffer& buffer = threadBuffer.get();
+    while (!buffer.push(level, line)) {
+        // Full: let the writer catch up rather than drop the message.
+        d.wake.notify_one();
+        this_thread::yield();
+    }
+}
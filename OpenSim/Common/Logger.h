@@ -0,0 +1,132 @@
+#ifndef OPENSIM_LOGGER_H_
+#define OPENSIM_LOGGER_H_
+/* -------------------------------------------------------------------------- *
+ *                             OpenSim:  Logger.h                             *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <atomic>
+#include <sstream>
+#include <string>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Level-filtered logging for messages written while a Tool or simulation is
+ * running, e.g. per-frame or per-step diagnostics.
+ *
+ * Messages are written with the OPENSIM_LOG() macro. If the message's level
+ * is not enabled, the macro costs one comparison and the message's
+ * arguments are not even evaluated:
+ *
+ * @code
+ * OPENSIM_LOG(Info) << "Frame " << i << ": RMS error = " << rms;
+ * OPENSIM_LOG(Debug) << "q's = " << s.getQ();
+ * @endcode
+ *
+ * Each message is formatted on the calling thread and queued in a buffer
+ * that belongs to that thread, without taking a lock. A background thread
+ * empties these buffers and passes the messages on to LogManager's output
+ * buffer, i.e. to the terminal and out.log like the std::cout output they
+ * replace, so the thread producing them does not wait for console or file
+ * I/O. Messages from one thread keep their order. flush() writes everything
+ * queued so far; Tools do it at the end of run() so that queued messages
+ * are not interleaved with later output written directly to std::cout.
+ *
+ * The background thread is stopped, and the remaining messages written, by
+ * shutdown() or, failing that, by an exit handler; it is never waited for
+ * during static destruction.
+ *
+ * The level is Info unless the environment variable OPENSIM_LOG_LEVEL is set
+ * to one of off, error, warn, info, debug or trace, and can be changed with
+ * setLevel().
+ */
+class OSIMCOMMON_API Logger {
+public:
+    enum class Level {
+        Off = 0,
+        Error,
+        Warn,
+        Info,
+        Debug,
+        Trace
+    };
+
+    static Level getLevel() { return Level(_level.load()); }
+    static void setLevel(Level level);
+    /** Parse a level from its name (case-insensitive), e.g. "debug". Throws
+    an Exception if the name is not recognized. */
+    static Level parseLevel(const std::string& name);
+
+    /** Whether messages of the given level are currently written. */
+    static bool shouldLog(Level level) {
+        return level != Level::Off && int(level) <= _level.load();
+    }
+
+    /** When asynchronous (the default), messages are written by a background
+    thread; otherwise they are written before log() returns. */
+    static void setAsynchronous(bool asynchronous);
+    static bool isAsynchronous();
+
+    /** Write all messages queued so far before returning. */
+    static void flush();
+
+    /** Write all queued messages and stop the background thread, waiting
+    for it to finish. Later messages are written synchronously. Call this
+    before unloading the library; otherwise the thread is stopped, without
+    waiting for it, when the program exits. */
+    static void shutdown();
+
+    /** Log a complete message; a newline is appended if it does not end
+    with one. Prefer the OPENSIM_LOG() macro, which skips formatting the
+    message when its level is disabled. */
+    static void log(Level level, const std::string& message);
+
+    /** Collects one message and logs it when destroyed. Used by
+    OPENSIM_LOG(). */
+    class Message {
+    public:
+        explicit Message(Level level) : _level(level) {}
+        ~Message() { Logger::log(_level, _stream.str()); }
+        std::ostream& stream() { return _stream; }
+    private:
+        Level _level;
+        std::ostringstream _stream;
+    };
+
+private:
+    static std::atomic<int> _level;
+};
+
+} // end of namespace OpenSim
+
+/** Stream a message at the given Logger::Level (Error, Warn, Info, Debug or
+Trace). Nothing after the macro is evaluated if the level is disabled. The
+macro is a single statement, so it can be the body of an unbraced if. */
+#define OPENSIM_LOG(level)                                                    \
+    for (bool opensimLogEnabled =                                             \
+             OpenSim::Logger::shouldLog(OpenSim::Logger::Level::level);       \
+         opensimLogEnabled; opensimLogEnabled = false)                        \
+        OpenSim::Logger::Message(OpenSim::Logger::Level::level).stream()
+
+#endif // OPENSIM_LOGGER_H_
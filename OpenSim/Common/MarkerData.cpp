@@ -29,6 +29,7 @@
 #include <math.h>
 #include <float.h>
 #include "MarkerData.h"
+#include "C3DFile.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
 #include "SimTKcommon.h"
@@ -56,7 +57,7 @@ MarkerData::MarkerData() :
 
 //_____________________________________________________________________________
 /**
- * Constructor from a TRB/TRC file.
+ * Constructor from a TRC, STO or C3D file.
  */
 MarkerData::MarkerData(const string& aFileName) :
     _numFrames(0),
@@ -83,6 +84,8 @@ MarkerData::MarkerData(const string& aFileName) :
       readTRCFile(aFileName, *this);
    else if (sExtension.toLower() == "sto")
        readStoFile(aFileName);
+   else if (sExtension.toLower() == "c3d")
+       readC3DFile(aFileName);
    else
        throw Exception("MarkerData: ERROR- Marker file type is unsupported",__FILE__,__LINE__);
 
@@ -130,6 +133,11 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
     }
 
    readTRCFileHeader(in, aFileName, aSMD);
+   if (aSMD._numFrames > 0) {
+      aSMD._frameNumbers.reserve(aSMD._numFrames);
+      aSMD._frameTimes.reserve(aSMD._numFrames);
+      aSMD._markers.reserve(aSMD._numFrames*aSMD._numMarkers);
+   }
 
    /* read frame data */
    while (getline(in, line))
@@ -138,7 +146,7 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
       if (findFirstNonWhiteSpace(line) == -1)
          continue;
 
-        if (aSMD._frames.getSize() == aSMD._numFrames)
+        if ((int)aSMD._frameNumbers.size() == aSMD._numFrames)
         {
 #if 0
             if (gUseGlobalMessages)
@@ -171,7 +179,8 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 #endif
       }
 
-        MarkerFrame *frame = new MarkerFrame(aSMD._numMarkers, frameNum, time, aSMD._units);
+        aSMD.appendFrame(frameNum, time);
+        Vec3* frame = aSMD._markers.end() - aSMD._numMarkers;
 
       /* keep reading sets of coordinates until the end of the line is
        * reached. If more coordinates were read than there are markers,
@@ -196,7 +205,7 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
 #endif
          }
          if (coordsRead < aSMD._numMarkers)
-                frame->addMarker(coords);
+                frame[coordsRead] = coords;
          coordsRead++;
       }
 
@@ -212,10 +221,9 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
          goto cleanup;
 #endif
       }
-        aSMD._frames.append(frame);
    }
 
-   if (aSMD._frames.getSize() < aSMD._numFrames)
+   if ((int)aSMD._frameNumbers.size() < aSMD._numFrames)
    {
 #if 0
       if (gUseGlobalMessages)
@@ -224,19 +232,19 @@ void MarkerData::readTRCFile(const string& aFileName, MarkerData& aSMD)
       rc = smFileError;
       goto cleanup;
 #endif
-        aSMD._numFrames = aSMD._frames.getSize();
+        aSMD._numFrames = aSMD._frameNumbers.size();
    }
 
    /* If the user-defined frame numbers are not contiguous from the first frame to the
     * last, reset them to a contiguous array. This is necessary because the user-defined
     * numbers are used to index the array of frames.
     */
-    if (aSMD._frames[aSMD._numFrames-1]->getFrameNumber() - aSMD._frames[0]->getFrameNumber() !=
+    if (aSMD._frameNumbers[aSMD._numFrames-1] - aSMD._frameNumbers[0] !=
          aSMD._numFrames - 1)
    {
-        int firstIndex = aSMD._frames[0]->getFrameNumber();
+        int firstIndex = aSMD._frameNumbers[0];
       for (int i = 1; i < aSMD._numFrames; i++)
-            aSMD._frames[i]->setFrameNumber(firstIndex + i);
+            aSMD._frameNumbers[i] = firstIndex + i;
    }
 
 #if 0
@@ -512,23 +520,65 @@ void MarkerData::readStoFile(const string& aFileName)
     _fileName = aFileName;
     _units = Units(Units::Meters);
 
-    double time;
     int sz = store.getSize();
+    _frameNumbers.reserve(sz);
+    _frameTimes.reserve(sz);
+    _markers.reserve(sz*_numMarkers);
     for (int i=0; i < sz; i++){
         StateVector* nextRow = store.getStateVector(i);
-        time = nextRow->getTime();
-        int frameNum = i+1;
-        MarkerFrame *frame = new MarkerFrame(_numMarkers, frameNum, time, _units);
+        appendFrame(i+1, nextRow->getTime());
+        Vec3* frame = _markers.begin() + i*_numMarkers;
         const Array<double>& rowData = nextRow->getData();
         // Cycle through map and add Marker coordinates to the frame. Same order as header.
+        int j = 0;
         for (iter = markerIndices.begin(); iter != markerIndices.end(); iter++) {
             int startIndex = iter->first; // startIndex includes time but data doesn't!
-            frame->addMarker(SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]));
+            frame[j++] = SimTK::Vec3(rowData[startIndex-1], rowData[startIndex], rowData[startIndex+1]);
         }
-        _frames.append(frame);
    }
    
 }
+//_____________________________________________________________________________
+/**
+ * Read the 3D points of a C3D file. The points are decoded straight from the
+ * (memory-mapped) file into the marker array, in the units of the file;
+ * points not visible in a frame are NaN, as missing markers of a TRC file
+ * are.
+ *
+ * @param aFileName name of C3D file.
+ */
+void MarkerData::readC3DFile(const string& aFileName)
+{
+    C3DFile c3d(aFileName);
+    if (c3d.getNumPoints() == 0)
+        throw Exception("MarkerData.readC3DFile: ERROR- No points in file " + aFileName,__FILE__,__LINE__);
+
+    _numMarkers = c3d.getNumPoints();
+    _numFrames = c3d.getNumFrames();
+    _firstFrameNumber = c3d.getFirstFrame();
+    _dataRate = c3d.getPointRate();
+    _cameraRate = _dataRate;
+    _originalDataRate = _dataRate;
+    _originalStartFrame = _firstFrameNumber;
+    _originalNumFrames = _numFrames;
+    _fileName = aFileName;
+    _units = Units(c3d.getPointUnits());
+
+    const std::vector<std::string>& labels = c3d.getPointLabels();
+    for (int i = 0; i < _numMarkers; i++)
+        _markerNames.append(labels[i]);
+
+    _frameNumbers.reserve(_numFrames);
+    _frameTimes.reserve(_numFrames);
+    _markers.reserve(_numFrames*_numMarkers);
+    for (int i = 0; i < _numFrames; i++) {
+        const int frameNum = _firstFrameNumber + i;
+        appendFrame(frameNum, (frameNum - 1)/_dataRate);
+        Vec3* frame = _markers.begin() + i*_numMarkers;
+        for (int j = 0; j < _numMarkers; j++)
+            frame[j] = c3d.getPoint(i, j);
+    }
+}
 /**
  * Helper function to check column labels of passed in Storage for possibly being a MarkerName, and if true
  * add the start index and corresponding name to the passed in std::map
@@ -555,6 +605,21 @@ void MarkerData::buildMarkerMap(const Storage& storageToReadFrom, std::map<int,
     }
 }
 
+//_____________________________________________________________________________
+/**
+ * Append a frame with all of its markers missing (NaN), to be filled in.
+ *
+ * @param aFrameNumber the frame number
+ * @param aTime the time of the frame
+ */
+void MarkerData::appendFrame(int aFrameNumber, double aTime)
+{
+    _frameNumbers.push_back(aFrameNumber);
+    _frameTimes.push_back(aTime);
+    // insert() grows the capacity geometrically, unlike resize()
+    _markers.insert(_markers.end(), _numMarkers, Vec3(SimTK::NaN));
+}
+
 //=============================================================================
 // UTILITY
 //=============================================================================
@@ -582,7 +647,7 @@ void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartF
 
     for (i = _numFrames - 1; i >= 0 ; i--)
     {
-        if (_frames[i]->getFrameTime() <= aStartTime)
+        if (_frameTimes[i] <= aStartTime)
         {
             rStartFrame = i;
             break;
@@ -591,7 +656,7 @@ void MarkerData::findFrameRange(double aStartTime, double aEndTime, int& rStartF
 
     for (i = rStartFrame; i < _numFrames; i++)
     {
-        if (_frames[i]->getFrameTime() >= aEndTime - SimTK::Zero)
+        if (_frameTimes[i] >= aEndTime - SimTK::Zero)
         {
             rEndFrame = i;
             break;
@@ -610,7 +675,7 @@ double MarkerData::getStartFrameTime() const
     if (_numFrames<=0)
         return SimTK::NaN;
 
-    return(_frames[0]->getFrameTime());
+    return(_frameTimes[0]);
 
 }
 /**
@@ -623,7 +688,7 @@ double MarkerData::getLastFrameTime() const
     if (_numFrames<=0)
         return SimTK::NaN;
 
-    return(_frames[_numFrames-1]->getFrameTime());
+    return(_frameTimes[_numFrames-1]);
 }
 
 //_____________________________________________________________________________
@@ -650,7 +715,7 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
     double *minX = NULL, *minY = NULL, *minZ = NULL, *maxX = NULL, *maxY = NULL, *maxZ = NULL;
 
     findFrameRange(aStartTime, aEndTime, startIndex, endIndex);
-    MarkerFrame *averagedFrame = new MarkerFrame(*_frames[startIndex]);
+    SimTK::Array_<Vec3> averagedFrame(_numMarkers);
 
     /* If aThreshold is greater than zero, then calculate
      * the movement of each marker so you can check if it
@@ -679,15 +744,15 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
     for (int i = 0; i < _numMarkers; i++)
     {
         int numFrames = 0;
-        Vec3& avePt = averagedFrame->updMarker(i);
+        Vec3& avePt = averagedFrame[i];
         avePt = Vec3(0);
 
         for (int j = startIndex; j <= endIndex; j++)
         {
-            Vec3& pt = _frames[j]->updMarker(i);
+            const Vec3& pt = getMarker(j, i);
             if (!pt.isNaN())
             {
-                Vec3& coords = pt; //.get();
+                const Vec3& coords = pt; //.get();
                 avePt += coords;
                 numFrames++;
                 if (aThreshold > 0.0)
@@ -718,20 +783,24 @@ void MarkerData::averageFrames(double aThreshold, double aStartTime, double aEnd
     /* Store the indices from the file of the first frame and
      * last frame that were averaged, so you can report them later.
      */
-    int startUserIndex = _frames[startIndex]->getFrameNumber();
-    int endUserIndex = _frames[endIndex]->getFrameNumber();
+    int startUserIndex = _frameNumbers[startIndex];
+    int endUserIndex = _frameNumbers[endIndex];
 
-    /* Now delete all the existing frames and insert the averaged one. */
-    _frames.clearAndDestroy();
-    _frames.append(averagedFrame);
+    /* Now replace all the existing frames with the averaged one, which
+     * keeps the time and number of the startIndex frame.
+     */
+    const double startTime = _frameTimes[startIndex];
+    _markers = averagedFrame;
+    _frameNumbers.assign(1, startUserIndex);
+    _frameTimes.assign(1, startTime);
     _numFrames = 1;
-    _firstFrameNumber = _frames[0]->getFrameNumber();
+    _firstFrameNumber = startUserIndex;
 
     if (aThreshold > 0.0)
     {
         for (int i = 0; i < _numMarkers; i++)
         {
-            Vec3& pt = _frames[0]->updMarker(i);
+            const Vec3& pt = _markers[i];
 
             if (pt.isNaN())
             {
@@ -788,24 +857,14 @@ void MarkerData::makeRdStorage(Storage& rStorage)
     }
     rStorage.setColumnLabels(columnLabels);
 
-    /* Store the marker coordinates in an array of doubles
-     * and add it to the Storage.
+    /* The marker coordinates of a frame are already a row of
+     * doubles (X1 Y1 Z1 X2 Y2 Z2 ...), so add them to the Storage.
      */
     int numColumns = _numMarkers * 3;
-    double* row = new double [numColumns];
+    if (numColumns == 0) return;
 
     for (int i = 0; i < _numFrames; i++)
-    {
-        for (int j = 0, index = 0; j < _numMarkers; j++)
-        {
-            SimTK::Vec3& marker = _frames[i]->updMarker(j);
-            for (int k = 0; k < 3; k++)
-                row[index++] = marker[k];
-        }
-        rStorage.append(_frames[i]->getFrameTime(), numColumns, row);
-    }
-
-    delete [] row;
+        rStorage.append(_frameTimes[i], numColumns, &getMarker(i, 0)[0]);
 }
 
 //_____________________________________________________________________________
@@ -823,8 +882,8 @@ void MarkerData::convertToUnits(const Units& aUnits)
     if (!SimTK::isNaN(scaleFactor))
     {
         /* Scale all marker locations by the conversion factor. */
-        for (int i = 0; i < _frames.getSize(); i++)
-            _frames[i]->scale(scaleFactor);
+        for (unsigned i = 0; i < _markers.size(); i++)
+            _markers[i] *= scaleFactor;
 
         /* Change the units for this object to the new ones. */
         _units = aUnits;
@@ -838,17 +897,20 @@ void MarkerData::convertToUnits(const Units& aUnits)
 //=============================================================================
 //_____________________________________________________________________________
 /**
- * Get a frame of marker data.
+ * Get a frame of marker data. The frame is a view of the markers of this
+ * MarkerData; it is valid until averageFrames() is called or this
+ * MarkerData is destroyed, and the markers cannot be changed through it.
  *
  * @param aIndex index of the row to get.
- * @return Pointer to the frame of data.
+ * @return The frame of data.
  */
-const MarkerFrame& MarkerData::getFrame(int aIndex) const
+const MarkerFrame MarkerData::getFrame(int aIndex) const
 {
     if (aIndex < 0 || aIndex >= _numFrames)
         throw Exception("MarkerData::getFrame() invalid frame index.");
 
-    return *_frames[aIndex];
+    return MarkerFrame(_numMarkers, _frameNumbers[aIndex], _frameTimes[aIndex],
+                       _units, _markers.cbegin() + aIndex*_numMarkers);
 }
 
 //_____________________________________________________________________________
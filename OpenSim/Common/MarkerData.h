@@ -39,7 +39,13 @@ namespace OpenSim {
 //=============================================================================
 //=============================================================================
 /**
- * A class implementing a sequence of marker frames from a TRC/TRB file.
+ * A class implementing a sequence of marker frames from a TRC/TRB, STO or
+ * C3D file.
+ *
+ * The coordinates of all markers in all frames are stored in one contiguous
+ * array, frame after frame, so memory use is proportional to the data and
+ * reading a file does not allocate per frame. getFrame() returns a view of
+ * one frame of that array.
  *
  * @author Peter Loan
  * @version 1.0
@@ -62,7 +68,11 @@ private:
     std::string _fileName;
     Units _units;
     Array<std::string> _markerNames;
-    ArrayPtrs<MarkerFrame> _frames;
+    // Marker coordinates, _numMarkers per frame, and the number and time of
+    // each frame.
+    SimTK::Array_<SimTK::Vec3> _markers;
+    SimTK::Array_<int> _frameNumbers;
+    SimTK::Array_<double> _frameTimes;
 
 //=============================================================================
 // METHODS
@@ -79,7 +89,13 @@ public:
     void averageFrames(double aThreshold = -1.0, double aStartTime = -SimTK::Infinity, double aEndTime = SimTK::Infinity);
     const std::string& getFileName() const { return _fileName; }
     void makeRdStorage(Storage& rStorage);
-    const MarkerFrame& getFrame(int aIndex) const;
+    const MarkerFrame getFrame(int aIndex) const;
+    const SimTK::Vec3& getMarker(int aFrameIndex, int aMarkerIndex) const {
+        return _markers[aFrameIndex*_numMarkers + aMarkerIndex];
+    }
+    double getFrameTime(int aFrameIndex) const {
+        return _frameTimes[aFrameIndex];
+    }
     int getMarkerIndex(const std::string& aName) const;
     const Units& getUnits() const { return _units; }
     void convertToUnits(const Units& aUnits);
@@ -96,7 +112,9 @@ private:
     void readTRCFileHeader(std::ifstream &in, const std::string& aFileName, MarkerData& aSMD);
     void readTRBFile(const std::string& aFileName, MarkerData& aSMD);
     void readStoFile(const std::string& aFileName);
+    void readC3DFile(const std::string& aFileName);
     void buildMarkerMap(const Storage& storageToReadFrom, std::map<int, std::string>& markerNames);
+    void appendFrame(int aFrameNumber, double aTime);
 
 //=============================================================================
 };  // END of class MarkerData
@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "MarkerFrame.h"
+#include "Exception.h"
 
 //=============================================================================
 // STATICS
@@ -65,6 +66,29 @@ MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units&
     setNull();
 }
 
+//_____________________________________________________________________________
+/**
+ * Constructor of a view of markers stored elsewhere. The markers are not
+ * copied, so they must outlive the frame; markers cannot be added to it.
+ *
+ * @param aNumMarkers the number of markers in the frame
+ * @param aFrameNumber the frame number
+ * @param aTime the time of the frame
+ * @param aUnits the units of the XYZ marker coordinates
+ * @param aMarkers the XYZ coordinates of the markers
+ */
+MarkerFrame::MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime,
+                         const Units& aUnits, const SimTK::Vec3* aMarkers) :
+    _numMarkers(aNumMarkers),
+    _frameNumber(aFrameNumber),
+    _frameTime(aTime),
+    _units(aUnits),
+    _markers(const_cast<SimTK::Vec3*>(aMarkers), aMarkers + aNumMarkers,
+             SimTK::DontCopy())
+{
+    setNull();
+}
+
 /**
  * Copy constructor.
  */
@@ -80,6 +104,28 @@ MarkerFrame::MarkerFrame(const MarkerFrame& aFrame) :
     _markers = aFrame._markers;
 }
 
+//_____________________________________________________________________________
+/**
+ * Assignment operator. The markers are copied, also when this frame is a
+ * view, which then holds its own markers rather than writing to the ones
+ * it viewed.
+ */
+MarkerFrame& MarkerFrame::operator=(const MarkerFrame& aFrame)
+{
+    Object::operator=(aFrame);
+
+    _numMarkers = aFrame._numMarkers;
+    _frameNumber = aFrame._frameNumber;
+    _frameTime = aFrame._frameTime;
+    _units = aFrame._units;
+    if (&aFrame != this) {
+        _markers.deallocate();
+        _markers = aFrame._markers;
+    }
+
+    return *this;
+}
+
 //_____________________________________________________________________________
 /**
  * Destructor.
@@ -100,6 +146,20 @@ void MarkerFrame::setNull()
     setAuthors("Peter Loan");
 }
 
+//_____________________________________________________________________________
+/**
+ * Throw an exception if this frame is a view, whose markers cannot be
+ * changed.
+ *
+ * @param aMethod the name of the method changing the markers
+ */
+void MarkerFrame::throwIfView(const std::string& aMethod) const
+{
+    if (isView())
+        throw Exception("MarkerFrame::" + aMethod + "() cannot change the "
+                        "markers of a view of another frame's markers.");
+}
+
 //=============================================================================
 // UTILITY
 //=============================================================================
@@ -111,6 +171,7 @@ void MarkerFrame::setNull()
  */
 void MarkerFrame::addMarker(const SimTK::Vec3& aCoords)
 {
+    throwIfView("addMarker");
     //SimmPoint* pt = new SimmPoint(aCoords);
     _markers.push_back(aCoords);
 }
@@ -126,6 +187,7 @@ void MarkerFrame::addMarker(const SimTK::Vec3& aCoords)
  */
 void MarkerFrame::scale(double aScaleFactor)
 {
+    throwIfView("scale");
     for (int i = 0; i < _numMarkers; i++)
     {
         //SimTK::Vec3& pt = _markers[i]->get();
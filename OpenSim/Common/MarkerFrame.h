@@ -39,6 +39,12 @@ namespace OpenSim {
 /**
  * A class implementing a frame of marker data from a TRC/TRB file.
  *
+ * A frame either holds its own markers or is a view of markers stored
+ * elsewhere, as the frames returned by MarkerData::getFrame() are. A view is
+ * valid as long as the markers it views are, and its markers cannot be
+ * changed through it: updMarker(), addMarker() and scale() throw. Copying a
+ * frame, or assigning one to a view, always copies the markers.
+ *
  * @author Peter Loan
  * @version 1.0
  */
@@ -64,21 +70,30 @@ private:
 public:
     MarkerFrame();
     MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime, Units& aUnits);
+    MarkerFrame(int aNumMarkers, int aFrameNumber, double aTime,
+                const Units& aUnits, const SimTK::Vec3* aMarkers);
     MarkerFrame(const MarkerFrame& aFrame);
     virtual ~MarkerFrame();
+#ifndef SWIG
+    MarkerFrame& operator=(const MarkerFrame& aFrame);
+#endif
 
     void addMarker(const SimTK::Vec3& aCoords);
     SimTK::Vec3 getMarker(int aIndex) const { return _markers[aIndex]; }
-    SimTK::Vec3& updMarker(int aIndex) { return _markers[aIndex]; }
+    SimTK::Vec3& updMarker(int aIndex)
+    {   throwIfView("updMarker"); return _markers[aIndex]; }
     int getFrameNumber() const { return _frameNumber; }
     void setFrameNumber(int aNumber) { _frameNumber = aNumber; }
     double getFrameTime() const { return _frameTime; }
     void scale(double aScaleFactor);
 
     const SimTK::Array_<SimTK::Vec3>& getMarkers() const { return _markers;}
+    /** Whether this frame is a view of markers stored elsewhere. */
+    bool isView() const { return !_markers.isOwner(); }
 
 private:
     void setNull();
+    void throwIfView(const std::string& aMethod) const;
 
 //=============================================================================
 };  // END of class MarkerFrame
@@ -60,9 +60,35 @@ std::map<string,Object*>    Object::_mapTypesToDefaultObjects;
 std::map<string,string>     Object::_renamedTypesMap;
 
 bool                        Object::_serializeAllDefaults=false;
+bool                        Object::_deserializeLazily=false;
 const string                Object::DEFAULT_NAME(ObjectDEFAULT_NAME);
 int                         Object::_debugLevel = 0;
 
+//=============================================================================
+// LAZY DESERIALIZATION
+//=============================================================================
+// A copy of the XML element of an object whose properties have not been read
+// yet, along with what is needed to read it later as it would have been read
+// now. The copy is an orphan owned by this struct so that it outlives the
+// document (and any temporary element) it was read from.
+struct Object::PendingProperties {
+    PendingProperties(const SimTK::Xml::Element& aNode, int aVersionNumber,
+                      const string& aDirectory)
+    :   element(aNode.clone()), versionNumber(aVersionNumber),
+        directory(aDirectory) {}
+    ~PendingProperties() { element.clearOrphan(); }
+
+    SimTK::Xml::Element element;
+    int                 versionNumber;
+    // File names in the XML are relative to the directory that was current
+    // when the object was read.
+    string              directory;
+
+private:
+    PendingProperties(const PendingProperties&);
+    PendingProperties& operator=(const PendingProperties&);
+};
+
 //=============================================================================
 // CONSTRUCTOR(S)
 //=============================================================================
@@ -210,6 +236,13 @@ operator=(const Object& source)
         _authors        = source._authors;
         _references     = source._references;
         _propertyTable  = source._propertyTable;
+        // A copy of a lazily read object reads its own copy of the XML.
+        _pendingProperties.reset();
+        if (source._pendingProperties) {
+            const PendingProperties& pending = *source._pendingProperties;
+            _pendingProperties = std::make_shared<PendingProperties>(
+                pending.element, pending.versionNumber, pending.directory);
+        }
 
         delete _document; _document = NULL;
         _inlined = true; // meaning: not associated to an XML document
@@ -230,6 +263,7 @@ setNull()
 {
     _propertySet.clear();
     _propertyTable.clear();
+    _pendingProperties.reset();
     _objectIsUpToDate = false;
 
     _name           = "";
@@ -405,6 +439,7 @@ getPropertyByIndex(int propertyIndex) const {
     }
     // ... to here.
 
+    if (_pendingProperties) readPendingProperties();
     return _propertyTable.getAbstractPropertyByIndex(propertyIndex);
 }
 
@@ -426,6 +461,7 @@ updPropertyByIndex(int propertyIndex) {
     }
     // ... to here.
 
+    if (_pendingProperties) readPendingProperties();
     return _propertyTable.updAbstractPropertyByIndex(propertyIndex);
 }
 
@@ -450,6 +486,7 @@ hasProperty(const std::string& name) const {
 
 const AbstractProperty& Object::
 getPropertyByName(const std::string& name) const {
+    if (_pendingProperties) readPendingProperties();
     const AbstractProperty* p = _propertyTable.getPropertyPtr(name);
     if (p) return *p;
 
@@ -468,6 +505,7 @@ updPropertyByName(const std::string& name) {
     // A property is being modified.
     _objectIsUpToDate = false;
 
+    if (_pendingProperties) readPendingProperties();
     AbstractProperty* p = _propertyTable.updPropertyPtr(name);
     if (p) return *p;
 
@@ -806,6 +844,10 @@ UpdateXMLNodeTransform(const Property_Deprecated*   aProperty,
 void Object::updateFromXMLNode(SimTK::Xml::Element& aNode, int versionNumber)
 {
 try {
+    // Values read by an earlier, lazy, call come first; this call only
+    // overrides the properties that appear in aNode.
+    if (_pendingProperties) readPendingProperties();
+
     // NAME
     const string dName = 
         aNode.getOptionalAttributeValueAs<std::string>("name", "");
@@ -816,11 +858,12 @@ try {
     // UPDATE DEFAULT OBJECTS
     updateDefaultObjectsFromXMLNode(); // May need to pass in aNode
 
-    // LOOP THROUGH PROPERTIES
-    for(int i=0; i < _propertyTable.getNumProperties(); ++i) {
-        AbstractProperty& prop = _propertyTable.updAbstractPropertyByIndex(i);
-        prop.readFromXMLParentElement(aNode, versionNumber);
-    }
+    // PROPERTIES
+    if (_deserializeLazily && _propertyTable.getNumProperties() > 0)
+        _pendingProperties = std::make_shared<PendingProperties>(
+            aNode, versionNumber, IO::getCwd());
+    else
+        readPropertiesFromXMLNode(aNode, versionNumber);
 
     // LOOP THROUGH DEPRECATED PROPERTIES
     // TODO: get rid of this
@@ -1003,6 +1046,37 @@ try {
 
 }
 
+void Object::
+readPropertiesFromXMLNode(SimTK::Xml::Element& aNode, int versionNumber)
+{
+    for(int i=0; i < _propertyTable.getNumProperties(); ++i) {
+        AbstractProperty& prop = _propertyTable.updAbstractPropertyByIndex(i);
+        prop.readFromXMLParentElement(aNode, versionNumber);
+    }
+}
+
+void Object::
+readPendingProperties() const
+{
+    // Release the XML before reading so that property access while reading
+    // does not come back here; it is deleted once read.
+    std::shared_ptr<PendingProperties> pending;
+    pending.swap(_pendingProperties);
+
+    // Read relative file names as they would have been read originally.
+    const string saveWorkingDirectory = IO::getCwd();
+    const bool changeDirectory = pending->directory != saveWorkingDirectory;
+    if (changeDirectory) IO::chDir(pending->directory);
+    try {
+        const_cast<Object*>(this)->readPropertiesFromXMLNode(
+            pending->element, pending->versionNumber);
+    } catch (...) {
+        if (changeDirectory) IO::chDir(saveWorkingDirectory);
+        throw;
+    }
+    if (changeDirectory) IO::chDir(saveWorkingDirectory);
+}
+
 //-----------------------------------------------------------------------------
 // UPDATE DEFAULT OBJECTS FROM XML NODE
 //-----------------------------------------------------------------------------
@@ -1064,6 +1138,8 @@ updateDefaultObjectsFromXMLNode()
 void Object::
 updateXMLNode(SimTK::Xml::Element& aParent) const
 {
+    if (_pendingProperties) readPendingProperties();
+
     // Handle non-inlined object
     if(!getInlined()) {
         // If object is not inlined we don't want to generate node in original document
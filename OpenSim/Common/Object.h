@@ -44,6 +44,7 @@
 #include <cstring>
 #include <cassert>
 #include <map>
+#include <memory>
 
 // DISABLES MULTIPLE INSTANTIATION WARNINGS
 
@@ -494,6 +495,12 @@ public:
     virtual void updateFromXMLNode(SimTK::Xml::Element& objectElement, 
                                    int                  versionNumber);
 
+    /** Return true if this %Object was deserialized lazily and the values of
+    its properties have not been read from XML yet. They are read on first
+    access to any property, or when the %Object is written out.
+    @see setDeserializeLazily() **/
+    bool hasPendingProperties() const { return (bool)_pendingProperties; }
+
     /** Serialize this object into the XML node that represents it.   
     @param      parent 
         Parent XML node of this object. Sending in a parent node allows an XML 
@@ -599,6 +606,24 @@ public:
         return _serializeAllDefaults;
     }
 
+    /** Static function to control whether objects read from XML keep the XML
+    for their (non-deprecated) properties and read it only when a property is
+    first accessed. Objects held in properties are then not created at all
+    until their owner is used, so memory use and load time are proportional
+    to the part of a large model or setup file that is actually used. Reading
+    properties on first access is not thread safe; access the properties of a
+    lazily read %Object once before sharing it among threads. Properties of
+    the deprecated kind are always read immediately. **/
+    static void setDeserializeLazily(bool shouldDeserializeLazily)
+    {
+        _deserializeLazily = shouldDeserializeLazily;
+    }
+    /** Report the value of the "deserialize lazily" flag. **/
+    static bool getDeserializeLazily()
+    {
+        return _deserializeLazily;
+    }
+
     /** Returns true if the passed-in string is "Object"; each %Object-derived
     class defines a method of this name for its own class name. **/
     static bool isKindOf(const char *type) 
@@ -775,6 +800,12 @@ private:
     void updateDefaultObjectsFromXMLNode();
     void updateDefaultObjectsXMLNode(SimTK::Xml::Element& aParent);
 
+    // Read the properties in the property table from the given element.
+    void readPropertiesFromXMLNode(SimTK::Xml::Element& aNode,
+                                   int versionNumber);
+    // Read the properties whose XML was kept by a lazy deserialization.
+    void readPendingProperties() const;
+
 
 //==============================================================================
 // DATA
@@ -816,6 +847,10 @@ private:
     // a "defaults" section.
     static bool _serializeAllDefaults;
 
+    // Global flag to indicate if property values are read from XML only when
+    // they are first accessed.
+    static bool _deserializeLazily;
+
     // Debug level: 
     //  0: Hides non fatal warnings 
     //  1: Shows illegal tags 
@@ -842,6 +877,11 @@ private:
     // is initialized to false and is only set manually.
     bool            _objectIsUpToDate;
 
+    // The XML for the properties in the property table if it has not been
+    // read yet (lazy deserialization). Null once the properties are read.
+    struct PendingProperties;
+    mutable std::shared_ptr<PendingProperties> _pendingProperties;
+
     // The XML document, if any, associated with this object.
     // This is mutable since it's cached on deserialization and is 
     // kept up to date to maintain "defaults" and document file path
@@ -878,11 +918,13 @@ hasProperty() const {
 
 template <class T> const Property<T>& Object::
 getProperty(const PropertyIndex& index) const {
+    if (_pendingProperties) readPendingProperties();
     return _propertyTable.getProperty<T>(index);
 }
 
 template <class T> Property<T>& Object::
 updProperty(const PropertyIndex& index) {
+    if (_pendingProperties) readPendingProperties();
     _objectIsUpToDate = false; // property may be changed
     return _propertyTable.updProperty<T>(index);
 }
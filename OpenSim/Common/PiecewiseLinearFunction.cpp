@@ -427,9 +427,38 @@ void PiecewiseLinearFunction::calcCoefficients()
 }
 
 double PiecewiseLinearFunction::calcValue(const Vector& x) const
+{
+    return calcScalarValue(x[0]);
+}
+
+double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+{
+    if (derivComponents.size() == 0)
+        return SimTK::NaN;
+    return calcScalarDerivative((int)derivComponents.size(), x[0]);
+}
+
+int PiecewiseLinearFunction::findInterval(double aX) const
+{
+    // Do a binary search to find which two points the abscissa is between.
+    int k, i = 0;
+    int j = _x.getSize();
+    while (1)
+    {
+        k = (i+j)/2;
+        if (aX < _x[k])
+            j = k;
+        else if (aX > _x[k+1])
+            i = k;
+        else
+            break;
+    }
+    return k;
+}
+
+double PiecewiseLinearFunction::calcScalarValue(double aX) const
 {
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0])
         return _y[0] + (aX - _x[0]) * _b[0];
@@ -445,32 +474,18 @@ double PiecewiseLinearFunction::calcValue(const Vector& x) const
     else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
         return _y[n-1];
 
-    // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
-    int j = n;
-    while (1)
-    {
-        k = (i+j)/2;
-        if (aX < _x[k])
-            j = k;
-        else if (aX > _x[k+1])
-            i = k;
-        else
-            break;
-    }
-
+    int k = findInterval(aX);
     return _y[k] + (aX - _x[k]) * _b[k];
 }
 
-double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+double PiecewiseLinearFunction::calcScalarDerivative(int derivOrder, double aX) const
 {
-    if (derivComponents.size() == 0)
-        return SimTK::NaN;
-    if (derivComponents.size() > 1)
+    if (derivOrder == 0)
+        return calcScalarValue(aX);
+    if (derivOrder > 1)
         return 0.0;
 
     int n = _x.getSize();
-    double aX = x[0];
 
     if (aX < _x[0]) {
         return _b[0];
@@ -488,21 +503,25 @@ double PiecewiseLinearFunction::calcDerivative(const std::vector<int>& derivComp
         return _b[n-1];
     }
 
-    // Do a binary search to find which two points the abscissa is between.
-    int k, i = 0;
-    int j = n;
-    while (1)
-    {
-        k = (i+j)/2;
-        if (aX < _x[k])
-            j = k;
-        else if (aX > _x[k+1])
-            i = k;
-        else
-            break;
-    }
+    return _b[findInterval(aX)];
+}
+
+SimTK::Vec3 PiecewiseLinearFunction::calcScalarValueAndDerivatives(double aX) const
+{
+    int n = _x.getSize();
+
+    if (aX < _x[0])
+        return SimTK::Vec3(_y[0] + (aX - _x[0]) * _b[0], _b[0], 0);
+    else if (aX > _x[n-1])
+        return SimTK::Vec3(_y[n-1] + (aX - _x[n-1]) * _b[n-1], _b[n-1], 0);
+
+    if (EQUAL_WITHIN_ERROR(aX, _x[0]))
+        return SimTK::Vec3(_y[0], _b[0], 0);
+    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return SimTK::Vec3(_y[n-1], _b[n-1], 0);
 
-    return _b[k];
+    int k = findInterval(aX);
+    return SimTK::Vec3(_y[k] + (aX - _x[k]) * _b[k], _b[k], 0);
 }
 
 int PiecewiseLinearFunction::getArgumentSize() const
@@ -119,6 +119,9 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const override;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const override;
+    double calcScalarValue(double x) const override;
+    double calcScalarDerivative(int derivOrder, double x) const override;
+    SimTK::Vec3 calcScalarValueAndDerivatives(double x) const override;
     int getArgumentSize() const override;
     int getMaxDerivativeOrder() const override;
     SimTK::Function* createSimTKFunction() const override;
@@ -127,6 +130,9 @@ public:
 
 private:
    void calcCoefficients();
+   // Index k of the interval [x[k], x[k+1]] containing aX, which must lie
+   // strictly between the first and last points.
+   int findInterval(double aX) const;
 
 //=============================================================================
 };  // END class PiecewiseLinearFunction
@@ -0,0 +1,401 @@
+/* -------------------------------------------------------------------------- *
+ *                           OpenSim:  Profiler.cpp                           *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "Profiler.h"
+#include "Component.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+
+// What one thread recorded for one object (while it had this name) and
+// category.
+struct ThreadEntry {
+    const Object* object;
+    const char* category;
+    string objectName;  // the object's name, to notice reuse or renaming
+    string name;        // path name, or name if it is not a Component
+    string className;
+    long long count = 0;
+    double inclusive = 0;
+    double exclusive = 0;
+};
+
+struct TraceEvent {
+    const ThreadEntry* entry;
+    Profiler::Clock::time_point start;
+    double duration;    // microseconds
+};
+
+struct ObjectCategoryHash {
+    size_t operator()(const pair<const Object*, const char*>& key) const {
+        return hash<const void*>()(key.first) ^
+               (hash<const void*>()(key.second) << 1);
+    }
+};
+
+// Each thread records into its own ThreadData, so that threads do not
+// contend for a lock while they run; its mutex is taken by other threads
+// only to merge or clear what it recorded. Entries are looked up by object
+// address, and the object's path name is resolved only when it is first
+// seen (or its address is reused by an object with another name).
+struct ThreadData {
+    mutex lock;
+    size_t thread = hash<thread::id>()(this_thread::get_id());
+    unordered_map<pair<const Object*, const char*>, ThreadEntry*,
+                  ObjectCategoryHash> index;
+    deque<ThreadEntry> entries;   // stable addresses for index and events
+    vector<TraceEvent> events;
+
+    void clear() {
+        index.clear();
+        events.clear();
+        entries.clear();
+    }
+};
+
+// Keep traces of very long runs from exhausting memory.
+const size_t MAX_TRACE_EVENTS = 2000000;
+
+struct ProfilerData {
+    mutex lock;
+    // Every thread that has recorded since it was last cleared; the data of
+    // threads that have exited is kept until then.
+    vector<shared_ptr<ThreadData> > threads;
+    string traceFileName;
+    atomic<bool> tracing;
+    atomic<size_t> numEvents;
+    Profiler::Clock::time_point epoch = Profiler::Clock::now();
+    int regionDepth = 0;
+
+    ProfilerData() : tracing(false), numEvents(0) {
+        const char* trace = getenv("OPENSIM_PROFILE_TRACE");
+        if (trace) traceFileName = trace;
+        tracing = !traceFileName.empty();
+    }
+};
+
+ProfilerData& data() {
+    static ProfilerData d;
+    return d;
+}
+
+// The innermost active Scope on this thread.
+thread_local Profiler::Scope* currentScope = nullptr;
+
+ThreadData& threadData() {
+    thread_local shared_ptr<ThreadData> local;
+    if (!local) {
+        local = make_shared<ThreadData>();
+        ProfilerData& d = data();
+        lock_guard<mutex> guard(d.lock);
+        d.threads.push_back(local);
+    }
+    return *local;
+}
+
+// Objects are merged by path name (or name), since an address may be
+// reused by another object; categories by their text so that equal
+// literals in different translation units are merged.
+struct Key {
+    string name;
+    const char* category;
+    bool operator<(const Key& other) const {
+        int c = name.compare(other.name);
+        if (c != 0) return c < 0;
+        return strcmp(category, other.category) < 0;
+    }
+};
+
+struct Entry {
+    string className;
+    long long count = 0;
+    double inclusive = 0;
+    double exclusive = 0;
+};
+
+// Merge what all threads recorded. Must be called with d.lock held.
+map<Key, Entry> merge(ProfilerData& d) {
+    map<Key, Entry> merged;
+    for (const auto& t : d.threads) {
+        lock_guard<mutex> guard(t->lock);
+        for (const ThreadEntry& te : t->entries) {
+            Key key = { te.name, te.category };
+            Entry& entry = merged[key];
+            entry.className = te.className;
+            entry.count += te.count;
+            entry.inclusive += te.inclusive;
+            entry.exclusive += te.exclusive;
+        }
+    }
+    return merged;
+}
+
+// JSON strings must not contain unescaped quotes or backslashes.
+string escapeJSON(const string& s) {
+    string out;
+    out.reserve(s.size());
+    for (char c : s) {
+        if (c == '"' || c == '\\') out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+// The name an object's calls are recorded under.
+string nameOf(const Object& object) {
+    const Component* component = dynamic_cast<const Component*>(&object);
+    if (component && !component->getPathName().empty())
+        return component->getPathName();
+    return object.getName();
+}
+
+// Must be called with d.lock held. Threads that have exited are forgotten.
+void clear(ProfilerData& d) {
+    vector<shared_ptr<ThreadData> > running;
+    for (const auto& t : d.threads) {
+        if (t.use_count() == 1) continue;
+        lock_guard<mutex> guard(t->lock);
+        t->clear();
+        running.push_back(t);
+    }
+    d.threads.swap(running);
+    d.numEvents = 0;
+    d.epoch = Profiler::Clock::now();
+}
+
+} // anonymous namespace
+
+std::atomic<bool> Profiler::_enabled(getenv("OPENSIM_PROFILE") != nullptr);
+
+//=============================================================================
+// SETTINGS
+//=============================================================================
+void Profiler::setEnabled(bool enabled)
+{
+    _enabled = enabled;
+}
+
+void Profiler::setTraceFileName(const std::string& fileName)
+{
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    d.traceFileName = fileName;
+    d.tracing = !fileName.empty();
+}
+
+std::string Profiler::getTraceFileName()
+{
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    return d.traceFileName;
+}
+
+void Profiler::reset()
+{
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    clear(d);
+}
+
+long long Profiler::getNumCalls(const std::string& objectName,
+                                const std::string& category)
+{
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    long long count = 0;
+    for (const auto& t : d.threads) {
+        lock_guard<mutex> threadGuard(t->lock);
+        for (const ThreadEntry& te : t->entries) {
+            if (te.name == objectName && category == te.category)
+                count += te.count;
+        }
+    }
+    return count;
+}
+
+//=============================================================================
+// RECORDING
+//=============================================================================
+Profiler::Scope::Scope(const Object& object, const char* category) :
+    _object(nullptr), _category(category), _childTime(0), _parent(nullptr)
+{
+    if (!_enabled) return;
+    _object = &object;
+    _parent = currentScope;
+    currentScope = this;
+    _start = Clock::now();
+}
+
+Profiler::Scope::~Scope()
+{
+    if (!_object) return;
+    Clock::time_point end = Clock::now();
+    double inclusive = chrono::duration<double>(end - _start).count();
+    currentScope = _parent;
+    if (_parent) _parent->_childTime += inclusive;
+    record(*this, end, inclusive, inclusive - _childTime);
+}
+
+void Profiler::record(const Scope& scope, Clock::time_point end,
+                      double inclusive, double exclusive)
+{
+    ThreadData& t = threadData();
+    lock_guard<mutex> guard(t.lock);
+    ThreadEntry*& entry = t.index[make_pair(scope._object, scope._category)];
+    if (!entry || entry->objectName != scope._object->getName()) {
+        t.entries.push_back(ThreadEntry());
+        entry = &t.entries.back();
+        entry->object = scope._object;
+        entry->category = scope._category;
+        entry->objectName = scope._object->getName();
+        entry->name = nameOf(*scope._object);
+        entry->className = scope._object->getConcreteClassName();
+    }
+    ++entry->count;
+    entry->inclusive += inclusive;
+    entry->exclusive += exclusive;
+
+    ProfilerData& d = data();
+    if (d.tracing && d.numEvents++ < MAX_TRACE_EVENTS) {
+        TraceEvent event;
+        event.entry = entry;
+        event.start = scope._start;
+        event.duration = chrono::duration<double, micro>(
+                end - scope._start).count();
+        t.events.push_back(event);
+    }
+}
+
+Profiler::Region::Region(const std::string& name) : _name(name),
+    _active(_enabled)
+{
+    if (!_active) return;
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    if (d.regionDepth++ == 0) clear(d);
+}
+
+Profiler::Region::~Region()
+{
+    if (!_active) return;
+    ProfilerData& d = data();
+    string traceFileName;
+    {
+        lock_guard<mutex> guard(d.lock);
+        if (--d.regionDepth > 0) return;
+        traceFileName = d.traceFileName;
+    }
+    cout << "\nProfile of " << _name << ":" << endl;
+    printReport(cout);
+    if (!traceFileName.empty()) {
+        if (printChromeTrace(traceFileName))
+            cout << "Wrote profiler trace to " << traceFileName << endl;
+        else
+            cerr << "Profiler: could not write " << traceFileName << endl;
+    }
+}
+
+//=============================================================================
+// OUTPUT
+//=============================================================================
+void Profiler::printReport(std::ostream& out)
+{
+    ProfilerData& d = data();
+    map<Key, Entry> entries;
+    {
+        lock_guard<mutex> guard(d.lock);
+        entries = merge(d);
+    }
+
+    typedef pair<const Key*, const Entry*> Row;
+    vector<Row> rows;
+    double totalExclusive = 0;
+    for (const auto& kv : entries) {
+        rows.push_back(Row(&kv.first, &kv.second));
+        totalExclusive += kv.second.exclusive;
+    }
+    sort(rows.begin(), rows.end(), [](const Row& a, const Row& b) {
+        return a.second->exclusive > b.second->exclusive; });
+
+    out << left << setw(40) << "component" << setw(28) << "class"
+        << setw(26) << "category" << right << setw(12) << "calls"
+        << setw(14) << "incl [s]" << setw(14) << "excl [s]"
+        << setw(8) << "excl %" << "\n";
+    for (const Row& row : rows) {
+        const Entry& e = *row.second;
+        out << left << setw(40) << row.first->name << setw(28) << e.className
+            << setw(26) << row.first->category << right << setw(12)
+            << e.count << scientific << setprecision(3)
+            << setw(14) << e.inclusive << setw(14) << e.exclusive
+            << fixed << setprecision(1) << setw(8)
+            << (totalExclusive > 0 ? 100*e.exclusive/totalExclusive : 0.0)
+            << "\n";
+        out.unsetf(ios::floatfield);
+    }
+    out << "Total profiled (exclusive) time: " << totalExclusive << " s"
+        << endl;
+}
+
+bool Profiler::printChromeTrace(const std::string& fileName)
+{
+    ofstream out(fileName.c_str());
+    if (!out) return false;
+
+    ProfilerData& d = data();
+    lock_guard<mutex> guard(d.lock);
+    out << "{\"traceEvents\":[\n";
+    out << fixed << setprecision(3);
+    bool first = true;
+    for (const auto& t : d.threads) {
+        lock_guard<mutex> threadGuard(t->lock);
+        for (const TraceEvent& e : t->events) {
+            out << (first ? "" : ",\n")
+                << "{\"name\":\"" << escapeJSON(e.entry->name)
+                << "\",\"cat\":\"" << e.entry->category << "\",\"ph\":\"X\""
+                << ",\"ts\":" << chrono::duration<double, micro>(
+                        e.start - d.epoch).count()
+                << ",\"dur\":" << e.duration
+                << ",\"pid\":0,\"tid\":" << t->thread << "}";
+            first = false;
+        }
+    }
+    out << "\n],\"displayTimeUnit\":\"ms\"}\n";
+    return true;
+}
@@ -0,0 +1,158 @@
+#ifndef OPENSIM_PROFILER_H_
+#define OPENSIM_PROFILER_H_
+/* -------------------------------------------------------------------------- *
+ *                            OpenSim:  Profiler.h                            *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <atomic>
+#include <chrono>
+#include <iosfwd>
+#include <string>
+
+namespace OpenSim {
+
+class Object;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Accumulates call counts and wall-clock time spent by each Object (usually
+ * a Component, identified by its path name, otherwise by its name) in each
+ * category of work (a realize stage, computeForce,
+ * computeControls, Analysis::step, ...), so that the components responsible
+ * for a slow simulation can be identified.
+ *
+ * Instrumentation is placed with the OPENSIM_PROFILE_SCOPE() and
+ * OPENSIM_PROFILE_REGION() macros, which expand to nothing unless OpenSim is
+ * built with the CMake option OPENSIM_WITH_PROFILING (which defines
+ * OPENSIM_PROFILING). Even when compiled in, nothing is recorded until
+ * profiling is enabled with setEnabled(true) or by setting the environment
+ * variable OPENSIM_PROFILE.
+ *
+ * Time is reported both inclusive (everything done within the scope) and
+ * exclusive (minus the time of nested profiled scopes on the same thread).
+ * Each thread records its calls separately, keyed by object address, so
+ * that a profiled scope neither takes a shared lock nor looks up the path
+ * name of its object; what the threads recorded is merged, by path name,
+ * when it is reported.
+ * Everything recorded before is discarded when an outermost region, e.g.
+ * Manager::integrate() or a Tool's run(), begins. When it ends, a report of
+ * that region sorted by exclusive time is printed and, if a trace file
+ * name was set (or the environment variable OPENSIM_PROFILE_TRACE is set),
+ * the individual calls are written in the Chrome trace event format, which
+ * can be viewed in chrome://tracing.
+ *
+ * @code
+ * Profiler::setEnabled(true);
+ * Profiler::setTraceFileName("integrate_trace.json");
+ * manager.integrate(state);   // prints the report when done
+ * @endcode
+ */
+class OSIMCOMMON_API Profiler {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    /** Whether calls are currently being recorded. */
+    static bool isEnabled() { return _enabled.load(); }
+    static void setEnabled(bool enabled);
+
+    /** Write a Chrome trace of the recorded calls to this file when the
+    outermost region ends. An empty name (the default) disables tracing. */
+    static void setTraceFileName(const std::string& fileName);
+    static std::string getTraceFileName();
+
+    /** Discard everything recorded so far. */
+    static void reset();
+
+    /** Number of calls recorded for an object (by path name, or name if it
+    is not a Component) in a category. */
+    static long long getNumCalls(const std::string& objectName,
+                                 const std::string& category);
+
+    /** Print the accumulated statistics, one line per object and category,
+    sorted by decreasing exclusive time. */
+    static void printReport(std::ostream& out);
+    /** Write the recorded calls as Chrome trace event JSON.
+    @return false if the file could not be opened. */
+    static bool printChromeTrace(const std::string& fileName);
+
+    /** Times the enclosing block as work of the given category done by
+    object. category must be a string literal (or otherwise outlive the
+    Profiler's records). */
+    class OSIMCOMMON_API Scope {
+    public:
+        Scope(const Object& object, const char* category);
+        ~Scope();
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+        friend class Profiler;
+
+        const Object* _object;
+        const char* _category;
+        Clock::time_point _start;
+        double _childTime;
+        Scope* _parent;
+    };
+
+    /** Marks an outer unit of work (e.g. an integration or a Tool run). The
+    outermost Region starts recording afresh; the report is printed, and the
+    trace written, when it ends. */
+    class OSIMCOMMON_API Region {
+    public:
+        explicit Region(const std::string& name);
+        ~Region();
+    private:
+        Region(const Region&);
+        Region& operator=(const Region&);
+
+        std::string _name;
+        bool _active;
+    };
+
+private:
+    static void record(const Scope& scope, Clock::time_point end,
+                       double inclusive, double exclusive);
+
+    static std::atomic<bool> _enabled;
+};
+
+} // namespace OpenSim
+
+#define OPENSIM_PROFILE_CONCAT_(a, b) a##b
+#define OPENSIM_PROFILE_CONCAT(a, b) OPENSIM_PROFILE_CONCAT_(a, b)
+
+#ifdef OPENSIM_PROFILING
+/** Profile the rest of the enclosing block as category work of object. */
+#define OPENSIM_PROFILE_SCOPE(object, category)                               \
+    OpenSim::Profiler::Scope OPENSIM_PROFILE_CONCAT(osimProfScope_, __LINE__) \
+        ((object), (category))
+/** Mark the rest of the enclosing block as a profiled region. */
+#define OPENSIM_PROFILE_REGION(name)                                          \
+    OpenSim::Profiler::Region OPENSIM_PROFILE_CONCAT(osimProfRegion_,__LINE__)\
+        ((name))
+#else
+#define OPENSIM_PROFILE_SCOPE(object, category)
+#define OPENSIM_PROFILE_REGION(name)
+#endif
+
+#endif // OPENSIM_PROFILER_H_
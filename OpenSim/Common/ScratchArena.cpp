@@ -0,0 +1,65 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  ScratchArena.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "ScratchArena.h"
+#include <algorithm>
+
+using namespace OpenSim;
+using namespace std;
+
+// The block always holds at least one double so that allocate() never
+// returns null, which callers such as Storage::append() treat as no data.
+ScratchArena::ScratchArena(size_t aSize) :
+    _block(max(aSize, size_t(1))),
+    _used(0),
+    _overflowUsed(0)
+{
+}
+
+void ScratchArena::reserve(size_t aSize)
+{
+    if (aSize > _block.size()) _block.resize(aSize);
+    _used = 0;
+    _overflow.clear();
+    _overflowUsed = 0;
+}
+
+void ScratchArena::reset()
+{
+    if (!_overflow.empty()) reserve(_used + _overflowUsed);
+    _used = 0;
+}
+
+double* ScratchArena::allocate(size_t aN, double aValue)
+{
+    double* array;
+    if (_used + aN <= _block.size()) {
+        array = &_block[0] + _used;
+        _used += aN;
+        fill(array, array + aN, aValue);
+    } else {
+        _overflow.push_back(vector<double>(max(aN, size_t(1)), aValue));
+        _overflowUsed += aN;
+        array = &_overflow.back()[0];
+    }
+    return array;
+}
@@ -0,0 +1,73 @@
+#ifndef OPENSIM_SCRATCH_ARENA_H_
+#define OPENSIM_SCRATCH_ARENA_H_
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  ScratchArena.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <cstddef>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/**
+ * Scratch memory for the temporary arrays of a computation that is repeated
+ * many times, such as Analysis::record() at every step of a simulation.
+ *
+ * Each cycle of the computation starts with reset() and takes its arrays
+ * with allocate(); they stay valid until the next reset(). Arrays are
+ * carved out of one block of memory. If a cycle needs more than the block
+ * holds, the extra arrays are allocated separately and the next reset()
+ * grows the block to what the cycle used, so once the computation has run
+ * through its largest cycle (or after reserve()) it does not allocate.
+ */
+class OSIMCOMMON_API ScratchArena {
+public:
+    explicit ScratchArena(size_t aSize=0);
+
+    /** Make the block hold at least aSize doubles. Invalidates the arrays
+    allocated since the last reset(). */
+    void reserve(size_t aSize);
+    /** Release all arrays, to start a new cycle. */
+    void reset();
+
+    /** An array of aN doubles, all set to aValue. Never null, even if aN is
+    0. */
+    double* allocate(size_t aN, double aValue=0.0);
+
+    /** Number of doubles the block holds. */
+    size_t getCapacity() const { return _block.size(); }
+    /** Number of doubles allocated since the last reset(). */
+    size_t getSize() const { return _used + _overflowUsed; }
+
+private:
+    std::vector<double> _block;
+    size_t _used;
+    // Arrays that did not fit in the block during this cycle.
+    std::vector<std::vector<double> > _overflow;
+    size_t _overflowUsed;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_SCRATCH_ARENA_H_
@@ -442,6 +442,25 @@ virtual int getIndex(const std::string &aName,int aStartIndex=0) const
     return( _objects.getIndex(aName,aStartIndex) );
 }
 //_____________________________________________________________________________
+/**
+ * %Set whether finding objects by name may use a hash index of their names.
+ * The index is on by default.
+ *
+ * @see ArrayPtrs::setUseNameIndex()
+ */
+void setUseNameIndex(bool aTrueFalse)
+{
+    _objects.setUseNameIndex(aTrueFalse);
+}
+//_____________________________________________________________________________
+/**
+ * Get whether finding objects by name may use a hash index of their names.
+ */
+bool getUseNameIndex() const
+{
+    return( _objects.getUseNameIndex() );
+}
+//_____________________________________________________________________________
 /**
  * Get names of groups containing a given object 
  */
@@ -30,6 +30,9 @@
 #include <iostream>
 #include <string>
 #include <math.h>
+#include <algorithm>
+#include <thread>
+#include <vector>
 #include "Signal.h"
 #include "Array.h"
 #include "SimTKsimbody.h"
@@ -276,16 +279,21 @@ LowpassFIR(int M,double T,double f,int N,double *sig,double *sigf)
     // CALCULATE THE ANGULAR CUTOFF FREQUENCY
     w = 2.0*SimTK_PI*f;
 
+    // COMPUTE THE FILTER COEFFICIENTS
+    // They do not depend on n, so they are computed once up front.
+    double sum_coef = 0.0;
+    std::vector<double> coef(2*M+1);
+    for(k=-M;k<=M;k++) {
+        x = (double)k*w*T; // k*T = time (seconds) and w scales sinc input argument using filter cutoff
+        coef[k+M] = (sinc(x)*T*w/SimTK_PI)*hamming(k,M); // scale lowpass sinc amplitude by 2*f*T = T*w/pi
+        sum_coef = sum_coef + coef[k+M];
+    }
+
     // FILTER THE DATA
-    double sum_coef,coef;
     for(n=0;n<N;n++) {
-        sum_coef = 0.0;
         sigf[n] = 0.0;
         for(k=-M;k<=M;k++) {   
-            x = (double)k*w*T; // k*T = time (seconds) and w scales sinc input argument using filter cutoff
-            coef = (sinc(x)*T*w/SimTK_PI)*hamming(k,M); // scale lowpass sinc amplitude by 2*f*T = T*w/pi
-            sigf[n] = sigf[n] + coef*s[M+n-k]; 
-            sum_coef = sum_coef + coef;
+            sigf[n] = sigf[n] + coef[k+M]*s[M+n-k]; 
         }
         sigf[n] = sigf[n] / sum_coef; // normalize for unity gain at DC
     }
@@ -370,27 +378,315 @@ double *s;
     for (i=M+N,j=N-2;i<M+M+N;i++,j--)  s[i] = sig[j];
   
 
+    // COMPUTE THE FILTER COEFFICIENTS
+    double sum_coef = 0.0;
+    std::vector<double> coef(2*M+1);
+    for (k=-M;k<=M;k++) {
+        x1 = (double)k*w1*T;  // k*T = time (seconds) and w scales sinc input argument using filter cutoff
+        x2 = (double)k*w2*T;  // k*T = time (seconds) and w scales sinc input argument using filter cutoff
+        coef[k+M] = (sinc(x2)*T*w2/SimTK_PI - sinc(x1)*T*w1/SimTK_PI)*hamming(k,M); // scale lowpass sinc amplitude by 2*f*T = T*w/pi
+        sum_coef = sum_coef + coef[k+M];
+    }
+
     // FILTER THE DATA
-    double sum_coef,coef;
     for (n=0;n<N;n++) {
-        sum_coef = 0.0;
         sigf[n] = 0.0;
         for (k=-M;k<=M;k++) {   
-            x1 = (double)k*w1*T;  // k*T = time (seconds) and w scales sinc input argument using filter cutoff
-            x2 = (double)k*w2*T;  // k*T = time (seconds) and w scales sinc input argument using filter cutoff
-            coef = (sinc(x2)*T*w2/SimTK_PI - sinc(x1)*T*w1/SimTK_PI)*hamming(k,M); // scale lowpass sinc amplitude by 2*f*T = T*w/pi
-            sigf[n] = sigf[n] + coef*s[M+n-k];
-            sum_coef = sum_coef + coef;
+            sigf[n] = sigf[n] + coef[k+M]*s[M+n-k];
         }
         sigf[n] = sigf[n] / sum_coef; // normalize for unity gain at DC
     }
 
     // CLEANUP
-    if(s!=NULL) delete s;
+    if(s!=NULL) free(s);
 
   return(0);
 }
 
+//-----------------------------------------------------------------------------
+// MULTI-CHANNEL FILTERS
+//-----------------------------------------------------------------------------
+namespace {
+
+// Number of multiply-adds below which it is not worth spawning threads.
+const double MIN_WORK_PER_THREAD = 2.0e6;
+
+/**
+ * Call aFunc(c0,c1) for contiguous blocks of channels [c0,c1) that together
+ * cover [0,aNC). The blocks are run on separate threads when aWork (an
+ * estimate of the number of multiply-adds) is large enough.
+ */
+template <typename F>
+void forEachChannelBlock(int aNC,double aWork,F aFunc)
+{
+    int nThreads = (int)std::thread::hardware_concurrency();
+    nThreads = std::min(nThreads,(int)(aWork/MIN_WORK_PER_THREAD));
+    nThreads = std::min(nThreads,aNC);
+    if(nThreads<=1) {
+        aFunc(0,aNC);
+        return;
+    }
+
+    int blockSize = (aNC + nThreads - 1) / nThreads;
+    std::vector<std::thread> threads;
+    for(int c0=0;c0<aNC;c0+=blockSize)
+        threads.push_back(std::thread(aFunc,c0,std::min(aNC,c0+blockSize)));
+    for(std::thread& t : threads) t.join();
+}
+
+/**
+ * Apply a symmetric FIR kernel of half-width M to channels [c0,c1) of a
+ * row-major aN x aNC signal. The channels of a block are copied into a
+ * padded, contiguous work buffer so that the innermost loop runs over
+ * channels with unit stride. If aNegatePad is true the signal is padded as
+ * in Signal::Pad() (reflected and negated); otherwise it is mirrored.
+ */
+void convolveFIR(const std::vector<double> &aCoef,double aSumCoef,
+    bool aNegatePad,int M,int aN,int aNC,int c0,int c1,
+    const double *aSig,double *rSigf)
+{
+    int w = c1 - c0;
+    std::vector<double> s((aN+2*M)*w);
+    std::vector<double> acc(w);
+
+    // PAD
+    int i,j,c;
+    for(i=0,j=M;i<M;i++,j--) for(c=0;c<w;c++) {
+        s[i*w+c] = aSig[j*aNC+c0+c];
+        if(aNegatePad) s[i*w+c] = 2.0*aSig[c0+c] - s[i*w+c];
+    }
+    for(i=M,j=0;i<M+aN;i++,j++) for(c=0;c<w;c++)
+        s[i*w+c] = aSig[j*aNC+c0+c];
+    for(i=M+aN,j=aN-2;i<M+M+aN;i++,j--) for(c=0;c<w;c++) {
+        s[i*w+c] = aSig[j*aNC+c0+c];
+        if(aNegatePad) s[i*w+c] = 2.0*aSig[(aN-1)*aNC+c0+c] - s[i*w+c];
+    }
+
+    // FILTER
+    for(int n=0;n<aN;n++) {
+        for(c=0;c<w;c++) acc[c] = 0.0;
+        for(int k=-M;k<=M;k++) {
+            const double coef = aCoef[k+M];
+            const double *row = &s[(M+n-k)*w];
+            for(c=0;c<w;c++) acc[c] = acc[c] + coef*row[c];
+        }
+        for(c=0;c<w;c++) rSigf[n*aNC+c0+c] = acc[c] / aSumCoef;
+    }
+}
+
+} // anonymous namespace
+
+//_____________________________________________________________________________
+/**
+ * 3rd ORDER LOWPASS IIR BUTTERWORTH DIGITAL FILTER applied to many channels.
+ *
+ * This is the multi-channel counterpart of LowpassIIR(double,double,int,
+ * double*,double*); each channel is filtered forward and backward (zero
+ * phase) with identical results. aSignal and rFilteredSignal may be the same
+ * buffer.
+ *
+ *  @param T Sample interval in seconds.
+ *  @param fc Cutoff frequency in Hz.
+ *  @param N Number of samples (rows).
+ *  @param NC Number of channels (columns).
+ *  @param sig The sampled signals, row-major N x NC.
+ *  @param sigf The filtered signals, row-major N x NC.
+ *
+ * @return 0 on success, and -1 on failure.
+ */
+int Signal::
+LowpassIIR(double T,double fc,int N,int NC,const double *sig,double *sigf)
+{
+    // ERROR CHECK
+    if(T==0) return(-1);
+    if(N<4) return(-1);
+    if(NC<=0) return(-1);
+    if(sig==NULL) return(-1);
+    if(sigf==NULL) return(-1);
+
+    // CHECK THAT THE CUTOFF FREQUENCY IS LESS THAN HALF THE SAMPLE FREQUENCY
+    double fs = 1 / T;
+    if (fc >= 0.5 * fs) {
+        printf("\nCutoff frequency should be less than half sample frequency.");
+        printf("\nchanging the cutoff frequency to 0.49*(Sample Frequency)...");
+        fc = 0.49 * fs;
+        printf("\ncutoff = %lf\n\n",fc);
+    }
+
+    // CALCULATE THE FREQUENCY WARPING
+    double wc = 2*SimTK_PI*fc;
+    double wa = tan(wc*T/2.0);
+    double wa2 = wa*wa;
+    double wa3 = wa*wa*wa;
+
+    // GET COEFFICIENTS FOR THE FILTER
+    double a[4],b[4];
+    double denom = (wa+1) * (wa*wa + wa + 1.0);
+    a[0] = wa3 / denom;
+    a[1] = 3*wa3 / denom;
+    a[2] = 3*wa3 / denom;
+    a[3] = wa3 / denom;
+    b[0] = 1;
+    b[1] = (3*wa3 + 2*wa2 - 2*wa - 3) / denom; 
+    b[2] = (3*wa3 - 2*wa2 - 2*wa + 3) / denom; 
+    b[3] = (wa - 1) * (wa2 - wa + 1) / denom;
+
+    // FILTER EACH BLOCK OF CHANNELS
+    auto filterBlock = [&](int c0,int c1) {
+        int w = c1 - c0;
+        std::vector<double> f(N*w),r(N*w);
+        int i,c;
+
+        // FORWARD PASS
+        for(i=0;i<=3;i++) for(c=0;c<w;c++) f[i*w+c] = sig[i*NC+c0+c];
+        for(i=3;i<N;i++) {
+            const double *x0 = &sig[i*NC+c0];
+            const double *x1 = x0 - NC;
+            const double *x2 = x1 - NC;
+            const double *x3 = x2 - NC;
+            double *y0 = &f[i*w];
+            const double *y1 = y0 - w;
+            const double *y2 = y1 - w;
+            const double *y3 = y2 - w;
+            for(c=0;c<w;c++) {
+                y0[c] = a[0]*x0[c] + a[1]*x1[c] +  a[2]*x2[c] +  a[3]*x3[c]
+                                   - b[1]*y1[c] - b[2]*y2[c] - b[3]*y3[c];
+            }
+        }
+
+        // REVERSE
+        for(i=0;i<N;i++) for(c=0;c<w;c++) r[i*w+c] = f[(N-1-i)*w+c];
+
+        // BACKWARD PASS
+        for(i=0;i<=3;i++) for(c=0;c<w;c++) f[i*w+c] = r[i*w+c];
+        for(i=3;i<N;i++) {
+            const double *x0 = &r[i*w];
+            const double *x1 = x0 - w;
+            const double *x2 = x1 - w;
+            const double *x3 = x2 - w;
+            double *y0 = &f[i*w];
+            const double *y1 = y0 - w;
+            const double *y2 = y1 - w;
+            const double *y3 = y2 - w;
+            for(c=0;c<w;c++) {
+                y0[c] = a[0]*x0[c] + a[1]*x1[c] +  a[2]*x2[c] +  a[3]*x3[c]
+                                   - b[1]*y1[c] - b[2]*y2[c] - b[3]*y3[c];
+            }
+        }
+
+        // REVERSE INTO THE OUTPUT
+        for(i=0;i<N;i++) for(c=0;c<w;c++)
+            sigf[i*NC+c0+c] = f[(N-1-i)*w+c];
+    };
+    forEachChannelBlock(NC,14.0*N*NC,filterBlock);
+
+  return(0);
+}
+//_____________________________________________________________________________
+/**
+ * LOWPASS FIR NON-RECURSIVE DIGITAL FILTER applied to many channels.
+ *
+ * This is the multi-channel counterpart of LowpassFIR(int,double,double,int,
+ * double*,double*) and gives identical results for each channel. The filter
+ * coefficients are computed once and shared by all channels. aSignal and
+ * rFilteredSignal may be the same buffer.
+ *
+ *  @param M Order of filter (should be 30 or greater).
+ *  @param T Sample interval in seconds.
+ *  @param f Cutoff frequency in Hz.
+ *  @param N Number of samples (rows).
+ *  @param NC Number of channels (columns).
+ *  @param sig The sampled signals, row-major N x NC.
+ *  @param sigf The filtered signals, row-major N x NC.
+ *
+ * @return 0 on success, and -1 on failure.
+ */
+int Signal::
+LowpassFIR(int M,double T,double f,int N,int NC,const double *sig,double *sigf)
+{
+    // CHECK THAT M IS NOT TOO LARGE RELATIVE TO N
+    if((M+M)>N) {
+        printf("rdSingal.lowpassFIR:  ERROR- The number of data points (%d)",N);
+        printf(" should be at least twice the order of the filter (%d).\n",M);
+        return(-1);
+    }
+    if(M<=0 || NC<=0 || sig==NULL || sigf==NULL) return(-1);
+
+    // COMPUTE THE FILTER COEFFICIENTS
+    double w = 2.0*SimTK_PI*f;
+    double sum_coef = 0.0;
+    std::vector<double> coef(2*M+1);
+    for(int k=-M;k<=M;k++) {
+        double x = (double)k*w*T;
+        coef[k+M] = (sinc(x)*T*w/SimTK_PI)*hamming(k,M);
+        sum_coef = sum_coef + coef[k+M];
+    }
+
+    // FILTER EACH BLOCK OF CHANNELS
+    // Filtering into a scratch buffer keeps in-place calls correct.
+    std::vector<double> out(N*NC);
+    forEachChannelBlock(NC,(2.0*M+1)*N*NC,[&](int c0,int c1) {
+        convolveFIR(coef,sum_coef,true,M,N,NC,c0,c1,sig,&out[0]);
+    });
+    std::copy(out.begin(),out.end(),sigf);
+
+  return(0);
+}
+//_____________________________________________________________________________
+/**
+ * BANDPASS FIR NON-RECURSIVE DIGITAL FILTER applied to many channels.
+ *
+ * This is the multi-channel counterpart of BandpassFIR(int,double,double,
+ * double,int,double*,double*) and gives identical results for each channel.
+ * Unlike the single-channel version, aSignal and rFilteredSignal may be the
+ * same buffer.
+ *
+ *  @param M Order of filter (should be 30 or greater).
+ *  @param T Sample interval in seconds.
+ *  @param f1 Low-end cutoff frequency in Hz.
+ *  @param f2 High-end cutoff frequency in Hz.
+ *  @param N Number of samples (rows).
+ *  @param NC Number of channels (columns).
+ *  @param sig The sampled signals, row-major N x NC.
+ *  @param sigf The filtered signals, row-major N x NC.
+ *
+ * @return 0 on success, and -1 on failure.
+ */
+int Signal::
+BandpassFIR(int M,double T,double f1,double f2,int N,int NC,
+    const double *sig,double *sigf)
+{
+    // CHECK THAT M IS NOT TOO LARGE RELATIVE TO N
+    if((M+M)>N) {
+    printf("\n\nThe number of data points (%d) should be at least twice\n",N);
+    printf("the order of the filter (%d).\n\n",M);
+    return(-1);
+    }
+    if(M<=0 || NC<=0 || sig==NULL || sigf==NULL) return(-1);
+
+    // COMPUTE THE FILTER COEFFICIENTS
+    double w1 = 2*SimTK_PI*f1;
+    double w2 = 2*SimTK_PI*f2;
+    double sum_coef = 0.0;
+    std::vector<double> coef(2*M+1);
+    for(int k=-M;k<=M;k++) {
+        double x1 = (double)k*w1*T;
+        double x2 = (double)k*w2*T;
+        coef[k+M] = (sinc(x2)*T*w2/SimTK_PI - sinc(x1)*T*w1/SimTK_PI)*hamming(k,M);
+        sum_coef = sum_coef + coef[k+M];
+    }
+
+    // FILTER EACH BLOCK OF CHANNELS
+    std::vector<double> out(N*NC);
+    forEachChannelBlock(NC,(2.0*M+1)*N*NC,[&](int c0,int c1) {
+        convolveFIR(coef,sum_coef,false,M,N,NC,c0,c1,sig,&out[0]);
+    });
+    std::copy(out.begin(),out.end(),sigf);
+
+  return(0);
+}
+
+
 //_____________________________________________________________________________
 /**
  * Pad a signal with a specified number of data points.
@@ -72,6 +72,26 @@ public:
         double aLowFrequency,double aHighFrequency,
         int aN,double *aSignal,double *aFilteredSignal);
 
+    //--------------------------------------------------------------------------
+    // MULTI-CHANNEL FILTERS
+    //--------------------------------------------------------------------------
+    // The following filter aNC channels at once. aSignal and rFilteredSignal
+    // are row-major buffers of aN rows (samples) by aNC columns (channels),
+    // i.e., the layout in which a Storage holds its state vectors. Each
+    // channel yields the same result as the corresponding single-channel
+    // routine. Blocks of channels are processed concurrently when the
+    // amount of work warrants it.
+    static int
+        LowpassIIR(double aDeltaT,double aCutOffFrequency,
+        int aN,int aNC,const double *aSignal,double *rFilteredSignal);
+    static int
+        LowpassFIR(int aOrder,double aDeltaT,double aCutoffFrequency,
+        int aN,int aNC,const double *aSignal,double *rFilteredSignal);
+    static int
+        BandpassFIR(int aOrder,double aDeltaT,
+        double aLowFrequency,double aHighFrequency,
+        int aN,int aNC,const double *aSignal,double *rFilteredSignal);
+
     //--------------------------------------------------------------------------
     // PADDING
     //--------------------------------------------------------------------------
@@ -512,6 +512,46 @@ int SimmSpline::addPoint(double aX, double aY)
 }
 
 double SimmSpline::calcValue(const Vector& x) const
+{
+    return calcScalarValue(x[0]);
+}
+
+double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+{
+    int aDerivOrder = (int)derivComponents.size();
+    if (aDerivOrder < 1 || aDerivOrder > 2)
+        throw Exception("SimmSpline::calcDerivative(): derivative order must be 1 or 2.");
+    return calcScalarDerivative(aDerivOrder, x[0]);
+}
+
+int SimmSpline::findInterval(double aX) const
+{
+    int n = _x.getSize();
+    if (n < 3)
+    {
+        /* If there are only 2 function points, then set k to zero
+         * (you've already checked to see if the abscissa is out of
+         * range or equal to one of the endpoints).
+         */
+        return 0;
+    }
+
+    /* Do a binary search to find which two points the abscissa is between. */
+    int i = 0, j = n, k;
+    while (1)
+    {
+        k = (i+j)/2;
+        if (aX < _x[k])
+            j = k;
+        else if (aX > _x[k+1])
+            i = k;
+        else
+            break;
+    }
+    return k;
+}
+
+double SimmSpline::calcScalarValue(double aX) const
 {
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
@@ -519,11 +559,7 @@ double SimmSpline::calcValue(const Vector& x) const
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
-    double dx;
-
     int n = _x.getSize();
-    double aX = x[0];
 
    /* Check if the abscissa is out of range of the function. If it is,
     * then use the slope of the function at the appropriate end point to
@@ -549,62 +585,29 @@ double SimmSpline::calcValue(const Vector& x) const
    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
        return _y[n-1];
 
-    if (n < 3)
-    {
-        /* If there are only 2 function points, then set k to zero
-         * (you've already checked to see if the abscissa is out of
-         * range or equal to one of the endpoints).
-         */
-        k = 0;
-    }
-    else
-    {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
-    }
-
-   dx = aX - _x[k];
+   int k = findInterval(aX);
+   double dx = aX - _x[k];
    return _y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k]));
 }
 
-double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const Vector& x) const
+double SimmSpline::calcScalarDerivative(int aDerivOrder, double aX) const
 {
+    if (aDerivOrder == 0)
+        return calcScalarValue(aX);
+    if (aDerivOrder < 0 || aDerivOrder > 2)
+        throw Exception("SimmSpline::calcScalarDerivative(): derivative order must be 0, 1 or 2.");
+
     // NOT A NUMBER
     if(!_y.getSize()) return(SimTK::NaN);
     if(!_b.getSize()) return(SimTK::NaN);
     if(!_c.getSize()) return(SimTK::NaN);
     if(!_d.getSize()) return(SimTK::NaN);
 
-    int i, j, k;
-    double dx;
-
     int n = _x.getSize();
-    double aX = x[0];
-    int aDerivOrder = (int)derivComponents.size();
-    if (aDerivOrder < 1 || aDerivOrder > 2)
-        throw Exception("SimmSpline::calcDerivative(): derivative order must be 1 or 2.");
 
-   /* Check if the abscissa is out of range of the function. If it is,
-    * then use the slope of the function at the appropriate end point to
-    * extrapolate. You do this rather than printing an error because the
-    * assumption is that this will only occur in relatively harmless
-    * situations (like a motion file that contains an out-of-range coordinate
-    * value). The rest of the SIMM code has many checks to clamp a coordinate
-    * value within its range of motion, so if you make it to this function
-    * and the coordinate is still out of range, deal with it quietly.
+   /* Outside the range of the function, extrapolate linearly (see
+    * calcScalarValue()).
     */
-
    if (aX < _x[0])
    {
       if (aDerivOrder == 1)
@@ -639,32 +642,8 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
          return 2.0*_c[n-1];
    }
 
-    if (n < 3)
-    {
-        /* If there are only 2 function points, then set k to zero
-         * (you've already checked to see if the abscissa is out of
-         * range or equal to one of the endpoints).
-         */
-        k = 0;
-    }
-    else
-    {
-        /* Do a binary search to find which two points the abscissa is between. */
-        i = 0;
-        j = n;
-        while (1)
-        {
-            k = (i+j)/2;
-            if (aX < _x[k])
-                j = k;
-            else if (aX > _x[k+1])
-                i = k;
-            else
-                break;
-        }
-    }
-
-   dx = aX - _x[k];
+   int k = findInterval(aX);
+   double dx = aX - _x[k];
 
    if (aDerivOrder == 1)
       return (_b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]));
@@ -673,6 +652,69 @@ double SimmSpline::calcDerivative(const std::vector<int>& derivComponents, const
       return (2.0*_c[k] + 6.0*dx*_d[k]);
 }
 
+SimTK::Vec3 SimmSpline::calcScalarValueAndDerivatives(double aX) const
+{
+    // NOT A NUMBER
+    if(!_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize())
+        return SimTK::Vec3(SimTK::NaN);
+
+    int n = _x.getSize();
+
+    // Same cases as calcScalarValue() and calcScalarDerivative(), sharing
+    // the search for the interval containing aX.
+    if (aX < _x[0])
+        return SimTK::Vec3(_y[0] + (aX - _x[0])*_b[0], _b[0], 0);
+    else if (aX > _x[n-1])
+        return SimTK::Vec3(_y[n-1] + (aX - _x[n-1])*_b[n-1], _b[n-1], 0);
+
+    if (EQUAL_WITHIN_ERROR(aX,_x[0]))
+        return SimTK::Vec3(_y[0], _b[0], 2.0*_c[0]);
+    else if (EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return SimTK::Vec3(_y[n-1], _b[n-1], 2.0*_c[n-1]);
+
+    int k = findInterval(aX);
+    double dx = aX - _x[k];
+    return SimTK::Vec3(_y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k])),
+                       _b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]),
+                       2.0*_c[k] + 6.0*dx*_d[k]);
+}
+
+int SimmSpline::findEvaluationInterval(double aX) const
+{
+    int n = _x.getSize();
+    if(n < 2 || !_y.getSize() || !_b.getSize() || !_c.getSize() || !_d.getSize())
+        return -1;
+    // The cases handled without a search in calcScalarValueAndDerivatives().
+    if (!(aX > _x[0] && aX < _x[n-1]) || EQUAL_WITHIN_ERROR(aX,_x[0])
+            || EQUAL_WITHIN_ERROR(aX,_x[n-1]))
+        return -1;
+    return findInterval(aX);
+}
+
+SimTK::Vec3 SimmSpline::calcScalarValueAndDerivativesInInterval(double aX,
+    int aInterval) const
+{
+    if (aInterval < 0)
+        return calcScalarValueAndDerivatives(aX);
+
+    int k = aInterval;
+    double dx = aX - _x[k];
+    return SimTK::Vec3(_y[k] + dx*(_b[k] + dx*(_c[k] + dx*_d[k])),
+                       _b[k] + dx*(2.0*_c[k] + 3.0*dx*_d[k]),
+                       2.0*_c[k] + 6.0*dx*_d[k]);
+}
+
+bool SimmSpline::hasSameX(const SimmSpline& aSpline) const
+{
+    int n = _x.getSize();
+    if (aSpline._x.getSize() != n)
+        return false;
+    for (int i = 0; i < n; ++i)
+        if (_x[i] != aSpline._x[i])
+            return false;
+    return true;
+}
+
 int SimmSpline::getArgumentSize() const
 {
     return 1;
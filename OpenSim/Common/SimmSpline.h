@@ -122,6 +122,22 @@ public:
     //--------------------------------------------------------------------------
     double calcValue(const SimTK::Vector& x) const override;
     double calcDerivative(const std::vector<int>& derivComponents, const SimTK::Vector& x) const override;
+    double calcScalarValue(double x) const override;
+    double calcScalarDerivative(int derivOrder, double x) const override;
+    SimTK::Vec3 calcScalarValueAndDerivatives(double x) const override;
+    /** The index of the interval whose cubic gives the value of the spline
+    at x, or -1 if x is at or beyond the first or last point (where no search
+    is needed). Splines with identical abscissae (see hasSameX()) can share
+    the result of one search through calcScalarValueAndDerivativesInInterval().
+    */
+    int findEvaluationInterval(double x) const;
+    /** Same as calcScalarValueAndDerivatives(x), given the interval returned
+    by findEvaluationInterval(x) for this spline or one with the same
+    abscissae. */
+    SimTK::Vec3 calcScalarValueAndDerivativesInInterval(double x,
+                                                        int interval) const;
+    /** Whether the abscissae of this spline and aSpline are identical. */
+    bool hasSameX(const SimmSpline& aSpline) const;
     int getArgumentSize() const override;
     int getMaxDerivativeOrder() const override;
     SimTK::Function* createSimTKFunction() const override;
@@ -130,6 +146,9 @@ public:
 
 private:
     void calcCoefficients();
+    // Index k of the interval [x[k], x[k+1]] containing aX, which must lie
+    // strictly between the first and last points.
+    int findInterval(double aX) const;
 //=============================================================================
 };  // END class SimmSpline
 
@@ -30,10 +30,14 @@
 #include "osimCommonDLL.h"
 #include <sstream>
 #include <iostream>
+#include <vector>
+#include <climits>
 #include "IO.h"
 #include "Signal.h"
 #include "Storage.h"
+#include "StorageWriter.h"
 #include "GCVSplineSet.h"
+#include "C3DFile.h"
 #include "SimmIO.h"
 #include "SimmMacros.h"
 #include "SimTKcommon.h"
@@ -109,7 +113,9 @@ Storage::Storage(int aCapacity,const string &aName) :
 //_____________________________________________________________________________
 /**
  * Construct an Storage instance from file.
- * This constructor is far from bullet proof.
+ * This constructor is far from bullet proof. The ground reactions of the
+ * force plates are read from .c3d files (see
+ * C3DFile::makeForcePlateStorage()).
  *
  * @param aFileName Name of the file from which the Storage is to be
  * constructed.
@@ -121,6 +127,20 @@ Storage::Storage(const string &aFileName, bool readHeadersOnly) :
     // SET NULL STATES
     setNull();
 
+    // C3D FILES: ground reactions of their force plates
+    if (aFileName.size() > 4 &&
+            SimTK::String(aFileName.substr(aFileName.size() - 4)).toLower() == ".c3d") {
+        C3DFile c3d(aFileName);
+        if (readHeadersOnly) {
+            setName(aFileName);
+            setColumnLabels(c3d.getForcePlateColumnLabels());
+            return;
+        }
+        c3d.makeForcePlateStorage(*this);
+        cout << "Storage: file=" << aFileName << " (nr=" << getSize() << " nc=" << getColumnLabels().getSize() << ")" << endl;
+        return;
+    }
+
     // OPEN FILE
     ifstream *fp = IO::OpenInputFile(aFileName);
     if(fp==NULL) throw Exception("Storage: ERROR- failed to open file " + aFileName, __FILE__,__LINE__);
@@ -313,7 +333,6 @@ setNull()
     setHeaderToken(DEFAULT_HEADER_TOKEN);
     _stepInterval = 1;
     _lastI = 0;
-    _fp = 0;
     _inDegrees = false;
 }
 //_____________________________________________________________________________
@@ -989,8 +1008,27 @@ getDataAtTime(double aT,int aN,double **rData) const
         return(0);
     }
 
+    // ALLOCATE MEMORY?
+    if(*rData==NULL) {
+        aN = interpolateData(i,aT,INT_MAX,NULL);
+        *rData = new double[aN];
+    }
+
+    return(interpolateData(i,aT,aN,*rData));
+}
+//_____________________________________________________________________________
+/**
+ * Linearly interpolate the first aN states at time aT between the state
+ * vectors at index aI (as returned by findIndex()) and the one following it.
+ *
+ * @return Number of states that were set, which is limited by the sizes of
+ * the two state vectors.  If rData is NULL, nothing is set.
+ */
+int Storage::
+interpolateData(int aI,double aT,int aN,double *rData) const
+{
     // CHECK FOR i AT END POINTS
-    int i1=i,i2=i+1;
+    int i1=aI,i2=aI+1;
 
     if(i2==_storage.getSize()) {
         i1--;  if(i1<0) i1=0;
@@ -1009,15 +1047,8 @@ getDataAtTime(double aT,int aN,double **rData) const
 
     // GET THE SMALLEST N TO PREVENT MEMORY OVER-RUNS
     int ns = (n1<n2) ? n1 : n2;
-
-    // ALLOCATE MEMORY?
-    double *y;
-    if(*rData==NULL) {
-        y = new double[ns];
-    } else {
-        y = *rData;
-        if(aN<ns)  ns = aN;
-    }
+    if(aN<ns) ns = aN;
+    if(rData==NULL) return(ns);
 
     // ASSIGN VALUES
     double pct;
@@ -1029,18 +1060,14 @@ getDataAtTime(double aT,int aN,double **rData) const
         pct = num/den;
     }
 
-
-    for(i=0;i<ns;i++) {
+    for(int i=0;i<ns;i++) {
         if(pct==0.0) {
-            y[i] = y1[i];
+            rData[i] = y1[i];
         } else {
-            y[i] = y1[i] + pct*(y2[i]-y1[i]);
+            rData[i] = y1[i] + pct*(y2[i]-y1[i]);
         }
     }
 
-    // ASSIGN FOR RETURN
-    *rData = y; 
-
     return(ns); 
 }
 //_____________________________________________________________________________
@@ -1069,6 +1096,11 @@ getDataAtTime(double aT,int aN,Array<double> &rData) const
 int Storage::
 getDataAtTime(double aT,int aN,SimTK::Vector& v) const
 {
+    if(aN<=0) return(0);
+    if(v.hasContiguousData()) {
+        double *data=&v[0];
+        return getDataAtTime(aT,aN,&data);
+    }
     Array<double> rData;
     rData.setSize(aN);
     int r = getDataAtTime(aT,aN,rData);
@@ -1177,6 +1209,34 @@ setDataColumn(int aStateIndex,const Array<double> &aData)
         vec->setDataValue(aStateIndex,aData[i]);
     }
 }
+//_____________________________________________________________________________
+/**
+ * Get the first aNC values of all state vectors as one contiguous, row-major
+ * block. This is the layout used by the multi-channel routines in Signal.
+ */
+void Storage::
+getDataRows(int aNC,double *rData) const
+{
+    int n = _storage.getSize();
+    for(int i=0;i<n;i++) {
+        const Array<double> &data = _storage[i].getData();
+        for(int j=0;j<aNC;j++) rData[i*aNC+j] = data[j];
+    }
+}
+//_____________________________________________________________________________
+/**
+ * Set the first aNC values of all state vectors from a contiguous, row-major
+ * block.
+ */
+void Storage::
+setDataRows(int aNC,const double *aData)
+{
+    int n = _storage.getSize();
+    for(int i=0;i<n;i++) {
+        Array<double> &data = _storage[i].getData();
+        for(int j=0;j<aNC;j++) data[j] = aData[i*aNC+j];
+    }
+}
 /**
  * set values in the column specified by columnName to newValue
  */
@@ -1357,10 +1417,7 @@ append(const StateVector &aStateVector,bool aCheckForDuplicateTime)
     else
         _storage.append(aStateVector);
 
-    if (_fp!=0){
-        aStateVector.print(_fp);
-        fflush(_fp);
-    }
+    if (_writer) _writer->write(aStateVector);
     return(_storage.getSize());
 }
 //_____________________________________________________________________________
@@ -2343,18 +2400,13 @@ lowpassIIR(double aCutoffFrequency)
         return;
     }
 
-    // LOOP OVER COLUMNS
+    // FILTER ALL COLUMNS AT ONCE
     int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassIIR(dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
-    }
-
-    // CLEANUP
-    delete[] signal;
+    if(nc<=0) return;
+    std::vector<double> data(size*nc);
+    getDataRows(nc,&data[0]);
+    Signal::LowpassIIR(dtmin,aCutoffFrequency,size,nc,&data[0],&data[0]);
+    setDataRows(nc,&data[0]);
 }
 
 
@@ -2385,18 +2437,13 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
         return;
     }
 
-    // LOOP OVER COLUMNS
+    // FILTER ALL COLUMNS AT ONCE
     int nc = getSmallestNumberOfStates();
-    double *signal=NULL;
-    Array<double> filt(0.0,size);
-    for(int i=0;i<nc;i++) {
-        getDataColumn(i,signal);
-        Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,signal,&filt[0]);
-        setDataColumn(i,filt);
-    }
-
-    // CLEANUP
-    delete[] signal;
+    if(nc<=0) return;
+    std::vector<double> data(size*nc);
+    getDataRows(nc,&data[0]);
+    Signal::LowpassFIR(aOrder,dtmin,aCutoffFrequency,size,nc,&data[0],&data[0]);
+    setDataRows(nc,&data[0]);
 }
 
 
@@ -2406,12 +2453,14 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 //_____________________________________________________________________________
 /**
  * Find the index of the storage element that occurred immediately before
- * or at time aT ( aT <= getTime(index) ).
+ * or at time aT ( getTime(index) <= aT ).
  *
- * This method can be much more efficient than findIndex(aT) if a good guess
- * is made for aI.
- * If aI corresponds to a state which occurred later than aT, an exhaustive
- * search is performed by calling findIndex(aT).
+ * This method can be more efficient than findIndex(aT) if a good guess
+ * is made for aI: the search steps forward from aI in growing strides, so
+ * its cost depends on the distance from aI to the result rather than on the
+ * size of the storage.
+ * If aI corresponds to a state which occurred later than aT, the whole
+ * storage is searched.
  *
  * @param aI Index at which to start searching.
  * @param aT Time.
@@ -2421,19 +2470,8 @@ lowpassFIR(int aOrder,double aCutoffFrequency)
 int Storage::
 findIndex(int aI,double aT) const
 {
-    // MAKE SURE aI IS VALID
     if(_storage.getSize()<=0) return(-1);
-    if((aI>=_storage.getSize())||(aI<0)) aI=0;
-    if(getStateVector(aI)->getTime()>aT) aI=0;
-
-    // SEARCH
-    //cout << "Storage.findIndex: starting at " << aI << endl;
-    int i;
-    for(i=aI;i<_storage.getSize();i++) {
-        if(aT<getStateVector(i)->getTime()) break;
-    }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
+    _lastI = findIndexFrom(aI,aT);
     return(_lastI);
 }
 //_____________________________________________________________________________
@@ -2441,8 +2479,8 @@ findIndex(int aI,double aT) const
  * Find the index of the storage element that occurred immediately before
  * or at a specified time ( getTime(index) <= aT ).
  *
- * This method is not very efficient because it always starts its search
- * with the first stored state.
+ * The search is a bisection over all stored states, which relies on the
+ * times being nondecreasing.
  *
  * @param aT Time.
  * @return Index preceding or at time aT.  If aT is less than the earliest
@@ -2451,14 +2489,37 @@ findIndex(int aI,double aT) const
 int Storage::
 findIndex(double aT) const
 {
-    if(_storage.getSize()<=0) return(-1);
-    int i;
-    for(i=0;i<_storage.getSize();i++) {
-        if(aT<getStateVector(i)->getTime()) break;
+    return(findIndex(-1,aT));
+}
+//_____________________________________________________________________________
+/**
+ * Implementation of findIndex(int,double) that does not update _lastI.
+ */
+int Storage::
+findIndexFrom(int aI,double aT) const
+{
+    int n = _storage.getSize();
+    if(n<=0) return(-1);
+
+    // BRACKET aT: time(lo) <= aT < time(hi), with lo=-1 and hi=n standing
+    // for times before the first and after the last state.
+    int lo=-1, hi=n;
+    if((aI>=0)&&(aI<n)&&(getStateVector(aI)->getTime()<=aT)) {
+        lo = aI;
+        hi = aI+1;
+        for(int step=1; (hi<n)&&(getStateVector(hi)->getTime()<=aT); step*=2) {
+            lo = hi;
+            hi = (n-lo>2*step) ? lo+2*step : n;
+        }
     }
-    _lastI = i-1;
-    if(_lastI<0) _lastI=0;
-    return(_lastI);
+
+    // BISECT
+    while(hi-lo>1) {
+        int mid = lo + (hi-lo)/2;
+        if(getStateVector(mid)->getTime()<=aT) lo = mid;
+        else hi = mid;
+    }
+    return((lo<0) ? 0 : lo);
 }
 //_____________________________________________________________________________
 /** 
@@ -2597,6 +2658,39 @@ void Storage::interpolateAt(const Array<double> &targetTimes)
     }
 }
 //=============================================================================
+// INTERPOLATION CURSOR
+//=============================================================================
+Storage::InterpolationCursor::
+InterpolationCursor(const Storage& aStorage) :
+    _storage(&aStorage), _index(0)
+{
+}
+int Storage::InterpolationCursor::
+findIndex(double aT)
+{
+    int i = _storage->findIndexFrom(_index,aT);
+    if(i>=0) _index = i;
+    return(i);
+}
+int Storage::InterpolationCursor::
+getDataAtTime(double aT,int aN,double *rData)
+{
+    int i = findIndex(aT);
+    if((i<0)||(rData==NULL)) return(0);
+    return(_storage->interpolateData(i,aT,aN,rData));
+}
+int Storage::InterpolationCursor::
+getDataAtTime(double aT,SimTK::Vector& v)
+{
+    if(v.size()<=0) return(0);
+    if(v.hasContiguousData())
+        return(getDataAtTime(aT,v.size(),&v[0]));
+    SimTK::Vector data(v.size());
+    int n = getDataAtTime(aT,data.size(),&data[0]);
+    v = data;
+    return(n);
+}
+//=============================================================================
 // IO
 //=============================================================================
 //_____________________________________________________________________________
@@ -2604,6 +2698,12 @@ void Storage::interpolateAt(const Array<double> &targetTimes)
  * Set name of output file to be written into.
  * This has the side effect of opening the file for writing. The header will not have the correct
  * number of rows but this may not be an issue for version 2 of the Storage class
+ *
+ * Appended rows are written by a StorageWriter, which buffers them and
+ * flushes the file periodically (see StorageWriter::setDefaultFlushInterval())
+ * rather than after every row. Use flushOutputFile() for an explicit
+ * durability point; the file is closed by closeOutputFile() or when this
+ * storage is destroyed.
  */
 void Storage::
 setOutputFileName(const std::string& aFileName)
@@ -2612,14 +2712,35 @@ setOutputFileName(const std::string& aFileName)
     _fileName = aFileName;
 
     // OPEN THE FILE
-    _fp = IO::OpenFile(aFileName,"w");
-    if(_fp==NULL) throw(Exception("Could not open file "+aFileName));
+    FILE *fp = IO::OpenFile(aFileName,"w");
+    if(fp==NULL) throw(Exception("Could not open file "+aFileName));
     // WRITE THE HEADER
     int n=0,nTotal=0;
-    n = writeHeader(_fp);
-    n = writeDescription(_fp);
+    n = writeHeader(fp);
+    n = writeDescription(fp);
     // WRITE THE COLUMN LABELS
-    n = writeColumnLabels(_fp);
+    n = writeColumnLabels(fp);
+
+    _writer.reset(new StorageWriter(fp,aFileName));
+}
+//_____________________________________________________________________________
+/**
+ * Write all rows appended so far to the output file and flush it.
+ * Does nothing if there is no open output file.
+ */
+void Storage::
+flushOutputFile()
+{
+    if(_writer) _writer->flush();
+}
+//_____________________________________________________________________________
+/**
+ * Flush and close the output file.
+ */
+void Storage::
+closeOutputFile()
+{
+    if(_writer) _writer->close();
 }
 //_____________________________________________________________________________
 /**
@@ -2641,6 +2762,10 @@ setOutputFileName(const std::string& aFileName)
 bool Storage::
 print(const string &aFileName,const string &aMode, const string& aComment) const
 {
+    // CLOSE THE OUTPUT FILE if it is the one rewritten, so rows still
+    // buffered are not written over the new contents
+    if(_writer && aFileName==_fileName) _writer->close();
+
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(false);
@@ -2718,7 +2843,7 @@ print(const string &aFileName,double aDT,const string &aMode) const
     // CHECK FOR VALID DT
     if(aDT<=0) return(0);
 
-    if (_fp!= NULL) fclose(_fp);
+    if(_writer) _writer->close();
     // OPEN THE FILE
     FILE *fp = IO::OpenFile(aFileName,aMode);
     if(fp==NULL) return(-1);
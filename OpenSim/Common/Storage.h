@@ -33,6 +33,7 @@
 #include "Units.h"
 #include "SimTKcommon.h"
 #include "StorageInterface.h"
+#include <memory>
 
 const int Storage_DEFAULT_CAPACITY = 256;
 //=============================================================================
@@ -41,6 +42,8 @@ namespace OpenSim {
 
 typedef std::map<std::string, std::string, std::less<std::string> > MapKeysToValues;
 
+class StorageWriter;
+
 //static std::string[] simmReservedKeys;
  
 /**
@@ -97,9 +100,9 @@ protected:
     bool _inDegrees;
     /** Map between keys in file header and values */
     MapKeysToValues _keyValueMap;
-    /** Cache for fileName and file pointer when the file is opened so we can flush and write intermediate files if needed */
+    /** Cache for fileName and the writer streaming appended rows to it when the file is opened so we can flush and write intermediate files if needed */
     std::string _fileName;
-    FILE *_fp;
+    std::unique_ptr<StorageWriter> _writer;
     /** Name and Description */
     std::string _name;
     std::string _description;
@@ -111,6 +114,33 @@ protected:
 // METHODS
 //=============================================================================
 public:
+#ifndef SWIG
+    /** A cursor into the rows of a Storage for callers that look up or
+    interpolate data at a sequence of times, typically nondecreasing. The
+    cursor remembers the row found by the previous lookup, so stepping
+    forward through the storage costs amortized O(1) per lookup (and
+    O(log n) for an arbitrary jump), and it does not modify the Storage.
+    Interpolation fills a caller-provided buffer without allocating. A cursor
+    must not outlive its Storage and is invalidated by inserting or removing
+    rows. */
+    class OSIMCOMMON_API InterpolationCursor {
+    public:
+        explicit InterpolationCursor(const Storage& aStorage);
+        /** Same as Storage::findIndex(double) but starting from the row
+        found by the previous call. */
+        int findIndex(double aT);
+        /** Linearly interpolate the first aN values of the rows at time aT
+        into rData, which must hold at least aN values. Returns the number of
+        values set. */
+        int getDataAtTime(double aT, int aN, double *rData);
+        /** Same as above for the first v.size() values. */
+        int getDataAtTime(double aT, SimTK::Vector& v);
+    private:
+        const Storage* _storage;
+        int _index;
+    };
+#endif
+
     // make this constructor explicit so you don't get implicit casting of int to Storage
     explicit Storage(int aCapacity=Storage_DEFAULT_CAPACITY,
         const std::string &aName="UNKNOWN");
@@ -192,6 +222,14 @@ public:
     void setDataColumn(int aStateIndex,const Array<double> &aData);
     int getDataColumn(const std::string& columnName,double *&rData) const;
     void getDataColumn(const std::string& columnName, Array<double>& data, double startTime=0.0) override;
+#ifndef SWIG
+    /** Copy the first aNC values of every state vector into rData, which
+    must hold getSize()*aNC values and is filled row by row (row-major). */
+    void getDataRows(int aNC,double *rData) const;
+    /** Set the first aNC values of every state vector from the row-major
+    buffer aData of size getSize()*aNC. */
+    void setDataRows(int aNC,const double *aData);
+#endif
 #ifndef SWIG
     /** A data block, like a vector for a force, point, etc... will span multiple "columns"
         It is desirable to access the block as a single entity provided an identifier that is common 
@@ -299,6 +337,12 @@ public:
     bool print(const std::string &aFileName,const std::string &aMode="w", const std::string& aComment="") const;
     int print(const std::string &aFileName,double aDT,const std::string &aMode="w") const;
     void setOutputFileName(const std::string& aFileName) override ;
+    /** Write all rows appended so far to the output file and flush it
+    before returning (see setOutputFileName()). */
+    void flushOutputFile();
+    /** Flush and close the output file. Rows appended afterward are only
+    stored. */
+    void closeOutputFile();
     // convenience function for Analyses and DerivCallbacks
     static void printResult(const Storage *aStorage,const std::string &aName,
         const std::string &aDir,double aDT,const std::string &aExtension);
@@ -308,6 +352,8 @@ private:
     int writeSIMMHeader(FILE *rFP,double aDT=-1, const char*aComment=0) const;
     int writeDescription(FILE *rFP) const;
     int writeColumnLabels(FILE *rFP) const;
+    int findIndexFrom(int aI,double aT) const;
+    int interpolateData(int aI,double aT,int aN,double *rData) const;
     int integrate(double aTI,double aTF,int aN,double *rArea,Storage *rStorage) const;
     int integrate(int aI1,int aI2,int aN,double *rArea,Storage *rStorage) const;
 
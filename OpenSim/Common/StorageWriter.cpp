@@ -0,0 +1,231 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  StorageWriter.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "StorageWriter.h"
+#include "StateVector.h"
+#include "Exception.h"
+#include "IO.h"
+#include "Logger.h"
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+
+using namespace OpenSim;
+using namespace std;
+
+namespace {
+    atomic<size_t> defaultBufferSize(64*1024);
+    atomic<double> defaultFlushInterval(1.0);
+    atomic<bool> defaultRoundTrip(false);
+}
+
+//=============================================================================
+// CONSTRUCTION
+//=============================================================================
+StorageWriter::StorageWriter(FILE* fp, const string& fileName) :
+    _fp(fp),
+    _fileName(fileName),
+    _bufferSize(defaultBufferSize.load()),
+    _flushInterval(defaultFlushInterval.load()),
+    _roundTrip(defaultRoundTrip.load()),
+    _flushRequests(0),
+    _flushesDone(0),
+    _stop(false),
+    _failed(false)
+{
+    _pending.reserve(_bufferSize + _bufferSize/2);
+    _thread = thread(&StorageWriter::run, this);
+}
+
+StorageWriter::~StorageWriter()
+{
+    try {
+        close();
+    } catch (const Exception& e) {
+        OPENSIM_LOG(Error) << e.getMessage();
+    }
+}
+
+//=============================================================================
+// DEFAULTS
+//=============================================================================
+void StorageWriter::setDefaultBufferSize(size_t bytes)
+{
+    defaultBufferSize = bytes;
+}
+size_t StorageWriter::getDefaultBufferSize()
+{
+    return defaultBufferSize.load();
+}
+void StorageWriter::setDefaultFlushInterval(double seconds)
+{
+    defaultFlushInterval = seconds;
+}
+double StorageWriter::getDefaultFlushInterval()
+{
+    return defaultFlushInterval.load();
+}
+void StorageWriter::setDefaultRoundTrip(bool roundTrip)
+{
+    defaultRoundTrip = roundTrip;
+}
+bool StorageWriter::getDefaultRoundTrip()
+{
+    return defaultRoundTrip.load();
+}
+
+//=============================================================================
+// WRITING
+//=============================================================================
+void StorageWriter::appendValue(string& text, double value) const
+{
+    char buffer[64];
+    int n = 0;
+    if (_roundTrip) {
+        // 15 digits are enough for any double that has a shorter decimal
+        // representation (%g drops the trailing zeros), 17 for all others.
+        for (int digits = 15; digits <= 17; ++digits) {
+            n = snprintf(buffer, sizeof(buffer), "%.*g", digits, value);
+            if (digits == 17 || strtod(buffer, nullptr) == value) break;
+        }
+    } else {
+        const char* format = IO::GetDoubleOutputFormat();
+        n = snprintf(buffer, sizeof(buffer), format, value);
+        if (n >= int(sizeof(buffer))) {
+            // A large value in fixed-point notation.
+            const size_t size = text.size();
+            text.resize(size + n + 1);
+            snprintf(&text[size], n + 1, format, value);
+            text.resize(size + n);
+            return;
+        }
+    }
+    if (n > 0) text.append(buffer, n);
+}
+
+void StorageWriter::write(const StateVector& row)
+{
+    if (!_fp) return;
+
+    // FORMAT, the same as StateVector::print()
+    _row.clear();
+    appendValue(_row, row.getTime());
+    const Array<double>& data = row.getData();
+    for (int i = 0; i < data.getSize(); ++i) {
+        _row += '\t';
+        appendValue(_row, data[i]);
+    }
+    _row += '\n';
+
+    // QUEUE. Wait only if the background thread is a whole buffer behind.
+    unique_lock<mutex> lock(_lock);
+    _written.wait(lock, [this] {
+        return _pending.size() < 2*_bufferSize || _failed;
+    });
+    _pending += _row;
+    const bool full = _pending.size() >= _bufferSize;
+    lock.unlock();
+    if (full) _wake.notify_one();
+}
+
+void StorageWriter::flush()
+{
+    if (!_fp) return;
+    unique_lock<mutex> lock(_lock);
+    const unsigned long request = ++_flushRequests;
+    _wake.notify_one();
+    _written.wait(lock, [&] { return _flushesDone >= request; });
+    if (_failed)
+        throw Exception("StorageWriter: could not write to file " +
+                        _fileName, __FILE__, __LINE__);
+}
+
+void StorageWriter::close()
+{
+    if (!_fp) return;
+    {
+        lock_guard<mutex> guard(_lock);
+        _stop = true;
+    }
+    _wake.notify_one();
+    _thread.join();
+
+    const bool failed = fclose(_fp) != 0 || _failed;
+    _fp = nullptr;
+    if (failed)
+        throw Exception("StorageWriter: could not write to file " +
+                        _fileName, __FILE__, __LINE__);
+}
+
+//_____________________________________________________________________________
+/**
+ * Body of the background thread. Takes the pending rows when the buffer is
+ * full, when a flush is requested or when the flush interval has elapsed,
+ * and writes them without holding the lock.
+ */
+void StorageWriter::run()
+{
+    typedef chrono::steady_clock Clock;
+    const Clock::duration interval = chrono::duration_cast<Clock::duration>(
+        chrono::duration<double>(_flushInterval > 0 ? _flushInterval : 0));
+    Clock::time_point lastFlush = Clock::now();
+    bool unflushed = false;
+    string buffer;
+    buffer.reserve(_pending.capacity());
+
+    unique_lock<mutex> lock(_lock);
+    const auto ready = [this] {
+        return _stop || _flushRequests != _flushesDone ||
+               _pending.size() >= _bufferSize;
+    };
+    for (;;) {
+        if (_flushInterval > 0)
+            _wake.wait_until(lock, lastFlush + interval, ready);
+        else _wake.wait(lock, ready);
+
+        const bool stop = _stop;
+        const unsigned long requests = _flushRequests;
+        const bool durable = stop || requests != _flushesDone ||
+            (_flushInterval > 0 && Clock::now() >= lastFlush + interval);
+        if (_pending.empty() && !durable) continue;
+        buffer.swap(_pending);
+        lock.unlock();
+
+        bool ok = true;
+        if (!buffer.empty()) {
+            ok = fwrite(buffer.data(), 1, buffer.size(), _fp) == buffer.size();
+            buffer.clear();
+            unflushed = true;
+        }
+        if (durable) {
+            if (unflushed) ok = fflush(_fp) == 0 && ok;
+            unflushed = false;
+            lastFlush = Clock::now();
+        }
+
+        lock.lock();
+        if (!ok) _failed = true;
+        if (durable) _flushesDone = requests;
+        _written.notify_all();
+        if (stop) break;
+    }
+}
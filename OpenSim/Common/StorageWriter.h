@@ -0,0 +1,130 @@
+#ifndef OPENSIM_STORAGE_WRITER_H_
+#define OPENSIM_STORAGE_WRITER_H_
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  StorageWriter.h                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+#include "osimCommonDLL.h"
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace OpenSim {
+
+class StateVector;
+
+//=============================================================================
+//=============================================================================
+/**
+ * Streams the rows of a Storage to an open file, as done by
+ * Storage::setOutputFileName() so that the results of a long simulation are
+ * on disk if it fails.
+ *
+ * Rows are formatted on the calling thread into a memory buffer. A
+ * background thread writes the buffer to the file once it holds
+ * getBufferSize() bytes, and flushes the file to the operating system every
+ * getFlushInterval() seconds, so the thread appending rows does not wait for
+ * file I/O and does not make a system call per row. flush() is an explicit
+ * durability point: it returns once all rows written so far are flushed.
+ * close() (also done by the destructor) flushes and closes the file.
+ *
+ * Values are formatted with IO::GetDoubleOutputFormat(), like
+ * StateVector::print(), unless round-trip formatting is on; then each value
+ * is written with the fewest significant digits (at most 17) that read back
+ * as the same double.
+ */
+class OSIMCOMMON_API StorageWriter {
+public:
+    /** Take ownership of a file opened for writing, e.g. after its header
+    was written. The name is used in error messages. */
+    StorageWriter(FILE* fp, const std::string& fileName);
+    ~StorageWriter();
+
+    const std::string& getFileName() const { return _fileName; }
+    bool isOpen() const { return _fp != nullptr; }
+
+    /** Append a row: the time and the data, tab separated. Rows written
+    after close() are ignored. */
+    void write(const StateVector& row);
+
+    /** Write and flush everything written so far before returning. Throws
+    an Exception if writing to the file failed. */
+    void flush();
+    /** Flush, stop the background thread and close the file. Does nothing
+    if the file is closed already. */
+    void close();
+
+    size_t getBufferSize() const { return _bufferSize; }
+    double getFlushInterval() const { return _flushInterval; }
+    bool getRoundTrip() const { return _roundTrip; }
+
+    /** Buffer size, in bytes, of writers created from now on. The default
+    is 64 KiB. */
+    static void setDefaultBufferSize(size_t bytes);
+    static size_t getDefaultBufferSize();
+    /** Time between flushes of the file, in seconds, of writers created
+    from now on. The default is 1 second; 0 or less flushes only when the
+    buffer is full and at explicit durability points. */
+    static void setDefaultFlushInterval(double seconds);
+    static double getDefaultFlushInterval();
+    /** Whether writers created from now on use round-trip formatting. The
+    default is false. */
+    static void setDefaultRoundTrip(bool roundTrip);
+    static bool getDefaultRoundTrip();
+
+private:
+    StorageWriter(const StorageWriter&);
+    StorageWriter& operator=(const StorageWriter&);
+
+    void appendValue(std::string& text, double value) const;
+    void run();
+
+    FILE* _fp;
+    std::string _fileName;
+    const size_t _bufferSize;
+    const double _flushInterval;
+    const bool _roundTrip;
+
+    // Row being formatted; only used by the thread calling write().
+    std::string _row;
+
+    // The members below are guarded by _lock.
+    std::mutex _lock;
+    // Wakes the background thread.
+    std::condition_variable _wake;
+    // Signaled when the background thread finished a write.
+    std::condition_variable _written;
+    // Rows waiting to be written.
+    std::string _pending;
+    // Counts the calls to flush() and the flushes done for them.
+    unsigned long _flushRequests;
+    unsigned long _flushesDone;
+    bool _stop;
+    bool _failed;
+
+    std::thread _thread;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_STORAGE_WRITER_H_
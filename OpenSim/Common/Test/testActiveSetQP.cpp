@@ -0,0 +1,116 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testActiveSetQP.cpp                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check ActiveSetQP on small problems with known solutions and on random
+// problems, where the solution must be feasible and no better than any
+// point on the segment to another feasible point.
+
+#include <OpenSim/Common/ActiveSetQP.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <random>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Matrix;
+using SimTK::Vector;
+
+void testKnownSolutions()
+{
+    ActiveSetQP qp;
+    Matrix A(1, 2, 1.0);
+    Vector b(1, 1.0), w(2, 1.0), lower(2, 0.0), upper(2, 1.0), x(2, 0.0);
+
+    // min x1^2 + x2^2, x1 + x2 = 1.
+    ASSERT(qp.solve(A, b, w, lower, upper, x));
+    ASSERT_EQUAL(0.5, x[0], 1e-12, __FILE__, __LINE__);
+    ASSERT_EQUAL(0.5, x[1], 1e-12, __FILE__, __LINE__);
+
+    // Weights shift the solution: x1 = w2/(w1 + w2).
+    w[1] = 3;
+    ASSERT(qp.solve(A, b, w, lower, upper, x));
+    ASSERT_EQUAL(0.75, x[0], 1e-12, __FILE__, __LINE__);
+
+    // An active upper bound.
+    upper[0] = 0.2;
+    ASSERT(qp.solve(A, b, w, lower, upper, x));
+    ASSERT_EQUAL(0.2, x[0], 1e-12, __FILE__, __LINE__);
+    ASSERT_EQUAL(0.8, x[1], 1e-12, __FILE__, __LINE__);
+
+    // Out of reach of the bounds; x is left alone.
+    b[0] = 3;
+    ASSERT(!qp.solve(A, b, w, lower, upper, x));
+    ASSERT_EQUAL(0.2, x[0], 0.0, __FILE__, __LINE__);
+}
+
+void testRandomProblems()
+{
+    std::mt19937 gen(0);
+    std::uniform_real_distribution<double> uniform(-1, 1);
+    ActiveSetQP qp;
+    for (int trial = 0; trial < 500; ++trial) {
+        const int m = 1 + trial%8, n = m + trial%50;
+        Matrix A(m, n);
+        Vector w(n), lower(n), upper(n), feasible(n), b(m, 0.0), x(n);
+        for (int i = 0; i < n; ++i) {
+            // Sparse columns, like an actuator that spans a few coordinates.
+            for (int p = 0; p < m; ++p)
+                A(p,i) = gen()%3 == 0 ? uniform(gen) : 0;
+            w[i] = 0.1 + fabs(uniform(gen));
+            lower[i] = gen()%2 ? 0 : -1;
+            upper[i] = 1;
+            feasible[i] = lower[i] + (upper[i] - lower[i])*(uniform(gen) + 1)/2;
+            for (int p = 0; p < m; ++p) b[p] += A(p,i)*feasible[i];
+        }
+        ASSERT(qp.solve(A, b, w, lower, upper, x), __FILE__, __LINE__,
+               "No solution for a feasible problem.");
+
+        ASSERT((A*x - b).normInf() < 1e-8, __FILE__, __LINE__,
+               "Constraints not met.");
+        double fx = 0;
+        for (int i = 0; i < n; ++i) {
+            ASSERT(lower[i] <= x[i] && x[i] <= upper[i]);
+            fx += w[i]*x[i]*x[i];
+        }
+        for (double a = 0.1; a <= 1.0; a += 0.1) {
+            double f = 0;
+            for (int i = 0; i < n; ++i) {
+                const double xi = (1 - a)*x[i] + a*feasible[i];
+                f += w[i]*xi*xi;
+            }
+            ASSERT(f >= fx - 1e-9, __FILE__, __LINE__, "Not a minimum.");
+        }
+    }
+}
+
+int main()
+{
+    try {
+        testKnownSolutions();
+        testRandomProblems();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
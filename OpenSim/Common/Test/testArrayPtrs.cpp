@@ -0,0 +1,179 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  testArrayPtrs.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that finding objects by name in an ArrayPtrs gives the same result
+// as a linear search, with and without the name index, while objects are
+// appended, inserted, replaced, removed and renamed, and when it is searched
+// from several threads at once.
+
+#include <OpenSim/Common/ArrayPtrs.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <random>
+#include <thread>
+
+using namespace OpenSim;
+using namespace std;
+
+class Named {
+public:
+    explicit Named(const string& name) : _name(name) {}
+    Named* clone() const { return new Named(*this); }
+    const string& getName() const { return _name; }
+    void setName(const string& name) { _name = name; }
+private:
+    string _name;
+};
+
+int linearIndex(const ArrayPtrs<Named>& array, const string& name,
+                int start = 0)
+{
+    if (start < 0 || start >= array.getSize()) start = 0;
+    for (int i = start; i < array.getSize(); ++i)
+        if (array[i]->getName() == name) return i;
+    for (int i = 0; i < start; ++i)
+        if (array[i]->getName() == name) return i;
+    return -1;
+}
+
+void checkAllNames(const ArrayPtrs<Named>& array, int numNames)
+{
+    for (int n = 0; n < numNames; ++n) {
+        const string name = "obj" + to_string(n);
+        ASSERT(array.getIndex(name) == linearIndex(array, name),
+               __FILE__, __LINE__, "Wrong index for " + name);
+        for (int start = 0; start < array.getSize(); start += 7)
+            ASSERT(array.getIndex(name, start) ==
+                   linearIndex(array, name, start),
+                   __FILE__, __LINE__, "Wrong index for " + name);
+    }
+}
+
+void testEdits()
+{
+    ArrayPtrs<Named> array;
+    ASSERT(array.getUseNameIndex());
+    for (int i = 0; i < 100; ++i)
+        array.append(new Named("obj" + to_string(i)));
+    ASSERT(array.getIndex("obj57") == 57);
+    ASSERT(array.getIndex("missing") == -1);
+
+    // Appending keeps the index and adds to it.
+    array.append(new Named("obj100"));
+    ASSERT(array.getIndex("obj100") == 100);
+
+    // Renaming an indexed object.
+    array[10]->setName("renamed");
+    ASSERT(array.getIndex("obj10") == -1);
+    ASSERT(array.getIndex("renamed") == 10);
+    ASSERT(array.getIndex("obj11") == 11);
+
+    array.remove(0);
+    ASSERT(array.getIndex("obj1") == 0);
+    array.insert(0, new Named("first"));
+    ASSERT(array.getIndex("first") == 0);
+    ASSERT(array.getIndex("obj1") == 1);
+    array.set(1, new Named("second"));
+    ASSERT(array.getIndex("obj1") == -1);
+    ASSERT(array.getIndex("second") == 1);
+    array.setSize(50);
+    ASSERT(array.getIndex("obj70") == -1);
+
+    ArrayPtrs<Named> copy(array);
+    ASSERT(copy.getIndex("second") == 1);
+    copy.clearAndDestroy();
+    ASSERT(copy.getIndex("second") == -1);
+}
+
+void testRandomEdits()
+{
+    std::mt19937 gen(0);
+    const int numNames = 60;
+    for (bool useIndex : {true, false}) {
+        ArrayPtrs<Named> array;
+        array.setUseNameIndex(useIndex);
+        for (int step = 0; step < 2000; ++step) {
+            const string name = "obj" + to_string(gen() % numNames);
+            const int size = array.getSize();
+            switch (gen() % 6) {
+            case 0: case 1: array.append(new Named(name)); break;
+            case 2: array.insert(size ? gen() % size : 0, new Named(name));
+                    break;
+            case 3: if (size) array.remove(gen() % size); break;
+            case 4: if (size) array.set(gen() % size, new Named(name));
+                    break;
+            // Renaming to a name no other object has (or will have).
+            case 5: if (size) array[gen() % size]->setName(
+                        "renamed" + to_string(step));
+                    break;
+            }
+            if (step % 10 == 0) checkAllNames(array, numNames);
+        }
+    }
+}
+
+// Lookups that build and reset the index, searched from several threads.
+void testConcurrentLookups()
+{
+    const int numObjects = 200;
+    const int numThreads = 4;
+    ArrayPtrs<Named> array;
+    for (int i = 0; i < numObjects; ++i)
+        array.append(new Named("obj" + to_string(i)));
+    // Renamed objects are found by the linear search, which resets the index.
+    for (int i = 0; i < numObjects; i += 10)
+        array[i]->setName("renamed" + to_string(i));
+    vector<int> expected(numObjects);
+    for (int i = 0; i < numObjects; ++i)
+        expected[i] = linearIndex(array, array[i]->getName());
+
+    vector<int> numWrong(numThreads, 0);
+    vector<thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.push_back(thread([&array, &expected, &numWrong, t]() {
+            for (int pass = 0; pass < 20; ++pass)
+                for (int i = 0; i < numObjects; ++i) {
+                    const int j = (i + 37*t) % numObjects;
+                    if (array.getIndex(array[j]->getName()) != expected[j])
+                        ++numWrong[t];
+                }
+        }));
+    }
+    for (thread& th : threads) th.join();
+    for (int t = 0; t < numThreads; ++t)
+        ASSERT(numWrong[t] == 0, __FILE__, __LINE__,
+               "Thread " + to_string(t) + " found wrong indices.");
+}
+
+int main()
+{
+    try {
+        testEdits();
+        testRandomEdits();
+        testConcurrentLookups();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -0,0 +1,448 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testC3DFile.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Write small C3D files in the integer and floating-point formats of Intel,
+// DEC and MIPS processors, with two markers and one type 2 force plate, and
+// read them back with C3DFile, MarkerData and Storage. Floats encoded by hand
+// check the decoders independently of the writer, and a plate turned about
+// the vertical checks the rotation of its reactions into the lab frame.
+
+#include <OpenSim/Common/C3DFile.h>
+#include <OpenSim/Common/MarkerData.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+const int nFrames = 5;
+const int firstFrame = 3;
+const double pointRate = 100;
+const int samplesPerFrame = 2;
+const double pointScale = 0.1;      // mm per count in the integer format
+
+// Channel values are (count - offset)*scale*genScale: N and N.mm.
+const double analogOffset = 100;
+const double analogScales[6] = {0.5, 0.5, 0.5, 5, 5, 5};
+const double analogGenScale = 2;
+
+// Plate corners in mm, in the quadrants (+,+), (-,+), (-,-), (+,-) of the
+// plate frame, and the plate surface center from the sensor origin. The
+// plate is centered at (300, 200, 0), 400 mm long along its x axis and
+// 200 mm wide. The rotated plate's x axis is the lab's y axis and its y axis
+// the lab's -x axis.
+const double corners[12] = {500, 300, 0,  100, 300, 0,
+                            100, 100, 0,  500, 100, 0};
+const double rotatedCorners[12] = {200, 400, 0,  200, 0, 0,
+                                   400, 0, 0,    400, 400, 0};
+const double origin[3] = {1, -2, -40};
+
+// Marker locations in mm; the second marker is not seen in frame 1.
+Vec3 pointAt(int frame, int point)
+{
+    if (point == 1 && frame == 1) return Vec3(SimTK::NaN);
+    return point == 0 ? Vec3(10.5*frame + 1, 20 - frame, 300.2)
+                      : Vec3(-100, 0.5*frame, 12.3);
+}
+
+// Force plate channels: forces in N, moments in N.mm. The vertical force is
+// below the threshold used below in the first sample.
+double analogAt(int sample, int channel)
+{
+    switch (channel) {
+    case 0: return 10 + sample;
+    case 1: return -20;
+    case 2: return sample == 0 ? -4 : -400 - 10*sample;
+    case 3: return 4000;
+    case 4: return -8000 + 100*sample;
+    default: return 1000;
+    }
+}
+
+//==============================================================================
+// C3D WRITER
+//==============================================================================
+enum Processor { Intel = 1, DEC = 2, MIPS = 3 };
+
+class C3DWriter {
+public:
+    C3DWriter(Processor processor, const double* plateCorners = corners) :
+        _processor(processor), _corners(plateCorners) {}
+
+    void int8(vector<unsigned char>& out, int value)
+    {   out.push_back((unsigned char)(int8_t)value); }
+
+    void int16(vector<unsigned char>& out, int value)
+    {
+        const uint16_t u = uint16_t(int16_t(value));
+        if (_processor == MIPS) { int8(out, u >> 8); int8(out, u & 0xff); }
+        else { int8(out, u & 0xff); int8(out, u >> 8); }
+    }
+
+    void float32(vector<unsigned char>& out, double value)
+    {
+        float f = float(_processor == DEC ? 4*value : value);
+        uint32_t u;
+        memcpy(&u, &f, 4);
+        unsigned char b[4] = {(unsigned char)(u & 0xff),
+            (unsigned char)((u >> 8) & 0xff),
+            (unsigned char)((u >> 16) & 0xff), (unsigned char)(u >> 24)};
+        if (_processor == MIPS)
+            out.insert(out.end(), {b[3], b[2], b[1], b[0]});
+        else if (_processor == DEC)
+            out.insert(out.end(), {b[2], b[3], b[0], b[1]});
+        else
+            out.insert(out.end(), b, b + 4);
+    }
+
+    void group(int id, const string& name)
+    {
+        int8(_parameters, int(name.size()));
+        int8(_parameters, -id);
+        _parameters.insert(_parameters.end(), name.begin(), name.end());
+        int16(_parameters, 3);
+        int8(_parameters, 0);     // no description
+    }
+
+    // A parameter of type 2 (int16), 4 (float) or -1 (characters).
+    void parameter(int group, const string& name, int type,
+                   const vector<int>& dims, const vector<double>& values,
+                   const string& chars = "")
+    {
+        int8(_parameters, int(name.size()));
+        int8(_parameters, group);
+        _parameters.insert(_parameters.end(), name.begin(), name.end());
+        vector<unsigned char> body;
+        int8(body, type);
+        int8(body, int(dims.size()));
+        for (size_t i = 0; i < dims.size(); ++i) int8(body, dims[i]);
+        if (type == -1)
+            body.insert(body.end(), chars.begin(), chars.end());
+        for (size_t i = 0; i < values.size(); ++i)
+            if (type == 2) int16(body, int(values[i]));
+            else float32(body, values[i]);
+        int8(body, 0);            // no description
+        int16(_parameters, int(body.size()) + 2);
+        _parameters.insert(_parameters.end(), body.begin(), body.end());
+    }
+
+    void strings(int group, const string& name, const vector<string>& values,
+                 int length)
+    {
+        string chars;
+        for (size_t i = 0; i < values.size(); ++i)
+            chars += values[i] + string(length - values[i].size(), ' ');
+        parameter(group, name, -1, {length, int(values.size())}, {}, chars);
+    }
+
+    void write(const string& fileName, bool isFloat)
+    {
+        const int nPoints = 2, nChannels = 6;
+        const int paramBlocks = 3, dataBlock = 2 + paramBlocks;
+
+        group(1, "POINT");
+        parameter(1, "USED", 2, {}, {double(nPoints)});
+        parameter(1, "SCALE", 4, {}, {isFloat ? -pointScale : pointScale});
+        parameter(1, "RATE", 4, {}, {pointRate});
+        strings(1, "LABELS", {"R.Heel", "L.Toe"}, 8);
+        strings(1, "UNITS", {"mm"}, 2);
+        group(2, "ANALOG");
+        parameter(2, "USED", 2, {}, {double(nChannels)});
+        parameter(2, "RATE", 4, {}, {pointRate*samplesPerFrame});
+        parameter(2, "GEN_SCALE", 4, {}, {analogGenScale});
+        parameter(2, "SCALE", 4, {nChannels},
+                  vector<double>(analogScales, analogScales + nChannels));
+        parameter(2, "OFFSET", 2, {nChannels},
+                  vector<double>(nChannels, analogOffset));
+        strings(2, "LABELS", {"Fx1", "Fy1", "Fz1", "Mx1", "My1", "Mz1"}, 4);
+        strings(2, "UNITS", {"N", "N", "N", "Nmm", "Nmm", "Nmm"}, 4);
+        group(3, "FORCE_PLATFORM");
+        parameter(3, "USED", 2, {}, {1});
+        parameter(3, "TYPE", 2, {1}, {2});
+        parameter(3, "CHANNEL", 2, {6, 1}, {1, 2, 3, 4, 5, 6});
+        parameter(3, "CORNERS", 4, {3, 4, 1},
+                  vector<double>(_corners, _corners + 12));
+        parameter(3, "ORIGIN", 4, {3, 1},
+                  vector<double>(origin, origin + 3));
+        int8(_parameters, 0);
+
+        vector<unsigned char> out;
+        // Header.
+        int8(out, 2);
+        int8(out, 0x50);
+        int16(out, nPoints);
+        int16(out, nChannels*samplesPerFrame);
+        int16(out, firstFrame);
+        int16(out, firstFrame + nFrames - 1);
+        int16(out, 10);
+        float32(out, isFloat ? -pointScale : pointScale);
+        int16(out, dataBlock);
+        int16(out, samplesPerFrame);
+        float32(out, pointRate);
+        out.resize(512, 0);
+        // Parameters.
+        int8(out, 1);
+        int8(out, 0x50);
+        int8(out, paramBlocks);
+        int8(out, 83 + _processor);
+        out.insert(out.end(), _parameters.begin(), _parameters.end());
+        out.resize((dataBlock - 1)*512, 0);
+        // Data.
+        for (int f = 0; f < nFrames; ++f) {
+            for (int p = 0; p < nPoints; ++p) {
+                const Vec3 x = pointAt(f, p);
+                const bool seen = !SimTK::isNaN(x[0]);
+                for (int k = 0; k < 3; ++k) {
+                    const double value = seen ? x[k] : 0;
+                    if (isFloat) float32(out, value);
+                    else int16(out, int(floor(value/pointScale + 0.5)));
+                }
+                if (isFloat) float32(out, seen ? 0 : -1);
+                else int16(out, seen ? 0 : -1);
+            }
+            for (int s = 0; s < samplesPerFrame; ++s)
+                for (int c = 0; c < nChannels; ++c) {
+                    const double value = analogAt(f*samplesPerFrame + s, c);
+                    const double count = analogOffset +
+                        value/(analogScales[c]*analogGenScale);
+                    if (isFloat) float32(out, count);
+                    else int16(out, int(count));
+                }
+        }
+        ofstream file(fileName.c_str(), ios::binary);
+        file.write((const char*)out.data(), out.size());
+    }
+
+private:
+    Processor _processor;
+    const double* _corners;
+    vector<unsigned char> _parameters;
+};
+
+//==============================================================================
+// TESTS
+//==============================================================================
+// Reaction on the body, from the equations of a type 2 plate whose axes are
+// those of the laboratory or, if rotated, turned about the vertical so that
+// plate (x, y, z) is lab (-y, x, z).
+void expectedReaction(int sample, Vec3& force, Vec3& point, Vec3& torque,
+                      bool rotated = false)
+{
+    const Vec3 F(analogAt(sample, 0), analogAt(sample, 1),
+                 analogAt(sample, 2));
+    const double Mx = 1e-3*analogAt(sample, 3), My = 1e-3*analogAt(sample, 4),
+                 Mz = 1e-3*analogAt(sample, 5);
+    const double h = 1e-3*origin[2];
+    const double dx = (h*F[0] - My)/F[2], dy = (h*F[1] + Mx)/F[2];
+    force = -F;
+    point = Vec3(dx - 1e-3*origin[0], dy - 1e-3*origin[1], 0);
+    torque = Vec3(0, 0, -(Mz - dx*F[1] + dy*F[0]));
+    if (rotated) {
+        force = Vec3(-force[1], force[0], force[2]);
+        point = Vec3(-point[1], point[0], point[2]);
+    }
+    point += Vec3(0.3, 0.2, 0);
+}
+
+void testC3DFile(Processor processor, bool isFloat)
+{
+    const string fileName = "testC3DFile.c3d";
+    C3DWriter(processor).write(fileName, isFloat);
+    // Points are exact to the precision of the point scale, a float.
+    const double pointTol = 1e-4, tol = 1e-9;
+
+    C3DFile c3d(fileName);
+    ASSERT(c3d.getFirstFrame() == firstFrame);
+    ASSERT(c3d.getNumFrames() == nFrames);
+    ASSERT(c3d.getNumPoints() == 2);
+    ASSERT_EQUAL(pointRate, c3d.getPointRate(), 0.0, __FILE__, __LINE__);
+    ASSERT(c3d.getPointLabels()[1] == "L.Toe");
+    ASSERT(c3d.getPointUnits() == "mm");
+    ASSERT(c3d.hasParameter("force_platform", "Corners"));
+    ASSERT(!c3d.hasParameter("POINT", "NO_SUCH_PARAMETER"));
+    ASSERT(c3d.getParameterStrings("ANALOG", "UNITS")[5] == "Nmm");
+    for (int f = 0; f < nFrames; ++f)
+        for (int p = 0; p < 2; ++p) {
+            const Vec3 expected = pointAt(f, p), found = c3d.getPoint(f, p);
+            if (SimTK::isNaN(expected[0]))
+                ASSERT(SimTK::isNaN(found[0]));
+            else for (int k = 0; k < 3; ++k)
+                ASSERT_EQUAL(expected[k], found[k], pointTol,
+                             __FILE__, __LINE__);
+        }
+    ASSERT_THROW(Exception, c3d.getPoint(nFrames, 0));
+
+    ASSERT(c3d.getNumAnalogChannels() == 6);
+    ASSERT(c3d.getNumAnalogSamplesPerFrame() == samplesPerFrame);
+    ASSERT_EQUAL(pointRate*samplesPerFrame, c3d.getAnalogRate(), 0.0,
+                 __FILE__, __LINE__);
+    ASSERT(c3d.getAnalogLabels()[3] == "Mx1");
+    for (int s = 0; s < nFrames*samplesPerFrame; ++s)
+        for (int c = 0; c < 6; ++c)
+            ASSERT_EQUAL(analogAt(s, c), c3d.getAnalog(s, c), tol,
+                         __FILE__, __LINE__);
+
+    ASSERT(c3d.getNumForcePlates() == 1);
+    Vec3 force, point, torque, expectedForce, expectedPoint, expectedTorque;
+    for (int s = 1; s < nFrames*samplesPerFrame; ++s) {
+        c3d.getForcePlateReaction(0, s, force, point, torque, 10);
+        expectedReaction(s, expectedForce, expectedPoint, expectedTorque);
+        for (int k = 0; k < 3; ++k) {
+            ASSERT_EQUAL(expectedForce[k], force[k], tol, __FILE__, __LINE__);
+            ASSERT_EQUAL(expectedPoint[k], point[k], tol, __FILE__, __LINE__);
+            ASSERT_EQUAL(expectedTorque[k], torque[k], tol,
+                         __FILE__, __LINE__);
+        }
+    }
+    // Below the threshold the plate is unloaded.
+    c3d.getForcePlateReaction(0, 0, force, point, torque, 10);
+    ASSERT(force.norm() == 0 && torque.norm() == 0);
+    ASSERT_EQUAL(0.3, point[0], 1e-12, __FILE__, __LINE__);
+    ASSERT_EQUAL(0.2, point[1], 1e-12, __FILE__, __LINE__);
+
+    // Markers, in the units of the file, at the times of their frames.
+    MarkerData markers(fileName);
+    ASSERT(markers.getNumMarkers() == 2 && markers.getNumFrames() == nFrames);
+    ASSERT(markers.getMarkerNames()[0] == "R.Heel");
+    ASSERT(markers.getUnits().getType() == Units::Millimeters);
+    ASSERT_EQUAL((firstFrame - 1)/pointRate, markers.getStartFrameTime(),
+                 1e-12, __FILE__, __LINE__);
+    ASSERT_EQUAL(pointAt(4, 0)[0], markers.getFrame(4).getMarker(0)[0],
+                 pointTol, __FILE__, __LINE__);
+    ASSERT(SimTK::isNaN(markers.getFrame(1).getMarker(1)[2]));
+
+    // Ground reactions, as read by ExternalLoads.
+    Storage grf(fileName);
+    ASSERT(grf.getSize() == nFrames*samplesPerFrame);
+    ASSERT(grf.getColumnLabels().getSize() == 10);
+    ASSERT(grf.getColumnLabels()[4] == "ground_force_px");
+    ASSERT_EQUAL((firstFrame - 1)/pointRate + 3/c3d.getAnalogRate(),
+                 grf.getStateVector(3)->getTime(), 1e-12, __FILE__, __LINE__);
+    c3d.getForcePlateReaction(0, 3, force, point, torque);
+    ASSERT_EQUAL(force[2], grf.getStateVector(3)->getData()[2], 0.0,
+                 __FILE__, __LINE__);
+    ASSERT_EQUAL(point[0], grf.getStateVector(3)->getData()[3], 0.0,
+                 __FILE__, __LINE__);
+
+    // Only the column labels, as when ExternalLoads checks the file.
+    Storage grfHeaders(fileName, true);
+    ASSERT(grfHeaders.getSize() == 0);
+    ASSERT(grfHeaders.getColumnLabels().getSize() == 10);
+    ASSERT(grfHeaders.getColumnLabels()[9] == "ground_torque_z");
+}
+
+// Hand-encoded floats, overwriting the point rate in the header and the x
+// and y of the first marker in the first frame of a float file.
+void testHandEncodedFloats(Processor processor)
+{
+    // 250 and -2.5 as IEEE little-endian, VAX F-floating (DEC) and IEEE
+    // big-endian (MIPS) floats.
+    const unsigned char encoded[3][2][4] = {
+        {{0x00, 0x00, 0x7a, 0x43}, {0x00, 0x00, 0x20, 0xc0}},
+        {{0x7a, 0x44, 0x00, 0x00}, {0x20, 0xc1, 0x00, 0x00}},
+        {{0x43, 0x7a, 0x00, 0x00}, {0xc0, 0x20, 0x00, 0x00}}};
+    const char* plus250 = (const char*)encoded[processor - 1][0];
+    const char* minus2_5 = (const char*)encoded[processor - 1][1];
+
+    const string fileName = "testC3DFile.c3d";
+    C3DWriter(processor).write(fileName, true);
+    {
+        fstream file(fileName.c_str(), ios::binary | ios::in | ios::out);
+        file.seekp(20);
+        file.write(plus250, 4);
+        file.seekp(4*512);
+        file.write(plus250, 4);
+        file.write(minus2_5, 4);
+    }
+
+    C3DFile c3d(fileName);
+    ASSERT_EQUAL(250.0, c3d.getPointRate(), 0.0, __FILE__, __LINE__);
+    ASSERT_EQUAL(250.0, c3d.getPoint(0, 0)[0], 0.0, __FILE__, __LINE__);
+    ASSERT_EQUAL(-2.5, c3d.getPoint(0, 0)[1], 0.0, __FILE__, __LINE__);
+}
+
+// A plate whose axes are not the lab's.
+void testRotatedPlate()
+{
+    const string fileName = "testC3DFile.c3d";
+    C3DWriter(Intel, rotatedCorners).write(fileName, false);
+    const double tol = 1e-9;
+
+    C3DFile c3d(fileName);
+    Vec3 force, point, torque, expectedForce, expectedPoint, expectedTorque;
+    for (int s = 1; s < nFrames*samplesPerFrame; ++s) {
+        c3d.getForcePlateReaction(0, s, force, point, torque, 10);
+        expectedReaction(s, expectedForce, expectedPoint, expectedTorque,
+                         true);
+        for (int k = 0; k < 3; ++k) {
+            ASSERT_EQUAL(expectedForce[k], force[k], tol, __FILE__, __LINE__);
+            ASSERT_EQUAL(expectedPoint[k], point[k], tol, __FILE__, __LINE__);
+            ASSERT_EQUAL(expectedTorque[k], torque[k], tol,
+                         __FILE__, __LINE__);
+        }
+    }
+    c3d.getForcePlateReaction(0, 0, force, point, torque, 10);
+    ASSERT_EQUAL(0.3, point[0], 1e-12, __FILE__, __LINE__);
+    ASSERT_EQUAL(0.2, point[1], 1e-12, __FILE__, __LINE__);
+}
+
+void testBadFiles()
+{
+    ofstream("testC3DFile.trc") << "PathFileType\t4\n";
+    ASSERT_THROW(Exception, C3DFile("testC3DFile.trc"));
+    ASSERT_THROW(Exception, C3DFile("no_such_file.c3d"));
+
+    // A file cut short in its parameters.
+    C3DWriter(Intel).write("testC3DFile.c3d", false);
+    vector<char> bytes(700);
+    ifstream("testC3DFile.c3d", ios::binary).read(bytes.data(), bytes.size());
+    ofstream("testC3DFile_truncated.c3d", ios::binary).write(bytes.data(),
+                                                             bytes.size());
+    ASSERT_THROW(Exception, C3DFile("testC3DFile_truncated.c3d"));
+}
+
+int main()
+{
+    try {
+        testC3DFile(Intel, false);
+        testC3DFile(Intel, true);
+        testC3DFile(DEC, false);
+        testC3DFile(DEC, true);
+        testC3DFile(MIPS, false);
+        testC3DFile(MIPS, true);
+        testHandEncodedFloats(Intel);
+        testHandEncodedFloats(DEC);
+        testHandEncodedFloats(MIPS);
+        testRotatedPlate();
+        testBadFiles();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -22,6 +22,7 @@
  * -------------------------------------------------------------------------- */
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 #include <OpenSim/Common/Component.h>
+#include <thread>
 
 using namespace OpenSim;
 using namespace std;
@@ -376,6 +377,69 @@ private:
 SimTK_NICETYPENAME_LITERAL(Foo);
 SimTK_NICETYPENAME_LITERAL(Bar);
 
+// The cached view of a type must hold the components the list iterates over.
+template <typename T>
+void checkComponentView(const Component& root)
+{
+    const std::vector<const T*>& view = root.getComponentView<T>();
+    size_t i = 0;
+    for (const T& comp : root.getComponentList<T>()) {
+        ASSERT(i < view.size() && view[i] == &comp, __FILE__, __LINE__,
+               "Component view does not match the component list.");
+        ++i;
+    }
+    ASSERT(i == view.size(), __FILE__, __LINE__,
+           "Component view has more components than the component list.");
+    // A second request returns the same array.
+    ASSERT(&root.getComponentView<T>() == &view);
+}
+
+// Views not yet filled, requested from several threads at once, are filled
+// once: every thread gets the same arrays.
+void checkComponentViewsConcurrently(const Component& root)
+{
+    const int numThreads = 4;
+    std::vector<const void*> fooViews(numThreads), componentViews(numThreads);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread(
+                [&root, &fooViews, &componentViews, t]() {
+            fooViews[t] = &root.getComponentView<Foo>();
+            componentViews[t] = &root.getComponentView<Component>();
+        }));
+    }
+    for (std::thread& thread : threads) thread.join();
+    for (int t = 1; t < numThreads; ++t)
+        ASSERT(fooViews[t] == fooViews[0] &&
+               componentViews[t] == componentViews[0], __FILE__, __LINE__,
+               "Threads were given different component views.");
+}
+
+// Adding or removing a grandchild replaces the views of the root.
+void checkComponentViewsOfGrandchildren()
+{
+    TheWorld root;
+    TheWorld* inner = new TheWorld();
+    inner->setName("inner");
+    root.add(inner);
+    Foo* foo1 = new Foo();
+    foo1->setName("foo1");
+    inner->add(foo1);
+    root.buildComponentTreeAndConnect();
+    ASSERT(root.getComponentView<Foo>().size() == 1);
+
+    Foo* foo2 = new Foo();
+    foo2->setName("foo2");
+    inner->add(foo2);
+    inner->initComponentTreeTraversal(root);
+    checkComponentView<Foo>(root);
+    ASSERT(root.getComponentView<Foo>().size() == 2);
+
+    inner->clearComponents();
+    checkComponentView<Foo>(root);
+    ASSERT(root.getComponentView<Foo>().empty());
+}
+
 int main() {
 
     //Register new types for testing deserialization
@@ -454,6 +518,10 @@ int main() {
         for (auto& component : theWorld.getComponentList<Foo>()) {
             std::cout << "Iterator is at: " << component.getName() << std::endl;
         }
+        checkComponentView<Foo>(theWorld);
+        checkComponentView<Bar>(theWorld);
+        checkComponentView<Component>(theWorld);
+        ASSERT(theWorld.getComponentView<Foo>().size() == 2);
 
         theWorld.buildUpSystem(system);
 
@@ -537,6 +605,12 @@ int main() {
         // Add second world as the internal model of the first
         theWorld.add(world2);
         theWorld.buildComponentTreeAndConnect();
+        // Rebuilding the tree replaces the cached views.
+        checkComponentViewsConcurrently(theWorld);
+        ASSERT(theWorld.getComponentView<Foo>().size() == 4);
+        checkComponentView<Foo>(theWorld);
+        checkComponentView<Component>(theWorld);
+        checkComponentViewsOfGrandchildren();
 
         Bar& bar2 = *new Bar();
         bar2.setName("bar2");
@@ -0,0 +1,125 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  testLogger.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that disabled messages are not formatted, that messages logged
+// concurrently from several threads are all written, each thread's in order,
+// that all levels go to the output buffer, and that shutdown() leaves the
+// logger writing synchronously.
+
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/LogManager.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+class RecordingLogCallback : public LogCallback {
+public:
+    void log(const std::string& str) override { lines.push_back(str); }
+    vector<string> lines;
+};
+
+int main()
+{
+    try {
+        RecordingLogCallback* recorder = new RecordingLogCallback();
+        LogBuffer* out = LogManager::getInstance()->getOutBuffer();
+        out->addLogCallback(recorder);
+
+        Logger::setLevel(Logger::Level::Info);
+        ASSERT(Logger::shouldLog(Logger::Level::Warn));
+        ASSERT(!Logger::shouldLog(Logger::Level::Debug));
+        ASSERT(Logger::parseLevel("DEBUG") == Logger::Level::Debug);
+        ASSERT_THROW(Exception, Logger::parseLevel("loud"));
+
+        int numEvaluated = 0;
+        OPENSIM_LOG(Debug) << ++numEvaluated;
+        ASSERT(numEvaluated == 0);
+
+        // An else after the macro belongs to the caller's if.
+        bool inElse = false;
+        if (numEvaluated != 0) OPENSIM_LOG(Info) << "not logged";
+        else inElse = true;
+        ASSERT(inElse);
+
+        const int numThreads = 4;
+        const int numMessages = 5000;
+        vector<thread> threads;
+        for (int t = 0; t < numThreads; ++t) {
+            threads.push_back(thread([t, numMessages]() {
+                for (int i = 0; i < numMessages; ++i)
+                    OPENSIM_LOG(Info) << "thread " << t << " message " << i;
+            }));
+        }
+        for (auto& thread : threads)
+            thread.join();
+        Logger::flush();
+
+        vector<int> last(numThreads, -1);
+        for (const auto& line : recorder->lines) {
+            int t, i;
+            if (sscanf(line.c_str(), "thread %d message %d", &t, &i) == 2) {
+                ASSERT(i == last[t] + 1);
+                last[t] = i;
+            }
+        }
+        for (int t = 0; t < numThreads; ++t)
+            ASSERT(last[t] == numMessages - 1);
+
+        Logger::setAsynchronous(false);
+        OPENSIM_LOG(Info) << "written immediately";
+        ASSERT(recorder->lines.back() == "written immediately\n");
+        Logger::setAsynchronous(true);
+
+        // Warnings and errors go to the output buffer, like the std::cout
+        // output they replace.
+        OPENSIM_LOG(Warn) << "a warning";
+        OPENSIM_LOG(Error) << "an error";
+        Logger::flush();
+        ASSERT(recorder->lines.size() >= 2);
+        ASSERT(recorder->lines[recorder->lines.size() - 2] == "a warning\n");
+        ASSERT(recorder->lines.back() == "an error\n");
+
+        // After shutdown, the background thread is gone for good and
+        // messages are written immediately.
+        OPENSIM_LOG(Info) << "queued before shutdown";
+        Logger::shutdown();
+        ASSERT(recorder->lines.back() == "queued before shutdown\n");
+        ASSERT(!Logger::isAsynchronous());
+        Logger::setAsynchronous(true);
+        ASSERT(!Logger::isAsynchronous());
+        OPENSIM_LOG(Info) << "after shutdown";
+        ASSERT(recorder->lines.back() == "after shutdown\n");
+
+        out->removeLogCallback(recorder);
+        delete recorder;
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
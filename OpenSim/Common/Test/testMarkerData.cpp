@@ -46,6 +46,8 @@ int main() {
         ASSERT(md.getFileName()=="TRCFileWithNANs.trc");
         Storage storage;
         md.makeRdStorage(storage);
+        ASSERT(storage.getSize()==5, __FILE__, __LINE__);
+        ASSERT(storage.getColumnLabels().getSize()==1+3*14, __FILE__, __LINE__);
         ASSERT(md.getUnits().getType()==Units(string("mm")).getType(), __FILE__, __LINE__);
         //std::string mm("mm");
         Units lengthUnit = Units::Millimeters;
@@ -60,7 +62,57 @@ int main() {
         ASSERT(md.getLastFrameTime()==0.016, __FILE__, __LINE__);
         ASSERT(md.getDataRate()==250., __FILE__, __LINE__);
         ASSERT(md.getCameraRate()==250., __FILE__, __LINE__);
-        //ToBeTested md.convertToUnits(Units(Units::Meters));
+        // Frames are views of the markers stored in md, which are also the
+        // rows of its Storage.
+        for (int i = 0; i < md.getNumFrames(); i++) {
+            const MarkerFrame& frame = md.getFrame(i);
+            ASSERT(frame.getFrameTime()==md.getFrameTime(i), __FILE__, __LINE__);
+            ASSERT(frame.getFrameNumber()==i+1, __FILE__, __LINE__);
+            const Array<double>& row = storage.getStateVector(i)->getData();
+            for (int j = 0; j < md.getNumMarkers(); j++) {
+                ASSERT(&frame.getMarkers()[j]==&md.getMarker(i, j), __FILE__, __LINE__);
+                for (int k = 0; k < 3; k++) {
+                    const double x = md.getMarker(i, j)[k];
+                    ASSERT(x==row[3*j+k] || (SimTK::isNaN(x) && SimTK::isNaN(row[3*j+k])),
+                        __FILE__, __LINE__);
+                }
+            }
+        }
+        // A copy of a frame holds its own markers.
+        MarkerFrame copy(md.getFrame(2));
+        ASSERT(&copy.getMarkers()[0]!=&md.getMarker(2, 0), __FILE__, __LINE__);
+        ASSERT(md.getFrame(2).isView() && !copy.isView(), __FILE__, __LINE__);
+
+        // The markers of md cannot be changed through a view of them, and
+        // assigning to a view copies the markers rather than writing to md.
+        const SimTK::Vec3 marker = md.getMarker(1, 0);
+        MarkerFrame view(md.getNumMarkers(), 2, md.getFrameTime(1),
+                         md.getUnits(), &md.getMarker(1, 0));
+        ASSERT_THROW(Exception, view.updMarker(0));
+        ASSERT_THROW(Exception, view.scale(2.0));
+        ASSERT_THROW(Exception, view.addMarker(SimTK::Vec3(0)));
+        copy.updMarker(0) = SimTK::Vec3(1, 2, 3);
+        view = copy;
+        ASSERT(!view.isView() && view.getMarker(0)==SimTK::Vec3(1, 2, 3),
+               __FILE__, __LINE__);
+        for (int k = 0; k < 3; k++) {
+            const double x = md.getMarker(1, 0)[k];
+            ASSERT(x==marker[k] || (SimTK::isNaN(x) && SimTK::isNaN(marker[k])),
+                __FILE__, __LINE__);
+        }
+
+        // Converting the units scales all frames; averaging leaves one frame
+        // holding the mean of the markers that are not missing.
+        const SimTK::Vec3 first = md.getMarker(0, 0);
+        md.convertToUnits(Units(Units::Meters));
+        ASSERT_EQUAL(first[0]/1000, md.getMarker(0, 0)[0], 1e-12, __FILE__, __LINE__);
+        SimTK::Vec3 mean(0);
+        for (int i = 0; i < 5; i++)
+            mean += md.getMarker(i, 0)/5;
+        md.averageFrames();
+        ASSERT(md.getNumFrames()==1, __FILE__, __LINE__);
+        ASSERT(md.getStartFrameTime()==0.0, __FILE__, __LINE__);
+        ASSERT_EQUAL(mean, md.getMarker(0, 0), SimTK::Vec3(1e-12), __FILE__, __LINE__);
 
         MarkerData md2("testNaNsParsing.trc");
         double expectedData[] = {1006.513977, 1014.924316,-195.748917};
@@ -0,0 +1,108 @@
+/* -------------------------------------------------------------------------- *
+ *                         OpenSim:  testProfiler.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that the Profiler counts the calls of each object by name, even when
+// an address is reused, that the calls recorded on several threads are all
+// counted, and that each outermost Region reports only its own calls.
+
+#include <OpenSim/Common/Profiler.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <thread>
+#include <vector>
+
+using namespace OpenSim;
+using namespace std;
+
+void call(const Object& object, int times)
+{
+    for (int i = 0; i < times; ++i)
+        Profiler::Scope scope(object, "test");
+}
+
+int main()
+{
+    try {
+        Constant a(1.0);
+        a.setName("a");
+
+        // Nothing is recorded while profiling is disabled.
+        Profiler::setEnabled(false);
+        {
+            Profiler::Region region("disabled");
+            call(a, 3);
+        }
+        ASSERT(Profiler::getNumCalls("a", "test") == 0);
+
+        // Each outermost region starts afresh; nested ones do not.
+        Profiler::setEnabled(true);
+        {
+            Profiler::Region region("first");
+            call(a, 3);
+        }
+        ASSERT(Profiler::getNumCalls("a", "test") == 3);
+        {
+            Profiler::Region region("second");
+            call(a, 2);
+            {
+                Profiler::Region nested("nested");
+                call(a, 1);
+            }
+            ASSERT(Profiler::getNumCalls("a", "test") == 3);
+        }
+        ASSERT(Profiler::getNumCalls("a", "test") == 3);
+
+        // Objects are told apart by name, not by address.
+        {
+            Profiler::Region region("reused");
+            for (const string name : {"b", "c"}) {
+                Constant* f = new Constant(0.0);
+                f->setName(name);
+                call(*f, 1);
+                delete f;
+            }
+        }
+        ASSERT(Profiler::getNumCalls("b", "test") == 1);
+        ASSERT(Profiler::getNumCalls("c", "test") == 1);
+        ASSERT(Profiler::getNumCalls("a", "test") == 0);
+        ASSERT(Profiler::getNumCalls("b", "other") == 0);
+
+        // Each thread records on its own; the report merges them.
+        {
+            Profiler::Region region("threads");
+            vector<thread> threads;
+            for (int t = 0; t < 4; ++t)
+                threads.push_back(thread([&a]() { call(a, 1000); }));
+            for (auto& thread : threads)
+                thread.join();
+            call(a, 1);
+            ASSERT(Profiler::getNumCalls("a", "test") == 4001);
+        }
+        Profiler::setEnabled(false);
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
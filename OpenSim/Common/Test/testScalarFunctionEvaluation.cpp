@@ -0,0 +1,85 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testScalarFunctionEvaluation.cpp               *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that the scalar evaluation methods of Function agree with the general
+// (Vector argument) ones, inside and outside the range of the data and at
+// the data points themselves.
+
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Common/GCVSpline.h>
+#include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Common/PiecewiseLinearFunction.h>
+#include <OpenSim/Common/SimmSpline.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+void compareScalarEvaluation(const Function& f, int maxDerivOrder)
+{
+    cout << "Testing " << f.getConcreteClassName() << endl;
+    const vector<int> first(1, 0), second(2, 0);
+    SimTK::Vector xvec(1);
+    // Steps of 0.05 hit every knot exactly.
+    for (int i = -20; i <= 220; ++i) {
+        double x = i*0.05;
+        xvec[0] = x;
+        double value = f.calcValue(xvec);
+        double d1 = maxDerivOrder >= 1 ? f.calcDerivative(first, xvec) : 0;
+        double d2 = maxDerivOrder >= 2 ? f.calcDerivative(second, xvec) : 0;
+
+        ASSERT_EQUAL(value, f.calcScalarValue(x), 1e-12, __FILE__, __LINE__);
+        ASSERT_EQUAL(value, f.calcScalarDerivative(0, x), 1e-12,
+                     __FILE__, __LINE__);
+        ASSERT_EQUAL(d1, f.calcScalarDerivative(1, x), 1e-12,
+                     __FILE__, __LINE__);
+        if (maxDerivOrder >= 2)
+            ASSERT_EQUAL(d2, f.calcScalarDerivative(2, x), 1e-12,
+                         __FILE__, __LINE__);
+
+        SimTK::Vec3 all = f.calcScalarValueAndDerivatives(x);
+        ASSERT_EQUAL(value, all[0], 1e-12, __FILE__, __LINE__);
+        ASSERT_EQUAL(d1, all[1], 1e-12, __FILE__, __LINE__);
+        ASSERT_EQUAL(d2, all[2], 1e-12, __FILE__, __LINE__);
+    }
+}
+
+int main()
+{
+    try {
+        double x[] = {0.0, 1.0, 2.0, 2.5, 5.0, 10.0};
+        double y[] = {0.5, 0.7, 2.0, -1.0, 0.5, 0.1};
+
+        compareScalarEvaluation(PiecewiseLinearFunction(6, x, y), 1);
+        compareScalarEvaluation(SimmSpline(6, x, y), 2);
+        compareScalarEvaluation(SimmSpline(2, x, y), 2);
+        compareScalarEvaluation(GCVSpline(5, 6, x, y), 2);
+        compareScalarEvaluation(Constant(3.2), 2);
+        compareScalarEvaluation(LinearFunction(-1.5, 0.25), 2);
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -0,0 +1,110 @@
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  testScratchArena.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Check that arrays from a ScratchArena are valid and that, once a cycle
+// has been run, repeating it performs no heap allocations. Allocations are
+// counted by replacing the global operator new.
+
+#include <OpenSim/Common/ScratchArena.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace OpenSim;
+using namespace std;
+
+static atomic<long> allocations(0);
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+
+// One cycle: arrays of the given sizes, each filled with its index, checked
+// after all of them were allocated.
+void cycle(ScratchArena& arena, const int* sizes, int n)
+{
+    double* arrays[8];
+    arena.reset();
+    for (int i = 0; i < n; ++i) {
+        arrays[i] = arena.allocate(sizes[i], -1.0);
+        ASSERT(arrays[i] != nullptr);
+        for (int j = 0; j < sizes[i]; ++j) {
+            ASSERT(arrays[i][j] == -1.0);
+            arrays[i][j] = i;
+        }
+    }
+    for (int i = 0; i < n; ++i)
+        for (int j = 0; j < sizes[i]; ++j)
+            ASSERT(arrays[i][j] == i);
+}
+
+long countAllocations(ScratchArena& arena, const int* sizes, int n)
+{
+    const long before = allocations.load();
+    cycle(arena, sizes, n);
+    return allocations.load() - before;
+}
+
+int main()
+{
+    try {
+        const int sizes[] = {17, 0, 40, 3, 17, 100};
+        const int n = 6;
+
+        // The first cycle overflows the empty arena, which the next reset()
+        // grows to what the cycle used; the next cycles fit.
+        ScratchArena arena;
+        cycle(arena, sizes, n);
+        ASSERT(arena.getSize() == 177 && arena.getCapacity() < 177);
+        arena.reset();
+        ASSERT(arena.getCapacity() == 177);
+        for (int k = 0; k < 10; ++k)
+            ASSERT(countAllocations(arena, sizes, n) == 0);
+
+        // Smaller cycles fit too; a larger one grows the arena once.
+        ASSERT(countAllocations(arena, sizes, 3) == 0);
+        const int larger[] = {200, 17};
+        cycle(arena, larger, 2);
+        arena.reset();
+        ASSERT(arena.getCapacity() == 217);
+        ASSERT(countAllocations(arena, larger, 2) == 0);
+        ASSERT(countAllocations(arena, sizes, n) == 0);
+
+        // An arena reserved up front does not allocate at all.
+        ScratchArena reserved;
+        reserved.reserve(177);
+        ASSERT(countAllocations(reserved, sizes, n) == 0);
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
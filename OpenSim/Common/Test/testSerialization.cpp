@@ -218,6 +218,25 @@ int main()
         cout << "DUMPOBJ(assignOfObj1)" << endl;
         dumpObj(assignOfObj1, 0);
 
+        // Lazily read objects read their properties on first access, or
+        // when they are copied or written, and then match eager ones.
+        Object::setDeserializeLazily(true);
+        SerializableObject lazyObj("obj1.xml");
+        SerializableObject lazyPrinted("obj1.xml");
+        Object::setDeserializeLazily(false);
+        ASSERT(lazyObj.hasPendingProperties(), __FILE__, __LINE__,
+               "lazily read object has pending properties");
+        ASSERT(lazyObj.getName() == obj2.getName());
+        SerializableObject lazyCopy(lazyObj);
+        ASSERT(lazyCopy == obj2, __FILE__, __LINE__, "lazy copy equality");
+        ASSERT(lazyObj.get_Test_Dbl_2() == obj2.get_Test_Dbl_2());
+        ASSERT(!lazyObj.hasPendingProperties());
+        ASSERT(lazyObj == obj2, __FILE__, __LINE__, "lazy equality");
+        lazyPrinted.print("roundtripLazy.xml");
+        ASSERT(!lazyPrinted.hasPendingProperties());
+        ASSERT(SerializableObject("roundtripLazy.xml") == obj2, __FILE__,
+               __LINE__, "lazy round trip");
+
         ObjectWithListProperty objWithListProp;
         SerializableObject obj_l1;
         obj_l1.setName("First");
@@ -229,6 +248,23 @@ int main()
         ASSERT(loc == 1);
         int notFound = objWithListProp.getProperty_list_SerializableObject().findIndexForName("Third");
         ASSERT(notFound == -1);
+
+        // Objects held in properties are themselves read lazily.
+        objWithListProp.print("objWithListProp.xml");
+        Object::registerType(ObjectWithListProperty());
+        Object::setDeserializeLazily(true);
+        std::unique_ptr<Object> lazyList(
+            Object::makeObjectFromFile("objWithListProp.xml"));
+        Object::setDeserializeLazily(false);
+        const ObjectWithListProperty& lazyListProp =
+            dynamic_cast<const ObjectWithListProperty&>(*lazyList);
+        ASSERT(lazyListProp.hasPendingProperties());
+        const SerializableObject& lazySecond =
+            lazyListProp.get_list_SerializableObject(1);
+        ASSERT(lazySecond.getName() == "Second");
+        ASSERT(lazySecond.hasPendingProperties());
+        ASSERT(lazySecond == obj_l2);
+        ASSERT(*lazyList == objWithListProp);
     }
     catch(const std::exception& e) {
         cerr << "EXCEPTION: " << e.what() << endl;
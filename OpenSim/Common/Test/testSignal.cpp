@@ -0,0 +1,169 @@
+/* -------------------------------------------------------------------------- *
+ *                          OpenSim:  testSignal.cpp                          *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Checks that the multi-channel filters in Signal reproduce the single-channel
+// filters exactly, and reports the time taken by each on 1 kHz data.
+
+#include <chrono>
+#include <vector>
+#include <OpenSim/Common/Signal.h>
+#include <OpenSim/Common/Storage.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+const double T = 0.001;     // 1 kHz
+const int N = 60000;        // one minute
+const int NC = 120;         // channels
+const int ORDER = 50;       // FIR order
+
+typedef std::chrono::steady_clock Clock;
+
+double secondsSince(Clock::time_point start)
+{
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Fill a row-major N x NC buffer with noisy sinusoids.
+void fillSignals(vector<double>& data)
+{
+    data.resize(N*NC);
+    for (int i = 0; i < N; ++i) {
+        for (int c = 0; c < NC; ++c) {
+            data[i*NC+c] = sin(0.002*i*(c+1)) + 0.05*cos(1.3*i + c) + c;
+        }
+    }
+}
+
+// Compare the channels of rowMajor against columns filtered one at a time.
+template <typename SingleFilter>
+double compareToSingleChannel(const vector<double>& data,
+        const vector<double>& rowMajor, SingleFilter filter, double& time)
+{
+    vector<double> col(N), filt(N);
+    double maxError = 0;
+    time = 0;
+    for (int c = 0; c < NC; ++c) {
+        for (int i = 0; i < N; ++i) col[i] = data[i*NC+c];
+        Clock::time_point start = Clock::now();
+        filter(&col[0], &filt[0]);
+        time += secondsSince(start);
+        for (int i = 0; i < N; ++i)
+            maxError = max(maxError, fabs(filt[i] - rowMajor[i*NC+c]));
+    }
+    return maxError;
+}
+
+void testLowpassIIR(const vector<double>& data)
+{
+    vector<double> out(N*NC);
+    Clock::time_point start = Clock::now();
+    ASSERT(Signal::LowpassIIR(T, 6.0, N, NC, &data[0], &out[0]) == 0);
+    double multiTime = secondsSince(start);
+
+    double singleTime;
+    double err = compareToSingleChannel(data, out,
+        [](double* sig, double* sigf) {
+            Signal::LowpassIIR(T, 6.0, N, sig, sigf); },
+        singleTime);
+    cout << "LowpassIIR: single-channel " << singleTime << " s, "
+         << "multi-channel " << multiTime << " s." << endl;
+    ASSERT_EQUAL(0.0, err, 1e-12, __FILE__, __LINE__);
+}
+
+void testLowpassFIR(const vector<double>& data)
+{
+    vector<double> out(N*NC);
+    Clock::time_point start = Clock::now();
+    ASSERT(Signal::LowpassFIR(ORDER, T, 6.0, N, NC, &data[0], &out[0]) == 0);
+    double multiTime = secondsSince(start);
+
+    double singleTime;
+    double err = compareToSingleChannel(data, out,
+        [](double* sig, double* sigf) {
+            Signal::LowpassFIR(ORDER, T, 6.0, N, sig, sigf); },
+        singleTime);
+    cout << "LowpassFIR: single-channel " << singleTime << " s, "
+         << "multi-channel " << multiTime << " s." << endl;
+    ASSERT_EQUAL(0.0, err, 1e-12, __FILE__, __LINE__);
+}
+
+void testBandpassFIR(const vector<double>& data)
+{
+    // Filter in place to check that aliasing the buffers is allowed.
+    vector<double> out = data;
+    ASSERT(Signal::BandpassFIR(ORDER, T, 10.0, 150.0, N, NC,
+            &out[0], &out[0]) == 0);
+
+    double singleTime;
+    double err = compareToSingleChannel(data, out,
+        [](double* sig, double* sigf) {
+            Signal::BandpassFIR(ORDER, T, 10.0, 150.0, N, sig, sigf); },
+        singleTime);
+    ASSERT_EQUAL(0.0, err, 1e-12, __FILE__, __LINE__);
+}
+
+void testStorageLowpass()
+{
+    // Storage filtering goes through the multi-channel path; its columns
+    // must match filtering each column on its own.
+    const int n = 2000, nc = 5;
+    Storage storage;
+    for (int i = 0; i < n; ++i) {
+        Array<double> row(0.0, nc);
+        for (int c = 0; c < nc; ++c) row[c] = sin(0.01*i*(c+1));
+        storage.append(i*T, nc, &row[0]);
+    }
+    Storage original(storage);
+    storage.lowpassIIR(6.0);
+    double dt = original.resample(original.getMinTimeStep(), 5);
+    ASSERT(storage.getSize() == original.getSize());
+
+    Array<double> col, filtered, expected;
+    for (int c = 0; c < nc; ++c) {
+        original.getDataColumn(c, col);
+        storage.getDataColumn(c, filtered);
+        expected.setSize(col.getSize());
+        Signal::LowpassIIR(dt, 6.0, col.getSize(),
+                &col[0], &expected[0]);
+        for (int i = 0; i < col.getSize(); ++i)
+            ASSERT_EQUAL(expected[i], filtered[i], 1e-12, __FILE__, __LINE__);
+    }
+}
+
+int main() {
+    try {
+        vector<double> data;
+        fillSignals(data);
+        testLowpassIIR(data);
+        testLowpassFIR(data);
+        testBandpassFIR(data);
+        testStorageLowpass();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
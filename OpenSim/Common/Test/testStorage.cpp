@@ -20,13 +20,36 @@
  * limitations under the License.                                             *
  * -------------------------------------------------------------------------- */
 
+#include <cmath>
 #include <fstream>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/StorageWriter.h>
 #include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
 
 using namespace OpenSim;
 using namespace std;
 
+// Compare the rows streamed to a file by a Storage with its rows in memory.
+void checkStreamedRows(const string& fileName, const Storage& storage,
+                       double tol)
+{
+    ifstream file(fileName);
+    string line;
+    while(getline(file, line) && line!=Storage::DEFAULT_HEADER_TOKEN) {}
+    getline(file, line); // column labels
+    double value;
+    for(int i=0; i<storage.getSize(); i++){
+        const StateVector& row = *storage.getStateVector(i);
+        ASSERT(bool(file >> value));
+        ASSERT_EQUAL(row.getTime(), value, tol, __FILE__, __LINE__);
+        for(int j=0; j<row.getSize(); j++){
+            ASSERT(bool(file >> value));
+            ASSERT_EQUAL(row.getData()[j], value, tol, __FILE__, __LINE__);
+        }
+    }
+    ASSERT(!(file >> value));
+}
+
 int main() {
     try {
         // Create a storage from a std file "std_storage.sto"
@@ -72,6 +95,63 @@ int main() {
         ASSERT(fabs(diff) < 1E-7);
 
         delete st;
+
+        // Lookups by time, including repeated times, agree with a linear
+        // scan whether or not they start from a good guess.
+        Storage st3;
+        double times[] = {0.0, 0.1, 0.2, 0.2, 0.3, 0.5, 0.8, 0.8, 0.8, 1.0};
+        for(i=0; i<10; i++){
+            double data[] = {times[i], 2*times[i]};
+            st3.append(times[i], 2, data, false);
+        }
+        Storage::InterpolationCursor cursor(st3);
+        double y[2];
+        for(double t=-0.05; t<1.1; t+=0.01){
+            int expected = 0;
+            for(int j=0; j<st3.getSize(); j++)
+                if(times[j]<=t) expected = j;
+            ASSERT(st3.findIndex(t)==expected);
+            ASSERT(st3.findIndex(3, t)==expected);
+            ASSERT(cursor.findIndex(t)==expected);
+
+            ASSERT(cursor.getDataAtTime(t, 2, y)==2);
+            Array<double> yStorage(0.0, 2);
+            st3.getDataAtTime(t, 2, yStorage);
+            ASSERT(y[0]==yStorage[0] && y[1]==yStorage[1]);
+        }
+        cursor.getDataAtTime(0.65, 2, y);
+        ASSERT_EQUAL(0.65, y[0], 1e-12, __FILE__, __LINE__);
+        ASSERT_EQUAL(1.3, y[1], 1e-12, __FILE__, __LINE__);
+
+        // Rows appended after setOutputFileName() are streamed to the
+        // file; they are all on disk after flushOutputFile().
+        Array<string> labels;
+        labels.append("time");
+        labels.append("a");
+        labels.append("b");
+        Storage st4;
+        st4.setColumnLabels(labels);
+        st4.setOutputFileName("testStorage_streamed.sto");
+        for(i=0; i<5000; i++){
+            double data[] = {sin(0.01*i), 1.0/(i+1)};
+            st4.append(0.001*i, 2, data);
+        }
+        st4.flushOutputFile();
+        checkStreamedRows("testStorage_streamed.sto", st4, 1e-8);
+        st4.closeOutputFile();
+
+        // With round-trip formatting, the values read back exactly.
+        StorageWriter::setDefaultRoundTrip(true);
+        Storage st5;
+        st5.setColumnLabels(labels);
+        st5.setOutputFileName("testStorage_roundTrip.sto");
+        for(i=0; i<100; i++){
+            double data[] = {i/3.0, 1e-300*exp(0.1*i)};
+            st5.append(0.1*i, 2, data);
+        }
+        st5.closeOutputFile();
+        StorageWriter::setDefaultRoundTrip(false);
+        checkStreamedRows("testStorage_roundTrip.sto", st5, 0.0);
     }
     catch (const Exception& e) {
         e.print(cerr);
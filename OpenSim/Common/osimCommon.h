@@ -48,5 +48,11 @@
 #include "LoadOpenSimLibrary.h"
 #include "RegisterTypes_osimCommon.h"   // to expose RegisterTypes_osimCommon
 #include "SmoothSegmentedFunctionFactory.h"
+#include "Profiler.h"
+#include "Logger.h"
+#include "ActiveSetQP.h"
+#include "C3DFile.h"
+#include "StorageWriter.h"
+#include "ScratchArena.h"
 
 #endif // _osimCommon_h_
@@ -161,10 +161,10 @@ void PrescribedController::extendConnectToModel(Model& model)
 void PrescribedController::computeControls(const SimTK::State& s, SimTK::Vector& controls) const
 {
     SimTK::Vector actControls(1, 0.0);
-    SimTK::Vector time(1, s.getTime());
+    const double time = s.getTime();
 
     for(int i=0; i<getActuatorSet().getSize(); i++){
-        actControls[0] = get_ControlFunctions()[i].calcValue(time);
+        actControls[0] = get_ControlFunctions()[i].calcScalarValue(time);
         getActuatorSet()[i].addInControls(actControls, controls);
     }  
 }
@@ -90,9 +90,8 @@ const SimTK::Array_<std::string>& CoordinateReference::getNames() const
 /** get the values of the CoordinateReference */
 void CoordinateReference::getValues(const SimTK::State &s, SimTK::Array_<double> &values) const
 {
-    SimTK::Vector t(1, s.getTime());
     values.resize(getNumRefs());
-    values[0] = _coordinateValueFunction->calcValue(t);
+    values[0] = _coordinateValueFunction->calcScalarValue(s.getTime());
 }
 
 
@@ -107,24 +106,19 @@ void CoordinateReference::getWeights(const SimTK::State &s, SimTK::Array_<double
 /** get the value of the CoordinateReference */
 double CoordinateReference::getValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    return _coordinateValueFunction->calcValue(t);
+    return _coordinateValueFunction->calcScalarValue(s.getTime());
 }
 
 /** get the speed value of the CoordinateReference */
 double CoordinateReference::getSpeedValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    std::vector<int> order(1, 0);
-    return _coordinateValueFunction->calcDerivative(order, t);
+    return _coordinateValueFunction->calcScalarDerivative(1, s.getTime());
 }
 
 /** get the acceleration value of the CoordinateReference */
 double CoordinateReference::getAccelerationValue(const SimTK::State &s) const
 {
-    SimTK::Vector t(1, s.getTime());
-    std::vector<int> order(2, 0);
-    return _coordinateValueFunction->calcDerivative(order, t);
+    return _coordinateValueFunction->calcScalarDerivative(2, s.getTime());
 }
 
 /** get the weight of the CoordinateReference */
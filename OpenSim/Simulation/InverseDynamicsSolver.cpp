@@ -23,7 +23,11 @@
 
 #include "InverseDynamicsSolver.h"
 #include "Model/Model.h"
+#include "Model/GeometryPath.h"
 #include <OpenSim/Common/FunctionSet.h>
+#include <algorithm>
+#include <exception>
+#include <thread>
 
 using namespace std;
 using namespace SimTK;
@@ -114,9 +118,10 @@ Vector InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, doub
     Vector &udot = s.updUDot();
 
     for(int i=0; i<nq; i++){
-        q[i] = Qs.evaluate(i, 0, time);
-        u[i] = Qs.evaluate(i, 1, time);
-        udot[i] = Qs.evaluate(i, 2, time);
+        const SimTK::Vec3 qi = Qs[i].calcScalarValueAndDerivatives(time);
+        q[i] = qi[0];
+        u[i] = qi[1];
+        udot[i] = qi[2];
     }
 
     // Perform general inverse dynamics
@@ -141,4 +146,88 @@ void InverseDynamicsSolver::solve(SimTK::State &s, const FunctionSet &Qs, const
     }
 }
 
+int InverseDynamicsSolver::getNumThreadsForFrames(int numThreads, int nt)
+{
+    // Below this many frames per thread, starting a thread and copying the
+    // State costs more than the frames it would solve.
+    const int minFramesPerThread = 16;
+    if (numThreads <= 0)
+        numThreads = std::max(1, int(std::thread::hardware_concurrency()));
+    return std::max(1, std::min(numThreads, nt/minFramesPerThread));
+}
+
+bool InverseDynamicsSolver::canSolveFramesConcurrently(const Model& model)
+{
+    for (const GeometryPath& path : model.getComponentList<GeometryPath>()) {
+        if (path.getWrapSet().getSize() > 0)
+            return false;
+    }
+    return true;
+}
+
+/** Same as above but frames are solved concurrently into a matrix */
+void InverseDynamicsSolver::solve(const SimTK::State &s, const FunctionSet &Qs,
+    const Array_<double> &times, Matrix &genForceTrajectory, int numThreads)
+{
+    int nq = getModel().getNumCoordinates();
+    int nt = times.size();
+
+    if (genForceTrajectory.nrow() != nt || genForceTrajectory.ncol() != nq)
+        genForceTrajectory.resize(nt, nq);
+    if (nt == 0)
+        return;
+
+    solveFramesConcurrently(getModel(), s, nt, numThreads,
+        [&](State& sThread, int begin, int end) {
+            for (int i = begin; i < end; ++i)
+                genForceTrajectory[i] = ~solve(sThread, Qs, times[i]);
+        });
+}
+
+void InverseDynamicsSolver::solveFramesConcurrently(const Model& model,
+    const SimTK::State& s, int nt, int numThreads,
+    const std::function<void(SimTK::State& s, int begin, int end)>& solveFrames)
+{
+    if (nt <= 0)
+        return;
+
+    // Solve the first frame on this thread. This also creates anything the
+    // model and the coordinate functions allocate lazily on first use, which
+    // is not safe to do concurrently.
+    State s0 = s;
+    solveFrames(s0, 0, 1);
+
+    int nThreads = canSolveFramesConcurrently(model) ?
+                   getNumThreadsForFrames(numThreads, nt - 1) : 1;
+    if (nThreads == 1) {
+        solveFrames(s0, 1, nt);
+        return;
+    }
+
+    // Each thread solves a contiguous block of frames with its own State.
+    std::vector<std::exception_ptr> errors(nThreads);
+    auto solveBlock = [&](int thread, int begin, int end) {
+        try {
+            State sThread = s0;
+            solveFrames(sThread, begin, end);
+        }
+        catch (...) {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    int numFrames = nt - 1;
+    for (int t = 0; t < nThreads; ++t) {
+        int begin = 1 + (t*numFrames)/nThreads;
+        int end = 1 + ((t+1)*numFrames)/nThreads;
+        threads.push_back(std::thread(solveBlock, t, begin, end));
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    for (const auto& error : errors)
+        if (error) std::rethrow_exception(error);
+}
+
 } // end of namespace OpenSim
\ No newline at end of file
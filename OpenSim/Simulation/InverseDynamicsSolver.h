@@ -24,6 +24,7 @@
  * -------------------------------------------------------------------------- */
 
 #include "Solver.h"
+#include <functional>
 
 namespace OpenSim {
 
@@ -97,6 +98,50 @@ public:
     virtual void solve(SimTK::State& s, const FunctionSet& Qs, 
                  const SimTK::Array_<double>&  times,
                  SimTK::Array_<SimTK::Vector>& genForceTrajectory);
+
+    /** Solve for the generalized-coordinate forces over a time series,
+        evaluating frames concurrently. Each worker thread solves a contiguous
+        block of frames using its own copy of the State, and row i of
+        genForceTrajectory (resized to times.size() x nq if necessary) holds
+        the forces at times[i]. Unlike the Array_ version above, the model's
+        analyses are NOT stepped; use that version if they are needed.
+        @param[in] s       a realized state of the model used as the template
+                           for the per-thread states; it is not modified
+        @param[in] numThreads  the number of threads to use; 0 (the default)
+                           uses the number of available processors and 1
+                           solves serially on the calling thread. Models
+                           that cannot be realized concurrently (see
+                           canSolveFramesConcurrently()) are always solved
+                           serially. */
+    void solve(const SimTK::State& s, const FunctionSet& Qs,
+               const SimTK::Array_<double>& times,
+               SimTK::Matrix& genForceTrajectory, int numThreads = 0);
+
+    /** The number of threads that solving nt frames with the requested
+        number of threads (0 for all available processors) will use. Small
+        trajectories use fewer threads so each has enough work to amortize
+        starting it. */
+    static int getNumThreadsForFrames(int numThreads, int nt);
+
+    /** Whether states of the model may be realized on several threads at
+        once. Realizing a GeometryPath that has wrap objects records the wrap
+        it found in the PathWrap, not in the State, so models with such paths
+        are not. */
+    static bool canSolveFramesConcurrently(const Model& model);
+
+    /** Call solveFrames(state, begin, end) over contiguous blocks of the
+        frames [0, nt), concurrently. The first frame is solved alone on the
+        calling thread, so that anything the model creates lazily on first use
+        exists before going concurrent; the remaining frames are split over
+        getNumThreadsForFrames(numThreads, nt - 1) threads, each given its own
+        copy of s, or solved on the calling thread if the model cannot be
+        realized concurrently (see canSolveFramesConcurrently()). An exception
+        thrown on any thread is rethrown here once all threads have
+        finished. */
+    static void solveFramesConcurrently(const Model& model,
+        const SimTK::State& s, int nt, int numThreads,
+        const std::function<void(SimTK::State& s, int begin, int end)>&
+            solveFrames);
 #endif
 //=============================================================================
 };  // END of class InverseDynamicsSolver
@@ -26,6 +26,7 @@
 #include "MarkersReference.h"
 #include "Model/Model.h"
 #include "Model/MarkerSet.h"
+#include <chrono>
 
 using namespace std;
 using namespace SimTK;
@@ -77,6 +78,29 @@ InverseKinematicsSolver::InverseKinematicsSolver(const Model &model, MarkersRefe
     if(cnt < 4)
         cout << "WARNING: InverseKinematicsSolver found only " << cnt << " markers to track." << endl;
 
+    _useMarkerTracker = false;
+    _warmStartOrder = 1;
+    _maxTrackIterations = 20;
+    _numTrackIterations = -1;
+    _trackTime = 0;
+    _trackerApplicable = false;
+    _trackedByTracker = false;
+    _numHistory = 0;
+    _markerWeightScale = 0;
+}
+
+void InverseKinematicsSolver::setWarmStartOrder(int order)
+{
+    if(order < 0 || order > 2)
+        throw Exception("InverseKinematicsSolver::setWarmStartOrder: order must be 0, 1 or 2.");
+    _warmStartOrder = order;
+}
+
+void InverseKinematicsSolver::setMaxTrackIterations(int maxIterations)
+{
+    if(maxIterations < 1)
+        throw Exception("InverseKinematicsSolver::setMaxTrackIterations: at least one iteration is required.");
+    _maxTrackIterations = maxIterations;
 }
 
 /** Change the weighting of a marker to take affect when assemble or track is called next. 
@@ -95,6 +119,8 @@ void InverseKinematicsSolver::updateMarkerWeight(int markerIndex, double value)
     if(markerIndex >=0 && markerIndex < _markersReference.updMarkerWeightSet().getSize()){
         _markersReference.updMarkerWeightSet()[markerIndex].setWeight(value);
         _markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(markerIndex), value);
+        if(markerIndex < (int)_trackedMarkers.size())
+            _trackedMarkers[markerIndex].weight = value;
     }
     else
         throw Exception("InverseKinematicsSolver::updateMarkerWeight: invalid markerIndex.");
@@ -108,6 +134,8 @@ void InverseKinematicsSolver::updateMarkerWeights(const SimTK::Array_<double> &w
         for(unsigned int i=0; i<weights.size(); i++){
             _markersReference.updMarkerWeightSet()[i].setWeight(weights[i]);
             _markerAssemblyCondition->changeMarkerWeight(SimTK::Markers::MarkerIx(i), weights[i]);
+            if(i < _trackedMarkers.size())
+                _trackedMarkers[i].weight = weights[i];
         }
     }
     else
@@ -126,6 +154,8 @@ SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(const std::str
 SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(int markerIndex)
 {
     if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
+        if(_trackedByTracker)
+            return _trackedLocations[markerIndex];
         return _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(markerIndex));
     }
     else
@@ -135,6 +165,10 @@ SimTK::Vec3 InverseKinematicsSolver::computeCurrentMarkerLocation(int markerInde
 /** Compute and return the spatial locations of all markers in ground. */
 void InverseKinematicsSolver::computeCurrentMarkerLocations(SimTK::Array_<SimTK::Vec3> &markerLocations)
 {
+    if(_trackedByTracker){
+        markerLocations = _trackedLocations;
+        return;
+    }
     markerLocations.resize(_markerAssemblyCondition->getNumMarkers());
     for(unsigned int i=0; i<markerLocations.size(); i++)
         markerLocations[i] = _markerAssemblyCondition->findCurrentMarkerLocation(SimTK::Markers::MarkerIx(i));
@@ -153,6 +187,8 @@ double InverseKinematicsSolver::computeCurrentMarkerError(const std::string &mar
 double InverseKinematicsSolver::computeCurrentMarkerError(int markerIndex)
 {
     if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
+        if(_trackedByTracker)
+            return sqrt(calcTrackedMarkerErrorSquared(markerIndex));
         return _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(markerIndex));
     }
     else
@@ -164,7 +200,8 @@ void InverseKinematicsSolver::computeCurrentMarkerErrors(SimTK::Array_<double> &
 {
     markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
     for(unsigned int i=0; i<markerErrors.size(); i++)
-        markerErrors[i] = _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(i));
+        markerErrors[i] = _trackedByTracker ? sqrt(calcTrackedMarkerErrorSquared(i)) :
+            _markerAssemblyCondition->findCurrentMarkerError(SimTK::Markers::MarkerIx(i));
 }
 
 
@@ -180,6 +217,8 @@ double InverseKinematicsSolver::computeCurrentSquaredMarkerError(const std::stri
 double InverseKinematicsSolver::computeCurrentSquaredMarkerError(int markerIndex)
 {
     if(markerIndex >=0 && markerIndex < _markerAssemblyCondition->getNumMarkers()){
+        if(_trackedByTracker)
+            return calcTrackedMarkerErrorSquared(markerIndex);
         return _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(markerIndex));
     }
     else
@@ -191,7 +230,8 @@ void InverseKinematicsSolver::computeCurrentSquaredMarkerErrors(SimTK::Array_<do
 {
     markerErrors.resize(_markerAssemblyCondition->getNumMarkers());
     for(unsigned int i=0; i<markerErrors.size(); i++)
-        markerErrors[i] = _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(i));
+        markerErrors[i] = _trackedByTracker ? calcTrackedMarkerErrorSquared(i) :
+            _markerAssemblyCondition->findCurrentMarkerErrorSquared(SimTK::Markers::MarkerIx(i));
 }
 
 /** Marker errors are reported in order different from tasks file or model, find name corresponding to passed in index  */
@@ -205,9 +245,54 @@ std::string InverseKinematicsSolver::getMarkerNameForIndex(int markerIndex) cons
     of the base assembly solver, that is going to do the assembly.  */
 void InverseKinematicsSolver::setupGoals(SimTK::State &s)
 {
+    // Find the mobilities the marker tracker may change before the base class
+    // unlocks the locked coordinates in the working state.
+    const SimTK::SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    const CoordinateSet& modelCoordSet = getModel().getCoordinateSet();
+    _isFreeQ.assign(s.getNQ(), true);
+    std::vector<bool> isFreeU(s.getNU(), true);
+    _clampedQs.clear();
+    _trackerApplicable = true;
+    for(int i=0; i<modelCoordSet.getSize(); ++i){
+        const Coordinate& coord = modelCoordSet[i];
+        const SimTK::MobilizedBody& mobod = matter.getMobilizedBody(coord.getBodyIndex());
+        const int q = mobod.getFirstQIndex(s) + coord.getMobilizerQIndex();
+        if(coord.getLocked(s)){
+            _isFreeQ[q] = false;
+            isFreeU[mobod.getFirstUIndex(s) + coord.getMobilizerQIndex()] = false;
+        }
+        else if(coord.isPrescribed(s))
+            _trackerApplicable = false;
+        else if(coord.getClamped(s)){
+            ClampedQ clamped = {SimTK::QIndex(q), coord.getRangeMin(), coord.getRangeMax()};
+            _clampedQs.push_back(clamped);
+        }
+    }
+    _freeUs.clear();
+    for(int i=0; i<s.getNU(); ++i)
+        if(isFreeU[i]) _freeUs.push_back(i);
+    const ConstraintSet& constraints = getModel().getConstraintSet();
+    for(int i=0; i<constraints.getSize(); ++i)
+        if(!constraints[i].isDisabled(s))
+            _trackerApplicable = false;
+
     // Setup coordinates performed by the base class
     AssemblySolver::setupGoals(s);
 
+    _trackedCoordinates.clear();
+    for(unsigned int i=0; i<_coordinateReferencesp.size(); ++i){
+        const Coordinate& coord = modelCoordSet.get(_coordinateReferencesp[i].getName());
+        if(coord.get_is_free_to_satisfy_constraints())
+            continue;
+        const SimTK::MobilizedBody& mobod = matter.getMobilizedBody(coord.getBodyIndex());
+        TrackedCoordinate tracked = {int(i),
+            SimTK::QIndex(mobod.getFirstQIndex(s) + coord.getMobilizerQIndex()), 0, 0};
+        _trackedCoordinates.push_back(tracked);
+    }
+    _trackedMarkers.clear();
+    _markerBodies.clear();
+    _markerStations.clear();
+
     _markerAssemblyCondition = new SimTK::Markers();
 
     // Setup markers goals
@@ -240,6 +325,12 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
 
                 markerWeights[i]);
 
+            TrackedMarker tracked = {mobod.getMobilizedBodyIndex(),
+                X_BF*marker.get_location(), int(i), markerWeights[i]};
+            _trackedMarkers.push_back(tracked);
+            _markerBodies.push_back(tracked.body);
+            _markerStations.push_back(tracked.station);
+
             //cout << "IKSolver Marker: " << markerNames[i] << " " << marker.getName() << "  weight: " << markerWeights[i] << endl;
         }
     }
@@ -249,6 +340,7 @@ void InverseKinematicsSolver::setupGoals(SimTK::State &s)
     // lock-in the order that the observations (markers) are in and this cannot change from frame to frame
     // and we can use an array of just the data for updating
     _markerAssemblyCondition->defineObservationOrder(markerNames);
+    _trackedLocations.resize(unsigned(_trackedMarkers.size()));
 
     updateGoals(s);
 }
@@ -265,4 +357,280 @@ void InverseKinematicsSolver::updateGoals(const SimTK::State &s)
     _markerAssemblyCondition->moveAllObservations(_markerValues);
 }
 
+void InverseKinematicsSolver::assemble(SimTK::State &s)
+{
+    AssemblySolver::assemble(s);
+    _trackedByTracker = false;
+    _numTrackIterations = -1;
+    _numHistory = 0;
+    pushSolution(s);
+}
+
+void InverseKinematicsSolver::track(SimTK::State &s)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    if(_useMarkerTracker && _trackerApplicable){
+        if(!_assembler || !_assembler->isInitialized())
+            throw Exception(
+                "InverseKinematicsSolver::track() failed: assemble() must be called first.");
+        _markersReference.getValues(s, _markerValues);
+        predictQ(s);
+        _numTrackIterations = solveMarkerTracking(s);
+        _trackedByTracker = true;
+    }
+    else{
+        AssemblySolver::track(s);
+        _numTrackIterations = -1;
+        _trackedByTracker = false;
+    }
+    pushSolution(s);
+
+    _trackTime = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start).count();
+}
+
+/* Keep the last three solutions, most recent first. Solving the same time
+   again replaces the solution at that time, so that the times of the history
+   are distinct. */
+void InverseKinematicsSolver::pushSolution(const SimTK::State &s)
+{
+    if(_numHistory == 0 || s.getTime() != _tHistory[0]){
+        for(int k = std::min(_numHistory, 2); k > 0; --k){
+            _qHistory[k] = _qHistory[k-1];
+            _tHistory[k] = _tHistory[k-1];
+        }
+        _numHistory = std::min(_numHistory+1, 3);
+    }
+    _qHistory[0] = s.getQ();
+    _tHistory[0] = s.getTime();
+}
+
+/* Evaluate the Lagrange polynomial through the last (order+1) solutions at
+   the time of s for each free q. */
+void InverseKinematicsSolver::predictQ(SimTK::State &s) const
+{
+    const int n = std::min(_numHistory, _warmStartOrder+1);
+    if(n == 0 || _qHistory[0].size() != s.getNQ())
+        return;
+
+    const double t = s.getTime();
+    double L[3] = {1.0, 1.0, 1.0};
+    for(int k=0; k<n; ++k)
+        for(int j=0; j<n; ++j)
+            if(j != k)
+                L[k] *= (t - _tHistory[j])/(_tHistory[k] - _tHistory[j]);
+
+    SimTK::Vector& q = s.updQ();
+    for(int i=0; i<q.size(); ++i){
+        if(!_isFreeQ[i]) continue;
+        double value = 0;
+        for(int k=0; k<n; ++k)
+            value += L[k]*_qHistory[k][i];
+        q[i] = value;
+    }
+    clampQ(s);
+}
+
+void InverseKinematicsSolver::clampQ(SimTK::State &s) const
+{
+    for(unsigned int i=0; i<_clampedQs.size(); ++i){
+        const ClampedQ& clamped = _clampedQs[i];
+        double& q = s.updQ()[clamped.q];
+        q = SimTK::clamp(clamped.min, q, clamped.max);
+    }
+}
+
+double InverseKinematicsSolver::calcTrackedMarkerErrorSquared(int markerIndex) const
+{
+    const SimTK::Vec3& observed =
+        _markerValues[_trackedMarkers[markerIndex].observation];
+    // Markers without an observation in this frame have no error.
+    if(observed.isNaN())
+        return 0;
+    return (_trackedLocations[markerIndex] - observed).normSqr();
+}
+
+double InverseKinematicsSolver::calcTrackingResiduals(const SimTK::State &s)
+{
+    getModel().getMultibodySystem().realize(s, SimTK::Stage::Position);
+    const SimTK::SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+
+    const int nm = int(_trackedMarkers.size());
+    for(int m=0; m<nm; ++m){
+        const TrackedMarker& marker = _trackedMarkers[m];
+        _trackedLocations[m] = matter.getMobilizedBody(marker.body).
+            findStationLocationInGround(s, marker.station);
+        const SimTK::Vec3& observed = _markerValues[marker.observation];
+        const SimTK::Vec3 r = observed.isNaN() ? SimTK::Vec3(0) :
+            sqrt(_markerWeightScale*marker.weight)*(_trackedLocations[m] - observed);
+        for(int k=0; k<3; ++k)
+            _residuals[3*m+k] = r[k];
+    }
+    for(unsigned int c=0; c<_trackedCoordinates.size(); ++c){
+        const TrackedCoordinate& coord = _trackedCoordinates[c];
+        _residuals[3*nm+c] =
+            sqrt(coord.weight)*(s.getQ()[coord.q] - coord.value);
+    }
+    return 0.5*_residuals.normSqr();
+}
+
+/* Levenberg-Marquardt on the weighted residuals r(q) of the markers and the
+   coordinates, whose sum of squares is the objective of the Assembler. The
+   Jacobian is taken with respect to the free generalized speeds u, for which
+   the marker rows are the station Jacobians and the coordinate rows are rows
+   of N, where qdot = N u. A step du of the damped
+   normal equations
+        (J'J + lambda*diag(J'J)) du = -J'r
+   is mapped to the q's by dq = N du and accepted if it reduces the cost. */
+int InverseKinematicsSolver::solveMarkerTracking(SimTK::State &s)
+{
+    const SimTK::SimbodyMatterSubsystem& matter = getModel().getMatterSubsystem();
+    const int nm = int(_trackedMarkers.size());
+    const int nc = int(_trackedCoordinates.size());
+    const int nr = 3*nm + nc;
+    const int nf = int(_freeUs.size());
+
+    // As in SimTK::Markers, the marker term is the weighted mean of the
+    // squared errors of the markers observed in this frame.
+    double totalWeight = 0;
+    for(int m=0; m<nm; ++m)
+        if(!_markerValues[_trackedMarkers[m].observation].isNaN())
+            totalWeight += _trackedMarkers[m].weight;
+    _markerWeightScale = totalWeight > 0 ? 1/totalWeight : 0;
+
+    // Reference values and weights of the coordinates in this frame.
+    for(int c=0; c<nc; ++c){
+        TrackedCoordinate& coord = _trackedCoordinates[c];
+        coord.value = _coordinateReferencesp[coord.reference].getValue(s);
+        coord.weight = _coordinateReferencesp[coord.reference].getWeight(s);
+    }
+
+    _residuals.resize(nr);
+    _jacobian.resize(nr, nf);
+    _normal.resize(nf, nf);
+    _factor.resize(nf, nf);
+    _gradient.resize(nf);
+    _step.resize(nf);
+    _du.resize(s.getNU());
+    _dq.resize(s.getNQ());
+    _unitQ.resize(s.getNQ());
+
+    double cost = calcTrackingResiduals(s);
+    if(nf == 0)
+        return 0;
+
+    double lambda = 1e-3;
+    int iterations = 0;
+    bool residualsAreCurrent = true;
+    while(iterations < _maxTrackIterations){
+        ++iterations;
+
+        // Weighted Jacobian of the residuals for the free mobilities.
+        matter.calcStationJacobian(s, _markerBodies, _markerStations,
+                                   _stationJacobian);
+        for(int m=0; m<nm; ++m){
+            const TrackedMarker& marker = _trackedMarkers[m];
+            const double w = _markerValues[marker.observation].isNaN() ?
+                0 : sqrt(_markerWeightScale*marker.weight);
+            for(int k=0; k<3; ++k)
+                for(int j=0; j<nf; ++j)
+                    _jacobian(3*m+k, j) = w*_stationJacobian(3*m+k, _freeUs[j]);
+        }
+        for(int c=0; c<nc; ++c){
+            const TrackedCoordinate& coord = _trackedCoordinates[c];
+            _unitQ = 0;
+            _unitQ[coord.q] = 1;
+            matter.multiplyByN(s, true, _unitQ, _rowOfN);
+            const double w = sqrt(coord.weight);
+            for(int j=0; j<nf; ++j)
+                _jacobian(3*nm+c, j) = w*_rowOfN[_freeUs[j]];
+        }
+
+        // Normal equations, lower triangle, and the gradient J'r.
+        for(int i=0; i<nf; ++i){
+            for(int j=0; j<=i; ++j){
+                double sum = 0;
+                for(int r=0; r<nr; ++r)
+                    sum += _jacobian(r, i)*_jacobian(r, j);
+                _normal(i, j) = sum;
+            }
+            double sum = 0;
+            for(int r=0; r<nr; ++r)
+                sum += _jacobian(r, i)*_residuals[r];
+            _gradient[i] = sum;
+        }
+
+        _qStart = s.getQ();
+        bool accepted = false;
+        double newCost = cost;
+        while(!accepted && lambda < 1e10){
+            // Cholesky factorization of the damped normal equations.
+            bool positive = true;
+            for(int j=0; j<nf && positive; ++j){
+                double d = (1 + lambda)*_normal(j, j) + lambda*SimTK::SignificantReal;
+                for(int k=0; k<j; ++k)
+                    d -= _factor(j, k)*_factor(j, k);
+                if(d <= 0){
+                    positive = false;
+                    break;
+                }
+                _factor(j, j) = sqrt(d);
+                for(int i=j+1; i<nf; ++i){
+                    double sum = _normal(i, j);
+                    for(int k=0; k<j; ++k)
+                        sum -= _factor(i, k)*_factor(j, k);
+                    _factor(i, j) = sum/_factor(j, j);
+                }
+            }
+            if(!positive){
+                lambda *= 10;
+                continue;
+            }
+            for(int i=0; i<nf; ++i){
+                double sum = -_gradient[i];
+                for(int k=0; k<i; ++k)
+                    sum -= _factor(i, k)*_step[k];
+                _step[i] = sum/_factor(i, i);
+            }
+            for(int i=nf-1; i>=0; --i){
+                double sum = _step[i];
+                for(int k=i+1; k<nf; ++k)
+                    sum -= _factor(k, i)*_step[k];
+                _step[i] = sum/_factor(i, i);
+            }
+
+            _du = 0;
+            for(int j=0; j<nf; ++j)
+                _du[_freeUs[j]] = _step[j];
+            matter.multiplyByN(s, false, _du, _dq);
+            s.updQ() += _dq;
+            clampQ(s);
+            newCost = calcTrackingResiduals(s);
+            if(newCost <= cost){
+                accepted = true;
+                lambda = std::max(0.1*lambda, 1e-9);
+                residualsAreCurrent = true;
+            }
+            else{
+                // Reject the step and retry closer to steepest descent.
+                s.updQ() = _qStart;
+                getModel().getMultibodySystem().realize(s, SimTK::Stage::Position);
+                lambda *= 10;
+                residualsAreCurrent = false;
+            }
+        }
+        // No step reduces the cost: s is a minimum to working precision.
+        if(!accepted)
+            break;
+        cost = newCost;
+        if(_step.normInf() < _accuracy)
+            break;
+    }
+
+    if(!residualsAreCurrent)
+        calcTrackingResiduals(s);
+    return iterations;
+}
+
 } // end of namespace OpenSim
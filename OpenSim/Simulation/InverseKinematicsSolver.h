@@ -25,6 +25,7 @@
 
 #include "AssemblySolver.h"
 #include <OpenSim/Common/Set.h>
+#include <vector>
 
 namespace OpenSim {
 
@@ -54,6 +55,16 @@ class MarkersReference;
  *
  * See SimTK::Assembler for more algorithmic details of the underlying solver.
  *
+ * With setUseMarkerTracker(true), track() instead solves the weighted least-
+ * squares problem above directly with a Levenberg-Marquardt method, using the
+ * analytic station Jacobians of the markers, and starts each frame from a
+ * polynomial extrapolation of the solutions of the previous frames (see
+ * setWarmStartOrder()). Locked coordinates are held at their values in the
+ * state and clamped coordinates are kept in their ranges. Since constraint
+ * errors are not part of that problem, track() falls back to the Assembler
+ * when the model has enabled constraints. assemble() always uses the
+ * Assembler.
+ *
  * @author Ajay Seth
  * @version 1.0
  */
@@ -96,6 +107,34 @@ public:
         coordinate values can and should be updated between repeated calls
         to track a desired trajectory of coordinate values. */
     //virtual void track(SimTK::State &s);
+    void track(SimTK::State &s) override;
+
+    /** Assemble with the SimTK::Assembler and restart the history of
+        solutions used to predict the next frame for the marker tracker. */
+    void assemble(SimTK::State &s) override;
+
+    /** Use the dedicated marker tracker rather than the SimTK::Assembler in
+        track(). Takes effect at the next call to track(). */
+    void setUseMarkerTracker(bool useTracker) { _useMarkerTracker = useTracker; }
+    bool getUseMarkerTracker() const { return _useMarkerTracker; }
+
+    /** Order of the polynomial through the solutions of the previous frames
+        that the marker tracker extrapolates to start each frame: 0 starts
+        from the previous solution, 1 assumes constant velocity (default) and
+        2 constant acceleration. */
+    void setWarmStartOrder(int order);
+    int getWarmStartOrder() const { return _warmStartOrder; }
+
+    /** Maximum number of Jacobian evaluations of the marker tracker per
+        frame (default 20). */
+    void setMaxTrackIterations(int maxIterations);
+    int getMaxTrackIterations() const { return _maxTrackIterations; }
+
+    /** Number of Jacobian evaluations of the marker tracker in the last call
+        to track(), or -1 if the last frame was tracked by the Assembler. */
+    int getNumTrackIterations() const { return _numTrackIterations; }
+    /** Wall-clock time, in seconds, spent in the last call to track(). */
+    double getTrackTime() const { return _trackTime; }
 
     /** Change the weighting of a marker to take affect when assemble or track is called next. 
         Update a marker's weight by name. */
@@ -141,9 +180,75 @@ protected:
     virtual void updateGoals(const SimTK::State &s) override;
 
 private:
+    // Solve the tracking problem for the free mobilities, starting from the
+    // configuration in s, and return the number of Jacobian evaluations.
+    int solveMarkerTracking(SimTK::State &s);
+    // Set the free q's of s to the extrapolation of the previous solutions.
+    void predictQ(SimTK::State &s) const;
+    // Weighted residuals of the markers and coordinates at the configuration
+    // in s (realized to Position) and the half sum of their squares.
+    double calcTrackingResiduals(const SimTK::State &s);
+    void clampQ(SimTK::State &s) const;
+    double calcTrackedMarkerErrorSquared(int markerIndex) const;
+    void pushSolution(const SimTK::State &s);
+
     // Non-accessible cache of the marker values to be matched at a given state
     SimTK::Array_<SimTK::Vec3> _markerValues;
 
+    // Marker tracker settings and statistics of the last frame
+    bool _useMarkerTracker;
+    int _warmStartOrder;
+    int _maxTrackIterations;
+    int _numTrackIterations;
+    double _trackTime;
+    // True if the model has no enabled constraints and the tracker applies
+    bool _trackerApplicable;
+    // True if the last frame was solved by the tracker, so that the marker
+    // locations below, rather than the Assembler's, are current
+    bool _trackedByTracker;
+
+    // Markers in the order of the Markers assembly condition, with the index
+    // of their observation in _markerValues
+    struct TrackedMarker {
+        SimTK::MobilizedBodyIndex body;
+        SimTK::Vec3 station;
+        int observation;
+        double weight;
+    };
+    std::vector<TrackedMarker> _trackedMarkers;
+    SimTK::Array_<SimTK::MobilizedBodyIndex> _markerBodies;
+    SimTK::Array_<SimTK::Vec3> _markerStations;
+    SimTK::Array_<SimTK::Vec3> _trackedLocations;
+    // 1/(sum of the weights of the markers observed in the current frame)
+    double _markerWeightScale;
+
+    // Coordinate references tracked, by index in _coordinateReferencesp
+    struct TrackedCoordinate {
+        int reference;
+        SimTK::QIndex q;
+        // reference value and weight in the current frame
+        double value, weight;
+    };
+    std::vector<TrackedCoordinate> _trackedCoordinates;
+    struct ClampedQ {
+        SimTK::QIndex q;
+        double min, max;
+    };
+    std::vector<ClampedQ> _clampedQs;
+    // Mobilities that are not locked, and whether each q is free
+    std::vector<int> _freeUs;
+    std::vector<bool> _isFreeQ;
+
+    // Last (up to three) solutions and their times, most recent first
+    SimTK::Vector _qHistory[3];
+    double _tHistory[3];
+    int _numHistory;
+
+    // Work space of the tracker
+    SimTK::Vector _residuals, _gradient, _step, _du, _dq, _qStart;
+    SimTK::Vector _unitQ, _rowOfN;
+    SimTK::Matrix _stationJacobian, _jacobian, _normal, _factor;
+
 
 //=============================================================================
 };  // END of class InverseKinematicsSolver
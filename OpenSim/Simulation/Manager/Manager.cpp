@@ -33,6 +33,8 @@
 #include <OpenSim/Simulation/Control/Controller.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/Profiler.h>
 
 
 
@@ -695,11 +697,19 @@ integrate( SimTK::State& s, double dtFirst )
     s.setTime( _ti );
 
     // INTEGRATE
-    return(doIntegration(s, step, dtFirst));
+    bool completed = doIntegration(s, step, dtFirst);
+
+    // Write out the messages logged while integrating before the caller
+    // goes on to print its own, and the states streamed to a file (see
+    // Storage::setOutputFileName()) so the file is complete on return.
+    Logger::flush();
+    if(hasStateStorage()) getStateStorage().flushOutputFile();
+    return(completed);
 
 }
 
 bool Manager::doIntegration(SimTK::State& s, int step, double dtFirst ) {
+    OPENSIM_PROFILE_REGION("Manager::integrate");
 
     // CLEAR ANY INTERRUPT
     // Halts must arrive during an integration.
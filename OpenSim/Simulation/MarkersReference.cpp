@@ -150,10 +150,13 @@ void  MarkersReference::getValues(const SimTK::State &s, SimTK::Array_<Vec3> &va
     if(before > after || after < 0)
         throw Exception("MarkersReference: No index corresponding to time of frame.");
     else if(after-before > 0){
-        before = abs(_markerData->getFrame(before).getFrameTime()-time) < abs(_markerData->getFrame(after).getFrameTime()-time) ? before : after;
+        before = abs(_markerData->getFrameTime(before)-time) < abs(_markerData->getFrameTime(after)-time) ? before : after;
     }
 
-    values = _markerData->getFrame(before).getMarkers();
+    int nm = _markerData->getNumMarkers();
+    values.resize(nm);
+    for (int i = 0; i < nm; i++)
+        values[i] = _markerData->getMarker(before, i);
 }
 
 /** get the speed value of the MarkersReference */
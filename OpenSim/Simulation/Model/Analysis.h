@@ -37,6 +37,7 @@
 #include <OpenSim/Common/PropertyInt.h>
 #include <OpenSim/Common/ArrayPtrs.h>
 #include <OpenSim/Common/Array.h>
+#include <OpenSim/Common/ScratchArena.h>
 
 namespace OpenSim { 
 
@@ -91,6 +92,14 @@ protected:
     double &_endTime;
     ArrayPtrs<Storage> _storageList;
     bool _printResultFiles;
+#ifndef SWIG
+    /** Scratch memory for the temporary arrays of record(). Derived
+    analyses reset() it at the start of record() and may reserve() it in
+    begin(), so that these arrays are not allocated at every step. Recording
+    still allocates the rows it appends to Storage, and anything the model
+    allocates for the analysis (e.g., Force::getRecordValues()). */
+    ScratchArena _scratch;
+#endif
 
 //=============================================================================
 // METHODS
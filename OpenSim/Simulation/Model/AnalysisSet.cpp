@@ -31,6 +31,7 @@
 //=============================================================================
 #include "AnalysisSet.h"
 #include "Model.h"
+#include <OpenSim/Common/Profiler.h>
 
 
 using namespace OpenSim;
@@ -220,7 +221,10 @@ step( const SimTK::State& s, int stepNumber )
     int i;
     for(i=0;i<getSize();i++) {
         Analysis& analysis = get(i);
-        if (analysis.getOn()) analysis.step(s, stepNumber);
+        if (analysis.getOn()) {
+            OPENSIM_PROFILE_SCOPE(analysis, "Analysis::step");
+            analysis.step(s, stepNumber);
+        }
     }
 }
 //_____________________________________________________________________________
@@ -29,6 +29,7 @@
 
 
 // INCLUDES
+#include <memory>
 #include <string>
 #include <OpenSim/Common/Set.h>
 #include "Analysis.h"
@@ -39,6 +40,7 @@
 namespace OpenSim { 
 
 class Model;
+class KinematicsExtractor;
 
 /**
  * A class for holding and managing a set of integration callbacks for
@@ -65,6 +67,10 @@ protected:
     // testing for memory free error
     OpenSim::PropertyBool _enableProp;
     bool &_enable;
+
+private:
+    /** Shared by the kinematics analyses of the model owning this set. */
+    std::shared_ptr<KinematicsExtractor> _kinematicsExtractor;
 //
 //=============================================================================
 // METHODS
@@ -92,6 +98,16 @@ public:
     void setOn(bool aTrueFalse);
     void setOn(const Array<bool> &aOn);
     Array<bool> getOn() const;
+#ifndef SWIG
+    /** The KinematicsExtractor shared by the kinematics analyses of the
+    model that owns this set (see KinematicsExtractor::getShared()). It is
+    not copied with the set. */
+    const std::shared_ptr<KinematicsExtractor>& getKinematicsExtractor() const
+    {   return _kinematicsExtractor; }
+    void setKinematicsExtractor(
+            const std::shared_ptr<KinematicsExtractor>& extractor)
+    {   _kinematicsExtractor = extractor; }
+#endif
 
     //--------------------------------------------------------------------------
     // CALLBACKS
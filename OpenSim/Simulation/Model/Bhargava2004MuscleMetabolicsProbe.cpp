@@ -28,12 +28,43 @@
 //=============================================================================
 #include "Bhargava2004MuscleMetabolicsProbe.h"
 #include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Common/Logger.h>
+#include <algorithm>
+#include <vector>
 //#define DEBUG_METABOLICS
 
 using namespace std;
 using namespace SimTK;
 using namespace OpenSim;
 
+namespace {
+// Per-muscle inputs and intermediate heat rates, one array per quantity.
+// Kept per thread so that computeProbeInputs() does not allocate once the
+// arrays have grown to the number of muscles.
+struct MuscleArrays {
+    std::vector<double> mass, F_iso;
+    std::vector<double> fiberForceActive, fiberForceTotal;
+    std::vector<double> fiberLengthNormalized, fiberVelocity;
+    std::vector<double> slowTwitchExcitation, fastTwitchExcitation;
+    std::vector<double> activationConstantSlowTwitch;
+    std::vector<double> activationConstantFastTwitch;
+    std::vector<double> maintenanceConstantSlowTwitch;
+    std::vector<double> maintenanceConstantFastTwitch;
+    std::vector<double> Adot, Mdot, Sdot, Wdot;
+
+    void resize(int n) {
+        for (std::vector<double>* a : {&mass, &F_iso, &fiberForceActive,
+                &fiberForceTotal, &fiberLengthNormalized, &fiberVelocity,
+                &slowTwitchExcitation, &fastTwitchExcitation,
+                &activationConstantSlowTwitch, &activationConstantFastTwitch,
+                &maintenanceConstantSlowTwitch, &maintenanceConstantFastTwitch,
+                &Adot, &Mdot, &Sdot, &Wdot})
+            a->resize(n);
+    }
+};
+thread_local MuscleArrays muscleArrays;
+}
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND SETUP
@@ -249,8 +280,7 @@ SimTK::Vector Bhargava2004MuscleMetabolicsProbe::
 computeProbeInputs(const State& s) const
 {
     // Initialize metabolic energy rate values
-    double Adot, Mdot, Sdot, Bdot, Wdot;
-    Adot = Mdot = Sdot = Bdot = Wdot = 0;
+    double Bdot = 0;
     Vector EdotOutput(getNumProbeInputs());
     EdotOutput = 0;
 
@@ -263,7 +293,7 @@ computeProbeInputs(const State& s) const
         Bdot = get_basal_coefficient() 
             * pow(_model->getMatterSubsystem().calcSystemMass(s), get_basal_exponent());
         if (isNaN(Bdot))
-            cout << "WARNING::" << getName() << ": Bdot = NaN!" << endl;
+            OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Bdot = NaN!";
     }
     EdotOutput(0) += Bdot;       // TOTAL metabolic power storage
     
@@ -271,129 +301,172 @@ computeProbeInputs(const State& s) const
         EdotOutput(1) = Bdot;    // BASAL metabolic power storage
 
 
-    // Loop through each muscle in the MetabolicMuscleParameterSet
-    const int nM = 
-        get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet()
-        .getSize();
+    // Gather the inputs of every muscle in the MetabolicMuscleParameterSet
+    // into arrays, so that the heat rates below are computed one term at a
+    // time for all muscles.
+    const Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet& mmSet =
+        get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet();
+    const int nM = mmSet.getSize();
+    MuscleArrays& w = muscleArrays;
+    w.resize(nM);
+
+    const double scale = get_muscle_effort_scaling_factor();
+    Muscle::MetabolicsInputs inputs;
     for (int i=0; i<nM; i++)
     {
         // Get the current muscle parameters from the MetabolicMuscleParameterSet
         // and the corresponding OpenSim::Muscle pointer from the muscleMap.
-        Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
-            get_Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameterSet()[i];   
+        const Bhargava2004MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
+            mmSet[i];
         const Muscle* m = mm.getMuscle();
-
-        // Get important muscle values at the current time state
-        const double max_isometric_force = m->getMaxIsometricForce();
-        const double max_shortening_velocity = m->getMaxContractionVelocity();
-        const double activation = get_muscle_effort_scaling_factor()
-                                  * m->getActivation(s);
-        const double excitation = get_muscle_effort_scaling_factor()
-                                  * m->getControl(s);
-        const double fiber_force_passive = m->getPassiveFiberForce(s);
-        const double fiber_force_active = get_muscle_effort_scaling_factor()
-                                          * m->getActiveFiberForce(s);
-        const double fiber_force_total = fiber_force_active     // Scaled.
-                                         + fiber_force_passive;
-        const double fiber_length_normalized = m->getNormalizedFiberLength(s);
-        const double fiber_velocity = m->getFiberVelocity(s);
-        const double fiber_velocity_normalized = m->getNormalizedFiberVelocity(s);
-        const double slow_twitch_excitation = mm.get_ratio_slow_twitch_fibers() * sin(Pi/2 * excitation);
-        const double fast_twitch_excitation = (1 - mm.get_ratio_slow_twitch_fibers()) * (1 - cos(Pi/2 * excitation));
-        double alpha, fiber_length_dependence;
+        m->getMetabolicsInputs(s, inputs);
+
+        const double activation = scale * inputs.activation;
+        const double excitation = scale * inputs.excitation;
+        const double ratioSlowTwitch = mm.get_ratio_slow_twitch_fibers();
+
+        w.mass[i] = mm.getMuscleMass();
+        w.fiberForceActive[i] = scale * inputs.activeFiberForce;
+        w.fiberForceTotal[i] = w.fiberForceActive[i]     // Scaled.
+                               + inputs.passiveFiberForce;
+        w.fiberLengthNormalized[i] = inputs.normFiberLength;
+        w.fiberVelocity[i] = inputs.fiberVelocity;
+        w.slowTwitchExcitation[i] = ratioSlowTwitch * sin(Pi/2 * excitation);
+        w.fastTwitchExcitation[i] = (1 - ratioSlowTwitch) * (1 - cos(Pi/2 * excitation));
+        w.activationConstantSlowTwitch[i] = mm.get_activation_constant_slow_twitch();
+        w.activationConstantFastTwitch[i] = mm.get_activation_constant_fast_twitch();
+        w.maintenanceConstantSlowTwitch[i] = mm.get_maintenance_constant_slow_twitch();
+        w.maintenanceConstantFastTwitch[i] = mm.get_maintenance_constant_fast_twitch();
 
         // Get the unnormalized total active force, F_iso that 'would' be developed at the current activation
         // and fiber length under isometric conditions (i.e. Vm=0)
-        const double F_iso = activation * m->getActiveForceLengthMultiplier(s) * max_isometric_force;
+        w.F_iso[i] = activation * inputs.activeForceLengthMultiplier 
+                     * m->getMaxIsometricForce();
 
         // Warnings
-        if (fiber_length_normalized < 0)
-            cout << "WARNING: " << getName() << "  (t = " << s.getTime() 
+        if (inputs.normFiberLength < 0)
+            OPENSIM_LOG(Warn) << "WARNING: " << getName() << "  (t = " << s.getTime() 
             << "), muscle '" << m->getName() 
-            << "' has negative normalized fiber-length." << endl; 
+            << "' has negative normalized fiber-length."; 
+    }
 
+    const bool forbidNegativeTotalPower = get_forbid_negative_total_power();
+    const bool activationRateOn = get_activation_rate_on();
+    const bool maintenanceRateOn = get_maintenance_rate_on();
+    const bool shorteningRateOn = get_shortening_rate_on();
+    const bool mechanicalWorkRateOn = get_mechanical_work_rate_on();
 
 
-        // ACTIVATION HEAT RATE for muscle i (W)
-        // ------------------------------------------
-        if (get_forbid_negative_total_power() || get_activation_rate_on())
-        {
-            const double decay_function_value = 1.0;    // This value is set to 1.0, as used by Anderson & Pandy (1999), however, in
-                                                        // Bhargava et al., (2004) they assume a function here. We will ignore this
-                                                        // function and use 1.0 for now.
-            Adot = mm.getMuscleMass() * decay_function_value * 
-                ( (mm.get_activation_constant_slow_twitch() * slow_twitch_excitation) + (mm.get_activation_constant_fast_twitch() * fast_twitch_excitation) );
+    // ACTIVATION HEAT RATE for each muscle (W)
+    // ------------------------------------------
+    std::fill(w.Adot.begin(), w.Adot.end(), 0.0);
+    if (forbidNegativeTotalPower || activationRateOn)
+    {
+        const double decay_function_value = 1.0;    // This value is set to 1.0, as used by Anderson & Pandy (1999), however, in
+                                                    // Bhargava et al., (2004) they assume a function here. We will ignore this
+                                                    // function and use 1.0 for now.
+        for (int i=0; i<nM; i++) {
+            w.Adot[i] = w.mass[i] * decay_function_value * 
+                ( (w.activationConstantSlowTwitch[i] * w.slowTwitchExcitation[i]) 
+                + (w.activationConstantFastTwitch[i] * w.fastTwitchExcitation[i]) );
         }
+    }
 
 
-
-        // MAINTENANCE HEAT RATE for muscle i (W)
-        // ------------------------------------------
-        if (get_forbid_negative_total_power() || get_maintenance_rate_on())
-        {
-            Vector tmp(1, fiber_length_normalized);
-            fiber_length_dependence = get_normalized_fiber_length_dependence_on_maintenance_rate().calcValue(tmp);
-            
-            Mdot = mm.getMuscleMass() * fiber_length_dependence * 
-                ( (mm.get_maintenance_constant_slow_twitch() * slow_twitch_excitation) + (mm.get_maintenance_constant_fast_twitch() * fast_twitch_excitation) );
+    // MAINTENANCE HEAT RATE for each muscle (W)
+    // ------------------------------------------
+    std::fill(w.Mdot.begin(), w.Mdot.end(), 0.0);
+    if (forbidNegativeTotalPower || maintenanceRateOn)
+    {
+        const Function& lengthDependence = 
+            get_normalized_fiber_length_dependence_on_maintenance_rate();
+        for (int i=0; i<nM; i++) {
+            const double fiber_length_dependence = 
+                lengthDependence.calcScalarValue(w.fiberLengthNormalized[i]);
+            w.Mdot[i] = w.mass[i] * fiber_length_dependence * 
+                ( (w.maintenanceConstantSlowTwitch[i] * w.slowTwitchExcitation[i]) 
+                + (w.maintenanceConstantFastTwitch[i] * w.fastTwitchExcitation[i]) );
         }
+    }
 
 
-
-        // SHORTENING HEAT RATE for muscle i (W)
-        // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
-        // -----------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_shortening_rate_on())
-        {
-            if (get_use_force_dependent_shortening_prop_constant())
-            {
-                if (fiber_velocity <= 0)    // concentric contraction, Vm<0
-                    alpha = (0.16 * F_iso) + (0.18 * fiber_force_total);
-                else                        // eccentric contraction, Vm>0
-                    alpha = 0.157 * fiber_force_total;
+    // SHORTENING HEAT RATE for each muscle (W)
+    // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
+    // -----------------------------------------------------------------------
+    std::fill(w.Sdot.begin(), w.Sdot.end(), 0.0);
+    if (forbidNegativeTotalPower || shorteningRateOn)
+    {
+        if (get_use_force_dependent_shortening_prop_constant()) {
+            for (int i=0; i<nM; i++) {
+                const double alpha = (w.fiberVelocity[i] <= 0)  // concentric contraction, Vm<0
+                    ? (0.16 * w.F_iso[i]) + (0.18 * w.fiberForceTotal[i])
+                    : 0.157 * w.fiberForceTotal[i];             // eccentric contraction, Vm>0
+                w.Sdot[i] = -alpha * w.fiberVelocity[i];
             }
-            else
-            {
-                if (fiber_velocity <= 0)    // concentric contraction, Vm<0
-                    alpha = 0.25 * fiber_force_total;
-                else                        // eccentric contraction, Vm>0
-                    alpha = 0.0;
+        }
+        else {
+            for (int i=0; i<nM; i++) {
+                const double alpha = (w.fiberVelocity[i] <= 0)  // concentric contraction, Vm<0
+                    ? 0.25 * w.fiberForceTotal[i]
+                    : 0.0;                                      // eccentric contraction, Vm>0
+                w.Sdot[i] = -alpha * w.fiberVelocity[i];
             }
-            Sdot = -alpha * fiber_velocity;
         }
-        
+    }
 
 
-        // MECHANICAL WORK RATE for the contractile element of muscle i (W).
-        // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
-        // -------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_mechanical_work_rate_on())
-        {
-            if (get_include_negative_mechanical_work() || fiber_velocity <= 0)
-                Wdot = -fiber_force_active*fiber_velocity;
-            else
-                Wdot = 0;
+    // MECHANICAL WORK RATE for the contractile element of each muscle (W).
+    // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
+    // -------------------------------------------------------------------
+    std::fill(w.Wdot.begin(), w.Wdot.end(), 0.0);
+    if (forbidNegativeTotalPower || mechanicalWorkRateOn)
+    {
+        const bool includeNegativeMechanicalWork = 
+            get_include_negative_mechanical_work();
+        for (int i=0; i<nM; i++) {
+            const double v = w.fiberVelocity[i];
+            w.Wdot[i] = (includeNegativeMechanicalWork || v <= 0)
+                        ? -w.fiberForceActive[i]*v : 0.0;
         }
+    }
 
 
+    // If necessary, increase the shortening heat rate so that the total
+    // power is non-negative.
+    if (forbidNegativeTotalPower) {
+        for (int i=0; i<nM; i++) {
+            const double Edot_W_beforeClamp = 
+                w.Adot[i] + w.Mdot[i] + w.Sdot[i] + w.Wdot[i];
+            if (Edot_W_beforeClamp < 0)
+                w.Sdot[i] -= Edot_W_beforeClamp;
+        }
+    }
+
+
+    const bool allHeatRatesOn = 
+        activationRateOn && maintenanceRateOn && shorteningRateOn;
+    const bool enforceMinimumHeatRate = 
+        get_enforce_minimum_heat_rate_per_muscle() && allHeatRatesOn;
+    const bool reportMuscles = !get_report_total_metabolics_only();
+    for (int i=0; i<nM; i++)
+    {
+        const double Adot = w.Adot[i];
+        const double Mdot = w.Mdot[i];
+        const double Sdot = w.Sdot[i];
+        const double Wdot = w.Wdot[i];
+
         // NAN CHECKING
         // ------------------------------------------
-        if (isNaN(Adot))
-            cout << "WARNING::" << getName() << ": Adot (" << m->getName() << ") = NaN!" << endl;
-        if (isNaN(Mdot))
-            cout << "WARNING::" << getName() << ": Mdot (" << m->getName() << ") = NaN!" << endl;
-        if (isNaN(Sdot))
-            cout << "WARNING::" << getName() << ": Sdot (" << m->getName() << ") = NaN!" << endl;
-        if (isNaN(Wdot))
-            cout << "WARNING::" << getName() << ": Wdot (" << m->getName() << ") = NaN!" << endl;
-
-
-        // If necessary, increase the shortening heat rate so that the total
-        // power is non-negative.
-        if (get_forbid_negative_total_power()) {
-            const double Edot_W_beforeClamp = Adot + Mdot + Sdot + Wdot;
-            if (Edot_W_beforeClamp < 0)
-                Sdot -= Edot_W_beforeClamp;
+        if (isNaN(Adot) || isNaN(Mdot) || isNaN(Sdot) || isNaN(Wdot)) {
+            const std::string& muscleName = mmSet[i].getMuscle()->getName();
+            if (isNaN(Adot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Adot (" << muscleName << ") = NaN!";
+            if (isNaN(Mdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Mdot (" << muscleName << ") = NaN!";
+            if (isNaN(Sdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Sdot (" << muscleName << ") = NaN!";
+            if (isNaN(Wdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Wdot (" << muscleName << ") = NaN!";
         }
 
 
@@ -402,66 +475,43 @@ computeProbeInputs(const State& s) const
         // -----------------------------------------------------------------------
         double totalHeatRate = Adot + Mdot + Sdot;      // (W)
 
-        if(get_enforce_minimum_heat_rate_per_muscle() && totalHeatRate < 1.0 * mm.getMuscleMass()
-            && get_activation_rate_on() 
-            && get_maintenance_rate_on() 
-            && get_shortening_rate_on()) {
-                //cout << "WARNING: " << getName() 
-                //    << "  (t = " << s.getTime() 
-                //    << "), the muscle '" << mm.getName() 
-                //    << "' has a net metabolic energy rate of less than 1.0 W/kg." << endl; 
-                totalHeatRate = 1.0 * mm.getMuscleMass();           // not allowed to fall below 1.0 W.kg-1
-        }
+        if (enforceMinimumHeatRate && totalHeatRate < 1.0 * w.mass[i])
+            totalHeatRate = 1.0 * w.mass[i];            // not allowed to fall below 1.0 W.kg-1
 
 
         // TOTAL METABOLIC ENERGY RATE for muscle i (W)
         // ------------------------------------------
         double Edot = 0;
 
-        if (get_activation_rate_on() && get_maintenance_rate_on()
-            && get_shortening_rate_on())
+        if (allHeatRatesOn)
         {
             Edot += totalHeatRate;      // May have been clamped to 1.0 W/kg.
         } else {
-            if (get_activation_rate_on())
+            if (activationRateOn)
                 Edot += Adot;
-            if (get_maintenance_rate_on())
+            if (maintenanceRateOn)
                 Edot += Mdot;
-            if (get_shortening_rate_on())
+            if (shorteningRateOn)
                 Edot += Sdot;
         }
-        if (get_mechanical_work_rate_on())
+        if (mechanicalWorkRateOn)
             Edot += Wdot;
 
         EdotOutput(0) += Edot;       // Add to TOTAL metabolic power storage
-        if (!get_report_total_metabolics_only()) {
+        if (reportMuscles) {
             // Metabolic power storage for muscle i
             EdotOutput(i+2) = Edot;  
         }  
 
-
-
 #ifdef DEBUG_METABOLICS
-        cout << "muscle_mass = " << mm.getMuscleMass() << endl;
-        cout << "ratio_slow_twitch_fibers = " << mm.get_ratio_slow_twitch_fibers() << endl;
-        cout << "activation_constant_slow_twitch = " << mm.get_activation_constant_slow_twitch() << endl;
-        cout << "activation_constant_fast_twitch = " << mm.get_activation_constant_fast_twitch() << endl;
-        cout << "maintenance_constant_slow_twitch = " << mm.get_maintenance_constant_slow_twitch() << endl;
-        cout << "maintenance_constant_fast_twitch = " << mm.get_maintenance_constant_fast_twitch() << endl;
+        cout << "muscle_mass = " << w.mass[i] << endl;
         cout << "bodymass = " << _model->getMatterSubsystem().calcSystemMass(s) << endl;
-        cout << "max_isometric_force = " << max_isometric_force << endl;
-        cout << "activation = " << activation << endl;
-        cout << "excitation = " << excitation << endl;
-        cout << "fiber_force_total = " << fiber_force_total << endl;
-        cout << "fiber_force_active = " << fiber_force_active << endl;
-        cout << "fiber_length_normalized = " << fiber_length_normalized << endl;
-        cout << "fiber_length_dependence = " << fiber_length_dependence << endl;
-        cout << "fiber_velocity = " << fiber_velocity << endl;
-        cout << "fiber_velocity_normalized = " << fiber_velocity_normalized << endl;
-        cout << "slow_twitch_excitation = " << slow_twitch_excitation << endl;
-        cout << "fast_twitch_excitation = " << fast_twitch_excitation << endl;
-        cout << "max shortening velocity = " << max_shortening_velocity << endl;
-        cout << "alpha = " << alpha << endl;
+        cout << "fiber_force_total = " << w.fiberForceTotal[i] << endl;
+        cout << "fiber_force_active = " << w.fiberForceActive[i] << endl;
+        cout << "fiber_length_normalized = " << w.fiberLengthNormalized[i] << endl;
+        cout << "fiber_velocity = " << w.fiberVelocity[i] << endl;
+        cout << "slow_twitch_excitation = " << w.slowTwitchExcitation[i] << endl;
+        cout << "fast_twitch_excitation = " << w.fastTwitchExcitation[i] << endl;
         cout << "Adot = " << Adot << endl;
         cout << "Mdot = " << Mdot << endl;
         cout << "Sdot = " << Sdot << endl;
@@ -0,0 +1,110 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  ContactBroadPhase.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "ContactBroadPhase.h"
+#include <algorithm>
+
+using namespace OpenSim;
+
+void ContactBroadPhase::findPairs(const std::vector<SimTK::Vec3>& centers,
+    const std::vector<double>& radii, const std::vector<int>& bodies,
+    const std::vector<HalfSpace>& halfSpaces,
+    std::vector<std::pair<int, int> >& pairs)
+{
+    pairs.clear();
+    const int n = (int)centers.size();
+
+    std::vector<int> bounded, unbounded;
+    for (int i = 0; i < n; ++i) {
+        if (SimTK::isFinite(radii[i]))
+            bounded.push_back(i);
+        else
+            unbounded.push_back(i);
+    }
+
+    // Sweep along the axis in which the centers are most spread out, which
+    // leaves the fewest spheres overlapping along the sweep.
+    int axis = 0;
+    if (bounded.size() > 1) {
+        double sum[3] = {0, 0, 0}, sumSqr[3] = {0, 0, 0};
+        for (int i : bounded) {
+            for (int d = 0; d < 3; ++d) {
+                sum[d] += centers[i][d];
+                sumSqr[d] += centers[i][d]*centers[i][d];
+            }
+        }
+        const double m = (double)bounded.size();
+        double variance[3];
+        for (int d = 0; d < 3; ++d)
+            variance[d] = sumSqr[d]/m - (sum[d]/m)*(sum[d]/m);
+        if (variance[1] > variance[axis]) axis = 1;
+        if (variance[2] > variance[axis]) axis = 2;
+    }
+
+    std::sort(bounded.begin(), bounded.end(), [&](int a, int b) {
+        return centers[a][axis] - radii[a] < centers[b][axis] - radii[b];
+    });
+
+    // Spheres whose interval along the axis may still overlap the next one.
+    std::vector<int> active;
+    for (int i : bounded) {
+        const double lower = centers[i][axis] - radii[i];
+        for (int k = 0; k < (int)active.size();) {
+            const int j = active[k];
+            if (centers[j][axis] + radii[j] < lower) {
+                active[k] = active.back();
+                active.pop_back();
+                continue;
+            }
+            const double reach = radii[i] + radii[j];
+            if (bodies[i] != bodies[j] &&
+                    (centers[i] - centers[j]).normSqr() <= reach*reach)
+                pairs.push_back(std::make_pair(std::min(i, j),
+                                               std::max(i, j)));
+            ++k;
+        }
+        active.push_back(i);
+    }
+
+    for (int u : unbounded) {
+        const bool isHalfSpace = !halfSpaces.empty()
+                                 && !SimTK::isNaN(halfSpaces[u].offset);
+        for (int j = 0; j < n; ++j) {
+            // Pairs of unbounded surfaces are added once, from the first.
+            if (j == u || bodies[j] == bodies[u] ||
+                    (!SimTK::isFinite(radii[j]) && j < u))
+                continue;
+            // A bounded surface can only touch a half space if its bounding
+            // sphere reaches past the boundary.
+            if (isHalfSpace && SimTK::isFinite(radii[j]) &&
+                    ~halfSpaces[u].normal*centers[j] + radii[j]
+                        < halfSpaces[u].offset)
+                continue;
+            pairs.push_back(std::make_pair(std::min(u, j), std::max(u, j)));
+        }
+    }
+
+    std::sort(pairs.begin(), pairs.end());
+}
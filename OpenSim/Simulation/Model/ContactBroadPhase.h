@@ -0,0 +1,82 @@
+#ifndef OPENSIM_CONTACT_BROAD_PHASE_H_
+#define OPENSIM_CONTACT_BROAD_PHASE_H_
+/* -------------------------------------------------------------------------- *
+ *                       OpenSim:  ContactBroadPhase.h                        *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include "SimTKcommon.h"
+#include <utility>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/** The broad phase of contact detection: finds the pairs of contact surfaces
+whose bounding spheres overlap, which are the only pairs that can be touching,
+by sweep and prune along the direction in which the surfaces are most spread
+out. Only these pairs need to be passed to the (much more expensive) narrow
+phase, so the cost of detection grows with the number of nearby pairs rather
+than with the square of the number of surfaces.
+
+Half spaces are paired with the surfaces whose bounding spheres reach into
+them; other surfaces with an infinite bounding radius are paired with every
+other surface. Pairs of surfaces fixed to the same body are skipped, since
+they cannot exert forces on each other.
+
+It is used by HuntCrossleyForce. ElasticFoundationForce still has Simbody
+test every pair of its surfaces. */
+class OSIMSIMULATION_API ContactBroadPhase
+{
+public:
+    /** The half space of points p with ~normal*p >= offset. */
+    struct HalfSpace {
+        HalfSpace() : normal(1, 0, 0), offset(SimTK::NaN) {}
+        HalfSpace(const SimTK::UnitVec3& normal, double offset)
+        :   normal(normal), offset(offset) {}
+        SimTK::UnitVec3 normal;
+        double offset;
+    };
+
+    /** Find the overlapping pairs (i, j), i < j, of the bounding spheres with
+    the given centers and radii, all expressed in a common frame; body[i]
+    identifies the body surface i is fixed to. If halfSpaces is not empty, a
+    surface i with an infinite radius is the half space halfSpaces[i] unless
+    its offset is NaN. The pairs are sorted. */
+    static void findPairs(const std::vector<SimTK::Vec3>& centers,
+                          const std::vector<double>& radii,
+                          const std::vector<int>& bodies,
+                          const std::vector<HalfSpace>& halfSpaces,
+                          std::vector<std::pair<int, int> >& pairs);
+
+    /** Same as above, with no half spaces. */
+    static void findPairs(const std::vector<SimTK::Vec3>& centers,
+                          const std::vector<double>& radii,
+                          const std::vector<int>& bodies,
+                          std::vector<std::pair<int, int> >& pairs)
+    {   findPairs(centers, radii, bodies, std::vector<HalfSpace>(), pairs); }
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_CONTACT_BROAD_PHASE_H_
@@ -32,6 +32,7 @@
 #include <OpenSim/Simulation/Control/TrackingController.h>
 #include "Actuator.h" 
 #include <OpenSim/Common/Set.h>
+#include <OpenSim/Common/Profiler.h>
 #include "SimTKsimbody.h"
 
 using namespace std;
@@ -250,7 +251,9 @@ void ControllerSet::printInfo() const
 void ControllerSet::computeControls(const SimTK::State& s, SimTK::Vector &controls) const
 {
     for(int i=0;i<getSize(); i++ ) {
-        if(!get(i).isDisabled() )
+        if(!get(i).isDisabled() ) {
+            OPENSIM_PROFILE_SCOPE(get(i), "computeControls");
             get(i).computeControls(s, controls);
+        }
     }
 }
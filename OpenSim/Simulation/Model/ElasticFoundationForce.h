@@ -39,6 +39,11 @@ places a spring at the center of each face of each ContactMesh it acts on.
 Those springs interact with all objects (both meshes and other objects) the 
 mesh comes in contact with.
 
+Unlike HuntCrossleyForce, this force leaves contact detection to Simbody,
+which tests every pair of the geometry it acts on, since the springs are
+evaluated by SimTK::ElasticFoundationForce. Each mesh's own bounding volume
+hierarchy still limits the springs that are evaluated to those near contact.
+
 @author Peter Eastman **/
 class OSIMSIMULATION_API ElasticFoundationForce : public Force {
 OpenSim_DECLARE_CONCRETE_OBJECT(ElasticFoundationForce, Force);
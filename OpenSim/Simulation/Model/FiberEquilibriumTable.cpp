@@ -0,0 +1,126 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  FiberEquilibriumTable.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+//=============================================================================
+// INCLUDES
+//=============================================================================
+#include "FiberEquilibriumTable.h"
+#include "SimTKcommon.h"
+#include <algorithm>
+
+using namespace OpenSim;
+
+FiberEquilibriumTable::FiberEquilibriumTable() :
+    _minActivation(0), _deltaActivation(0),
+    _minPathLength(0), _deltaPathLength(0),
+    _numActivations(0), _numPathLengths(0),
+    _isEnabled(false), _isBuilt(false)
+{
+}
+
+FiberEquilibriumTable::FiberEquilibriumTable(
+        const FiberEquilibriumTable& other) :
+    FiberEquilibriumTable()
+{
+    _isEnabled = other._isEnabled;
+}
+
+FiberEquilibriumTable& FiberEquilibriumTable::operator=(
+        const FiberEquilibriumTable& other)
+{
+    if (this != &other) {
+        clear();
+        _isEnabled = other._isEnabled;
+    }
+    return *this;
+}
+
+void FiberEquilibriumTable::clear()
+{
+    _isBuilt = false;
+    _fiberLength.clear();
+    _numActivations = _numPathLengths = 0;
+}
+
+void FiberEquilibriumTable::ensureBuilt(double minActivation,
+    double minPathLength, double maxPathLength, const Solver& solver,
+    int numActivations, int numPathLengths)
+{
+    if (!_isEnabled || _isBuilt.load()) return;
+    std::lock_guard<std::mutex> guard(_buildMutex);
+    if (_isBuilt.load()) return;
+
+    // A table that cannot be built is left empty, so lookups return NaN.
+    if (numActivations < 2 || numPathLengths < 2
+            || !(maxPathLength > minPathLength) || !(minActivation < 1.0)) {
+        _isBuilt = true;
+        return;
+    }
+
+    _minActivation = minActivation;
+    _deltaActivation = (1.0 - minActivation)/(numActivations - 1);
+    _minPathLength = minPathLength;
+    _deltaPathLength = (maxPathLength - minPathLength)/(numPathLengths - 1);
+
+    std::vector<double> table(numActivations*numPathLengths, SimTK::NaN);
+    for (int i = 0; i < numActivations; ++i) {
+        double activation = _minActivation + i*_deltaActivation;
+        double guess = SimTK::NaN;
+        for (int j = 0; j < numPathLengths; ++j) {
+            double pathLength = _minPathLength + j*_deltaPathLength;
+            double fiberLength = SimTK::NaN;
+            try {
+                if (!solver(activation, pathLength, guess, fiberLength))
+                    fiberLength = SimTK::NaN;
+            }
+            catch (const std::exception&) {
+                fiberLength = SimTK::NaN;
+            }
+            table[i*numPathLengths + j] = fiberLength;
+            guess = fiberLength;
+        }
+    }
+    _fiberLength.swap(table);
+    _numActivations = numActivations;
+    _numPathLengths = numPathLengths;
+    _isBuilt = true;
+}
+
+double FiberEquilibriumTable::lookup(double activation,
+                                     double pathLength) const
+{
+    if (!_isEnabled || !isBuilt() || _fiberLength.empty()) return SimTK::NaN;
+
+    double x = (activation - _minActivation)/_deltaActivation;
+    double y = (pathLength - _minPathLength)/_deltaPathLength;
+    if (!(x >= 0 && x <= _numActivations - 1
+            && y >= 0 && y <= _numPathLengths - 1))
+        return SimTK::NaN;
+
+    int i = std::min(int(x), _numActivations - 2);
+    int j = std::min(int(y), _numPathLengths - 2);
+    double u = x - i, v = y - j;
+    const double* row0 = &_fiberLength[i*_numPathLengths + j];
+    const double* row1 = row0 + _numPathLengths;
+    // A NaN corner makes the result NaN, i.e., no warm start.
+    return (1-u)*((1-v)*row0[0] + v*row0[1]) + u*((1-v)*row1[0] + v*row1[1]);
+}
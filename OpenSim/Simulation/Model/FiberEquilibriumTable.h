@@ -0,0 +1,106 @@
+#ifndef OPENSIM_FIBER_EQUILIBRIUM_TABLE_H_
+#define OPENSIM_FIBER_EQUILIBRIUM_TABLE_H_
+/* -------------------------------------------------------------------------- *
+ *                    OpenSim:  FiberEquilibriumTable.h                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// INCLUDES
+#include <OpenSim/Simulation/osimSimulationDLL.h>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace OpenSim {
+
+//=============================================================================
+//=============================================================================
+/** A table of static (zero-velocity) fiber equilibrium solutions of a muscle
+over a regular grid of activation and musculotendon path length. Muscles use
+it to warm start their Newton iterations for fiber equilibrium: a value
+interpolated from the table is typically within the solver's tolerance after
+one or two iterations, instead of the tens of iterations needed when starting
+from a slack tendon.
+
+The table is filled by the muscle's own equilibrium solver, so it holds
+exactly the solutions the muscle would otherwise find. It must be cleared
+whenever the muscle's properties change.
+
+The table is built on first use by ensureBuilt(), which costs a few hundred
+static equilibrium solves. Several threads may use the muscle at once: the
+first one builds the table while the others wait for it. */
+class OSIMSIMULATION_API FiberEquilibriumTable
+{
+public:
+    /** Solves for the static equilibrium fiber length at the given
+    activation and path length, starting from initialFiberLength (NaN for the
+    solver's default starting point). Returns false if the solution did not
+    converge. */
+    typedef std::function<bool(double activation, double pathLength,
+                               double initialFiberLength,
+                               double& fiberLength)> Solver;
+
+    FiberEquilibriumTable();
+    // The mutex and the built flag are not copied; a copy is built anew.
+    FiberEquilibriumTable(const FiberEquilibriumTable& other);
+    FiberEquilibriumTable& operator=(const FiberEquilibriumTable& other);
+
+    bool isBuilt() const { return _isBuilt.load(); }
+    /** Discard the table. Must not be called while others use it. */
+    void clear();
+
+    /** Whether the table is used at all (off by default). If not, it is
+    not built and lookup() returns NaN, i.e., solves start cold. */
+    bool isEnabled() const { return _isEnabled; }
+    void setEnabled(bool enabled) { _isEnabled = enabled; }
+
+    /** Fill the table, unless it is already built or disabled, over
+    activations in [minActivation, 1] and path lengths in [minPathLength,
+    maxPathLength]. Each row of constant activation is solved by
+    continuation, seeding each solve with the previous solution. */
+    void ensureBuilt(double minActivation, double minPathLength,
+                     double maxPathLength, const Solver& solver,
+                     int numActivations = 11, int numPathLengths = 41);
+
+    /** The fiber length interpolated bilinearly from the table, or NaN if
+    the table is not built, or the point lies outside the table or next to an
+    entry that failed to converge. */
+    double lookup(double activation, double pathLength) const;
+
+private:
+    double _minActivation;
+    double _deltaActivation;
+    double _minPathLength;
+    double _deltaPathLength;
+    int _numActivations;
+    int _numPathLengths;
+    // Row-major: _fiberLength[i*_numPathLengths + j] is the solution at the
+    // i-th activation and j-th path length.
+    std::vector<double> _fiberLength;
+    bool _isEnabled;
+    // Set, after the members above, once the table is built.
+    std::atomic<bool> _isBuilt;
+    std::mutex _buildMutex;
+};
+
+} // end of namespace OpenSim
+
+#endif // OPENSIM_FIBER_EQUILIBRIUM_TABLE_H_
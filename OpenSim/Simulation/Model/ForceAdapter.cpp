@@ -25,6 +25,7 @@
 // INCLUDES
 //=============================================================================
 #include "ForceAdapter.h"
+#include <OpenSim/Common/Profiler.h>
 
 //=============================================================================
 // STATICS
@@ -46,6 +47,7 @@ void ForceAdapter::calcForce(const SimTK::State& state,
     SimTK::Vector_<SimTK::SpatialVec>& bodyForces,SimTK::Vector_<SimTK::Vec3>& particleForces,
     SimTK::Vector& mobilityForces) const
 {
+    OPENSIM_PROFILE_SCOPE(*_force, "computeForce");
     _force->computeForce(state, bodyForces, mobilityForces);
 }
 
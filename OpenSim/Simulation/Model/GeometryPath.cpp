@@ -77,6 +77,11 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     if (&aModel == NULL)
         return;
 
+    connectPointsAndWrapsToModel(aModel);
+}
+
+void GeometryPath::connectPointsAndWrapsToModel(const Model& aModel)
+{
     // Name the path points based on the current path
     // (i.e., the set of currently active points is numbered
     // 1, 2, 3, ...).
@@ -88,7 +93,6 @@ void GeometryPath::extendConnectToModel(Model& aModel)
     for (int i = 0; i < get_PathPointSet().getSize(); i++){
         upd_PathPointSet().get(i).connectToModelAndPath(aModel, *this);
     }
-
 }
 
 //_____________________________________________________________________________
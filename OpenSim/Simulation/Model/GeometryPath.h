@@ -94,6 +94,12 @@ public:
     const PathWrapSet& getWrapSet() const { return get_PathWrapSet(); }
     void addPathWrap(WrapObject& aWrapObject);
 
+    /** Let the path points and wraps find the bodies and wrap objects they
+    name in the model. This is done when the path is connected to the model,
+    and again by the owner of a path updated in an existing System (see
+    Model::updateSystem()), in which the path is not connected again. */
+    void connectPointsAndWrapsToModel(const Model& aModel);
+
     //--------------------------------------------------------------------------
     // UTILITY
     //--------------------------------------------------------------------------
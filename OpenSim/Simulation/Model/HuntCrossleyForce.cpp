@@ -24,11 +24,214 @@
 #include "HuntCrossleyForce.h"
 #include "ContactGeometry.h"
 #include "ContactGeometrySet.h"
+#include "ContactBroadPhase.h"
 #include "Model.h"
 #include <OpenSim/Simulation/Model/BodySet.h>
 
 namespace OpenSim {
 
+namespace {
+// Hunt-Crossley contact between a set of surfaces, the same model as
+// SimTK::HuntCrossleyForce. SimTK::GeneralContactSubsystem tests every pair of
+// surfaces in a contact set, so instead the surfaces are kept here and only the
+// pairs found by ContactBroadPhase reach the narrow phase, which uses the same
+// collision detection algorithms.
+class HuntCrossleyContactImpl : public SimTK::Force::Custom::Implementation {
+public:
+    HuntCrossleyContactImpl(const SimTK::SimbodyMatterSubsystem& matter,
+                            double transitionVelocity)
+        : _matter(matter), _transitionVelocity(transitionVelocity) {}
+
+    void addSurface(SimTK::MobilizedBodyIndex body,
+                    const SimTK::ContactGeometry& geometry,
+                    const SimTK::Transform& X_BS,
+                    const HuntCrossleyForce::ContactParameters& params)
+    {
+        _surfaces.push_back(Surface(body, geometry, X_BS, params));
+    }
+
+    void calcForce(const SimTK::State& state,
+                   SimTK::Vector_<SimTK::SpatialVec>& bodyForces,
+                   SimTK::Vector_<SimTK::Vec3>& particleForces,
+                   SimTK::Vector& mobilityForces) const override
+    {
+        SimTK::Array_<SimTK::Contact> contacts;
+        findContacts(state, contacts);
+        for (const SimTK::Contact& contact : contacts)
+            calcContactForce(state, contact, &bodyForces);
+    }
+
+    SimTK::Real calcPotentialEnergy(const SimTK::State& state) const override
+    {
+        SimTK::Array_<SimTK::Contact> contacts;
+        findContacts(state, contacts);
+        SimTK::Real pe = 0;
+        for (const SimTK::Contact& contact : contacts)
+            pe += calcContactForce(state, contact, nullptr);
+        return pe;
+    }
+
+private:
+    struct Surface {
+        Surface(SimTK::MobilizedBodyIndex body,
+                const SimTK::ContactGeometry& geometry,
+                const SimTK::Transform& X_BS,
+                const HuntCrossleyForce::ContactParameters& params)
+            : body(body), geometry(geometry), X_BS(X_BS),
+              isHalfSpace(geometry.getTypeId()
+                  == SimTK::ContactGeometry::HalfSpace::classTypeId()),
+              // As in SimTK::HuntCrossleyForce, the stiffnesses of the two
+              // surfaces are combined to the 2/3 power.
+              stiffness(std::pow(params.getStiffness(), 2.0/3.0)),
+              dissipation(params.getDissipation()),
+              staticFriction(params.getStaticFriction()),
+              dynamicFriction(params.getDynamicFriction()),
+              viscousFriction(params.getViscousFriction()) {}
+
+        SimTK::MobilizedBodyIndex body;
+        SimTK::ContactGeometry geometry;
+        SimTK::Transform X_BS;
+        bool isHalfSpace;
+        double stiffness;
+        double dissipation;
+        double staticFriction;
+        double dynamicFriction;
+        double viscousFriction;
+    };
+
+    // Friction coefficients of the two surfaces combined symmetrically.
+    static double combineFriction(double u1, double u2)
+    {
+        return u1 + u2 == 0 ? 0 : 2*u1*u2/(u1 + u2);
+    }
+
+    void findContacts(const SimTK::State& state,
+                      SimTK::Array_<SimTK::Contact>& contacts) const
+    {
+        const int n = (int)_surfaces.size();
+        std::vector<SimTK::Transform> X_GS(n);
+        std::vector<SimTK::Vec3> centers(n);
+        std::vector<double> radii(n);
+        std::vector<int> bodies(n);
+        std::vector<ContactBroadPhase::HalfSpace> halfSpaces(n);
+        for (int i = 0; i < n; ++i) {
+            const Surface& surface = _surfaces[i];
+            X_GS[i] = _matter.getMobilizedBody(surface.body)
+                             .getBodyTransform(state)*surface.X_BS;
+            SimTK::Vec3 center;
+            SimTK::Real radius;
+            surface.geometry.getBoundingSphere(center, radius);
+            centers[i] = X_GS[i]*center;
+            radii[i] = radius;
+            bodies[i] = surface.body;
+            // A SimTK half space occupies x > 0 in its own frame.
+            if (surface.isHalfSpace) {
+                const SimTK::UnitVec3 normal = X_GS[i].R().x();
+                halfSpaces[i] = ContactBroadPhase::HalfSpace(normal,
+                    ~normal*X_GS[i].p());
+            }
+        }
+
+        std::vector<std::pair<int, int> > pairs;
+        ContactBroadPhase::findPairs(centers, radii, bodies, halfSpaces, pairs);
+
+        for (const auto& pair : pairs) {
+            int i = pair.first, j = pair.second;
+            const SimTK::ContactGeometry& gi = _surfaces[i].geometry;
+            const SimTK::ContactGeometry& gj = _surfaces[j].geometry;
+            SimTK::CollisionDetectionAlgorithm* algorithm =
+                SimTK::CollisionDetectionAlgorithm::getAlgorithm(
+                    gi.getTypeId(), gj.getTypeId());
+            if (algorithm) {
+                algorithm->processObjects(SimTK::ContactSurfaceIndex(i), gi,
+                    X_GS[i], SimTK::ContactSurfaceIndex(j), gj, X_GS[j],
+                    contacts);
+                continue;
+            }
+            algorithm = SimTK::CollisionDetectionAlgorithm::getAlgorithm(
+                gj.getTypeId(), gi.getTypeId());
+            if (algorithm)
+                algorithm->processObjects(SimTK::ContactSurfaceIndex(j), gj,
+                    X_GS[j], SimTK::ContactSurfaceIndex(i), gi, X_GS[i],
+                    contacts);
+        }
+    }
+
+    // Apply the force of one contact to bodyForces, unless it is null, and
+    // return its potential energy.
+    SimTK::Real calcContactForce(const SimTK::State& state,
+                                 const SimTK::Contact& c,
+                                 SimTK::Vector_<SimTK::SpatialVec>* bodyForces)
+                                 const
+    {
+        using SimTK::Real;
+        using SimTK::Vec3;
+
+        if (!SimTK::PointContact::isInstance(c))
+            return 0;
+        const SimTK::PointContact& contact =
+            static_cast<const SimTK::PointContact&>(c);
+        const Surface& surf1 = _surfaces[contact.getSurface1()];
+        const Surface& surf2 = _surfaces[contact.getSurface2()];
+
+        // Adjust the contact location based on the relative stiffness of the
+        // two materials.
+        const Real s1 = surf2.stiffness/(surf1.stiffness + surf2.stiffness);
+        const Real s2 = 1 - s1;
+        const Real depth = contact.getDepth();
+        const Vec3& normal = contact.getNormal();
+        const Vec3 location = contact.getLocation() + (depth*(0.5-s1))*normal;
+
+        // Hertz force.
+        const Real k = surf1.stiffness*s1;
+        const Real c12 = surf1.dissipation*s1 + surf2.dissipation*s2;
+        const Real radius = contact.getEffectiveRadius();
+        const Real fH = (4.0/3.0)*k*depth*std::sqrt(radius*k*depth);
+        const Real pe = 2.0*fH*depth/5.0;
+        if (!bodyForces)
+            return pe;
+
+        // Relative velocity of the two bodies at the contact point.
+        const SimTK::MobilizedBody& body1 = _matter.getMobilizedBody(surf1.body);
+        const SimTK::MobilizedBody& body2 = _matter.getMobilizedBody(surf2.body);
+        const Vec3 station1 = body1.findStationAtGroundPoint(state, location);
+        const Vec3 station2 = body2.findStationAtGroundPoint(state, location);
+        const Vec3 v = body1.findStationVelocityInGround(state, station1)
+                     - body2.findStationVelocityInGround(state, station2);
+        const Real vnormal = dot(v, normal);
+        const Vec3 vtangent = v - vnormal*normal;
+
+        // Hunt-Crossley force.
+        const Real f = fH*(1 + 1.5*c12*vnormal);
+        Vec3 force = (f > 0 ? f*normal : Vec3(0));
+
+        // Friction force.
+        const Real vslip = vtangent.norm();
+        if (f > 0 && vslip != 0) {
+            const Real vrel = vslip/_transitionVelocity;
+            const Real us = combineFriction(surf1.staticFriction,
+                                            surf2.staticFriction);
+            const Real ud = combineFriction(surf1.dynamicFriction,
+                                            surf2.dynamicFriction);
+            const Real uv = combineFriction(surf1.viscousFriction,
+                                            surf2.viscousFriction);
+            const Real ffriction = f*(std::min(vrel, Real(1))
+                                      *(ud + 2*(us - ud)/(1 + vrel*vrel))
+                                      + uv*vslip);
+            force += ffriction*vtangent/vslip;
+        }
+
+        body1.applyForceToBodyPoint(state, station1, -force, *bodyForces);
+        body2.applyForceToBodyPoint(state, station2, force, *bodyForces);
+        return pe;
+    }
+
+    const SimTK::SimbodyMatterSubsystem& _matter;
+    double _transitionVelocity;
+    std::vector<Surface> _surfaces;
+};
+} // anonymous namespace
+
 //==============================================================================
 //                          HUNT CROSSLEY FORCE
 //==============================================================================
@@ -57,11 +260,9 @@ void HuntCrossleyForce::extendAddToSystem(SimTK::MultibodySystem& system) const
         get_contact_parameters();
     const double& transitionVelocity = get_transition_velocity();
 
-    SimTK::GeneralContactSubsystem& contacts = system.updContactSubsystem();
     SimTK::SimbodyMatterSubsystem& matter = system.updMatterSubsystem();
-    SimTK::ContactSetIndex set = contacts.createContactSet();
-    SimTK::HuntCrossleyForce force(_model->updForceSubsystem(), contacts, set);
-    force.setTransitionVelocity(transitionVelocity);
+    HuntCrossleyContactImpl* contacts =
+        new HuntCrossleyContactImpl(matter, transitionVelocity);
     for (int i = 0; i < contactParametersSet.getSize(); ++i)
     {
         ContactParameters& params = contactParametersSet.get(i);
@@ -69,15 +270,17 @@ void HuntCrossleyForce::extendAddToSystem(SimTK::MultibodySystem& system) const
         {
             if (!_model->updContactGeometrySet().contains(params.getGeometry()[j]))
             {
+                delete contacts;
                 std::string errorMessage = "Invalid ContactGeometry (" + params.getGeometry()[j] + ") specified in HuntCrossleyForce" + getName();
                 throw Exception(errorMessage);
             }
             ContactGeometry& geom = _model->updContactGeometrySet().get(params.getGeometry()[j]);
-            contacts.addBody(set, geom.getBody().getMobilizedBody(), geom.createSimTKContactGeometry(), geom.getTransform());
-            force.setBodyParameters(SimTK::ContactSurfaceIndex(contacts.getNumBodies(set)-1), params.getStiffness(), params.getDissipation(),
-                params.getStaticFriction(), params.getDynamicFriction(), params.getViscousFriction());
+            contacts->addSurface(geom.getBody().getMobilizedBodyIndex(),
+                geom.createSimTKContactGeometry(), geom.getTransform(), params);
         }
     }
+    // The force subsystem takes over ownership of the implementation.
+    SimTK::Force::Custom force(_model->updForceSubsystem(), contacts);
 
     // Beyond the const Component get the index so we can access the SimTK::Force later
     HuntCrossleyForce* mutableThis = const_cast<HuntCrossleyForce *>(this);
@@ -331,8 +534,8 @@ getRecordValues(const SimTK::State& state) const
     const ContactParametersSet& contactParametersSet = 
         get_contact_parameters();
 
-    const SimTK::HuntCrossleyForce& simtkForce = 
-        (SimTK::HuntCrossleyForce &)(_model->getForceSubsystem().getForce(_index));
+    const SimTK::Force& simtkForce =
+        _model->getForceSubsystem().getForce(_index);
 
     SimTK::Vector_<SimTK::SpatialVec> bodyForces(0);
     SimTK::Vector_<SimTK::Vec3> particleForces(0);
@@ -38,6 +38,11 @@ class Model;
 contact theory to model the interactions between a set of ContactSpheres and 
 ContactHalfSpaces.
 
+Contacts are detected by first finding the pairs of geometry whose bounding
+spheres overlap, or reach into a ContactHalfSpace (see ContactBroadPhase), so
+only pairs that may be touching are tested in detail. Friction coefficients that differ between two contacting
+geometries are combined as 2*u1*u2/(u1 + u2).
+
 @author Peter Eastman **/
 class OSIMSIMULATION_API HuntCrossleyForce : public Force {
 OpenSim_DECLARE_CONCRETE_OBJECT(HuntCrossleyForce, Force);
@@ -27,6 +27,7 @@
 //=============================================================================
 
 #include <OpenSim/Common/IO.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Common/XMLDocument.h>
 #include <OpenSim/Common/ScaleSet.h>
 #include <OpenSim/Common/Storage.h>
@@ -64,6 +65,7 @@
 #include "ContactGeometrySet.h"
 #include "ProbeSet.h"
 #include "ComponentSet.h"
+#include <algorithm>
 #include <iostream>
 #include <string>
 #include <cmath>
@@ -276,6 +278,15 @@ void Model::buildSystem() {
     // necessary elements to the System. Doesn't initialize geometry yet.
     if (getUseVisualizer())
         _modelViz.reset(new ModelVisualizer(*this));
+
+    // Remember what the System was built from for updateSystem(). Anything
+    // that marked properties as edited while building is in the System.
+    findSystemComponents(_systemComponents);
+    findSetElements(_systemSetElements);
+    findModelProperties(_systemProperties);
+    setObjectIsUpToDateWithProperties();
+    for (const Component& comp : getComponentList())
+        const_cast<Component&>(comp).setObjectIsUpToDateWithProperties();
 }
 
 
@@ -332,6 +343,148 @@ SimTK::State& Model::initializeState() {
 }
 
 
+//------------------------------------------------------------------------------
+//                              UPDATE SYSTEM
+//------------------------------------------------------------------------------
+void Model::findSystemComponents(std::vector<std::pair<const Component*,
+    std::vector<std::string> > >& components) const
+{
+    components.clear();
+    for (const Component& comp : getComponentList()) {
+        std::vector<std::string> connectees(comp.getNumConnectors());
+        for (int i = 0; i < comp.getNumConnectors(); ++i)
+            connectees[i] = comp.getConnector(i).get_connectee_name();
+        components.push_back(std::make_pair(&comp, connectees));
+    }
+}
+
+void Model::findSetElements(std::vector<const Component*>& elements) const
+{
+    elements.clear();
+    for (int i = 0; i < getBodySet().getSize(); ++i)
+        elements.push_back(&getBodySet()[i]);
+    for (int i = 0; i < getJointSet().getSize(); ++i)
+        elements.push_back(&getJointSet()[i]);
+    for (int i = 0; i < getFrameSet().getSize(); ++i)
+        elements.push_back(&getFrameSet()[i]);
+    for (int i = 0; i < getConstraintSet().getSize(); ++i)
+        elements.push_back(&getConstraintSet()[i]);
+    for (int i = 0; i < getForceSet().getSize(); ++i)
+        elements.push_back(&getForceSet()[i]);
+    for (int i = 0; i < getMarkerSet().getSize(); ++i)
+        elements.push_back(&getMarkerSet()[i]);
+    for (int i = 0; i < getContactGeometrySet().getSize(); ++i)
+        elements.push_back(&getContactGeometrySet()[i]);
+    for (int i = 0; i < getControllerSet().getSize(); ++i)
+        elements.push_back(&getControllerSet()[i]);
+    for (int i = 0; i < getMiscModelComponentSet().getSize(); ++i)
+        elements.push_back(&getMiscModelComponentSet()[i]);
+    for (int i = 0; i < getProbeSet().getSize(); ++i)
+        elements.push_back(&getProbeSet()[i]);
+}
+
+void Model::findModelProperties(
+        std::vector<SimTK::ClonePtr<AbstractProperty> >& properties) const
+{
+    properties.clear();
+    for (int i = 0; i < getNumProperties(); ++i) {
+        const AbstractProperty& prop = getPropertyByIndex(i);
+        // Sets and ground are checked through their components.
+        if (prop.isObjectProperty() && prop.size() == 1 &&
+                dynamic_cast<const Component*>(&prop.getValueAsObject()))
+            continue;
+        properties.push_back(SimTK::ClonePtr<AbstractProperty>(prop.clone()));
+    }
+}
+
+SimTK::State& Model::updateSystem()
+{
+    SystemUpdateReport report;
+    return updateSystem(report);
+}
+
+SimTK::State& Model::updateSystem(SystemUpdateReport& report)
+{
+    report = SystemUpdateReport();
+    auto rebuild = [&](const std::string& reason) -> SimTK::State& {
+        report.rebuilt = true;
+        report.reason = reason;
+        OPENSIM_LOG(Info) << "Model '" << getName()
+            << "': building a new System because " << reason << ".";
+        return initSystem();
+    };
+
+    if (!_system || !getSystem().systemTopologyHasBeenRealized())
+        return rebuild("no System has been built");
+
+    // Edits to the model itself may only be edits of its sets' elements,
+    // which are found below; adding or removing elements, or editing any
+    // other property of the model, needs a new System.
+    if (!isObjectUpToDateWithProperties()) {
+        std::vector<SimTK::ClonePtr<AbstractProperty> > properties;
+        findModelProperties(properties);
+        for (size_t i = 0; i < properties.size(); ++i) {
+            if (!properties[i]->equals(*_systemProperties[i]))
+                return rebuild("property '" + properties[i]->getName() +
+                               "' of the model changed");
+        }
+        std::vector<const Component*> elements;
+        findSetElements(elements);
+        if (elements != _systemSetElements)
+            return rebuild("components were added or removed");
+        setObjectIsUpToDateWithProperties();
+    }
+
+    std::vector<const Component*> edited;
+    findComponentsNotUpToDate(edited);
+    if (edited.empty())
+        return _workingState;
+
+    // Each edited component is updated by the closest component, itself or
+    // one of its owners, that can update the System in place.
+    std::vector<ModelComponent*> updates;
+    for (const Component* comp : edited) {
+        const ModelComponent* update = nullptr;
+        for (const Component* c = comp; c != this; c = &c->getParent()) {
+            const ModelComponent* mc = dynamic_cast<const ModelComponent*>(c);
+            if (mc && mc->canUpdateSystemInPlace()) {
+                update = mc;
+                break;
+            }
+            if (!c->hasParent())
+                break;
+        }
+        if (!update)
+            return rebuild("'" + comp->getPathName() +
+                           "' cannot be updated in place");
+        ModelComponent* mutableUpdate = const_cast<ModelComponent*>(update);
+        if (std::find(updates.begin(), updates.end(), mutableUpdate)
+                == updates.end())
+            updates.push_back(mutableUpdate);
+    }
+
+    for (ModelComponent* update : updates)
+        update->finalizeFromPropertiesInSystem();
+
+    // The updates must not have added, removed or reconnected components.
+    std::vector<std::pair<const Component*, std::vector<std::string> > >
+        components;
+    findSystemComponents(components);
+    if (components != _systemComponents)
+        return rebuild("components were added, removed or reconnected");
+
+    for (ModelComponent* update : updates) {
+        update->initStateFromProperties(_workingState);
+        report.updatedComponents.push_back(update->getPathName());
+        OPENSIM_LOG(Debug) << "Model '" << getName()
+            << "': updated '" << update->getPathName() << "' in place.";
+    }
+    _workingState.invalidateAllCacheAtOrAbove(SimTK::Stage::Instance);
+
+    return _workingState;
+}
+
+
 SimTK::State& Model::updWorkingState()
 {
     if (!isValidSystem())
@@ -999,14 +1152,8 @@ void Model::generateDecorations
         const SimTK::State&                         state,
         SimTK::Array_<SimTK::DecorativeGeometry>&   appendToThis) const
 {
-    ComponentList<Component> allComps = getComponentList();
-    ComponentList<Component>::const_iterator iter = allComps.begin();
-    while (iter != allComps.end()){
-        //std::string cn = iter->getConcreteClassName();
-        //std::cout << cn << ":" << iter->getName() << std::endl;
-        iter->generateDecorations(fixed, hints, state, appendToThis);
-        iter++;
-    }
+    for (const Component* comp : getComponentView())
+        comp->generateDecorations(fixed, hints, state, appendToThis);
 }
 
 void Model::equilibrateMuscles(SimTK::State& state)
@@ -313,6 +313,40 @@ public:
         return initializeState();
     }
 
+#ifndef SWIG
+    /** What updateSystem() did. **/
+    struct SystemUpdateReport {
+        /** Whether a new System had to be built with initSystem(). **/
+        bool rebuilt = false;
+        /** Why a new System had to be built. **/
+        std::string reason;
+        /** Path names of the components updated in the existing System. **/
+        std::vector<std::string> updatedComponents;
+    };
+#endif
+
+    /** Apply the edits made to the properties of this model's components
+    since its System was built, without building a new System if possible.
+    That is the case if the model still has the same components, connected
+    the same way, its own properties other than its sets (e.g., gravity or
+    assembly_accuracy) are unchanged, and each edited component is, or is
+    part of, one that
+    can update the System in place (see
+    ModelComponent::canUpdateSystemInPlace()). Those components are then
+    updated from their properties (see
+    Component::finalizeFromPropertiesInSystem()), their values in the working
+    state are reinitialized from their properties, and the working state's
+    cache is invalidated from Stage::Instance up. Otherwise, this calls
+    initSystem(). Any other State of the System must have its cache
+    invalidated (see SimTK::State::invalidateAllCacheAtOrAbove()) before it
+    is used again. Returns the working state. **/
+    SimTK::State& updateSystem() SWIG_DECLARE_EXCEPTION;
+#ifndef SWIG
+    /** Same as updateSystem(), and also report what was updated in place or
+    why a new System was built. **/
+    SimTK::State& updateSystem(SystemUpdateReport& report);
+#endif
+
 
     /** Convenience method that returns a reference to the model's 'working'
     state. This is just returning the reference that was returned by 
@@ -959,6 +993,15 @@ private:
     void setDefaultProperties();
     void createMultibodySystem();
 
+    // Support for updateSystem(): list the components with their connectee
+    // names, the elements of the model's sets, and the model's own properties
+    // that do not hold components.
+    void findSystemComponents(std::vector<std::pair<const Component*,
+                              std::vector<std::string> > >& components) const;
+    void findSetElements(std::vector<const Component*>& elements) const;
+    void findModelProperties(
+        std::vector<SimTK::ClonePtr<AbstractProperty> >& properties) const;
+
     // Copy only the model-defining data members from source.
 //  void copyData(const Model& source);
 
@@ -1018,6 +1061,14 @@ private:
     // initializeState() or initSystem() is called.
     SimTK::State _workingState;
 
+    // What the System was built from, to tell whether updateSystem() can use
+    // it: each component with the connectee names of its connectors, the
+    // elements of the model's sets, and the model's other properties.
+    std::vector<std::pair<const Component*, std::vector<std::string> > >
+        _systemComponents;
+    std::vector<const Component*> _systemSetElements;
+    std::vector<SimTK::ClonePtr<AbstractProperty> > _systemProperties;
+
 
     //--------------------------------------------------------------------------
     //                              RUN TIME 
@@ -128,6 +128,14 @@ public:
      */
     void addGeometry(OpenSim::Geometry& aGeometry);
 
+    /** Whether edits to the properties of this ModelComponent, or of its
+    (sub)components, can be applied by Model::updateSystem() to the System
+    already built for the Model, instead of building a new one. This holds for
+    components that compute their contribution to the System from their
+    properties at run time. The default is false; a subclass that returns true
+    must return false for edits that change what it adds to the System. */
+    virtual bool canUpdateSystemInPlace() const { return false; }
+
     void extendFinalizeFromProperties() override;
 protected:
 template <class T> friend class ModelComponentSet;
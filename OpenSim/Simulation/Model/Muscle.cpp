@@ -241,10 +241,12 @@ void Muscle::setMaxContractionVelocity(double aMaxContractionVelocity)
 //=============================================================================
 // ModelComponent Interface Implementation
 //=============================================================================
-void Muscle::extendConnectToModel(Model& aModel)
+void Muscle::extendFinalizeFromProperties()
 {
-    Super::extendConnectToModel(aModel);
+    Super::extendFinalizeFromProperties();
 
+    // Cached here rather than when connected, so they follow edits applied
+    // by Model::updateSystem().
     _muscleWidth = getOptimalFiberLength()
                     * sin(getPennationAngleAtOptimalFiberLength());
 
@@ -261,6 +263,12 @@ void Muscle::extendConnectToModel(Model& aModel)
 
     addModelingOption("ignore_tendon_compliance", 1);
     addModelingOption("ignore_activation_dynamics", 1);
+
+    Muscle* mutableThis = const_cast<Muscle *>(this);
+    mutableThis->_ignoreTendonComplianceInSystem =
+        get_ignore_tendon_compliance();
+    mutableThis->_ignoreActivationDynamicsInSystem =
+        get_ignore_activation_dynamics();
     
     // Cache the calculated values for this muscle categorized by their realization stage 
     
@@ -319,6 +327,13 @@ void Muscle::setIgnoreActivationDynamics(SimTK::State& s, bool ignore) const
     setModelingOption(s, "ignore_activation_dynamics", int(ignore));
 }
 
+bool Muscle::canUpdateSystemInPlace() const
+{
+    return Super::canUpdateSystemInPlace()
+        && get_ignore_tendon_compliance() == _ignoreTendonComplianceInSystem
+        && get_ignore_activation_dynamics() == _ignoreActivationDynamicsInSystem;
+}
+
 
 
 //=============================================================================
@@ -333,6 +348,24 @@ double Muscle::getExcitation( const SimTK::State& s) const {
 }
 
 
+void Muscle::getMetabolicsInputs(const SimTK::State& s,
+                                 MetabolicsInputs& inputs) const
+{
+    const MuscleLengthInfo& mli = getMuscleLengthInfo(s);
+    const FiberVelocityInfo& fvi = getFiberVelocityInfo(s);
+    const MuscleDynamicsInfo& mdi = getMuscleDynamicsInfo(s);
+
+    inputs.excitation = getControl(s);
+    // getActivation() is virtual; some muscles do not store it in mdi.
+    inputs.activation = getActivation(s);
+    inputs.normFiberLength = mli.normFiberLength;
+    inputs.activeForceLengthMultiplier = mli.fiberActiveForceLengthMultiplier;
+    inputs.fiberVelocity = fvi.fiberVelocity;
+    inputs.normFiberVelocity = fvi.normFiberVelocity;
+    inputs.activeFiberForce = mdi.activeFiberForce;
+    inputs.passiveFiberForce = mdi.passiveFiberForce;
+}
+
 /* get the activation level of the muscle, which modulates the active force of the muscle 
     and has a normalized (0 to 1) value */
 double Muscle::getActivation(const SimTK::State& s) const
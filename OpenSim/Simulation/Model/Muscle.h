@@ -26,6 +26,8 @@
 
 // INCLUDE
 #include "PathActuator.h"
+#include "FiberEquilibriumTable.h"
+#include <mutex>
 
 #ifdef SWIG
     #ifdef OSIMSIMULATION_API
@@ -137,6 +139,10 @@ public:
     bool getIgnoreActivationDynamics(const SimTK::State& s) const;
     void setIgnoreActivationDynamics(SimTK::State& s, bool ignore) const;
 
+    /** Like PathActuator, except that changing whether tendon compliance or
+    activation dynamics are ignored may change the muscle's state variables. */
+    bool canUpdateSystemInPlace() const override;
+
     /** get the activation level of the muscle, which modulates the active force
         of the muscle and has a normalized (0 to 1) value 
         Note: method remains virtual to permit override by deprecated muscles. */
@@ -232,6 +238,24 @@ public:
     double getExcitation(const SimTK::State& s) const;
 
 
+    /** The state-dependent quantities that muscle metabolics models, such as
+    Umberger2010MuscleMetabolicsProbe, depend on. */
+    struct MetabolicsInputs {
+        double excitation;
+        double activation;
+        double normFiberLength;
+        double activeForceLengthMultiplier;
+        double fiberVelocity;
+        double normFiberVelocity;
+        double activeFiberForce;
+        double passiveFiberForce;
+    };
+    /** Fill all MetabolicsInputs at once from the muscle's cached length,
+    velocity and dynamics info, with a single cache access for each, rather
+    than one access per quantity through the accessors above. */
+    void getMetabolicsInputs(const SimTK::State& s,
+                             MetabolicsInputs& inputs) const;
+
     /** DEPRECATED: only for backward compatibility */
     virtual void setActivation(SimTK::State& s, double activation) const = 0;
 
@@ -248,6 +272,41 @@ public:
     //@{
     /** Find and set the equilibrium state of the muscle (if any) */
     void equilibrate(SimTK::State& s) const { return computeFiberEquilibriumAtZeroVelocity(s); }
+
+    /** Convergence report of the most recent iterative fiber-equilibrium
+    solve performed by this muscle, e.g., by equilibrate(). */
+    struct FiberEquilibriumStatistics {
+        /** 0 = converged, 1 = fiber reached its minimum length,
+        2 = did not converge, -1 = no iterative solve has been performed */
+        int status;
+        /** Number of Newton iterations taken. */
+        int iterations;
+        /** Remaining force error (N). */
+        double error;
+        /** Whether the solve started from the warm-start table. */
+        bool warmStarted;
+
+        FiberEquilibriumStatistics() :
+            status(-1), iterations(0), error(SimTK::NaN), warmStarted(false) {}
+        FiberEquilibriumStatistics(int status, int iterations, double error,
+                                   bool warmStarted) :
+            status(status), iterations(iterations), error(error),
+            warmStarted(warmStarted) {}
+    };
+    /** When several threads solve with the same muscle, this reports the
+    solve of whichever thread finished last. */
+    FiberEquilibriumStatistics getFiberEquilibriumStatistics() const
+    {   return _fiberEquilibriumStatistics.get(); }
+
+    /** Whether iterative fiber-equilibrium solves start from a table of
+    static solutions. The table is built, once, by the first solve, at the
+    cost of a few hundred static solves, so it pays off only for a muscle
+    that is equilibrated many more times than that. It is off by default:
+    every solve starts from the muscle's default guess. */
+    void setUseFiberEquilibriumTable(bool useTable)
+    {   _fiberEquilibriumTable.setEnabled(useTable); }
+    bool getUseFiberEquilibriumTable() const
+    {   return _fiberEquilibriumTable.isEnabled(); }
     // End of Muscle's State Dependent Accessors.
     //@} 
 
@@ -353,7 +412,7 @@ protected:
     SimTK::Vec3 computePathColor(const SimTK::State& state) const override;
     
     /** Model Component creation interface */
-    void extendConnectToModel(Model& aModel) override;
+    void extendFinalizeFromProperties() override;
     void extendAddToSystem(SimTK::MultibodySystem& system) const override;
     void extendSetPropertiesFromState(const SimTK::State &s) override;
     void extendInitStateFromProperties(SimTK::State& state) const override;
@@ -387,6 +446,11 @@ protected:
         be calculated. */
     double _muscleWidth;
 
+    // The ignore_tendon_compliance and ignore_activation_dynamics properties
+    // when the muscle was last added to a System.
+    bool _ignoreTendonComplianceInSystem = false;
+    bool _ignoreActivationDynamicsInSystem = false;
+
  /**
     The MuscleLengthInfo struct contains information about the muscle that is
     strictly a function of the length of the fiber and the tendon, and the 
@@ -775,6 +839,35 @@ protected:
     };
 
 
+    /** The statistics of the last fiber-equilibrium solve, which const
+    solves on several threads may record at once. */
+    class GuardedFiberEquilibriumStatistics {
+    public:
+        GuardedFiberEquilibriumStatistics() {}
+        GuardedFiberEquilibriumStatistics(
+                const GuardedFiberEquilibriumStatistics& other) :
+            _stats(other.get()) {}
+        GuardedFiberEquilibriumStatistics& operator=(
+                const GuardedFiberEquilibriumStatistics& other)
+        {   if (this != &other) set(other.get()); return *this; }
+        GuardedFiberEquilibriumStatistics& operator=(
+                const FiberEquilibriumStatistics& stats)
+        {   set(stats); return *this; }
+        FiberEquilibriumStatistics get() const
+        {   std::lock_guard<std::mutex> guard(_mutex); return _stats; }
+        void set(const FiberEquilibriumStatistics& stats)
+        {   std::lock_guard<std::mutex> guard(_mutex); _stats = stats; }
+    private:
+        mutable std::mutex _mutex;
+        FiberEquilibriumStatistics _stats;
+    };
+    mutable GuardedFiberEquilibriumStatistics _fiberEquilibriumStatistics;
+    /** Used by muscles that solve for fiber equilibrium iteratively. The
+    table holds static equilibrium solutions used to warm start the solver;
+    it must be cleared when the muscle's properties change. The table builds
+    itself under a lock, so const solves may run concurrently. */
+    mutable FiberEquilibriumTable _fiberEquilibriumTable;
+
     /** to support deprecated muscles */
     double _maxIsometricForce;
     double _optimalFiberLength;
@@ -233,6 +233,12 @@ void PathActuator::extendFinalizeFromProperties()
     // Set owner here in case errors happen later so we can put useful message about responsible party.
     path.setOwner(this);
 
+    // When updated in an existing System (see Model::updateSystem()), the
+    // path is not connected again, but its points or wraps may now name
+    // other bodies or wrap objects.
+    if (!_model.empty())
+        path.connectPointsAndWrapsToModel(*_model);
+
     Super::extendFinalizeFromProperties();
 }
 
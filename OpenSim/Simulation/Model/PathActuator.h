@@ -69,6 +69,10 @@ public:
     {   return get_GeometryPath(); }
     bool hasGeometryPath() const override { return true;};
 
+    /** The force and path are computed from the properties at run time;
+    the path is connected to the model again when it is updated. */
+    bool canUpdateSystemInPlace() const override { return true; }
+
     // OPTIMAL FORCE
     void setOptimalForce(double aOptimalForce);
     double getOptimalForce() const override;
@@ -28,12 +28,37 @@
 //=============================================================================
 #include "Umberger2010MuscleMetabolicsProbe.h"
 #include <OpenSim/Simulation/Model/Muscle.h>
+#include <OpenSim/Common/Logger.h>
+#include <algorithm>
+#include <vector>
 //#define DEBUG_METABOLICS
 
 using namespace std;
 using namespace SimTK;
 using namespace OpenSim;
 
+namespace {
+// Per-muscle inputs and intermediate heat rates, one array per quantity.
+// Kept per thread so that computeProbeInputs() does not allocate once the
+// arrays have grown to the number of muscles.
+struct MuscleArrays {
+    std::vector<double> mass, slowTwitchRatio, maxShorteningVelocity;
+    std::vector<double> activation, excitation, A, F_iso;
+    std::vector<double> fiberForceActive, fiberLengthNormalized;
+    std::vector<double> fiberVelocity, fiberVelocityNormalized;
+    std::vector<double> AMdot, Sdot, Wdot;
+
+    void resize(int n) {
+        for (std::vector<double>* a : {&mass, &slowTwitchRatio,
+                &maxShorteningVelocity, &activation, &excitation, &A, &F_iso,
+                &fiberForceActive, &fiberLengthNormalized, &fiberVelocity,
+                &fiberVelocityNormalized, &AMdot, &Sdot, &Wdot})
+            a->resize(n);
+    }
+};
+thread_local MuscleArrays muscleArrays;
+}
+
 
 //=============================================================================
 // CONSTRUCTOR(S) AND SETUP
@@ -233,8 +258,7 @@ void Umberger2010MuscleMetabolicsProbe::connectIndividualMetabolicMuscle(
 SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State& s) const
 {
     // Initialize metabolic energy rate values.
-    double AMdot, Sdot, Bdot, Wdot;
-    AMdot = Sdot = Bdot = Wdot = 0;
+    double Bdot = 0;
     Vector EdotOutput(getNumProbeInputs());
     EdotOutput = 0;
 
@@ -247,7 +271,7 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         Bdot = get_basal_coefficient() 
             * pow(_model->getMatterSubsystem().calcSystemMass(s), get_basal_exponent());
         if (isNaN(Bdot))
-            cout << "WARNING::" << getName() << ": Bdot = NaN!" << endl;
+            OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Bdot = NaN!";
     }
     EdotOutput(0) += Bdot;       // TOTAL metabolic power storage
     
@@ -255,174 +279,193 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         EdotOutput(1) = Bdot;    // BASAL metabolic power storage
     
 
-    // Loop through each muscle in the MetabolicMuscleParameterSet
-    const int nM = 
-        get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet()
-        .getSize();
+    // Gather the inputs of every muscle in the MetabolicMuscleParameterSet
+    // into arrays, so that the heat rates below are computed one term at a
+    // time for all muscles.
+    const Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet& mmSet = 
+        get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet();
+    const int nM = mmSet.getSize();
+    MuscleArrays& w = muscleArrays;
+    w.resize(nM);
+
+    const double scale = get_muscle_effort_scaling_factor();
+    Muscle::MetabolicsInputs inputs;
     for (int i=0; i<nM; ++i)
     {
         // Get the current muscle parameters from the MetabolicMuscleParameterSet
         // and the corresponding OpenSim::Muscle pointer from the muscleMap.
-        Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
-            get_Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameterSet()[i];
+        const Umberger2010MuscleMetabolicsProbe_MetabolicMuscleParameter& mm = 
+            mmSet[i];
         const Muscle* m = mm.getMuscle();
-
-        // Get some muscle properties at the current time state
-        //const double max_isometric_force = m->getMaxIsometricForce();
-        const double max_shortening_velocity = m->getMaxContractionVelocity();
-        const double activation = get_muscle_effort_scaling_factor()
-                                  * m->getActivation(s);
-        const double excitation = get_muscle_effort_scaling_factor()
-                                  * m->getControl(s);
-        double fiber_force_active = get_muscle_effort_scaling_factor()
-                                    * m->getActiveFiberForce(s);
-        const double fiber_length_normalized = m->getNormalizedFiberLength(s);
-        const double fiber_velocity = m->getFiberVelocity(s);
-        double A;
-
+        m->getMetabolicsInputs(s, inputs);
+
+        w.mass[i] = mm.getMuscleMass();
+        w.slowTwitchRatio[i] = mm.get_ratio_slow_twitch_fibers();
+        w.maxShorteningVelocity[i] = m->getMaxContractionVelocity();
+        w.activation[i] = scale * inputs.activation;
+        w.excitation[i] = scale * inputs.excitation;
+        w.fiberForceActive[i] = scale * inputs.activeFiberForce;
+        w.fiberLengthNormalized[i] = inputs.normFiberLength;
+        w.fiberVelocity[i] = inputs.fiberVelocity;
         // Umberger defines fiber_velocity_normalized as Vm/LoM, not Vm/Vmax (p101, top left, Umberger(2003))
-        //const double fiber_velocity_normalized = m->getNormalizedFiberVelocity(s);
-        const double fiber_velocity_normalized = fiber_velocity / m->getOptimalFiberLength();
-
-
-        // ---------------------------------------------------------------------------
-        // NOT USED FOR THIS IMPLEMENTATION
-        //const double slow_twitch_excitation = mm.get_ratio_slow_twitch_fibers() * sin(Pi/2 * excitation);
-        //const double fast_twitch_excitation = (1 - mm.get_ratio_slow_twitch_fibers()) * (1 - cos(Pi/2 * excitation));
-
-        // Set normalized hill constants: A_rel and B_rel
-        //const double A_rel = 0.1 + 0.4*(1 - mm.get_ratio_slow_twitch_fibers());
-        //const double B_rel = A_rel * max_shortening_velocity;
-        // ---------------------------------------------------------------------------
-
-
-        // Set activation dependence scaling parameter: A
-        if (excitation > activation)
-            A = excitation;
-        else
-            A = (excitation + activation) / 2;
-
+        w.fiberVelocityNormalized[i] = 
+            inputs.fiberVelocity / m->getOptimalFiberLength();
         // Normalized contractile element force-length curve
-        const double F_iso = m->getActiveForceLengthMultiplier(s);   
+        w.F_iso[i] = inputs.activeForceLengthMultiplier;
 
         // Warnings
-        if (fiber_length_normalized < 0)
-            cout << "WARNING: (t = " << s.getTime() 
+        if (inputs.normFiberLength < 0)
+            OPENSIM_LOG(Warn) << "WARNING: (t = " << s.getTime() 
             << "), muscle '" << m->getName() 
-            << "' has negative normalized fiber-length." << endl; 
+            << "' has negative normalized fiber-length."; 
+    }
 
+    const bool forbidNegativeTotalPower = get_forbid_negative_total_power();
+    const bool activationMaintenanceRateOn = 
+        get_activation_maintenance_rate_on();
+    const bool shorteningRateOn = get_shortening_rate_on();
+    const bool mechanicalWorkRateOn = get_mechanical_work_rate_on();
+    const bool includeNegativeMechanicalWork = 
+        get_include_negative_mechanical_work();
+    const double aerobicFactor = get_aerobic_factor();
 
 
-        // ACTIVATION & MAINTENANCE HEAT RATE for muscle i (W/kg)
-        // --> depends on the normalized fiber length of the contractile element
-        // -----------------------------------------------------------------------
-        double slowTwitchRatio = mm.get_ratio_slow_twitch_fibers();
-        if (get_use_Bhargava_recruitment_model()) {
-            const double uSlow = slowTwitchRatio * sin(0.5*Pi * excitation);
-            const double uFast = (1 - slowTwitchRatio)
+    // Set activation dependence scaling parameter: A
+    for (int i=0; i<nM; ++i) {
+        const double excitation = w.excitation[i];
+        const double activation = w.activation[i];
+        w.A[i] = (excitation > activation) ? excitation 
+                                           : (excitation + activation) / 2;
+    }
+
+    if (get_use_Bhargava_recruitment_model()) {
+        for (int i=0; i<nM; ++i) {
+            const double excitation = w.excitation[i];
+            const double uSlow = w.slowTwitchRatio[i] * sin(0.5*Pi * excitation);
+            const double uFast = (1 - w.slowTwitchRatio[i])
                                  * (1 - cos(0.5*Pi * excitation));
-            slowTwitchRatio = (excitation == 0) ? 1.0 : uSlow / (uSlow + uFast);
+            w.slowTwitchRatio[i] = 
+                (excitation == 0) ? 1.0 : uSlow / (uSlow + uFast);
         }
+    }
 
-        if (get_forbid_negative_total_power() ||
-            get_activation_maintenance_rate_on())
-        {
-            const double unscaledAMdot = 128*(1 - slowTwitchRatio) + 25;
 
-            if (fiber_length_normalized <= 1.0)
-                AMdot = get_aerobic_factor() * std::pow(A, 0.6) * unscaledAMdot;
-            else
-                AMdot = get_aerobic_factor() * std::pow(A, 0.6) * ((0.4 * unscaledAMdot) + (0.6 * unscaledAMdot * F_iso));
+    // ACTIVATION & MAINTENANCE HEAT RATE for each muscle (W/kg)
+    // --> depends on the normalized fiber length of the contractile element
+    // -----------------------------------------------------------------------
+    std::fill(w.AMdot.begin(), w.AMdot.end(), 0.0);
+    if (forbidNegativeTotalPower || activationMaintenanceRateOn)
+    {
+        for (int i=0; i<nM; ++i) {
+            const double unscaledAMdot = 128*(1 - w.slowTwitchRatio[i]) + 25;
+            const double lengthDependentAMdot = 
+                (w.fiberLengthNormalized[i] <= 1.0) ? unscaledAMdot
+                : (0.4 * unscaledAMdot) + (0.6 * unscaledAMdot * w.F_iso[i]);
+            w.AMdot[i] = aerobicFactor * std::pow(w.A[i], 0.6) 
+                         * lengthDependentAMdot;
         }
+    }
 
 
-
-        // SHORTENING HEAT RATE for muscle i (W/kg)
-        // --> depends on the normalized fiber length of the contractile element
-        // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
-        // -----------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_shortening_rate_on())
-        {
-            const double Vmax_fasttwitch = max_shortening_velocity;
-            const double Vmax_slowtwitch = max_shortening_velocity / 2.5;
+    // SHORTENING HEAT RATE for each muscle (W/kg)
+    // --> depends on the normalized fiber length of the contractile element
+    // --> note that we define Vm<0 as shortening and Vm>0 as lengthening
+    // -----------------------------------------------------------------------
+    std::fill(w.Sdot.begin(), w.Sdot.end(), 0.0);
+    if (forbidNegativeTotalPower || shorteningRateOn)
+    {
+        const double maxShorteningRate = 100.0;    // (W/kg)
+        const double lengtheningFactor = 
+            includeNegativeMechanicalWork ? 4.0 : 0.3;
+        for (int i=0; i<nM; ++i) {
+            const double Vmax_fasttwitch = w.maxShorteningVelocity[i];
+            const double Vmax_slowtwitch = w.maxShorteningVelocity[i] / 2.5;
             const double alpha_shortening_fasttwitch = 153 / Vmax_fasttwitch;
             const double alpha_shortening_slowtwitch = 100 / Vmax_slowtwitch;
-            double unscaledSdot, tmp_slowTwitch, tmp_fastTwitch;
+            const double vNorm = w.fiberVelocityNormalized[i];
+            const double slowTwitchRatio = w.slowTwitchRatio[i];
+            double Sdot;
 
-            if (fiber_velocity_normalized <= 0)    // concentric contraction, Vm<0
+            if (vNorm <= 0)    // concentric contraction, Vm<0
             {
-                const double maxShorteningRate = 100.0;    // (W/kg)
-
-                tmp_slowTwitch = -alpha_shortening_slowtwitch * fiber_velocity_normalized;
-
                 // Apply upper limit to the unscaled slow twitch shortening rate.
-                if (tmp_slowTwitch > maxShorteningRate) {
-                    //cout << "WARNING: " << getName() << "  (t = " << s.getTime() << 
-                    //    "Slow twitch shortening heat rate exceeds the max value of " << maxShorteningRate << 
-                    //    " W/kg. Setting to " << maxShorteningRate << " W/kg." << endl; 
-                    tmp_slowTwitch = maxShorteningRate;
-                }
-
-                tmp_fastTwitch = alpha_shortening_fasttwitch * fiber_velocity_normalized * (1-slowTwitchRatio);
-                unscaledSdot = (tmp_slowTwitch * slowTwitchRatio) - tmp_fastTwitch;   // unscaled shortening heat rate: muscle shortening
-                Sdot = get_aerobic_factor() * std::pow(A, 2.0) * unscaledSdot;                      // scaled shortening heat rate: muscle shortening
+                const double tmp_slowTwitch = 
+                    std::min(-alpha_shortening_slowtwitch * vNorm,
+                             maxShorteningRate);
+                const double tmp_fastTwitch = 
+                    alpha_shortening_fasttwitch * vNorm * (1-slowTwitchRatio);
+                // unscaled shortening heat rate: muscle shortening
+                const double unscaledSdot = 
+                    (tmp_slowTwitch * slowTwitchRatio) - tmp_fastTwitch;
+                Sdot = aerobicFactor * (w.A[i] * w.A[i]) * unscaledSdot;
             }
-
             else    // eccentric contraction, Vm>0
             {
-                unscaledSdot =
-                    (get_include_negative_mechanical_work() ? 4.0 : 0.3)
-                    * alpha_shortening_slowtwitch * fiber_velocity_normalized;  // unscaled shortening heat rate: muscle lengthening
-                Sdot = get_aerobic_factor() * A * unscaledSdot;                                // scaled shortening heat rate: muscle lengthening
+                // unscaled shortening heat rate: muscle lengthening
+                const double unscaledSdot = 
+                    lengtheningFactor * alpha_shortening_slowtwitch * vNorm;
+                Sdot = aerobicFactor * w.A[i] * unscaledSdot;
             }
 
-
             // Fiber length dependence on scaled shortening heat rate
             // (for both concentric and eccentric contractions).
-            if (fiber_length_normalized > 1.0)
-                Sdot *= F_iso;  
+            if (w.fiberLengthNormalized[i] > 1.0)
+                Sdot *= w.F_iso[i];
+            w.Sdot[i] = Sdot;
         }
-        
-
-
-        // Clamp fiber force. THIS SHOULD NEVER HAPPEN...
-        if (fiber_force_active < 0)
-            fiber_force_active = 0.0;
-
-
-
+    }
 
-        // MECHANICAL WORK RATE for the contractile element of muscle i (W/kg).
-        // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
-        // -------------------------------------------------------------------
-        if (get_forbid_negative_total_power() || get_mechanical_work_rate_on())
-        {
-            if (get_include_negative_mechanical_work() || fiber_velocity <= 0)
-                Wdot = -fiber_force_active*fiber_velocity;
-            else
-                Wdot = 0;
 
-            Wdot /= mm.getMuscleMass();
+    // MECHANICAL WORK RATE for the contractile element of each muscle (W/kg).
+    // --> note that we define Vm<0 as shortening and Vm>0 as lengthening.
+    // -------------------------------------------------------------------
+    std::fill(w.Wdot.begin(), w.Wdot.end(), 0.0);
+    if (forbidNegativeTotalPower || mechanicalWorkRateOn)
+    {
+        for (int i=0; i<nM; ++i) {
+            // Clamp fiber force. THIS SHOULD NEVER HAPPEN...
+            const double fiber_force_active = 
+                std::max(w.fiberForceActive[i], 0.0);
+            const double v = w.fiberVelocity[i];
+            w.Wdot[i] = (includeNegativeMechanicalWork || v <= 0) 
+                        ? -fiber_force_active * v / w.mass[i] : 0.0;
         }
+    }
 
 
-        // If necessary, increase the shortening heat rate so that the total
-        // power is non-negative.
-        if (get_forbid_negative_total_power()) {
-            const double Edot_Wkg_beforeClamp = AMdot + Sdot + Wdot;
+    // If necessary, increase the shortening heat rate so that the total
+    // power is non-negative.
+    if (forbidNegativeTotalPower) {
+        for (int i=0; i<nM; ++i) {
+            const double Edot_Wkg_beforeClamp = 
+                w.AMdot[i] + w.Sdot[i] + w.Wdot[i];
             if (Edot_Wkg_beforeClamp < 0)
-                Sdot -= Edot_Wkg_beforeClamp;
+                w.Sdot[i] -= Edot_Wkg_beforeClamp;
         }
+    }
 
 
+    const bool enforceMinimumHeatRate = 
+        get_enforce_minimum_heat_rate_per_muscle() 
+        && activationMaintenanceRateOn && shorteningRateOn;
+    const bool reportMuscles = !get_report_total_metabolics_only();
+    for (int i=0; i<nM; ++i)
+    {
+        const double AMdot = w.AMdot[i];
+        const double Sdot = w.Sdot[i];
+        const double Wdot = w.Wdot[i];
+
         // NAN CHECKING
         // ------------------------------------------
-        if (isNaN(AMdot))
-            cout << "WARNING::" << getName() << ": AMdot (" << m->getName() << ") = NaN!" << endl;
-        if (isNaN(Sdot))
-            cout << "WARNING::" << getName() << ": Sdot (" << m->getName() << ") = NaN!" << endl;
-        if (isNaN(Wdot))
-            cout << "WARNING::" << getName() << ": Wdot (" << m->getName() << ") = NaN!" << endl;
+        if (isNaN(AMdot) || isNaN(Sdot) || isNaN(Wdot)) {
+            const std::string& muscleName = mmSet[i].getMuscle()->getName();
+            if (isNaN(AMdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": AMdot (" << muscleName << ") = NaN!";
+            if (isNaN(Sdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Sdot (" << muscleName << ") = NaN!";
+            if (isNaN(Wdot))
+                OPENSIM_LOG(Warn) << "WARNING::" << getName() << ": Wdot (" << muscleName << ") = NaN!";
+        }
 
 
         // This check is from Umberger(2003), page 104: the total heat rate 
@@ -430,15 +473,8 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // -----------------------------------------------------------------------
         double totalHeatRate = AMdot + Sdot;
 
-        if(get_enforce_minimum_heat_rate_per_muscle() && totalHeatRate < 1.0 
-            && get_activation_maintenance_rate_on() 
-            && get_shortening_rate_on()) {
-                //cout << "WARNING: " << getName() 
-                //    << "  (t = " << s.getTime() 
-                //    << "), the muscle '" << mm.getName() 
-                //    << "' has a net metabolic energy rate of less than 1.0 W/kg." << endl; 
-                totalHeatRate = 1.0;            // not allowed to fall below 1.0 W.kg-1
-        }
+        if (enforceMinimumHeatRate && totalHeatRate < 1.0)
+            totalHeatRate = 1.0;            // not allowed to fall below 1.0 W.kg-1
         
 
         // TOTAL METABOLIC ENERGY RATE for muscle i
@@ -446,43 +482,34 @@ SimTK::Vector Umberger2010MuscleMetabolicsProbe::computeProbeInputs(const State&
         // ------------------------------------------
         double Edot = 0;
 
-        if (get_activation_maintenance_rate_on() && get_shortening_rate_on())
+        if (activationMaintenanceRateOn && shorteningRateOn)
             Edot += totalHeatRate;      // May have been clamped to 1.0 W/kg.
         else {
-            if (get_activation_maintenance_rate_on())
+            if (activationMaintenanceRateOn)
                 Edot += AMdot;
-            if (get_shortening_rate_on())
+            if (shorteningRateOn)
                 Edot += Sdot;
         }
-        if (get_mechanical_work_rate_on())
+        if (mechanicalWorkRateOn)
             Edot += Wdot;
-        Edot *= mm.getMuscleMass();
+        Edot *= w.mass[i];
 
         EdotOutput(0) += Edot;       // Add to TOTAL metabolic power storage
-        if (!get_report_total_metabolics_only()) {
+        if (reportMuscles) {
             // Metabolic power storage for muscle i
             EdotOutput(i+2) = Edot;  
         }                          
 
-
-        
-
 #ifdef DEBUG_METABOLICS
-        cout << "muscle_mass = " << mm.getMuscleMass() << endl;
-        cout << "ratio_slow_twitch_fibers = " << slowTwitchRatio << endl;
+        cout << "muscle_mass = " << w.mass[i] << endl;
+        cout << "ratio_slow_twitch_fibers = " << w.slowTwitchRatio[i] << endl;
         cout << "bodymass = " << _model->getMatterSubsystem().calcSystemMass(s) << endl;
-        //cout << "max_isometric_force = " << max_isometric_force << endl;
-        cout << "activation = " << activation << endl;
-        cout << "excitation = " << excitation << endl;
-        //cout << "fiber_force_total = " << fiber_force_total << endl;
-        cout << "fiber_force_active = " << fiber_force_active << endl;
-        cout << "fiber_length_normalized = " << fiber_length_normalized << endl;
-        cout << "fiber_velocity = " << fiber_velocity << endl;
-        //cout << "slow_twitch_excitation = " << slow_twitch_excitation << endl;
-        //cout << "fast_twitch_excitation = " << fast_twitch_excitation << endl;
-        cout << "max shortening velocity = " << max_shortening_velocity << endl;
-        //cout << "A_rel = " << A_rel << endl;
-        //cout << "B_rel = " << B_rel << endl;
+        cout << "activation = " << w.activation[i] << endl;
+        cout << "excitation = " << w.excitation[i] << endl;
+        cout << "fiber_force_active = " << w.fiberForceActive[i] << endl;
+        cout << "fiber_length_normalized = " << w.fiberLengthNormalized[i] << endl;
+        cout << "fiber_velocity = " << w.fiberVelocity[i] << endl;
+        cout << "max shortening velocity = " << w.maxShorteningVelocity[i] << endl;
         cout << "AMdot = " << AMdot << endl;
         cout << "Sdot = " << Sdot << endl;
         cout << "Bdot = " << Bdot << endl;
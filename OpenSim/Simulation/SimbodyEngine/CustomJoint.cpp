@@ -277,7 +277,7 @@ void CustomJoint::extendAddToSystem(SimTK::MultibodySystem& system) const
     std::vector<std::vector<int> > coordinateIndices =
         getSpatialTransform().getCoordinateIndices();
     std::vector<const SimTK::Function*> functions =
-        getSpatialTransform().getFunctions();
+        getSpatialTransform().getFusedFunctions();
     std::vector<Vec3> axes = getSpatialTransform().getAxes();
 
     SimTK_ASSERT1(numCoordinates == coordNames.getSize(),
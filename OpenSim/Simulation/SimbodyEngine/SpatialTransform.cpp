@@ -24,6 +24,9 @@
 #include <OpenSim/Common/Constant.h>
 #include <OpenSim/Common/MultiplierFunction.h>
 #include <OpenSim/Common/LinearFunction.h>
+#include <OpenSim/Common/SimmSpline.h>
+#include <atomic>
+#include <memory>
 
 using namespace std;
 using namespace OpenSim;
@@ -165,6 +168,180 @@ std::vector<const SimTK::Function*> SpatialTransform::getFunctions() const
     }
     return functions;
 }
+
+//=============================================================================
+// FUSED AXIS FUNCTIONS
+//=============================================================================
+namespace {
+// Evaluates the axes of a SpatialTransform that are functions of the same
+// single coordinate (a group) together. Simbody asks for the value and the
+// derivatives of each axis separately, so the results for a group are kept in
+// a small per-thread cache keyed on the coordinate value; being per thread, it
+// is safe for States realized concurrently.
+class SpatialTransformEvaluator {
+public:
+    explicit SpatialTransformEvaluator(const SpatialTransform& transform);
+
+    // The group of the axis, or -1 if it cannot be evaluated in a group.
+    int getGroup(int axis) const { return _group[axis]; }
+    const OpenSim::Function& getFunction(int axis) const
+    {   return *_function[axis]; }
+
+    // Value, first and second derivatives of the axis at coordinate value q.
+    Vec3 calcAxis(int axis, double q) const;
+
+private:
+    void calcGroup(int group, double q, Vec3* values) const;
+
+    // Identifies this evaluator in the cache, which may outlive it.
+    unsigned long long _id;
+    const OpenSim::Function* _function[SpatialTransform::NumTransformAxes];
+    const SimmSpline* _spline[SpatialTransform::NumTransformAxes];
+    int _group[SpatialTransform::NumTransformAxes];
+    // Axis whose interval search this axis' spline shares, or -1.
+    int _intervalFrom[SpatialTransform::NumTransformAxes];
+    std::vector<std::vector<int> > _groupAxes;
+};
+
+struct EvaluationCacheEntry {
+    unsigned long long id = 0;  // 0 marks an empty entry
+    int group = -1;
+    double q = 0;
+    Vec3 values[SpatialTransform::NumTransformAxes];
+};
+// Enough for every group of a 6 dof joint, plus a couple of joints'
+// worth of lookahead when Simbody interleaves mobilizers.
+const int EvaluationCacheSize = 8;
+thread_local EvaluationCacheEntry evaluationCache[EvaluationCacheSize];
+thread_local int nextEvaluationCacheEntry = 0;
+std::atomic<unsigned long long> nextEvaluatorId(1);
+
+SpatialTransformEvaluator::SpatialTransformEvaluator(
+    const SpatialTransform& transform) : _id(nextEvaluatorId++)
+{
+    std::vector<std::vector<int> > coordIndices =
+        transform.getCoordinateIndices();
+    std::vector<int> groupOfCoordinate;
+
+    for (int i = 0; i < SpatialTransform::NumTransformAxes; ++i) {
+        _function[i] = &transform.getTransformAxis(i).getFunction();
+        _spline[i] = dynamic_cast<const SimmSpline*>(_function[i]);
+        _group[i] = -1;
+        _intervalFrom[i] = -1;
+
+        // Only functions of one coordinate with both derivatives available
+        // are evaluated in a group.
+        if (coordIndices[i].size() != 1 ||
+                _function[i]->getArgumentSize() != 1 ||
+                _function[i]->getMaxDerivativeOrder() < 2)
+            continue;
+
+        int coord = coordIndices[i][0];
+        if (coord >= (int)groupOfCoordinate.size())
+            groupOfCoordinate.resize(coord + 1, -1);
+        if (groupOfCoordinate[coord] < 0) {
+            groupOfCoordinate[coord] = (int)_groupAxes.size();
+            _groupAxes.push_back(std::vector<int>());
+        }
+        int group = groupOfCoordinate[coord];
+        _group[i] = group;
+
+        if (_spline[i]) {
+            _intervalFrom[i] = i;
+            for (int j : _groupAxes[group]) {
+                if (_spline[j] && _intervalFrom[j] == j &&
+                        _spline[i]->hasSameX(*_spline[j])) {
+                    _intervalFrom[i] = j;
+                    break;
+                }
+            }
+        }
+        _groupAxes[group].push_back(i);
+    }
+}
+
+void SpatialTransformEvaluator::calcGroup(int group, double q,
+                                          Vec3* values) const
+{
+    int interval[SpatialTransform::NumTransformAxes];
+    for (int axis : _groupAxes[group]) {
+        if (_spline[axis]) {
+            // Axes are in order, so the axis searched comes first.
+            int from = _intervalFrom[axis];
+            if (from == axis)
+                interval[axis] = _spline[axis]->findEvaluationInterval(q);
+            values[axis] = _spline[axis]->
+                calcScalarValueAndDerivativesInInterval(q, interval[from]);
+        }
+        else
+            values[axis] = _function[axis]->calcScalarValueAndDerivatives(q);
+    }
+}
+
+Vec3 SpatialTransformEvaluator::calcAxis(int axis, double q) const
+{
+    int group = _group[axis];
+    for (const EvaluationCacheEntry& entry : evaluationCache)
+        if (entry.id == _id && entry.group == group && entry.q == q)
+            return entry.values[axis];
+
+    EvaluationCacheEntry& entry = evaluationCache[nextEvaluationCacheEntry];
+    nextEvaluationCacheEntry =
+        (nextEvaluationCacheEntry + 1) % EvaluationCacheSize;
+    // Leave the entry empty if the evaluation throws.
+    entry.id = 0;
+    calcGroup(group, q, entry.values);
+    entry.id = _id;
+    entry.group = group;
+    entry.q = q;
+    return entry.values[axis];
+}
+
+// The SimTK::Function of one axis, which shares its evaluator with the other
+// axes of the transform.
+class FusedAxisFunction : public SimTK::Function {
+public:
+    FusedAxisFunction(
+        const std::shared_ptr<const SpatialTransformEvaluator>& evaluator,
+        int axis) : _evaluator(evaluator), _axis(axis) {}
+
+    double calcValue(const SimTK::Vector& x) const override {
+        return _evaluator->calcAxis(_axis, x[0])[0];
+    }
+    using SimTK::Function::calcDerivative;
+    double calcDerivative(const SimTK::Array_<int>& derivComponents,
+                          const SimTK::Vector& x) const override {
+        int order = (int)derivComponents.size();
+        if (order <= 2)
+            return _evaluator->calcAxis(_axis, x[0])[order];
+        std::vector<int> dcs(derivComponents.begin(), derivComponents.end());
+        return _evaluator->getFunction(_axis).calcDerivative(dcs, x);
+    }
+    int getArgumentSize() const override { return 1; }
+    int getMaxDerivativeOrder() const override {
+        return _evaluator->getFunction(_axis).getMaxDerivativeOrder();
+    }
+
+private:
+    std::shared_ptr<const SpatialTransformEvaluator> _evaluator;
+    int _axis;
+};
+} // anonymous namespace
+
+std::vector<const SimTK::Function*> SpatialTransform::getFusedFunctions() const
+{
+    auto evaluator = std::make_shared<const SpatialTransformEvaluator>(*this);
+    std::vector<const SimTK::Function*> functions(NumTransformAxes);
+    for(int i=0; i < NumTransformAxes; i++){
+        if (evaluator->getGroup(i) >= 0)
+            functions[i] = new FusedAxisFunction(evaluator, i);
+        else
+            functions[i] =
+                getTransformAxis(i).getFunction().createSimTKFunction();
+    }
+    return functions;
+}
+
 std::vector<SimTK::Vec3> SpatialTransform::getAxes() const
 {
     std::vector<SimTK::Vec3> axes(NumTransformAxes);
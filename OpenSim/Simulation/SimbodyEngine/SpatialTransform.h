@@ -88,6 +88,13 @@ public:
     /** Create a new SimTK::Function corresponding to each axis; these are
     heap allocated and it is up to the caller to delete them. **/
     std::vector<const SimTK::Function*> getFunctions() const;
+    /** Same as getFunctions(), except that the axes that are functions of
+    the same single coordinate are evaluated together: the first request for
+    any of their values or first or second derivatives at a coordinate value
+    computes all of them, sharing the interval search among SimmSplines with
+    the same abscissae, and the rest are served from a small per-thread
+    cache. Used to build the Simbody mobilizer of a CustomJoint. **/
+    std::vector<const SimTK::Function*> getFusedFunctions() const;
     /** Get the axis direction associated with each TransformAxis. **/
     std::vector<SimTK::Vec3> getAxes() const;
 
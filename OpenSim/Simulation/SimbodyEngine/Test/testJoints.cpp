@@ -219,6 +219,7 @@ protected:
 
 void testCustomVsUniversalPin();
 void testCustomJointVsFunctionBased();
+void testFusedSpatialTransformFunctions();
 void testEllipsoidJoint();
 void testWeldJoint(bool randomizeBodyOrder);
 void testPinJoint();
@@ -292,6 +293,12 @@ int main()
         cout << e.what() <<endl;
         failures.push_back("testCustomJointVsFunctionBased");
     }
+    // Compare the fused CustomJoint axis functions with the separate ones
+    try { ++itc; testFusedSpatialTransformFunctions(); }
+    catch (const std::exception& e){
+        cout << e.what() <<endl;
+        failures.push_back("testFusedSpatialTransformFunctions");
+    }
     // Compare behavior of a double pendulum with an Ellipsoid hip and pin knee
     try { ++itc; testEllipsoidJoint(); }
     catch (const std::exception& e){
@@ -758,6 +765,66 @@ void testCustomJointVsFunctionBased()
     compareSimulations(system, state, osimModel, osim_state, "testCustomJointVsFunctionBased FAILED\n");
 } // end of testCustomJointVsFunctionBased
 
+void testFusedSpatialTransformFunctions()
+{
+    cout << endl;
+    cout << "==========================================================" << endl;
+    cout << " OpenSim SpatialTransform fused vs. separate functions    " << endl;
+    cout << "==========================================================" << endl;
+
+    double x[] = {-2.0, -1.5, -0.5, 0.0, 0.3, 1.2, 2.0};
+    double y1[] = {0.1, 0.3, -0.2, 0.0, 0.05, 0.4, 0.2};
+    double y2[] = {-0.4, -0.41, -0.39, -0.395, -0.40, -0.42, -0.41};
+    double xOther[] = {-2.0, -1.0, 0.0, 1.0, 2.0};
+
+    // Two splines with the same abscissae and one with different ones, all
+    // of the knee angle, and a rotation and a constant of the hip angle.
+    SpatialTransform transform;
+    const OpenSim::Array<std::string> knee("knee", 1, 1), hip("hip", 1, 1);
+    transform[0].setCoordinateNames(hip);
+    transform[0].setFunction(new LinearFunction());
+    transform[1].setCoordinateNames(hip);
+    transform[1].setFunction(new Constant(0.3));
+    transform[2].setCoordinateNames(knee);
+    transform[2].setFunction(new LinearFunction());
+    transform[3].setCoordinateNames(knee);
+    transform[3].setFunction(new SimmSpline(7, x, y1));
+    transform[4].setCoordinateNames(knee);
+    transform[4].setFunction(new SimmSpline(7, x, y2));
+    transform[5].setCoordinateNames(knee);
+    transform[5].setFunction(new SimmSpline(5, xOther, y1));
+
+    std::vector<const SimTK::Function*> separate = transform.getFunctions();
+    std::vector<const SimTK::Function*> fused =
+        transform.getFusedFunctions();
+    std::vector<std::vector<int> > coordIndices =
+        transform.getCoordinateIndices();
+
+    const SimTK::Array_<int> first(1, 0), second(2, 0);
+    SimTK::Vector arg(1);
+    // Includes the knots, the ends of the data and beyond them.
+    for (int k = -25; k <= 25; ++k) {
+        arg[0] = 0.1*k;
+        // Visit the axes in an order that moves between the coordinates.
+        for (int i : {3, 0, 4, 1, 5, 2, 4, 3}) {
+            ASSERT(coordIndices[i].size() == 1);
+            ASSERT_EQUAL(separate[i]->calcValue(arg),
+                fused[i]->calcValue(arg), 1e-14, __FILE__, __LINE__);
+            ASSERT_EQUAL(separate[i]->calcDerivative(first, arg),
+                fused[i]->calcDerivative(first, arg), 1e-14,
+                __FILE__, __LINE__);
+            ASSERT_EQUAL(separate[i]->calcDerivative(second, arg),
+                fused[i]->calcDerivative(second, arg), 1e-14,
+                __FILE__, __LINE__);
+        }
+    }
+
+    for (int i = 0; i < 6; ++i) {
+        delete separate[i];
+        delete fused[i];
+    }
+}
+
 void testEllipsoidJoint()
 {
     using namespace SimTK;
@@ -141,6 +141,10 @@ double TransformAxis::getValue(const State& s )
     const int nc = coordNames.size();
     const CoordinateSet& coords = _joint->getCoordinateSet();
 
+    if (nc == 1)
+        return getFunction().calcScalarValue(
+                coords.get(coordNames[0]).getValue(s));
+
     Vector workX(nc, 0.0);
     for (int i=0; i < nc; ++i)
         workX[i] = coords.get(coordNames[i]).getValue(s);
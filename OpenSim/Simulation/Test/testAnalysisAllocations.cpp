@@ -0,0 +1,160 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testAnalysisAllocations.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+// Record MuscleAnalysis, JointReaction and Actuation over several steps and
+// count the heap allocations of each record() by replacing the global
+// operator new. Once warm, each step makes only the allocations of the
+// Storage rows it appends, and the same number at every step. This holds
+// only as set up here: MuscleAnalysis without moment arms, whose solver
+// recomputes each path (allocating while wrapping it) in its own state, and
+// JointReaction given a state realized to Acceleration. ForceReporter and
+// InducedAccelerations still allocate at every step and are not checked.
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Analyses/MuscleAnalysis.h>
+#include <OpenSim/Analyses/JointReaction.h>
+#include <OpenSim/Analyses/Actuation.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+using namespace OpenSim;
+using namespace std;
+
+static atomic<long> allocations(0);
+
+void* operator new(size_t size)
+{
+    ++allocations;
+    if (void* p = malloc(size ? size : 1)) return p;
+    throw bad_alloc();
+}
+void operator delete(void* p) noexcept { free(p); }
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete[](void* p) noexcept { operator delete(p); }
+
+// Allocations made by appending a row of n values to a Storage made as the
+// analyses make theirs, once it holds a few rows.
+long countRowAllocations(int n)
+{
+    Storage storage(1000, "probe");
+    vector<double> row(n, 1.0);
+    for (int i = 0; i < 3; ++i)
+        storage.append(0.01*i, n, row.data());
+    const long before = allocations.load();
+    storage.append(0.03, n, row.data());
+    return allocations.load() - before;
+}
+
+// Move the model and realize the state, so that record() finds everything
+// the model computes already in the state's cache.
+void setStep(const Model& model, SimTK::State& s, int i)
+{
+    s.updTime() = 0.01*i;
+    const CoordinateSet& coords = model.getCoordinateSet();
+    for (int c = 0; c < coords.getSize(); ++c) {
+        if (coords[c].isConstrained(s)) continue;
+        coords[c].setValue(s, coords[c].getDefaultValue() + 0.01*i, false);
+        coords[c].setSpeedValue(s, 0.1*i);
+    }
+    model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+}
+
+// After a step to warm up, every record() must make the allocations of the
+// rows it appends and no others.
+void checkRecordAllocations(const Model& model, SimTK::State& s,
+                            Analysis& analysis, long expectedPerStep)
+{
+    setStep(model, s, 0);
+    analysis.begin(s);
+    for (int i = 1; i <= 10; ++i) {
+        setStep(model, s, i);
+        const long before = allocations.load();
+        analysis.record(s);
+        const long count = allocations.load() - before;
+        if (i == 1) continue;
+        ASSERT(count == expectedPerStep, __FILE__, __LINE__,
+            analysis.getConcreteClassName() + "::record() made " +
+            to_string(count) + " allocations at step " + to_string(i) +
+            " rather than " + to_string(expectedPerStep) + ".");
+    }
+}
+
+void testMuscleAnalysis()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    MuscleAnalysis analysis(&model);
+    // Moment arms are solved by recomputing each path in the solver's own
+    // state, which allocates.
+    analysis.setComputeMoments(false);
+
+    // One row in each of the 18 storages, of a value per muscle.
+    const int numStorages = 18;
+    checkRecordAllocations(model, s, analysis,
+        numStorages*countRowAllocations(model.getMuscles().getSize()));
+}
+
+void testJointReaction()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    JointReaction analysis(&model);
+
+    // One row of loads, without the time column.
+    setStep(model, s, 0);
+    analysis.begin(s);
+    const int numColumns =
+        analysis.getLoadsStorage().getColumnLabels().getSize() - 1;
+    checkRecordAllocations(model, s, analysis,
+                           countRowAllocations(numColumns));
+}
+
+void testActuation()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    Actuation analysis(&model);
+
+    // One row of force, speed and power, of a value per actuator.
+    checkRecordAllocations(model, s, analysis,
+        3*countRowAllocations(model.getActuators().getSize()));
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testMuscleAnalysis();
+        testJointReaction();
+        testActuation();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -42,6 +42,7 @@
 #include <OpenSim/Analyses/Kinematics.h>
 #include <OpenSim/Analyses/ForceReporter.h>
 
+#include <OpenSim/Simulation/Model/ContactBroadPhase.h>
 #include <OpenSim/Simulation/Model/ContactGeometrySet.h>
 #include <OpenSim/Simulation/Model/ContactHalfSpace.h>
 #include <OpenSim/Simulation/Model/ContactMesh.h>
@@ -74,6 +75,7 @@ const static string mesh_files[] = {"sphere_10cm_radius.obj", "sphere_10cm_radiu
 int testBouncingBall(bool useMesh, const std::string mesh_filename="");
 int testBallToBallContact(bool useElasticFoundation, bool useMesh1, bool useMesh2);
 void compareHertzAndMeshContactResults();
+void testContactBroadPhase();
 
 int main()
 {
@@ -91,6 +93,7 @@ int main()
         testBallToBallContact(true, false, true);
         testBallToBallContact(true, true, true); 
         compareHertzAndMeshContactResults();
+        testContactBroadPhase();
     }
     catch (const OpenSim::Exception& e) {
         e.print(cerr);
@@ -354,3 +357,70 @@ void compareHertzAndMeshContactResults()
     CHECK_STORAGE_AGAINST_STANDARD(noMeshToMesh, meshToNoMesh, rms_tols_3, __FILE__, __LINE__, "ElasticFoundation noMesh-Mesh FAILED to match Mesh-noMesh Case ");
 
 }
+
+// The broad phase must find exactly the pairs of overlapping bounding spheres
+// (or spheres reaching into half spaces) on different bodies that a test of
+// every pair finds.
+void testContactBroadPhase()
+{
+    cout << "Testing ContactBroadPhase" << endl;
+    Random::Uniform position(-1.0, 1.0), size(0.01, 0.2);
+    position.setSeed(17);
+    size.setSeed(23);
+
+    for (int n : {0, 1, 2, 10, 200}) {
+        std::vector<Vec3> centers(n);
+        std::vector<double> radii(n);
+        std::vector<int> bodies(n);
+        for (int i = 0; i < n; ++i) {
+            centers[i] = Vec3(position.getValue(), position.getValue(),
+                              0.1*position.getValue());
+            radii[i] = size.getValue();
+            // Several spheres per body, and two unbounded surfaces on ground.
+            bodies[i] = i/4;
+        }
+        if (n >= 10) {
+            radii[0] = radii[5] = radii[9] = SimTK::Infinity;
+            bodies[0] = bodies[5] = bodies[9] = 0;
+        }
+        // Surfaces 5 and 9 are floors, below y = -0.5 and z = 0.
+        std::vector<ContactBroadPhase::HalfSpace> halfSpaces(n);
+        if (n >= 10) {
+            halfSpaces[5] = ContactBroadPhase::HalfSpace(
+                SimTK::UnitVec3(0, -1, 0), 0.5);
+            halfSpaces[9] = ContactBroadPhase::HalfSpace(
+                SimTK::UnitVec3(0, 0, -1), 0);
+        }
+        auto overlap = [&](int i, int j) {
+            for (int k : {i, j}) {
+                int other = (k == i) ? j : i;
+                if (!SimTK::isNaN(halfSpaces[k].offset) &&
+                        SimTK::isFinite(radii[other]))
+                    return dot(halfSpaces[k].normal, centers[other])
+                        + radii[other] >= halfSpaces[k].offset;
+            }
+            return (centers[i] - centers[j]).norm() <= radii[i] + radii[j];
+        };
+
+        for (bool useHalfSpaces : {false, true}) {
+            std::vector<std::pair<int, int> > expected;
+            for (int i = 0; i < n; ++i) {
+                for (int j = i+1; j < n; ++j) {
+                    if (bodies[i] != bodies[j] && (useHalfSpaces ? overlap(i, j)
+                            : (centers[i] - centers[j]).norm()
+                                <= radii[i] + radii[j]))
+                        expected.push_back(std::make_pair(i, j));
+                }
+            }
+
+            std::vector<std::pair<int, int> > pairs;
+            if (useHalfSpaces)
+                ContactBroadPhase::findPairs(centers, radii, bodies,
+                                             halfSpaces, pairs);
+            else
+                ContactBroadPhase::findPairs(centers, radii, bodies, pairs);
+            ASSERT(pairs == expected, __FILE__, __LINE__,
+                "ContactBroadPhase found different pairs than testing all pairs");
+        }
+    }
+}
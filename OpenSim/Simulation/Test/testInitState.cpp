@@ -42,6 +42,18 @@ void testStates(const string& modelFile);
 // cause the memory footprint of the process to increase significantly.
 //==============================================================================
 void testMemoryUsage(const string& modelFile);
+//==============================================================================
+// testUpdateSystem tests that editing a muscle's properties is applied to the
+// existing System, with the same result as building a new one, and that
+// editing a body's or the model's own properties builds a new System.
+//==============================================================================
+void testUpdateSystem(const string& modelFile);
+//==============================================================================
+// testUpdateSystemPath tests that a muscle path whose points and wraps are
+// edited to use other bodies and wrap objects is connected to them when the
+// System is updated in place, with the same result as building a new one.
+//==============================================================================
+void testUpdateSystemPath(const string& modelFile);
 
 static const int MAX_N_TRIES = 100;
 
@@ -52,6 +64,10 @@ int main()
         testStates("arm26.osim");
         testMemoryUsage("arm26.osim");
         testMemoryUsage("PushUpToesOnGroundWithMuscles.osim");
+        testUpdateSystem("arm26.osim");
+        // Its muscles are deprecated ones, which cache their properties.
+        testUpdateSystem("PushUpToesOnGroundWithMuscles.osim");
+        testUpdateSystemPath("arm26.osim");
     }
     catch (const Exception& e) {
         cout << "testInitState failed: ";
@@ -224,3 +240,129 @@ void testMemoryUsage(const string& modelFile)
     ASSERT( delta < 1e8, __FILE__, __LINE__, 
         "testMemoryUsage: total estimated memory leaked > 100MB.");
 }
+
+// Scale the properties that muscles, deprecated ones in particular, compute
+// with; the tendon is shortened, not lengthened, so it stays in tension.
+static void editMuscle(Muscle& muscle, double scale)
+{
+    muscle.setMaxIsometricForce(scale*muscle.getMaxIsometricForce());
+    muscle.setOptimalFiberLength(scale*muscle.getOptimalFiberLength());
+    muscle.setPennationAngleAtOptimalFiberLength(
+        scale*muscle.getPennationAngleAtOptimalFiberLength());
+    muscle.setTendonSlackLength(muscle.getTendonSlackLength()/scale);
+}
+
+void testUpdateSystem(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    model.initSystem();
+
+    // Nothing edited, nothing to do.
+    Model::SystemUpdateReport report;
+    model.updateSystem(report);
+    ASSERT(!report.rebuilt && report.updatedComponents.empty());
+
+    const double scale = 1.5;
+    Muscle& muscle = model.updMuscles()[0];
+    editMuscle(muscle, scale);
+    State& s = model.updateSystem(report);
+    ASSERT(!report.rebuilt, __FILE__, __LINE__,
+           "Editing a muscle should not build a new System.");
+    ASSERT(report.updatedComponents.size() == 1 &&
+           report.updatedComponents[0] == muscle.getPathName());
+
+    // The same edits on a new model.
+    Model rebuilt(modelFile);
+    Muscle& rebuiltMuscle = rebuilt.updMuscles()[0];
+    editMuscle(rebuiltMuscle, scale);
+    State& s2 = rebuilt.initSystem();
+
+    ASSERT((s.getY() - s2.getY()).normRMS() < 1e-12, __FILE__, __LINE__,
+           "Updated and rebuilt states differ.");
+    model.getMultibodySystem().realize(s, Stage::Acceleration);
+    rebuilt.getMultibodySystem().realize(s2, Stage::Acceleration);
+    ASSERT_EQUAL(rebuiltMuscle.getActuation(s2), muscle.getActuation(s),
+                 1e-10, __FILE__, __LINE__);
+    ASSERT((s.getYDot() - s2.getYDot()).normRMS() < 1e-10, __FILE__, __LINE__,
+           "Updated and rebuilt state derivatives differ.");
+
+    // Mass properties are part of the System's topology.
+    Body& body = model.updBodySet()[0];
+    body.setMass(scale*body.getMass());
+    model.updateSystem(report);
+    ASSERT(report.rebuilt, __FILE__, __LINE__,
+           "Editing a body should build a new System.");
+
+    // So are the model's own properties, besides its sets.
+    model.set_assembly_accuracy(0.1*model.get_assembly_accuracy());
+    model.updateSystem(report);
+    ASSERT(report.rebuilt, __FILE__, __LINE__,
+           "Editing the model's assembly accuracy should build a new System.");
+    model.updateSystem(report);
+    ASSERT(!report.rebuilt && report.updatedComponents.empty());
+}
+
+// Move the second path point of TRIlong to the forearm and wrap its path over
+// BIClonghh instead of TRI. The point and wrap are edited in another model,
+// so what they are copied with refers to that model's body and wrap object.
+static void editPath(const string& modelFile, GeometryPath& path)
+{
+    Model donor(modelFile);
+    donor.initSystem();
+    GeometryPath& donorPath =
+        donor.updMuscles().get("TRIlong").updGeometryPath();
+    donorPath.updPathPointSet()[1].setBody(
+        donor.getBodySet().get("r_ulna_radius_hand"));
+    donorPath.upd_PathWrapSet()[0].setWrapObject(
+        donor.updBodySet().get("r_humerus").upd_WrapObjectSet()
+             .get("BIClonghh"));
+
+    path.updPathPointSet()[1] = donorPath.getPathPointSet()[1];
+    path.upd_PathWrapSet()[0] = donorPath.getWrapSet()[0];
+}
+
+void testUpdateSystemPath(const string& modelFile)
+{
+    using namespace SimTK;
+
+    Model model(modelFile);
+    model.initSystem();
+    Muscle& muscle = model.updMuscles().get("TRIlong");
+    editPath(modelFile, muscle.updGeometryPath());
+
+    Model::SystemUpdateReport report;
+    State& s = model.updateSystem(report);
+    ASSERT(!report.rebuilt, __FILE__, __LINE__,
+           "Editing a muscle's path should not build a new System.");
+
+    // The path refers to this model's body and wrap object, not the donor's.
+    const GeometryPath& path = muscle.getGeometryPath();
+    ASSERT(&path.getPathPointSet()[1].getBody() ==
+           &model.getBodySet().get("r_ulna_radius_hand"), __FILE__, __LINE__,
+           "The edited path point was not connected to the model's body.");
+    ASSERT(path.getWrapSet()[0].getWrapObject() ==
+           model.getBodySet().get("r_humerus").getWrapObject("BIClonghh"),
+           __FILE__, __LINE__,
+           "The edited path wrap was not connected to the model's wrap "
+           "object.");
+
+    // The same edits on a new model.
+    Model rebuilt(modelFile);
+    Muscle& rebuiltMuscle = rebuilt.updMuscles().get("TRIlong");
+    editPath(modelFile, rebuiltMuscle.updGeometryPath());
+    State& s2 = rebuilt.initSystem();
+
+    model.getMultibodySystem().realize(s, Stage::Velocity);
+    rebuilt.getMultibodySystem().realize(s2, Stage::Velocity);
+    ASSERT_EQUAL(rebuiltMuscle.getLength(s2), muscle.getLength(s),
+                 1e-12, __FILE__, __LINE__);
+    for (const string& name : {"r_shoulder_elev", "r_elbow_flex"}) {
+        ASSERT_EQUAL(
+            rebuiltMuscle.computeMomentArm(s2,
+                rebuilt.updCoordinateSet().get(name)),
+            muscle.computeMomentArm(s, model.updCoordinateSet().get(name)),
+            1e-12, __FILE__, __LINE__);
+    }
+}
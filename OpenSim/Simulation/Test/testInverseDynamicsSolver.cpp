@@ -0,0 +1,120 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testInverseDynamicsSolver.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Solve inverse dynamics over a multi-frame trajectory of the double pendulum
+// and of arm26, whose muscles wrap, serially and on several threads; the
+// generalized forces must be identical. arm26 must be solved serially, since
+// realizing its wrapping paths is not thread-safe.
+
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/Sine.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+
+const int nFrames = 200;
+
+// One sine per coordinate, so every frame has different q, u and udot.
+void createMotion(const Model& model, FunctionSet& Qs,
+                  SimTK::Array_<double>& times)
+{
+    for (int i = 0; i < model.getNumCoordinates(); ++i)
+        Qs.adoptAndAppend(new Sine(0.5 + 0.2*i, 2*SimTK::Pi*(i + 1), 0.3*i));
+    times.resize(nFrames);
+    for (int f = 0; f < nFrames; ++f)
+        times[f] = f/100.0;
+}
+
+void testThreadedMatchesSerial(const string& modelFile,
+                               bool canSolveConcurrently)
+{
+    Model model(modelFile);
+    SimTK::State& s = model.initSystem();
+    ASSERT(InverseDynamicsSolver::canSolveFramesConcurrently(model)
+            == canSolveConcurrently, __FILE__, __LINE__,
+        modelFile + " should " + (canSolveConcurrently ? "" : "not ") +
+        "be solved concurrently.");
+    FunctionSet Qs;
+    SimTK::Array_<double> times;
+    createMotion(model, Qs, times);
+    const int nq = model.getNumCoordinates();
+
+    // The frame-by-frame solve, as used when analyses must be stepped.
+    InverseDynamicsSolver serialSolver(model);
+    SimTK::State sSerial = s;
+    SimTK::Array_<SimTK::Vector> serial;
+    serialSolver.solve(sSerial, Qs, times, serial);
+
+    for (int numThreads : {1, 4}) {
+        InverseDynamicsSolver solver(model);
+        SimTK::Matrix genForces;
+        solver.solve(s, Qs, times, genForces, numThreads);
+        ASSERT(genForces.nrow() == nFrames && genForces.ncol() == nq,
+            __FILE__, __LINE__, "Trajectory has the wrong size.");
+        for (int f = 0; f < nFrames; ++f)
+            for (int j = 0; j < nq; ++j)
+                ASSERT(genForces(f, j) == serial[f][j], __FILE__, __LINE__,
+                    modelFile + ": frame " + to_string(f) + " differs from "
+                    "the serial solution with " + to_string(numThreads) +
+                    " threads.");
+    }
+}
+
+void testBlocksCoverFramesAndRethrow()
+{
+    Model model("double_pendulum.osim");
+    SimTK::State& s = model.initSystem();
+
+    // Every frame is visited exactly once, in blocks of increasing frames.
+    vector<int> visits(nFrames, 0);
+    InverseDynamicsSolver::solveFramesConcurrently(model, s, nFrames, 4,
+        [&](SimTK::State&, int begin, int end) {
+            for (int i = begin; i < end; ++i) ++visits[i];
+        });
+    for (int f = 0; f < nFrames; ++f)
+        ASSERT(visits[f] == 1, __FILE__, __LINE__,
+            "Frame " + to_string(f) + " was not solved exactly once.");
+
+    // A failure on a worker thread reaches the caller.
+    ASSERT_THROW(Exception,
+        InverseDynamicsSolver::solveFramesConcurrently(model, s, nFrames, 4,
+            [&](SimTK::State&, int begin, int end) {
+                if (begin <= nFrames/2 && nFrames/2 < end)
+                    throw Exception("Failed at the middle frame.");
+            }));
+}
+
+int main()
+{
+    try {
+        testThreadedMatchesSerial("double_pendulum.osim", true);
+        testThreadedMatchesSerial("arm26.osim", false);
+        testBlocksCoverFramesAndRethrow();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -0,0 +1,208 @@
+/* -------------------------------------------------------------------------- *
+ *                 OpenSim:  testInverseKinematicsSolver.cpp                  *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Track 1 kHz markers of a known arm26 motion with the marker tracker of the
+// InverseKinematicsSolver and compare with the motion and with the solutions
+// of the SimTK::Assembler, with and without coordinate references and locks.
+
+#include <OpenSim/Simulation/osimSimulation.h>
+#include <OpenSim/Common/Constant.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+const double rate = 1000;
+const int nFrames = 101;
+const string markerFile = "testInverseKinematicsSolver.trc";
+
+double shoulderAt(double t) { return 0.3 + 0.2*sin(2*SimTK::Pi*t); }
+double elbowAt(double t) { return 1.0 + 0.5*sin(4*SimTK::Pi*t); }
+
+// Write the locations of the model's markers while it follows the motion
+// above to a TRC file.
+void writeMarkerFile(const Model& model, SimTK::State s)
+{
+    const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    const MarkerSet& markers = model.getMarkerSet();
+    const int nm = markers.getSize();
+
+    ofstream out(markerFile.c_str());
+    out << "PathFileType\t4\t(X/Y/Z)\t" << markerFile << "\n";
+    out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\t"
+           "OrigDataRate\tOrigDataStartFrame\tOrigNumFrames\n";
+    out << rate << "\t" << rate << "\t" << nFrames << "\t" << nm
+        << "\tm\t" << rate << "\t1\t" << nFrames << "\n";
+    out << "Frame#\tTime";
+    for (int i = 0; i < nm; ++i) out << "\t" << markers[i].getName() << "\t\t";
+    out << "\n\t";
+    for (int i = 0; i < nm; ++i)
+        out << "\tX" << i+1 << "\tY" << i+1 << "\tZ" << i+1;
+    out << "\n";
+    out.precision(16);
+    for (int f = 0; f < nFrames; ++f) {
+        const double t = f/rate;
+        shoulder.setValue(s, shoulderAt(t), false);
+        elbow.setValue(s, elbowAt(t));
+        model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+        out << f+1 << "\t" << t;
+        for (int i = 0; i < nm; ++i) {
+            SimTK::Vec3 p = markers[i].findLocationInFrame(s, model.getGround());
+            out << "\t" << p[0] << "\t" << p[1] << "\t" << p[2];
+        }
+        out << "\n";
+    }
+}
+
+void loadMarkers(const Model& model, MarkersReference& markersRef)
+{
+    Set<MarkerWeight> weights;
+    for (int i = 0; i < model.getMarkerSet().getSize(); ++i)
+        weights.adoptAndAppend(
+            new MarkerWeight(model.getMarkerSet()[i].getName(), 1.0));
+    markersRef.setMarkerWeightSet(weights);
+    markersRef.loadMarkersFile(markerFile);
+}
+
+// Track all frames with the Assembler and with the marker tracker. The
+// solutions must agree, and match the motion if there is no coordinate
+// reference pulling away from it.
+void testTrackerMatchesAssembler(
+        SimTK::Array_<CoordinateReference>& coordRefs, bool matchMotion)
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    writeMarkerFile(model, s);
+    MarkersReference markersRef;
+    loadMarkers(model, markersRef);
+    const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+
+    InverseKinematicsSolver assemblerIK(model, markersRef, coordRefs);
+    InverseKinematicsSolver trackerIK(model, markersRef, coordRefs);
+    assemblerIK.setAccuracy(1e-9);
+    trackerIK.setAccuracy(1e-9);
+    trackerIK.setUseMarkerTracker(true);
+    trackerIK.setWarmStartOrder(2);
+
+    SimTK::State sa = s, st = s;
+    sa.updTime() = st.updTime() = 0;
+    assemblerIK.assemble(sa);
+    trackerIK.assemble(st);
+
+    int iterations = 0;
+    SimTK::Array_<double> errors, assemblerErrors;
+    for (int f = 1; f < nFrames; ++f) {
+        const double t = f/rate;
+        sa.updTime() = st.updTime() = t;
+        assemblerIK.track(sa);
+        trackerIK.track(st);
+        ASSERT(assemblerIK.getNumTrackIterations() == -1);
+        ASSERT(trackerIK.getNumTrackIterations() >= 1);
+        ASSERT(trackerIK.getTrackTime() >= 0);
+        iterations += trackerIK.getNumTrackIterations();
+
+        ASSERT_EQUAL(shoulder.getValue(sa), shoulder.getValue(st), 1e-6,
+                     __FILE__, __LINE__);
+        ASSERT_EQUAL(elbow.getValue(sa), elbow.getValue(st), 1e-6,
+                     __FILE__, __LINE__);
+        trackerIK.computeCurrentMarkerErrors(errors);
+        assemblerIK.computeCurrentMarkerErrors(assemblerErrors);
+        ASSERT(errors.size() == assemblerErrors.size());
+        for (unsigned i = 0; i < errors.size(); ++i)
+            ASSERT_EQUAL(assemblerErrors[i], errors[i], 1e-6,
+                         __FILE__, __LINE__);
+        if (matchMotion) {
+            ASSERT_EQUAL(shoulderAt(t), shoulder.getValue(st), 1e-6,
+                         __FILE__, __LINE__);
+            ASSERT_EQUAL(elbowAt(t), elbow.getValue(st), 1e-6,
+                         __FILE__, __LINE__);
+            for (unsigned i = 0; i < errors.size(); ++i)
+                ASSERT(errors[i] < 1e-6, __FILE__, __LINE__,
+                       "Marker not tracked.");
+        }
+    }
+    // Starting from the extrapolated motion, frames need few iterations.
+    cout << "Marker tracker: " << double(iterations)/(nFrames-1)
+         << " iterations per frame." << endl;
+    ASSERT(iterations <= 3*(nFrames-1), __FILE__, __LINE__,
+           "Too many iterations per frame.");
+}
+
+// A locked coordinate keeps its value.
+void testLockedCoordinate()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    writeMarkerFile(model, s);
+    MarkersReference markersRef;
+    loadMarkers(model, markersRef);
+    const Coordinate& shoulder = model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+
+    shoulder.setValue(s, 0.2);
+    shoulder.setLocked(s, true);
+    SimTK::Array_<CoordinateReference> coordRefs;
+    InverseKinematicsSolver ik(model, markersRef, coordRefs);
+    ik.setUseMarkerTracker(true);
+    s.updTime() = 0;
+    ik.assemble(s);
+    const double locked = shoulder.getValue(s);
+    ASSERT_EQUAL(0.2, locked, 1e-6, __FILE__, __LINE__);
+
+    for (int f = 1; f < 20; ++f) {
+        s.updTime() = f/rate;
+        ik.track(s);
+        ASSERT(ik.getNumTrackIterations() >= 1);
+        ASSERT_EQUAL(locked, shoulder.getValue(s), 0.0, __FILE__, __LINE__);
+        ASSERT(!SimTK::isNaN(elbow.getValue(s)));
+    }
+
+    ASSERT_THROW(Exception, ik.setWarmStartOrder(3));
+    ASSERT_THROW(Exception, ik.setMaxTrackIterations(0));
+}
+
+int main()
+{
+    try {
+        SimTK::Array_<CoordinateReference> noCoordRefs;
+        testTrackerMatchesAssembler(noCoordRefs, true);
+
+        // A heavily weighted coordinate reference away from the motion.
+        SimTK::Array_<CoordinateReference> coordRefs;
+        Constant elbowValue(0.7);
+        CoordinateReference elbowRef("r_elbow_flex", elbowValue);
+        elbowRef.setWeight(10);
+        coordRefs.push_back(elbowRef);
+        testTrackerMatchesAssembler(coordRefs, false);
+
+        testLockedCoordinate();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
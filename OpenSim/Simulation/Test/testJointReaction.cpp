@@ -0,0 +1,214 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testJointReaction.cpp                       *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+
+// Record the reaction loads of all joints, and of a single joint applied on
+// its parent, and compare them with the loads computed for all joints with
+// SimbodyEngine::computeReactions(). Check which state is realized, with and
+// without actuation from a forces file.
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Analyses/JointReaction.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+// Compare 3 columns of a row of a Storage with expected values.
+void checkRow(const Storage& storage, int row, int column,
+              const Vec3& expected)
+{
+    const Array<double>& data = storage.getStateVector(row)->getData();
+    const double tol = 1e-9*max(1.0, expected.norm());
+    for (int k = 0; k < 3; ++k)
+        ASSERT_EQUAL(expected[k], data[column + k], tol, __FILE__, __LINE__);
+}
+
+void testJointReaction(const string& modelFile, const string& jointName)
+{
+    Model model(modelFile);
+    JointReaction* all = new JointReaction(&model);
+    JointReaction* single = new JointReaction(&model);
+    Array<string> names(jointName, 1);
+    Array<string> onParent("parent", 1);
+    single->setJointNames(names);
+    single->setOnBody(onParent);
+    model.addAnalysis(all);
+    model.addAnalysis(single);
+
+    SimTK::State& s = model.initSystem();
+    for (int i = 0; i < model.getAnalysisSet().getSize(); ++i)
+        model.updAnalysisSet().get(i).setModel(model);
+
+    const JointSet& joints = model.getJointSet();
+    const CoordinateSet& coords = model.getCoordinateSet();
+    const int nj = joints.getSize();
+    SimTK::Vector_<Vec3> forces(nj), moments(nj);
+
+    const int nSteps = 3;
+    for (int i = 0; i < nSteps; ++i) {
+        s.updTime() = 0.01*i;
+        for (int c = 0; c < coords.getSize(); ++c) {
+            if (coords[c].isConstrained(s)) continue;
+            coords[c].setValue(s, coords[c].getValue(s) + 0.02*(i + c%3),
+                               false);
+            coords[c].setSpeedValue(s, 0.3*(c%4) - 0.5 + 0.1*i);
+        }
+        model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+        if (i == 0) model.updAnalysisSet().begin(s);
+        else model.updAnalysisSet().step(s, i);
+
+        model.getSimbodyEngine().computeReactions(s, forces, moments);
+
+        // All joints, applied on the child and expressed in ground.
+        const Storage& allLoads = all->getLoadsStorage();
+        ASSERT(allLoads.getSize() == i + 1);
+        for (int j = 0; j < nj; ++j) {
+            const Vec3 location =
+                joints[j].getChildFrame().getGroundTransform(s).p();
+            checkRow(allLoads, i, 9*j, forces[j]);
+            checkRow(allLoads, i, 9*j + 3, moments[j]);
+            checkRow(allLoads, i, 9*j + 6, location);
+        }
+
+        // The single joint, applied on the parent.
+        const int j = joints.getIndex(jointName);
+        const Vec3 childLocation =
+            joints[j].getChildFrame().getGroundTransform(s).p();
+        const Vec3 parentLocation =
+            joints[j].getParentFrame().getGroundTransform(s).p();
+        const Storage& singleLoads = single->getLoadsStorage();
+        ASSERT(singleLoads.getColumnLabels().getSize() == 10);
+        checkRow(singleLoads, i, 0, -forces[j]);
+        checkRow(singleLoads, i, 3, -moments[j] +
+            (parentLocation - childLocation) % forces[j]);
+        checkRow(singleLoads, i, 6, parentLocation);
+    }
+}
+
+// Compare the last row of the loads of all joints with the loads computed
+// for a state.
+void checkAllJoints(const Model& model, const SimTK::State& s,
+                    const JointReaction& reaction)
+{
+    const JointSet& joints = model.getJointSet();
+    const int nj = joints.getSize();
+    SimTK::Vector_<Vec3> forces(nj), moments(nj);
+    model.getSimbodyEngine().computeReactions(s, forces, moments);
+    const Storage& loads = reaction.getLoadsStorage();
+    const int row = loads.getSize() - 1;
+    for (int j = 0; j < nj; ++j) {
+        checkRow(loads, row, 9*j, forces[j]);
+        checkRow(loads, row, 9*j + 3, moments[j]);
+        checkRow(loads, row, 9*j + 6,
+                 joints[j].getChildFrame().getGroundTransform(s).p());
+    }
+}
+
+// record() realizes the given state rather than a copy of it, so a state
+// changed between steps is realized again. With actuation from a forces
+// file, it works in a copy instead, and the given state is left as it was.
+void testRealizedState()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    JointReaction reaction(&model);
+
+    elbow.setValue(s, 0.8);
+    model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+    reaction.begin(s);
+    ASSERT(s.getSystemStage() == SimTK::Stage::Acceleration, __FILE__,
+           __LINE__, "The given state was not realized.");
+    checkAllJoints(model, s, reaction);
+
+    s.updTime() = 0.01;
+    elbow.setValue(s, 1.2);
+    elbow.setSpeedValue(s, 0.5);
+    ASSERT(s.getSystemStage() < SimTK::Stage::Acceleration);
+    reaction.step(s, 1);
+    ASSERT(reaction.getLoadsStorage().getSize() == 2);
+    ASSERT(s.getSystemStage() == SimTK::Stage::Acceleration);
+    checkAllJoints(model, s, reaction);
+
+    // Constant forces for all actuators.
+    const Set<Actuator>& actuators = model.getActuators();
+    const int na = actuators.getSize();
+    Array<string> labels("time", 1);
+    Array<double> values(0.0, na);
+    for (int k = 0; k < na; ++k) {
+        labels.append(actuators[k].getName());
+        values[k] = 10.0*(k + 1);
+    }
+    Storage forcesStore;
+    forcesStore.setColumnLabels(labels);
+    forcesStore.append(0.0, values);
+    forcesStore.append(1.0, values);
+    forcesStore.print("testJointReaction_forces.sto");
+
+    JointReaction fromFile(&model);
+    fromFile.setForcesFileName("testJointReaction_forces.sto");
+    s.updTime() = 0.5;
+    elbow.setValue(s, 1.0);
+    model.getMultibodySystem().realize(s, SimTK::Stage::Velocity);
+    fromFile.begin(s);
+    ASSERT(fromFile.getLoadsStorage().getSize() == 1);
+    ASSERT(s.getSystemStage() == SimTK::Stage::Velocity, __FILE__, __LINE__,
+           "The given state was realized with the actuation from file.");
+    for (int k = 0; k < na; ++k) {
+        const ScalarActuator& act =
+            dynamic_cast<const ScalarActuator&>(actuators[k]);
+        ASSERT(!act.isActuationOverridden(s), __FILE__, __LINE__,
+               "The given state had its actuation overridden.");
+    }
+
+    // The same loads as with the actuation overridden in a copy.
+    SimTK::State overridden = s;
+    for (int k = 0; k < na; ++k) {
+        const ScalarActuator& act =
+            dynamic_cast<const ScalarActuator&>(actuators[k]);
+        act.overrideActuation(overridden, true);
+        act.setOverrideActuation(overridden, values[k]);
+    }
+    checkAllJoints(model, overridden, fromFile);
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testJointReaction("arm26.osim", "r_elbow");
+        testJointReaction("double_pendulum.osim", "pin2");
+        // point constraints between the hands and toes and the ground
+        testJointReaction("PushUpToesOnGroundExactConstraints.osim",
+                          "knee_r");
+        testRealizedState();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
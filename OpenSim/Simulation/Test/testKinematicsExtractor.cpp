@@ -0,0 +1,244 @@
+/* -------------------------------------------------------------------------- *
+ *                   OpenSim:  testKinematicsExtractor.cpp                    *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Record arm26 with Kinematics, BodyKinematics, PointKinematics and
+// StatesReporter, which share one KinematicsExtractor, and compare their
+// rows with the values computed directly with the SimbodyEngine.
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Analyses/Kinematics.h>
+#include <OpenSim/Analyses/BodyKinematics.h>
+#include <OpenSim/Analyses/PointKinematics.h>
+#include <OpenSim/Analyses/StatesReporter.h>
+#include <OpenSim/Analyses/KinematicsExtractor.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+
+using namespace OpenSim;
+using namespace std;
+using SimTK::Vec3;
+
+// Compare a row of a Storage with expected values, starting at a column.
+void checkRow(Storage& storage, int row, int column, const Vec3& expected)
+{
+    const Array<double>& data = storage.getStateVector(row)->getData();
+    for (int k = 0; k < 3; ++k)
+        ASSERT_EQUAL(expected[k], data[column + k], 0.0, __FILE__, __LINE__);
+}
+
+void testKinematicsViews(bool inBodyFrame)
+{
+    Model model("arm26.osim");
+    Kinematics* kinematics = new Kinematics(&model);
+    BodyKinematics* bodyKinematics = new BodyKinematics(&model);
+    bodyKinematics->setExpressResultsInLocalFrame(inBodyFrame);
+    PointKinematics* pointKinematics = new PointKinematics(&model);
+    StatesReporter* statesReporter = new StatesReporter(&model);
+    model.addAnalysis(kinematics);
+    model.addAnalysis(bodyKinematics);
+    model.addAnalysis(pointKinematics);
+    model.addAnalysis(statesReporter);
+
+    SimTK::State& s = model.initSystem();
+    for (int i = 0; i < model.getAnalysisSet().getSize(); ++i)
+        model.updAnalysisSet().get(i).setModel(model);
+    const Body& humerus = model.getBodySet().get("r_humerus");
+    const Body& ulna = model.getBodySet().get("r_ulna_radius_hand");
+    const Vec3 point(0.01, -0.2, 0.03);
+    pointKinematics->setBody(&model.updBodySet().get("r_ulna_radius_hand"));
+    pointKinematics->setRelativeToBody(
+        &model.updBodySet().get("r_humerus"));
+    pointKinematics->setPoint(point);
+    pointKinematics->setPointName("hand");
+
+    const Coordinate& shoulder =
+        model.getCoordinateSet().get("r_shoulder_elev");
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    const SimbodyEngine& engine = model.getSimbodyEngine();
+    const Ground& ground = model.getGround();
+
+    const int nSteps = 5;
+    for (int i = 0; i < nSteps; ++i) {
+        s.updTime() = 0.01*i;
+        shoulder.setValue(s, 0.1 + 0.1*i, false);
+        elbow.setValue(s, 0.5 + 0.2*i);
+        shoulder.setSpeedValue(s, 1.0 - 0.3*i);
+        elbow.setSpeedValue(s, -0.5 + 0.4*i);
+        if (i == 0) model.updAnalysisSet().begin(s);
+        else model.updAnalysisSet().step(s, i);
+        model.getMultibodySystem().realize(s, SimTK::Stage::Acceleration);
+
+        // Coordinates, in degrees.
+        Storage& q = *kinematics->getPositionStorage();
+        Storage& u = *kinematics->getVelocityStorage();
+        Storage& udot = *kinematics->getAccelerationStorage();
+        ASSERT(q.getSize() == i + 1);
+        const int e = q.getStateIndex("r_elbow_flex");
+        ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*elbow.getValue(s),
+                     q.getStateVector(i)->getData()[e], 0.0,
+                     __FILE__, __LINE__);
+        ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*elbow.getSpeedValue(s),
+                     u.getStateVector(i)->getData()[e], 0.0,
+                     __FILE__, __LINE__);
+        ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*elbow.getAccelerationValue(s),
+                     udot.getStateVector(i)->getData()[e], 0.0,
+                     __FILE__, __LINE__);
+
+        // Bodies and whole-body mass center.
+        Storage& bp = *bodyKinematics->getPositionStorage();
+        Storage& bv = *bodyKinematics->getVelocityStorage();
+        Storage& ba = *bodyKinematics->getAccelerationStorage();
+        const int b = bp.getStateIndex("r_ulna_radius_hand_X");
+        const Vec3& com = ulna.get_mass_center();
+        Vec3 vec, angles;
+        double dirCos[3][3];
+        engine.getPosition(s, ulna, com, vec);
+        engine.getDirectionCosines(s, ulna, dirCos);
+        engine.convertDirectionCosinesToAngles(dirCos,
+            &angles[0], &angles[1], &angles[2]);
+        checkRow(bp, i, b, vec);
+        checkRow(bp, i, b + 3, SimTK_RADIAN_TO_DEGREE*angles);
+        engine.getVelocity(s, ulna, com, vec);
+        if (inBodyFrame) engine.transform(s, ground, vec, ulna, vec);
+        engine.getAngularVelocity(s, ulna, angles);
+        checkRow(bv, i, b, vec);
+        checkRow(bv, i, b + 3, SimTK_RADIAN_TO_DEGREE*angles);
+        engine.getAcceleration(s, ulna, com, vec);
+        if (inBodyFrame) engine.transform(s, ground, vec, ulna, vec);
+        engine.getAngularAcceleration(s, ulna, angles);
+        checkRow(ba, i, b, vec);
+        checkRow(ba, i, b + 3, SimTK_RADIAN_TO_DEGREE*angles);
+
+        const int c = bp.getStateIndex("center_of_mass_X");
+        const Vec3 massCenter = model.calcMassCenterPosition(s);
+        for (int k = 0; k < 3; ++k)
+            ASSERT_EQUAL(massCenter[k], bp.getStateVector(i)->getData()[c+k],
+                         1e-14, __FILE__, __LINE__);
+
+        // A point relative to another body.
+        engine.getPosition(s, ulna, point, vec);
+        engine.transformPosition(s, ground, vec, humerus, vec);
+        checkRow(*pointKinematics->getPositionStorage(), i, 0, vec);
+        engine.getAcceleration(s, ulna, point, vec);
+        engine.transform(s, ground, vec, humerus, vec);
+        checkRow(*pointKinematics->getAccelerationStorage(), i, 0, vec);
+
+        // States.
+        const SimTK::Vector states = model.getStateVariableValues(s);
+        const Storage& statesStore = statesReporter->getStatesStorage();
+        ASSERT(statesStore.getSize() == i + 1);
+        for (int k = 0; k < states.size(); ++k)
+            ASSERT_EQUAL(states[k],
+                statesStore.getStateVector(i)->getData()[k], 0.0,
+                __FILE__, __LINE__);
+    }
+
+    // The analyses share one extractor, holding each request once.
+    shared_ptr<KinematicsExtractor> extractor =
+        KinematicsExtractor::getShared(model);
+    ASSERT(extractor->addBody(ulna) == extractor->addBody(ulna));
+    ASSERT(KinematicsExtractor::getShared(model) == extractor);
+    ASSERT(model.getAnalysisSet().getKinematicsExtractor() == extractor);
+}
+
+// The extractor is kept by its model, so a copy of the model does not share
+// it, and an analysis given a new model, which may be at the address of a
+// deleted one, gets the new model's extractor.
+void testSharedPerModel()
+{
+    unique_ptr<Model> model(new Model("arm26.osim"));
+    model->initSystem();
+    Kinematics kinematics(model.get());
+    shared_ptr<KinematicsExtractor> first =
+        model->getAnalysisSet().getKinematicsExtractor();
+    ASSERT(first && &first->getModel() == model.get());
+
+    Model copy(*model);
+    ASSERT(!copy.getAnalysisSet().getKinematicsExtractor());
+
+    model.reset();
+    model.reset(new Model("arm26.osim"));
+    SimTK::State& s = model->initSystem();
+    kinematics.setModel(*model);
+    const Coordinate& elbow = model->getCoordinateSet().get("r_elbow_flex");
+    elbow.setValue(s, 0.7);
+    kinematics.record(s);
+
+    shared_ptr<KinematicsExtractor> second =
+        model->getAnalysisSet().getKinematicsExtractor();
+    ASSERT(second && second != first && &second->getModel() == model.get());
+    Storage& q = *kinematics.getPositionStorage();
+    ASSERT_EQUAL(SimTK_RADIAN_TO_DEGREE*0.7,
+        q.getStateVector(q.getSize() - 1)->getData()[
+            q.getStateIndex("r_elbow_flex")], 1e-12, __FILE__, __LINE__);
+}
+
+// A state that changes without a change of time is swept again.
+void testChangedState()
+{
+    Model model("arm26.osim");
+    SimTK::State& s = model.initSystem();
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    KinematicsExtractor extractor(model);
+    const int slot = extractor.addCoordinate(elbow);
+    const int hand = extractor.addPoint(
+        model.getBodySet().get("r_ulna_radius_hand"), Vec3(0));
+
+    elbow.setValue(s, 0.3);
+    extractor.update(s);
+    ASSERT_EQUAL(0.3, extractor.getCoordinateValue(slot), 0.0);
+    ASSERT(SimTK::isNaN(extractor.getCoordinateAcceleration(slot)));
+    const Vec3 p = extractor.getPointPosition(hand);
+
+    elbow.setValue(s, 0.9);
+    extractor.update(s);
+    ASSERT_EQUAL(0.9, extractor.getCoordinateValue(slot), 0.0);
+    ASSERT(extractor.getPointPosition(hand) != p);
+
+    extractor.requireAccelerations();
+    extractor.update(s);
+    const double udot = extractor.getCoordinateAcceleration(slot);
+    ASSERT(!SimTK::isNaN(udot));
+
+    // Neither time nor Y changes with gravity, which is not a state
+    // variable, but the state must be realized again.
+    model.updGravityForce().setGravityVector(s, Vec3(0, -20, 0));
+    extractor.update(s);
+    ASSERT(extractor.getCoordinateAcceleration(slot) != udot);
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testKinematicsViews(false);
+        testKinematicsViews(true);
+        testChangedState();
+        testSharedPerModel();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+/* -------------------------------------------------------------------------- *
+ *                      OpenSim:  testOutputReporter.cpp                      *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+// Record double, Vec3 and Vector Outputs of arm26 with an OutputReporter and
+// compare them with the values computed directly, in the reporter's columns,
+// in the exported Storage and in the binary file.
+
+#include <OpenSim/Simulation/Model/Model.h>
+#include <OpenSim/Simulation/Model/ActuatorForceProbe.h>
+#include <OpenSim/Analyses/OutputReporter.h>
+#include <OpenSim/Common/LoadOpenSimLibrary.h>
+#include <OpenSim/Auxiliary/auxiliaryTestFunctions.h>
+#include <cstdint>
+#include <fstream>
+
+using namespace OpenSim;
+using namespace std;
+
+void testOutputReporter()
+{
+    Model model("arm26.osim");
+    Array<string> probed;
+    probed.append("BIClong");
+    probed.append("TRIlong");
+    ActuatorForceProbe* probe = new ActuatorForceProbe(probed, false, 1);
+    probe->setName("forces");
+    model.addProbe(probe);
+
+    OutputReporter* reporter = new OutputReporter(&model);
+    reporter->addToReport("r_elbow_flex/value");
+    reporter->addToReport("BIClong/fiber_force");
+    reporter->addToReport("com_position");
+    reporter->addToReport("forces/probe_outputs");
+    reporter->reserve(10);
+    model.addAnalysis(reporter);
+
+    SimTK::State& s = model.initSystem();
+    model.equilibrateMuscles(s);
+    const Coordinate& elbow = model.getCoordinateSet().get("r_elbow_flex");
+    const Muscle& bic = model.getMuscles().get("BIClong");
+
+    const int nSteps = 10;
+    vector<vector<double> > expected(nSteps);
+    for (int i = 0; i < nSteps; ++i) {
+        s.updTime() = 0.01*i;
+        elbow.setValue(s, 0.1*i);
+        if (i == 0)
+            reporter->begin(s);
+        else
+            reporter->step(s, i);
+
+        model.getMultibodySystem().realize(s, SimTK::Stage::Report);
+        SimTK::Vec3 com = model.calcMassCenterPosition(s);
+        SimTK::Vector probeValues = probe->getProbeOutputs(s);
+        expected[i] = {elbow.getValue(s), bic.getFiberForce(s),
+                       com[0], com[1], com[2],
+                       probeValues[0], probeValues[1]};
+    }
+    // Recording again at the same time replaces the last row.
+    reporter->step(s, nSteps);
+
+    ASSERT(reporter->getNumRows() == nSteps);
+    ASSERT(reporter->getNumColumns() == 7);
+    ASSERT(reporter->getColumnLabels()[2] == "com_position_x");
+    ASSERT(reporter->getColumnLabels()[6] == "forces/probe_outputs_1");
+    for (int i = 0; i < nSteps; ++i) {
+        ASSERT_EQUAL(0.01*i, reporter->getTimes()[i], 1e-15);
+        for (int j = 0; j < 7; ++j)
+            ASSERT_EQUAL(expected[i][j], reporter->getColumn(j)[i], 1e-12,
+                         __FILE__, __LINE__);
+    }
+
+    Storage storage;
+    reporter->exportToStorage(storage);
+    ASSERT(storage.getSize() == nSteps);
+    ASSERT(storage.getColumnLabels()[2] == "BIClong/fiber_force");
+    double value = SimTK::NaN;
+    storage.getDataAtTime(0.05, 1, &value);
+    ASSERT_EQUAL(expected[5][0], value, 1e-12, __FILE__, __LINE__);
+
+    reporter->printBinary("testOutputReporter.bin");
+    ifstream in("testOutputReporter.bin", ios::binary);
+    char magic[8];
+    int32_t nRows = 0, nCols = 0, length = 0;
+    in.read(magic, 8);
+    in.read((char*)&nRows, sizeof(nRows));
+    in.read((char*)&nCols, sizeof(nCols));
+    ASSERT(string(magic, 8) == "OSIMOUT1");
+    ASSERT(nRows == nSteps && nCols == 8);
+    for (int j = 0; j < nCols; ++j) {
+        in.read((char*)&length, sizeof(length));
+        in.seekg(length, ios::cur);
+    }
+    // Skip the times and read the fiber force column.
+    in.seekg(2*nRows*sizeof(double), ios::cur);
+    vector<double> fiberForce(nRows);
+    in.read((char*)fiberForce.data(), nRows*sizeof(double));
+    ASSERT(bool(in));
+    for (int i = 0; i < nSteps; ++i)
+        ASSERT_EQUAL(expected[i][1], fiberForce[i], 0.0, __FILE__, __LINE__);
+
+    // An Output that does not exist.
+    OutputReporter* bad = new OutputReporter(&model);
+    bad->addToReport("r_elbow_flex/no_such_output");
+    model.addAnalysis(bad);
+    ASSERT_THROW(Exception, bad->begin(s));
+}
+
+int main()
+{
+    try {
+        LoadOpenSimLibrary("osimActuators");
+        testOutputReporter();
+    }
+    catch (const Exception& e) {
+        e.print(cerr);
+        return 1;
+    }
+    cout << "Done" << endl;
+    return 0;
+}
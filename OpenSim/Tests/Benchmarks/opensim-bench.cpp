@@ -0,0 +1,546 @@
+/* -------------------------------------------------------------------------- *
+ *                        OpenSim:  opensim-bench.cpp                         *
+ * -------------------------------------------------------------------------- *
+ * The OpenSim API is a toolkit for musculoskeletal modeling and simulation.  *
+ * See http://opensim.stanford.edu and the NOTICE file for more information.  *
+ * OpenSim is developed at Stanford University and supported by the US        *
+ * National Institutes of Health (U54 GM072970, R24 HD065690) and by DARPA    *
+ * through the Warrior Web program.                                           *
+ *                                                                            *
+ * Copyright (c) 2005-2016 Stanford University and the Authors                *
+ *                                                                            *
+ * Licensed under the Apache License, Version 2.0 (the "License"); you may    *
+ * not use this file except in compliance with the License. You may obtain a  *
+ * copy of the License at http://www.apache.org/licenses/LICENSE-2.0.         *
+ *                                                                            *
+ * Unless required by applicable law or agreed to in writing, software        *
+ * distributed under the License is distributed on an "AS IS" BASIS,          *
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.   *
+ * See the License for the specific language governing permissions and        *
+ * limitations under the License.                                             *
+ * -------------------------------------------------------------------------- */
+
+/* Times the operations that dominate OpenSim workflows on the models bundled
+ * with the tests: model loading, initSystem, realizing each stage, muscle
+ * equilibrium, path lengths and speeds, IK of 1 kHz marker data, one frame
+ * of ID and static optimization, looping over components, recording
+ * component Outputs, Hunt-Crossley contact among many spheres, Storage I/O
+ * and filtering, and finding Set members by name.
+ *
+ * Usage (from the directory the models were copied to):
+ *
+ *     opensim-bench [--json results.json] [--reps N] [model.osim ...]
+ *
+ * Each benchmark is repeated a number of times suited to its cost, or N
+ * times if --reps is given. It is reported with its mean and minimum
+ * wall-clock time and with how much it raised the peak resident set size of
+ * the process (0 if it stayed within memory used by earlier benchmarks). */
+
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <memory>
+#include <OpenSim/OpenSim.h>
+#include <OpenSim/Auxiliary/getRSS.h>
+
+using namespace OpenSim;
+using namespace std;
+
+//=============================================================================
+// BENCHMARK HARNESS
+//=============================================================================
+struct BenchmarkResult {
+    string group;   // model file name, or "Storage"
+    string name;
+    int reps;
+    double meanTime;
+    double minTime;
+    size_t peakRSSGrowth;
+};
+
+class BenchmarkRunner {
+public:
+    /** If repsOverride is positive, every benchmark is repeated that many
+    times instead of the count given to run(). */
+    explicit BenchmarkRunner(int repsOverride) : _repsOverride(repsOverride) {}
+
+    /** Time func over reps repetitions (after one untimed warm-up call,
+    unless warmUp is false). If given, setup runs before each repetition
+    and is not timed. */
+    void run(const string& group, const string& name, int reps,
+             const function<void()>& func,
+             const function<void()>& setup = function<void()>(),
+             bool warmUp = true)
+    {
+        typedef chrono::steady_clock Clock;
+        if (_repsOverride > 0) reps = _repsOverride;
+        try {
+            const size_t peakBefore = getPeakRSS();
+            if (warmUp) {
+                if (setup) setup();
+                func();
+            }
+            double total = 0, best = SimTK::Infinity;
+            for (int i = 0; i < reps; ++i) {
+                if (setup) setup();
+                Clock::time_point start = Clock::now();
+                func();
+                double t = chrono::duration<double>(Clock::now()-start).count();
+                total += t;
+                best = min(best, t);
+            }
+            BenchmarkResult r = {group, name, reps, total/reps, best,
+                                 getPeakRSS() - peakBefore};
+            _results.push_back(r);
+            cout << left << setw(32) << group << setw(36) << name
+                 << right << setw(14) << scientific << setprecision(3)
+                 << r.meanTime << setw(14) << r.minTime
+                 << setw(10) << r.peakRSSGrowth/(1024*1024) << " MB" << endl;
+        }
+        catch (const std::exception& e) {
+            cout << group << " " << name << " FAILED: " << e.what() << endl;
+        }
+    }
+
+    void printJSON(ostream& out) const
+    {
+        out << "{\n  \"peak_rss_bytes\": " << getPeakRSS() << ",\n"
+            << "  \"results\": [\n";
+        out << setprecision(9) << scientific;
+        for (size_t i = 0; i < _results.size(); ++i) {
+            const BenchmarkResult& r = _results[i];
+            out << "    {\"group\": \"" << r.group << "\", "
+                << "\"name\": \"" << r.name << "\", "
+                << "\"reps\": " << r.reps << ", "
+                << "\"mean_s\": " << r.meanTime << ", "
+                << "\"min_s\": " << r.minTime << ", "
+                << "\"peak_rss_growth_bytes\": " << r.peakRSSGrowth << "}"
+                << (i+1 < _results.size() ? "," : "") << "\n";
+        }
+        out << "  ]\n}\n";
+    }
+
+private:
+    int _repsOverride;
+    vector<BenchmarkResult> _results;
+};
+
+//=============================================================================
+// HELPERS
+//=============================================================================
+// Write the model's markers to a TRC file while every coordinate swings
+// sinusoidally by amplitude (in rad or m) about its value in s.
+void writeMarkerMotion(const Model& model, SimTK::State s,
+                       const string& fileName, int numFrames, double rate,
+                       double amplitude)
+{
+    const MarkerSet& markers = model.getMarkerSet();
+    const CoordinateSet& coords = model.getCoordinateSet();
+    int nm = markers.getSize();
+    SimTK::Vector q0 = s.getQ();
+    ofstream out(fileName.c_str());
+    out << "PathFileType\t4\t(X/Y/Z)\t" << fileName << "\n";
+    out << "DataRate\tCameraRate\tNumFrames\tNumMarkers\tUnits\t"
+           "OrigDataRate\tOrigDataStartFrame\tOrigNumFrames\n";
+    out << rate << "\t" << rate << "\t" << numFrames << "\t" << nm
+        << "\tm\t" << rate << "\t1\t" << numFrames << "\n";
+    out << "Frame#\tTime";
+    for (int i = 0; i < nm; ++i) out << "\t" << markers[i].getName() << "\t\t";
+    out << "\n\t";
+    for (int i = 0; i < nm; ++i)
+        out << "\tX" << i+1 << "\tY" << i+1 << "\tZ" << i+1;
+    out << "\n";
+    out.precision(12);
+    for (int f = 0; f < numFrames; ++f) {
+        const double t = f/rate;
+        s.updQ() = q0;
+        for (int i = 0; i < coords.getSize(); ++i) {
+            if (coords[i].getLocked(s)) continue;
+            coords[i].setValue(s, coords[i].getValue(s)
+                + amplitude*sin(2*SimTK::Pi*t + i), false);
+        }
+        model.getMultibodySystem().realize(s, SimTK::Stage::Position);
+        out << f+1 << "\t" << t;
+        for (int i = 0; i < nm; ++i) {
+            SimTK::Vec3 p = markers[i].findLocationInFrame(s, model.getGround());
+            out << "\t" << p[0] << "\t" << p[1] << "\t" << p[2];
+        }
+        out << "\n";
+    }
+}
+
+// HuntCrossleyForce as it was before its broad phase: Simbody's
+// GeneralContactSubsystem tests every pair of the surfaces.
+class AllPairsHuntCrossleyForce : public HuntCrossleyForce {
+OpenSim_DECLARE_CONCRETE_OBJECT(AllPairsHuntCrossleyForce, HuntCrossleyForce);
+public:
+    explicit AllPairsHuntCrossleyForce(ContactParameters* params)
+    :   HuntCrossleyForce(params) {}
+protected:
+    void extendAddToSystem(SimTK::MultibodySystem& system) const override
+    {
+        Force::extendAddToSystem(system);
+        Model& model = const_cast<Model&>(getModel());
+        SimTK::GeneralContactSubsystem& contacts = system.updContactSubsystem();
+        SimTK::ContactSetIndex set = contacts.createContactSet();
+        SimTK::HuntCrossleyForce force(model.updForceSubsystem(), contacts, set);
+        force.setTransitionVelocity(get_transition_velocity());
+        const ContactParametersSet& paramsSet = get_contact_parameters();
+        for (int i = 0; i < paramsSet.getSize(); ++i) {
+            const ContactParameters& params = paramsSet[i];
+            for (int j = 0; j < params.getGeometry().size(); ++j) {
+                const ContactGeometry& geom =
+                    model.getContactGeometrySet().get(params.getGeometry()[j]);
+                contacts.addBody(set, geom.getBody().getMobilizedBody(),
+                    geom.createSimTKContactGeometry(), geom.getTransform());
+                force.setBodyParameters(
+                    SimTK::ContactSurfaceIndex(contacts.getNumBodies(set)-1),
+                    params.getStiffness(), params.getDissipation(),
+                    params.getStaticFriction(), params.getDynamicFriction(),
+                    params.getViscousFriction());
+            }
+        }
+        const_cast<AllPairsHuntCrossleyForce*>(this)->_index =
+            force.getForceIndex();
+    }
+};
+
+// Two free feet, each with a grid of nx x nz contact spheres whose bottom
+// row rests slightly into a ground half space, all in one Hunt-Crossley
+// force; or in one that tests every pair of surfaces.
+Model* createContactModel(int nx, int nz, bool allPairs)
+{
+    using SimTK::Vec3;
+    Model* model = new Model();
+    model->setName("contact");
+    Ground& ground = model->updGround();
+    ContactHalfSpace* floor = new ContactHalfSpace(Vec3(0),
+        Vec3(0, 0, -SimTK::Pi/2), ground, "floor");
+    model->addContactGeometry(floor);
+
+    HuntCrossleyForce::ContactParameters* params =
+        new HuntCrossleyForce::ContactParameters(1e7, 0.5, 0.9, 0.8, 0.0);
+    params->addGeometry("floor");
+
+    const double radius = 0.01, spacing = 0.025;
+    for (int f = 0; f < 2; ++f) {
+        const string name = f == 0 ? "foot_r" : "foot_l";
+        OpenSim::Body* foot = new OpenSim::Body(name, 1.0, Vec3(0),
+            SimTK::Inertia::brick(0.1, 0.02, 0.05));
+        model->addBody(foot);
+        model->addJoint(new FreeJoint(name + "_free", ground,
+            Vec3(0.3*f, radius - 0.001, 0), Vec3(0), *foot, Vec3(0), Vec3(0)));
+        for (int i = 0; i < nx; ++i) {
+            for (int k = 0; k < nz; ++k) {
+                const string sphere = name + "_" + to_string(i*nz + k);
+                // Alternate rows are raised, so half the spheres are clear
+                // of the ground.
+                model->addContactGeometry(new ContactSphere(radius,
+                    Vec3(i*spacing, (k % 2)*2*radius, k*spacing), *foot,
+                    sphere));
+                params->addGeometry(sphere);
+            }
+        }
+    }
+    if (allPairs)
+        model->addForce(new AllPairsHuntCrossleyForce(params));
+    else
+        model->addForce(new HuntCrossleyForce(params));
+    return model;
+}
+
+// A states storage holding the state s, unchanged, over a short interval.
+Storage* createConstantStatesStorage(const Model& model, const SimTK::State& s)
+{
+    Array<string> labels = model.getStateVariableNames();
+    labels.insert(0, "time");
+    Storage* states = new Storage(16, "states");
+    states->setColumnLabels(labels);
+    SimTK::Vector y = model.getStateVariableValues(s);
+    for (int i = 0; i <= 10; ++i)
+        states->append(0.01*i, y.size(), &y[0]);
+    return states;
+}
+
+//=============================================================================
+// BENCHMARKS
+//=============================================================================
+void benchmarkModel(BenchmarkRunner& runner, const string& fileName)
+{
+    const string& g = fileName;
+
+    runner.run(g, "load", 3, [&]() { Model model(fileName); });
+
+    Model model(fileName);
+    runner.run(g, "initSystem", 3, [&]() { model.initSystem(); });
+
+    SimTK::State& s = model.initSystem();
+    const SimTK::MultibodySystem& system = model.getMultibodySystem();
+
+    // Realize each stage on its own: invalidating a stage leaves all lower
+    // stages realized, so only the work of that stage is timed.
+    const SimTK::Stage stages[] = { SimTK::Stage::Time,
+        SimTK::Stage::Position, SimTK::Stage::Velocity,
+        SimTK::Stage::Dynamics, SimTK::Stage::Acceleration };
+    for (const SimTK::Stage& stage : stages) {
+        system.realize(s, stage);
+        runner.run(g, "realize " + stage.getName(), 100, [&]() {
+            s.invalidateAll(stage);
+            system.realize(s, stage);
+        });
+    }
+
+    const Set<Muscle>& muscles = model.getMuscles();
+    if (muscles.getSize() > 0) {
+        runner.run(g, "equilibrateMuscles", 10,
+            [&]() { model.equilibrateMuscles(s); });
+
+        // Path lengths and speeds are cached at Position and Velocity, so
+        // this includes realizing those stages.
+        runner.run(g, "GeometryPath length+speed", 100, [&]() {
+            s.invalidateAll(SimTK::Stage::Position);
+            system.realize(s, SimTK::Stage::Velocity);
+            double sum = 0;
+            for (int i = 0; i < muscles.getSize(); ++i) {
+                const GeometryPath& path = muscles[i].getGeometryPath();
+                sum += path.getLength(s) + path.getLengtheningSpeed(s);
+            }
+            if (SimTK::isNaN(sum)) cout << "NaN path length" << endl;
+        });
+    }
+
+    // Looping over all the Muscles of the model, by walking the component
+    // tree and through the cached array of the Muscles.
+    if (muscles.getSize() > 0) {
+        double sum = 0;
+        runner.run(g, "ComponentList<Muscle> loop x1000", 3, [&]() {
+            for (int i = 0; i < 1000; ++i)
+                for (const Muscle& muscle : model.getComponentList<Muscle>())
+                    sum += muscle.getMaxIsometricForce();
+        });
+        runner.run(g, "getComponentView<Muscle> loop x1000", 3, [&]() {
+            for (int i = 0; i < 1000; ++i)
+                for (const Muscle* muscle : model.getComponentView<Muscle>())
+                    sum += muscle->getMaxIsometricForce();
+        });
+        if (SimTK::isNaN(sum)) cout << "NaN muscle force" << endl;
+    }
+
+    // Inverse kinematics tracking 100 frames of markers recorded at 1 kHz,
+    // with the SimTK::Assembler and with the dedicated marker tracker.
+    if (model.getMarkerSet().getSize() > 0) {
+        system.realize(s, SimTK::Stage::Position);
+        writeMarkerMotion(model, s, "bench_markers.trc", 101, 1000, 0.05);
+        Set<MarkerWeight> markerWeights;
+        for (int i = 0; i < model.getMarkerSet().getSize(); ++i)
+            markerWeights.adoptAndAppend(new MarkerWeight(
+                model.getMarkerSet()[i].getName(), 1.0));
+        MarkersReference markersRef;
+        markersRef.setMarkerWeightSet(markerWeights);
+        markersRef.loadMarkersFile("bench_markers.trc");
+        SimTK::Array_<CoordinateReference> coordRefs;
+        for (bool useTracker : {false, true}) {
+            InverseKinematicsSolver ik(model, markersRef, coordRefs);
+            ik.setAccuracy(1e-5);
+            ik.setUseMarkerTracker(useTracker);
+            SimTK::State ikState = s;
+            int iterations = 0;
+            runner.run(g, useTracker ? "IK 100 frames (marker tracker)"
+                                     : "IK 100 frames (Assembler)", 3,
+                [&]() {
+                    for (int f = 1; f <= 100; ++f) {
+                        ikState.updTime() = f/1000.0;
+                        ik.track(ikState);
+                        iterations += ik.getNumTrackIterations();
+                    }
+                },
+                [&]() {
+                    ikState = s;
+                    ikState.updTime() = 0;
+                    ik.assemble(ikState);
+                    iterations = 0;
+                });
+            if (useTracker)
+                cout << "    marker tracker iterations per frame: "
+                     << iterations/100.0 << endl;
+        }
+    }
+
+    // Inverse dynamics, one frame.
+    {
+        InverseDynamicsSolver id(model);
+        system.realize(s, SimTK::Stage::Velocity);
+        SimTK::Vector udot(s.getNU(), 0.0);
+        runner.run(g, "ID frame", 100, [&]() { id.solve(s, udot); });
+    }
+
+    // Static optimization, one frame.
+    if (muscles.getSize() > 0) {
+        std::unique_ptr<Storage> states(createConstantStatesStorage(model, s));
+        StaticOptimization* so = new StaticOptimization(&model);
+        so->setStatesStore(*states);
+        model.addAnalysis(so);
+        SimTK::State soState = s;
+        so->begin(soState);
+        runner.run(g, "SO frame", 5, [&]() { so->step(soState, 0); });
+        so->setOptimizerAlgorithm("activeset");
+        runner.run(g, "SO frame (active set QP)", 5,
+                   [&]() { so->step(soState, 0); });
+        model.removeAnalysis(so);
+    }
+
+    // Recording all the scalar Outputs of the muscles, as values and as the
+    // strings a generic consumer of Outputs had to use.
+    if (muscles.getSize() > 0) {
+        OutputReporter* reporter = new OutputReporter(&model);
+        vector<const AbstractOutput*> outputs;
+        for (int i = 0; i < muscles.getSize(); ++i) {
+            for (auto it = muscles[i].getOutputsBegin();
+                    it != muscles[i].getOutputsEnd(); ++it) {
+                if (it->second->getTypeName() != "double") continue;
+                reporter->addToReport(muscles[i].getName() + "/" + it->first);
+                outputs.push_back(it->second.get());
+            }
+        }
+        model.addAnalysis(reporter);
+        system.realize(s, SimTK::Stage::Report);
+        reporter->begin(s);
+        const string n = to_string(outputs.size());
+        // Recording at the same time replaces the row, so only the cost of
+        // reading the Outputs is timed.
+        runner.run(g, "record " + n + " Outputs x1000", 3, [&]() {
+            for (int i = 0; i < 1000; ++i) reporter->step(s, i);
+        });
+        runner.run(g, "getValueAsString " + n + " Outputs x1000", 3, [&]() {
+            size_t length = 0;
+            for (int i = 0; i < 1000; ++i)
+                for (const AbstractOutput* output : outputs)
+                    length += output->getValueAsString(s).size();
+            if (length == 0) cout << "No output strings" << endl;
+        });
+        model.removeAnalysis(reporter);
+    }
+}
+
+void benchmarkContact(BenchmarkRunner& runner)
+{
+    const string g = "Contact";
+    for (int n : {4, 8}) {
+        for (bool allPairs : {true, false}) {
+            unique_ptr<Model> model(createContactModel(n, n, allPairs));
+            SimTK::State& s = model->initSystem();
+            const SimTK::MultibodySystem& system = model->getMultibodySystem();
+            system.realize(s, SimTK::Stage::Dynamics);
+            // Detection is part of realizing Position and Dynamics.
+            runner.run(g, "realize Dynamics, " + to_string(2*n*n) +
+                       (allPairs ? " spheres, all pairs" : " spheres"), 100,
+                [&]() {
+                    s.invalidateAll(SimTK::Stage::Position);
+                    system.realize(s, SimTK::Stage::Dynamics);
+                });
+        }
+    }
+}
+
+void benchmarkStorage(BenchmarkRunner& runner)
+{
+    // One minute of 100 channels at 1 kHz.
+    const int nRows = 60000, nCols = 100;
+    const string g = "Storage";
+    Array<string> labels("", nCols+1);
+    labels[0] = "time";
+    for (int j = 0; j < nCols; ++j) labels[j+1] = "c" + to_string(j);
+
+    Storage data(nRows);
+    data.setColumnLabels(labels);
+    Array<double> row(0.0, nCols);
+    for (int i = 0; i < nRows; ++i) {
+        for (int j = 0; j < nCols; ++j) row[j] = sin(0.001*i*(j+1));
+        data.append(0.001*i, row);
+    }
+
+    runner.run(g, "print 60000x100", 3,
+        [&]() { data.print("bench_storage.sto"); });
+    runner.run(g, "read 60000x100", 3,
+        [&]() { Storage in("bench_storage.sto"); });
+
+    Storage work;
+    runner.run(g, "lowpassIIR 60000x100", 3,
+        [&]() { work.lowpassIIR(6.0); },
+        [&]() { work = data; });
+    runner.run(g, "lowpassFIR(50) 60000x100", 3,
+        [&]() { work.lowpassFIR(50, 6.0); },
+        [&]() { work = data; });
+}
+
+void benchmarkSetLookup(BenchmarkRunner& runner)
+{
+    const string g = "Set";
+    const int nLookups = 10000;
+    for (int n : {10, 100, 10000}) {
+        FunctionSet set;
+        vector<string> names;
+        for (int i = 0; i < n; ++i) {
+            names.push_back("f" + to_string(i));
+            Constant* f = new Constant(i);
+            f->setName(names.back());
+            set.adoptAndAppend(f);
+        }
+        for (bool useIndex : {false, true}) {
+            set.setUseNameIndex(useIndex);
+            int found = 0;
+            runner.run(g, to_string(nLookups) + " getIndex, size " +
+                       to_string(n) + (useIndex ? " (index)" : ""), 3,
+                [&]() {
+                    for (int i = 0; i < nLookups; ++i)
+                        found += set.getIndex(names[(i*7919) % n]) >= 0;
+                });
+            if (found == 0) cout << "No objects found." << endl;
+        }
+    }
+}
+
+//=============================================================================
+// MAIN
+//=============================================================================
+int main(int argc, char** argv)
+{
+    string jsonFile = "opensim-bench.json";
+    int reps = 0;
+    vector<string> models;
+    for (int i = 1; i < argc; ++i) {
+        string arg = argv[i];
+        if (arg == "--json" && i+1 < argc) jsonFile = argv[++i];
+        else if (arg == "--reps" && i+1 < argc) reps = atoi(argv[++i]);
+        else models.push_back(arg);
+    }
+    if (models.empty()) {
+        models.push_back("arm26.osim");
+        models.push_back("gait2392_pelvisFixed.osim");
+        models.push_back("Arnold2010_pelvisFixed.osim");
+        models.push_back("BushingForceModel_30000.osim");
+        models.push_back("PushUpToesOnGroundWithMuscles.osim");
+    }
+
+    BenchmarkRunner runner(reps);
+    cout << left << setw(32) << "group" << setw(36) << "benchmark"
+         << right << setw(14) << "mean [s]" << setw(14) << "min [s]"
+         << setw(13) << "peak RSS +" << endl;
+    for (const string& m : models) {
+        try {
+            benchmarkModel(runner, m);
+        }
+        catch (const std::exception& e) {
+            cout << m << " FAILED: " << e.what() << endl;
+        }
+    }
+    benchmarkContact(runner);
+    benchmarkStorage(runner);
+    benchmarkSetLookup(runner);
+
+    ofstream json(jsonFile.c_str());
+    runner.printJSON(json);
+    cout << "Wrote " << jsonFile << endl;
+    return 0;
+}
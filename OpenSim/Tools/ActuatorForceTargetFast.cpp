@@ -30,6 +30,7 @@
 //==============================================================================
 #include <iostream>
 #include <OpenSim/Common/Exception.h>
+#include <OpenSim/Common/ActiveSetQP.h>
 
 #include <OpenSim/Simulation/Model/Actuator.h>
 #include <OpenSim/Simulation/Model/ActivationFiberLengthMuscle_Deprecated.h>
@@ -68,7 +69,7 @@ ActuatorForceTargetFast::~ActuatorForceTargetFast()
  */
 ActuatorForceTargetFast::
 ActuatorForceTargetFast(SimTK::State& s, int aNX,CMC *aController):
-    OptimizationTarget(aNX), _controller(aController)
+    OptimizationTarget(aNX), _controller(aController), _useActiveSetQP(false)
 {
     // NUMBER OF CONTROLS
     if(getNumParameters()<=0) {
@@ -175,6 +176,32 @@ prepareToOptimize(SimTK::State& s, double *x)
 
         _recipOptForceSquared[i] = 1.0 / (fOpt*fOpt);   
     }
+
+#ifdef USE_LINEAR_CONSTRAINT_MATRIX
+    // Without state tracking tasks the objective is a weighted sum of squared
+    // forces and, the constraints being linear, the problem can be solved
+    // directly.
+    const CMC_TaskSet& tset = _controller->getTaskSet();
+    bool hasStateTasks = false;
+    for(int t=0; t<tset.getSize(); t++)
+        if(dynamic_cast<StateTrackingTask*>(&tset.get(t))) hasStateTasks = true;
+
+    if(_useActiveSetQP && !hasStateTasks && getHasLimits()) {
+        Vector weights(nf);
+        for(int i=0; i<nf; i++) {
+            Muscle* mus = dynamic_cast<Muscle*>(&fSet[i]);
+            weights[i] = mus ? _recipOptForceSquared[i] : _recipAreaSquared[i];
+        }
+        double *lower, *upper;
+        getParameterLimits(&lower, &upper);
+        Vector solution(nf);
+        if(ActiveSetQP().solve(_constraintMatrix, -_constraintVector, weights,
+                Vector(nf, lower, true), Vector(nf, upper, true), solution)) {
+            for(int i=0; i<nf; i++) x[i] = solution[i];
+            return true;
+        }
+    }
+#endif
     
     // return false to indicate that we still need to proceed with optimization (did not do a lapack direct solve)
     return false;
@@ -96,6 +96,9 @@ private:
     
     // Save a (copy) of the state for state tracking purposes
     SimTK::State    _saveState;
+
+    /** Solve directly as a quadratic program when possible. */
+    bool _useActiveSetQP;
 //==============================================================================
 // METHODS
 //==============================================================================
@@ -113,6 +116,12 @@ public:
 
     bool prepareToOptimize(SimTK::State& s, double *x) override;
 
+    /** If true and there are no state tracking tasks, prepareToOptimize()
+    solves the problem directly as a quadratic program (see ActiveSetQP) and
+    returns true, unless that fails. **/
+    void setUseActiveSetQP(bool useIt) { _useActiveSetQP = useIt; }
+    bool getUseActiveSetQP() const { return _useActiveSetQP; }
+
     //--------------------------------------------------------------------------
     // REQUIRED OPTIMIZATION TARGET METHODS
     //--------------------------------------------------------------------------
@@ -34,6 +34,8 @@
 #include <OpenSim/Analyses/ProbeReporter.h>
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Actuators/Thelen2003Muscle.h>
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/Profiler.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -504,6 +506,7 @@ bool AnalyzeTool::run()
 }
 bool AnalyzeTool::run(bool plotting)
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     //cout<<"Running analyze tool "<<getName()<<"."<<endl;
 
     // CHECK FOR A MODEL
@@ -569,6 +572,7 @@ bool AnalyzeTool::run(bool plotting)
 
     cout<<"Executing the analyses from "<<ti<<" to "<<tf<<"..."<<endl;
     run(s, *_model, iInitial, iFinal, *_statesStore, _solveForEquilibriumForAuxiliaryStates);
+    Logger::flush();
     _model->getMultibodySystem().realize(s, SimTK::Stage::Position );
     } catch (const Exception& x) {
         x.print(cout);
@@ -640,9 +644,9 @@ void AnalyzeTool::run(SimTK::State& s, Model &aModel, int iInitial, int iFinal,
                 aModel.equilibrateMuscles(s);
             }
             catch (const std::exception& e) {
-                cout << "WARNING- AnalyzeTool::run() unable to equilibrate muscles ";
-                cout << "at time = " << t <<"." << endl;
-                cout << "Reason: " << e.what() << endl;
+                OPENSIM_LOG(Warn) << "WARNING- AnalyzeTool::run() unable to equilibrate muscles "
+                    << "at time = " << t << ".\n"
+                    << "Reason: " << e.what();
             }
         }
         // Make sure model is at least ready to provide kinematics
@@ -35,6 +35,7 @@
 #include <OpenSim/Common/Exception.h>
 #include <OpenSim/Common/Array.h>
 #include <OpenSim/Common/Storage.h>
+#include <OpenSim/Common/Logger.h>
 #include <OpenSim/Common/RootSolver.h>
 #include <OpenSim/Simulation/Model/AnalysisSet.h>
 #include <OpenSim/Simulation/Model/Muscle.h>
@@ -528,11 +529,11 @@ computeInitialStates(SimTK::State& s, double &rTI)
 
     double tiReal = rTI;
     if( _verbose ) {
-        cout<<"\n\n=============================================\n";
-        cout<<"enter CMC.computeInitialStates: ti="<< rTI << "  q's=" << s.getQ() <<endl;
-        cout<<"\nenter CMC.computeInitialStates: ti="<< rTI << "  u's=" << s.getU() <<endl;
-        cout<<"\nenter CMC.computeInitialStates: ti="<< rTI << "  z's=" << s.getZ() <<endl;
-        cout<<"=============================================\n";
+        OPENSIM_LOG(Info) << "\n\n=============================================\n"
+            << "enter CMC.computeInitialStates: ti=" << rTI << "  q's=" << s.getQ() << "\n"
+            << "\nenter CMC.computeInitialStates: ti=" << rTI << "  u's=" << s.getU() << "\n"
+            << "\nenter CMC.computeInitialStates: ti=" << rTI << "  z's=" << s.getZ() << "\n"
+            << "=============================================";
     }
 
 
@@ -567,22 +568,22 @@ computeInitialStates(SimTK::State& s, double &rTI)
 
     obtainActuatorEquilibrium(s,tiReal,0.200,xmin,true);
     if( _verbose ) {
-        cout<<"\n\n=============================================\n";
-        cout<<"#1 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  q's=" << s.getQ() <<endl;
-        cout<<"\n#1 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  u's=" << s.getU() <<endl;
-        cout<<"\n#1 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  z's=" << s.getZ() <<endl;
-        cout<<"=============================================\n";
+        OPENSIM_LOG(Info) << "\n\n=============================================\n"
+            << "#1 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  q's=" << s.getQ() << "\n"
+            << "\n#1 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  u's=" << s.getU() << "\n"
+            << "\n#1 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  z's=" << s.getZ() << "\n"
+            << "=============================================";
     }
     restoreConfiguration( s, initialState ); // set internal coord,speeds to initial vals. 
 
     // 2
     obtainActuatorEquilibrium(s,tiReal,0.200,xmin,true);
     if( _verbose ) {
-        cout<<"\n\n=============================================\n";
-        cout<<"#2 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  q's=" << s.getQ() <<endl;
-        cout<<"\n#2 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  u's=" << s.getU() <<endl;
-        cout<<"\n#2 act Equ.  CMC.computeInitialStates: ti="<< rTI << "  z's=" << s.getZ() <<endl;
-        cout<<"=============================================\n";
+        OPENSIM_LOG(Info) << "\n\n=============================================\n"
+            << "#2 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  q's=" << s.getQ() << "\n"
+            << "\n#2 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  u's=" << s.getU() << "\n"
+            << "\n#2 act Equ.  CMC.computeInitialStates: ti=" << rTI << "  z's=" << s.getZ() << "\n"
+            << "=============================================";
     }
     restoreConfiguration( s, initialState );
 
@@ -627,11 +628,11 @@ computeInitialStates(SimTK::State& s, double &rTI)
     setTargetDT(oldTargetDT);
     _model->updAnalysisSet().setOn(true);
     if( _verbose ) {
-        cout<<"\n\n=============================================\n";
-        cout<<"finish CMC.computeInitialStates: ti="<< rTI << "  q's=" << s.getQ() <<endl;
-        cout<<"\nfinish CMC.computeInitialStates: ti="<< rTI << "  u's=" << s.getU() <<endl;
-        cout<<"\nfinish CMC.computeInitialStates: ti="<< rTI << "  z's=" << s.getZ() <<endl;
-        cout<<"=============================================\n";
+        OPENSIM_LOG(Info) << "\n\n=============================================\n"
+            << "finish CMC.computeInitialStates: ti=" << rTI << "  q's=" << s.getQ() << "\n"
+            << "\nfinish CMC.computeInitialStates: ti=" << rTI << "  u's=" << s.getU() << "\n"
+            << "\nfinish CMC.computeInitialStates: ti=" << rTI << "  z's=" << s.getZ() << "\n"
+            << "=============================================";
     }
 }
 
@@ -718,10 +719,10 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     double tiReal = s.getTime(); 
     double tfReal = _tf; 
 
-    cout<<"CMC.computeControls:  t = "<<s.getTime()<<endl;
+    OPENSIM_LOG(Info) << "CMC.computeControls:  t = " << s.getTime();
     if(_verbose) { 
-        cout<<"\n\n----------------------------------\n";
-        cout<<"integration step size = "<<_targetDT<<",  target time = "<<_tf<<endl;
+        OPENSIM_LOG(Info) << "\n\n----------------------------------\n"
+            << "integration step size = " << _targetDT << ",  target time = " << _tf;
     }
 
     // SET CORRECTIONS 
@@ -747,15 +748,15 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _predictor->getCMCActSubsys()->setSpeedCorrections(&uCorrection[0]);
 
     if( _verbose ) {
-        cout << "\n=============================" << endl;
-        cout << "\nCMC:computeControls"  << endl;
-        cout << "\nq's = " << s.getQ() << endl;
-        cout << "\nu's = " << s.getU() << endl;
-        cout << "\nz's = " << s.getZ() << endl;
-        cout<<"\nqDesired:"<<qDesired << endl;
-        cout<<"\nuDesired:"<<uDesired << endl;
-        cout<<"\nQCorrections:"<<qCorrection << endl;
-        cout<<"\nUCorrections:"<<uCorrection << endl;
+        OPENSIM_LOG(Info) << "\n=============================\n"
+            << "\nCMC:computeControls\n"
+            << "\nq's = " << s.getQ() << "\n"
+            << "\nu's = " << s.getU() << "\n"
+            << "\nz's = " << s.getZ() << "\n"
+            << "\nqDesired:" << qDesired << "\n"
+            << "\nuDesired:" << uDesired << "\n"
+            << "\nQCorrections:" << qCorrection << "\n"
+            << "\nUCorrections:" << uCorrection;
     }
 
     // realize to Velocity because some tasks (eg. CMC_Point) need to be
@@ -767,7 +768,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _taskSet->recordErrorsAsLastErrors();
     Array<double> &pErr = _taskSet->getPositionErrors();
     Array<double> &vErr = _taskSet->getVelocityErrors();
-    if(_verbose) cout<<"\nErrors at time "<<s.getTime()<<":"<<endl;
+    if(_verbose) OPENSIM_LOG(Info) << "\nErrors at time " << s.getTime() << ":";
     int e=0;
     for(i=0;i<_taskSet->getSize();i++) {
         
@@ -775,8 +776,8 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
 
         if(_verbose) {
             for(j=0;j<task.getNumTaskFunctions();j++) {
-                cout<<task.getName()<<":  ";
-                cout<<"pErr="<<pErr[e]<<" vErr="<<vErr[e]<<endl;
+                OPENSIM_LOG(Info) << task.getName() << ":  "
+                    << "pErr=" << pErr[e] << " vErr=" << vErr[e];
                 e++;
             }
         }
@@ -806,12 +807,12 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
                 CMC_Joint& jointTask = dynamic_cast<CMC_Joint&>(_taskSet->get(i));
                 if(jointTask.getLimit()) {
                     double w = ForwardTool::SigmaDn(jointTask.getLimit() * relativeTau, jointTask.getLimit(), fabs(pErr[i]));
-                    if(_verbose) cout << "Task " << i << ": err=" << pErr[i] << ", limit=" << jointTask.getLimit() << ", sigmoid=" << w << endl;
+                    if(_verbose) OPENSIM_LOG(Info) << "Task " << i << ": err=" << pErr[i] << ", limit=" << jointTask.getLimit() << ", sigmoid=" << w;
                     stressTermWeight = min(stressTermWeight, w);
                 }
             }
         }
-        if(_verbose) cout << "Setting stress term weight to " << stressTermWeight << " (relativeTau was " << relativeTau << ")" << std::endl;
+        if(_verbose) OPENSIM_LOG(Info) << "Setting stress term weight to " << stressTermWeight << " (relativeTau was " << relativeTau << ")";
         realTarget->setStressTermWeight(stressTermWeight);
 
         for(i=0;i<vErr.getSize();i++) err[i] = vErr[i];
@@ -828,8 +829,8 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     }
 
     if(_verbose) {
-        cout<<"\nxmin:\n"<<xmin<<endl;
-        cout<<"\nxmax:\n"<<xmax<<endl;
+        OPENSIM_LOG(Info) << "\nxmin:\n" << xmin << "\n"
+            << "\nxmax:\n" << xmax;
     }
 
     // COMPUTE BOUNDS ON MUSCLE FORCES
@@ -838,18 +839,24 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     _predictor->setInitialTime(tiReal);
     _predictor->setFinalTime(tfReal);
     _predictor->setTargetForces(&zero[0]);
-    _predictor->evaluate(s, &xmin[0], &fmin[0]);
-    _predictor->evaluate(s, &xmax[0], &fmax[0]);
+    Array<double> xBounds(0.0,2*N),fBounds(0.0,2*N);
+    for(i=0;i<N;i++) {
+        xBounds[i] = xmin[i];
+        xBounds[N+i] = xmax[i];
+    }
+    _predictor->evaluate(s, 2, &xBounds[0], &fBounds[0]);
+    for(i=0;i<N;i++) {
+        fmin[i] = fBounds[i];
+        fmax[i] = fBounds[N+i];
+    }
 
     SimTK::State newState = _predictor->getCMCActSubsys()->getCompleteState();
     
      if(_verbose) {
-        cout<<endl<<endl;
-        cout<<"\ntiReal = "<<tiReal<<"  tfReal = "<<tfReal<<endl;
-        cout<<"Min forces:\n";
-        cout<<fmin<<endl;
-        cout<<"Max forces:\n";
-        cout<<fmax<<endl;
+        OPENSIM_LOG(Info) << "\n\n"
+            << "\ntiReal = " << tiReal << "  tfReal = " << tfReal << "\n"
+            << "Min forces:\n" << fmin << "\n"
+            << "Max forces:\n" << fmax;
     }
 
     // Print actuator force range if range is small
@@ -857,9 +864,9 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     for(i=0;i<N;i++) {
         range = fmax[i] - fmin[i];
         if(range<1.0) {
-            cout << "CMC::computeControls WARNING- small force range for "
+            OPENSIM_LOG(Warn) << "CMC::computeControls WARNING- small force range for "
                  << getActuatorSet()[i].getName()
-                 << " ("<<fmin[i]<<" to "<<fmax[i]<<")\n" << endl;
+                 << " ("<<fmin[i]<<" to "<<fmax[i]<<")\n";
             // if the force range is so small it means the control value, x, 
             // is inconsequential and we might as well choose the smallest control
             // value possible, or else the RootSolver will choose the last value
@@ -898,9 +905,8 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
             _optimizer->optimize(fVector);
         }
         catch (const SimTK::Exception::Base& ex) {
-            cout << ex.getMessage() << endl;
-            cout << "OPTIMIZATION FAILED..." << endl;
-            cout<<endl;
+            OPENSIM_LOG(Error) << ex.getMessage() << "\n"
+                << "OPTIMIZATION FAILED...\n";
 
             ostringstream msg;
             msg << "CMC.computeControls: ERROR- Optimizer could not find a solution." << endl;
@@ -910,7 +916,8 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
             msg << "2. there are tracking tasks for locked coordinates, and/or" << endl;
             msg << "3. there are unnecessary control constraints on reserve/residual actuators." << endl;
                    
-            cout<<"\n"<<msg.str()<<endl<<endl;
+            OPENSIM_LOG(Error) << "\n" << msg.str() << "\n";
+            Logger::flush();
 
          throw(new OpenSim::Exception(msg.str(), __FILE__,__LINE__));
         }
@@ -921,8 +928,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     if(_verbose) _target->printPerformance(&_f[0]);
 
     if(_verbose) {
-        cout<<"\nDesired actuator forces:\n";
-        cout<<_f<<endl;
+        OPENSIM_LOG(Info) << "\nDesired actuator forces:\n" << _f;
     }
 
 
@@ -934,7 +940,7 @@ computeControls(SimTK::State& s, ControlSet &controlSet)
     Array<double> controls(0.0,N);
     controls = rootSolver.solve(s, xmin,xmax,tol);
     if(_verbose) {
-       cout<<"\n\nXXX t=" << _tf << "   Controls:" <<controls<<endl;
+       OPENSIM_LOG(Info) << "\n\nXXX t=" << _tf << "   Controls:" << controls;
     }
     
     // FILTER OSCILLATIONS IN CONTROL VALUES
@@ -1013,11 +1019,11 @@ FilterControls(const SimTK::State& s, const ControlSet &aControlSet,double aDT,
                OpenSim::Array<double> &rControls,bool aVerbosePrinting)
 {
     if(aDT <= SimTK::Zero) {
-        if(aVerbosePrinting) cout<<"\nCMC.filterControls: aDT is practically 0.0, skipping!\n\n";
+        if(aVerbosePrinting) OPENSIM_LOG(Info) << "\nCMC.filterControls: aDT is practically 0.0, skipping!\n";
         return;
     }
 
-    if(aVerbosePrinting) cout<<"\n\nFiltering controls to limit curvature...\n";
+    if(aVerbosePrinting) OPENSIM_LOG(Info) << "\n\nFiltering controls to limit curvature...";
 
     int i;
     int size = rControls.getSize();
@@ -1060,10 +1066,10 @@ FilterControls(const SimTK::State& s, const ControlSet &aControlSet,double aDT,
         rControls[i] = (3.0*x2[i] + 2.0*x1[i] + x0[i]) / 6.0;
 
         // PRINT
-        if(aVerbosePrinting) cout<<aControlSet[i].getName()<<": old="<<x2[i]<<" new="<<rControls[i]<<endl;
+        if(aVerbosePrinting) OPENSIM_LOG(Info) << aControlSet[i].getName() << ": old=" << x2[i] << " new=" << rControls[i];
     }
 
-    if(aVerbosePrinting) cout<<endl<<endl;
+    if(aVerbosePrinting) OPENSIM_LOG(Info) << "\n";
 }
 
 
@@ -40,6 +40,7 @@
 #include "CMC_TaskSet.h"
 #include "ActuatorForceTarget.h"
 #include "ActuatorForceTargetFast.h"
+#include <OpenSim/Common/Profiler.h>
 
 using namespace std;
 using namespace SimTK;
@@ -299,8 +300,10 @@ void CMCTool::setupProperties()
     _useFastTargetProp.setName("use_fast_optimization_target");          
     _propertySet.append( &_useFastTargetProp );
 
-    comment = "Preferred optimizer algorithm (currently support \"ipopt\" or \"cfsqp\", "
-                 "the latter requiring the osimCFSQP library.";
+    comment = "Preferred optimizer algorithm (currently support \"ipopt\", \"cfsqp\", "
+                 "the latter requiring the osimCFSQP library, or \"activeset\", which "
+                 "solves the fast target directly as a quadratic program when there "
+                 "are no state tracking tasks and uses \"ipopt\" otherwise.";
     _optimizerAlgorithmProp.setComment(comment);
     _optimizerAlgorithmProp.setName("optimizer_algorithm");
     _propertySet.append( &_optimizerAlgorithmProp );
@@ -388,6 +391,7 @@ operator=(const CMCTool &aTool)
  */
 bool CMCTool::run()
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     cout<<"Running tool "<<getName()<<".\n";
 
     // CHECK FOR A MODEL
@@ -703,6 +707,14 @@ bool CMCTool::run()
     } else if(IO::Uppercase(_optimizerAlgorithm) == "IPOPT") {
         std::cout << "Using IPOPT optimizer algorithm." << std::endl;
         algorithm = SimTK::InteriorPoint;
+    } else if(IO::Uppercase(_optimizerAlgorithm) == "ACTIVESET") {
+        if(_useFastTarget) {
+            std::cout << "Using active set QP, with IPOPT as a fallback." << std::endl;
+            static_cast<ActuatorForceTargetFast*>(target)->setUseActiveSetQP(true);
+        } else {
+            std::cout << "Active set QP requires the fast target.  Will use IPOPT instead." << std::endl;
+        }
+        algorithm = SimTK::InteriorPoint;
     } else {
         throw Exception("CMCTool: ERROR- Unrecognized optimizer algorithm: '"+_optimizerAlgorithm+"'",__FILE__,__LINE__);
     }
@@ -36,6 +36,7 @@
 #include <OpenSim/Simulation/Model/PrescribedForce.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include "CorrectionController.h"
+#include <OpenSim/Common/Profiler.h>
 
 using namespace std;
 using namespace SimTK;
@@ -234,6 +235,7 @@ operator=(const ForwardTool &aTool)
  */
 bool ForwardTool::run()
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     cout<<"Running tool "<<getName()<<"."<<endl;
     // CHECK FOR A MODEL
     if(_model==NULL) {
@@ -39,6 +39,8 @@
 #include <OpenSim/Common/GCVSplineSet.h>
 #include <OpenSim/Common/Constant.h>
 #include "AnalyzeTool.h"
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/Profiler.h>
 
 using namespace OpenSim;
 using namespace std;
@@ -224,7 +226,7 @@ void InverseDynamicsTool::getJointsByName(Model &model, const Array<std::string>
         if (k >= 0){
             joints.adoptAndAppend(&modelJoints[k]);
         } else {
-            cout << "\nWARNING: InverseDynamicsTool could not find Joint named '" << jointNames[i] << "' to report body forces." << endl;
+            OPENSIM_LOG(Warn) << "\nWARNING: InverseDynamicsTool could not find Joint named '" << jointNames[i] << "' to report body forces.";
         }
     }
     joints.setMemoryOwner(false);
@@ -240,6 +242,7 @@ void InverseDynamicsTool::getJointsByName(Model &model, const Array<std::string>
  */
 bool InverseDynamicsTool::run()
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     bool success = false;
     bool modelFromFile=true;
     try{
@@ -250,7 +253,7 @@ bool InverseDynamicsTool::run()
             modelFromFile = false;
         _model->printBasicInfo(cout);
 
-        cout<<"Running tool " << getName() <<".\n"<<endl;
+        OPENSIM_LOG(Info) << "Running tool " << getName() << ".\n";
 
         _model->setup();
 
@@ -268,7 +271,7 @@ bool InverseDynamicsTool::run()
 
         if (loadCoordinateValues()){
             if(_lowpassCutoffFrequency>=0) {
-                cout<<"\n\nLow-pass filtering coordinates data with a cutoff frequency of "<<_lowpassCutoffFrequency<<"..."<<endl<<endl;
+                OPENSIM_LOG(Info) << "\n\nLow-pass filtering coordinates data with a cutoff frequency of " << _lowpassCutoffFrequency << "...\n";
                 _coordinateValues->pad(_coordinateValues->getSize()/2);
                 _coordinateValues->lowpassIIR(_lowpassCutoffFrequency);
                 if (getVerboseLevel()==Debug) _coordinateValues->print("coordinateDataFiltered.sto");
@@ -287,9 +290,8 @@ bool InverseDynamicsTool::run()
                 }
                 else{
                     coordFunctions->insert(i,new Constant(coords[i].getDefaultValue()));
-                    std::cout << "InverseDynamicsTool: coordinate file does not contain coordinate "
-                        << coords[i].getName() << " assuming default value" 
-                        << std::endl;
+                    OPENSIM_LOG(Warn) << "InverseDynamicsTool: coordinate file does not contain coordinate "
+                        << coords[i].getName() << " assuming default value";
                 }
             }
             if(coordFunctions->getSize() > nq){
@@ -330,17 +332,26 @@ bool InverseDynamicsTool::run()
             times[i]=_coordinateValues->getStateVector(start_index+i)->getTime();
         }
 
-        // Preallocate results
-        Array_<Vector> genForceTraj(nt, Vector(nq, 0.0));
+        // Preallocate results, one row per time frame
+        Matrix genForceTraj(nt, nq, 0.0);
 
         // solve for the trajectory of generalized forces that correspond to the 
-        // coordinate trajectories provided
-        ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        // coordinate trajectories provided. Frames are solved concurrently
+        // unless the model has analyses, which must be stepped in order.
+        if (_model->getAnalysisSet().getSize() == 0) {
+            ivdSolver.solve(s, *coordFunctions, times, genForceTraj);
+        }
+        else {
+            Array_<Vector> genForceArray(nt, Vector(nq, 0.0));
+            ivdSolver.solve(s, *coordFunctions, times, genForceArray);
+            for(int i=0; i<nt; i++)
+                genForceTraj[i] = ~genForceArray[i];
+        }
 
 
         success = true;
 
-        cout << "InverseDynamicsTool: " << nt << " time frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
+        OPENSIM_LOG(Info) << "InverseDynamicsTool: " << nt << " time frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n";
     
         JointSet jointsForEquivalentBodyForces;
         getJointsByName(*_model, _jointsForReportingBodyForces, jointsForEquivalentBodyForces);
@@ -363,39 +374,53 @@ bool InverseDynamicsTool::run()
             }
         }
 
+        // if there are joints requested for equivalent body forces then
+        // calculate them, concurrently over contiguous blocks of frames
+        Matrix bodyForcesTraj(nt, 6*nj, 0.0);
+        if(nj>0){
+            auto calcBodyForces = [&](State& sThread, int begin, int end) {
+                Vector genForces(nq);
+                for(int i=begin; i<end; ++i){
+                    sThread.updTime() = times[i];
+                    Vector &q = sThread.updQ();
+                    Vector &u = sThread.updU();
+                    for(int j=0; j<nq; ++j){
+                        q[j] = coordFunctions->evaluate(j, 0, times[i]);
+                        u[j] = coordFunctions->evaluate(j, 1, times[i]);
+                        genForces[j] = genForceTraj(i, j);
+                    }
+
+                    for(int j=0; j<nj; ++j){
+                        SpatialVec equivalentBodyForceAtJoint =
+                            jointsForEquivalentBodyForces[j]
+                                .calcEquivalentSpatialForce(sThread, genForces);
+                        for(int k=0; k<3; ++k){
+                            // body force components
+                            bodyForcesTraj(i, 6*j+k) = equivalentBodyForceAtJoint[1][k];
+                            // body torque components
+                            bodyForcesTraj(i, 6*j+k+3) = equivalentBodyForceAtJoint[0][k];
+                        }
+                    }
+                }
+            };
+            InverseDynamicsSolver::solveFramesConcurrently(*_model, s, nt, 0,
+                                                           calcBodyForces);
+        }
+
         Storage genForceResults(nt);
         Storage bodyForcesResults(nt);
-        SpatialVec equivalentBodyForceAtJoint;
+        Vector genForces(nq);
+        Vector bodyForces(6*nj);
 
         for(int i=0; i<nt; i++){
-            StateVector genForceVec(times[i], nq, &((genForceTraj[i])[0]));
+            genForces = ~genForceTraj[i];
+            StateVector genForceVec(times[i], nq, &genForces[0]);
             genForceResults.append(genForceVec);
 
-            // if there are joints requested for equivalent body forces then calculate them
             if(nj>0){
-                Vector forces(6*nj, 0.0);
-                StateVector bodyForcesVec(times[i], 6*nj, &forces[0]);
-
-                s.updTime() = times[i];
-                Vector &q = s.updQ();
-                Vector &u = s.updU();
-
-                for(int j=0; j<nq; ++j){
-                    q[j] = coordFunctions->evaluate(j, 0, times[i]);
-                    u[j] = coordFunctions->evaluate(j, 1, times[i]);
-                }
-            
-                for(int j=0; j<nj; ++j){
-                    equivalentBodyForceAtJoint = jointsForEquivalentBodyForces[j].calcEquivalentSpatialForce(s, genForceTraj[i]);
-                    for(int k=0; k<3; ++k){
-                        // body force components
-                        bodyForcesVec.setDataValue(6*j+k, equivalentBodyForceAtJoint[1][k]); 
-                        // body torque components
-                        bodyForcesVec.setDataValue(6*j+k+3, equivalentBodyForceAtJoint[0][k]);
-                    }
-                }
+                bodyForces = ~bodyForcesTraj[i];
+                StateVector bodyForcesVec(times[i], 6*nj, &bodyForces[0]);
                 bodyForcesResults.append(bodyForcesVec);
-
             }
         }
 
@@ -415,10 +440,11 @@ bool InverseDynamicsTool::run()
             Storage::printResult(&bodyForcesResults, _outputBodyForcesAtJointsFileName, getResultsDir(), -1, ".sto");
             IO::chDir(saveWorkingDirectory);
         }
-
+        Logger::flush();
     }
     catch (const OpenSim::Exception& ex) {
-        std::cout << "InverseDynamicsTool Failed: " << ex.what() << std::endl;
+        OPENSIM_LOG(Error) << "InverseDynamicsTool Failed: " << ex.what();
+        Logger::flush();
         throw (Exception("InverseDynamicsTool Failed, please see messages window for details..."));
     }
 
@@ -46,6 +46,8 @@
 #include "IKMarkerTask.h"
 
 #include "SimTKsimbody.h"
+#include <OpenSim/Common/Logger.h>
+#include <OpenSim/Common/Profiler.h>
 
 
 using namespace OpenSim;
@@ -77,7 +79,8 @@ InverseKinematicsTool::InverseKinematicsTool() : Tool(),
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _useMarkerTracker(_useMarkerTrackerProp.getValueBool())
 {
     setNull();
 }
@@ -102,7 +105,8 @@ InverseKinematicsTool::InverseKinematicsTool(const string &aFileName, bool aLoad
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _useMarkerTracker(_useMarkerTrackerProp.getValueBool())
 {
     setNull();
     updateFromXMLDocument();
@@ -130,7 +134,8 @@ InverseKinematicsTool::InverseKinematicsTool(const InverseKinematicsTool &aTool)
     _timeRange(_timeRangeProp.getValueDblArray()),
     _reportErrors(_reportErrorsProp.getValueBool()),
     _outputMotionFileName(_outputMotionFileNameProp.getValueStr()),
-    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool())
+    _reportMarkerLocations(_reportMarkerLocationsProp.getValueBool()),
+    _useMarkerTracker(_useMarkerTrackerProp.getValueBool())
 {
     setNull();
     *this = aTool;
@@ -202,6 +207,13 @@ void InverseKinematicsTool::setupProperties()
     _reportMarkerLocationsProp.setValue(false);
     _propertySet.append(&_reportMarkerLocationsProp);
 
+    _useMarkerTrackerProp.setComment("Flag indicating whether to track frames with the dedicated marker "
+        "tracker (Levenberg-Marquardt with motion-predicted initial guesses) rather than the general "
+        "assembler. The assembler is used regardless for models with enabled constraints.");
+    _useMarkerTrackerProp.setName("use_marker_tracker");
+    _useMarkerTrackerProp.setValue(false);
+    _propertySet.append(&_useMarkerTrackerProp);
+
 }
 
 //_____________________________________________________________________________
@@ -239,6 +251,7 @@ operator=(const InverseKinematicsTool &aTool)
     _reportErrors = aTool._reportErrors;
     _outputMotionFileName = aTool._outputMotionFileName;
     _reportMarkerLocations = aTool._reportMarkerLocations;
+    _useMarkerTracker = aTool._useMarkerTracker;
 
     return(*this);
 }
@@ -257,6 +270,7 @@ operator=(const InverseKinematicsTool &aTool)
  */
 bool InverseKinematicsTool::run()
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     bool success = false;
     bool modelFromFile=true;
     try{
@@ -281,7 +295,7 @@ bool InverseKinematicsTool::run()
         kinematicsReporter.setInDegrees(true);
         _model->addAnalysis(&kinematicsReporter);
 
-        cout<<"Running tool "<<getName()<<".\n";
+        OPENSIM_LOG(Info) << "Running tool " << getName() << ".";
 
         // Initialize the model's underlying computational system and get its default state.
         SimTK::State& s = _model->initSystem();
@@ -357,6 +371,7 @@ bool InverseKinematicsTool::run()
         // create the solver given the input data
         InverseKinematicsSolver ikSolver(*_model, markersReference, coordinateReferences, _constraintWeight);
         ikSolver.setAccuracy(_accuracy);
+        ikSolver.setUseMarkerTracker(_useMarkerTracker);
         s.updTime() = start_time;
         ikSolver.assemble(s);
         kinematicsReporter.begin(s);
@@ -371,11 +386,17 @@ bool InverseKinematicsTool::run()
         SimTK::Array_<double> squaredMarkerErrors(nm, 0.0);
         SimTK::Array_<Vec3> markerLocations(nm, Vec3(0));
         
+        double trackTime = 0;
+        int trackIterations = 0;
+
         Storage *modelMarkerLocations = _reportMarkerLocations ? new Storage(Nframes, "ModelMarkerLocations") : NULL;
 
         for (int i = 0; i < Nframes; i++) {
             s.updTime() = start_time + i*dt;
             ikSolver.track(s);
+            trackTime += ikSolver.getTrackTime();
+            if(ikSolver.getNumTrackIterations() >= 0)
+                trackIterations += ikSolver.getNumTrackIterations();
             
             if(_reportErrors){
                 double totalSquaredMarkerError = 0.0;
@@ -390,10 +411,10 @@ bool InverseKinematicsTool::run()
                         worst = j;
                     }
                 }
-                cout << "Frame " << i << " (t=" << s.getTime() << "):\t";
-                cout << "total squared error = " << totalSquaredMarkerError;
-                cout << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm);
-                cout << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")" << endl;
+                OPENSIM_LOG(Info) << "Frame " << i << " (t=" << s.getTime() << "):\t"
+                    << "total squared error = " << totalSquaredMarkerError
+                    << ", marker error: RMS=" << sqrt(totalSquaredMarkerError/nm)
+                    << ", max=" << sqrt(maxSquaredMarkerError) << " (" << ikSolver.getMarkerNameForIndex(worst) << ")";
             }
 
             if(_reportMarkerLocations){
@@ -441,10 +462,15 @@ bool InverseKinematicsTool::run()
 
         success = true;
 
-        cout << "InverseKinematicsTool completed " << Nframes-1 << " frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n" <<endl;
+        OPENSIM_LOG(Info) << "InverseKinematicsTool completed " << Nframes-1 << " frames in " <<(double)(clock()-start)/CLOCKS_PER_SEC << "s\n";
+        if(_useMarkerTracker)
+            OPENSIM_LOG(Info) << "Marker tracker: " << 1000*trackTime/Nframes << " ms and "
+                << (double)trackIterations/Nframes << " iterations per frame.";
+        Logger::flush();
     }
     catch (const std::exception& ex) {
-        std::cout << "InverseKinematicsTool Failed: " << ex.what() << std::endl;
+        OPENSIM_LOG(Error) << "InverseKinematicsTool Failed: " << ex.what();
+        Logger::flush();
         throw (Exception("InverseKinematicsTool Failed, please see messages window for details..."));
     }
 
@@ -108,6 +108,11 @@ private:
     PropertyBool _reportMarkerLocationsProp;
     bool &_reportMarkerLocations;
 
+    // flag indicating whether frames are tracked with the dedicated marker
+    // tracker of the InverseKinematicsSolver rather than the SimTK::Assembler
+    PropertyBool _useMarkerTrackerProp;
+    bool &_useMarkerTracker;
+
 //=============================================================================
 // METHODS
 //=============================================================================
@@ -160,6 +165,8 @@ public:
         _outputMotionFileName = aOutputMotionFileName;
     }
     std::string getOutputMotionFileName() { return _outputMotionFileName;}
+    void setUseMarkerTracker(bool useTracker) { _useMarkerTracker = useTracker; }
+    bool getUseMarkerTracker() const { return _useMarkerTracker; }
     IKTaskSet& getIKTaskSet() { return _ikTaskSet; }
 
     //--------------------------------------------------------------------------
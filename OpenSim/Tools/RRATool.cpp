@@ -42,6 +42,7 @@
 #include "CMC_TaskSet.h"
 #include "ActuatorForceTarget.h"
 #include "ActuatorForceTargetFast.h"
+#include <OpenSim/Common/Profiler.h>
 
 using namespace std;
 using namespace SimTK;
@@ -350,6 +351,7 @@ operator=(const RRATool &aTool)
  */
 bool RRATool::run()
 {
+    OPENSIM_PROFILE_REGION(getConcreteClassName() + " " + getName());
     cout<<"Running tool "<<getName()<<".\n";
 
     // CHECK FOR A MODEL
@@ -31,7 +31,6 @@
 #include <OpenSim/Simulation/Model/Actuator.h>
 #include <OpenSim/Simulation/SimbodyEngine/SimbodyEngine.h>
 #include <OpenSim/Simulation/Model/ControllerSet.h>
-#include <OpenSim/Simulation/Manager/Manager.h>
 #include <OpenSim/Simulation/Model/Model.h>
 #include <OpenSim/Simulation/Model/CMCActuatorSubsystem.h>
 #include "CMC.h"
@@ -50,6 +49,8 @@ using namespace std;
  */
 VectorFunctionForActuators::~VectorFunctionForActuators()
 {
+    delete _timeStepper;
+    delete _integrator;
 }
 //_____________________________________________________________________________
 /**
@@ -70,7 +71,14 @@ VectorFunctionForActuators(SimTK::System *aActuatorSystem, Model* model, CMCActu
 
     // Don't project constraints while inside the controller
     _integrator->setProjectInterpolatedStates( false );
+    _integrator->setReturnEveryInternalStep( true );
     _f.setSize(getNX());
+
+    // The actuator system, its state and the time stepper are the same for
+    // every evaluation, so set them up once here rather than per call.
+    _actSysState = aActuatorSystem->getDefaultState();
+    _timeStepper = new SimTK::TimeStepper(*aActuatorSystem, *_integrator);
+    _timeStepper->setReportAllSignificantStates(true);
 }
 //_____________________________________________________________________________
 /**
@@ -106,6 +114,7 @@ setNull()
     _CMCActuatorSubsystem = NULL;
     _model             = NULL;
     _integrator        = NULL;
+    _timeStepper       = NULL;
 }
 
 //_____________________________________________________________________________
@@ -262,25 +271,19 @@ evaluate( const SimTK::State& s, double *aX, double *rF)
     CMC& controller=  dynamic_cast<CMC&>(_model->updControllerSet().get("CMC" ));
     controller.updControlSet().setControlValues(_tf, aX);
 
-    // create a Manager that will integrate just the actuator subsystem and use only the 
-    // CMC controller
-
-    Manager manager(*_model, *_integrator);
-    manager.setInitialTime(_ti);
-    manager.setFinalTime(_tf);
-    manager.setSystem( _CMCActuatorSystem );
-    // tell the manager to not call the analyses or write to storage 
-    // while the CMCSubsystem is being integrated.
-    manager.setPerformAnalyses(false); 
-    manager.setWriteToStorage(false); 
-    SimTK::State& actSysState = _CMCActuatorSystem->updDefaultState();
-    getCMCActSubsys()->updZ(actSysState) = _model->getMultibodySystem()
+    // Integrate just the actuator subsystem using only the CMC controller.
+    // This is what a Manager would do with analyses and storage turned off,
+    // minus constructing the Manager, its state storage and a TimeStepper on
+    // every call.
+    getCMCActSubsys()->updZ(_actSysState) = _model->getMultibodySystem()
                                             .getDefaultSubsystem().getZ(s);
-
-    actSysState.setTime(_ti);
-
-    // Integration
-    manager.integrate(actSysState, 0.000001);
+    _actSysState.setTime(_ti);
+    _timeStepper->initialize(_actSysState);
+    while(_integrator->getTime() < _tf) {
+        SimTK::Integrator::SuccessfulStepStatus status =
+            _timeStepper->stepTo(_tf);
+        if(status == SimTK::Integrator::EndOfSimulation) break;
+    }
 
     const Set<Actuator>& forceSet = controller.getActuatorSet();
     // Vector function values
@@ -292,6 +295,27 @@ evaluate( const SimTK::State& s, double *aX, double *rF)
     }
 
 
+}
+//_____________________________________________________________________________
+/**
+ * Evaluate the vector function for several sets of controls in turn. Each
+ * evaluation starts from the actuator states in s and reuses the same
+ * integrator. Evaluations run one after another because the actuator
+ * subsystem realizes the model into a single complete state; on return that
+ * state corresponds to the last set of controls.
+ *
+ * @param s SimTK::State.
+ * @param aNumGuesses Number of control sets.
+ * @param aX Control sets, stored one after another (aNumGuesses x getNX()).
+ * @param rF Actuator force differences, stored in the same layout as aX.
+ */
+void VectorFunctionForActuators::
+evaluate( const SimTK::State& s, int aNumGuesses, const double *aX, double *rF)
+{
+    int N = getNX();
+    for(int g=0;g<aNumGuesses;g++) {
+        evaluate(s, const_cast<double*>(&aX[g*N]), &rF[g*N]);
+    }
 }
 //_____________________________________________________________________________
 /**
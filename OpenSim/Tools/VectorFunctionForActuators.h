@@ -70,6 +70,12 @@ protected:
     CMCActuatorSubsystem* _CMCActuatorSubsystem;
     /** Integrator. */
     SimTK::Integrator* _integrator;
+    /** Time stepper driving _integrator; created once and reinitialized
+    for each evaluation. */
+    SimTK::TimeStepper* _timeStepper;
+    /** Working state of the actuator system, realized through Topology once
+    and reused by every evaluation. */
+    SimTK::State _actSysState;
     /** Model */
     Model* _model;
 
@@ -131,6 +137,8 @@ public:
     }
 
     virtual void evaluate( const SimTK::State& s,  double *aX, double *rF);
+    void evaluate( const SimTK::State& s, int aNumGuesses,
+        const double *aX, double *rF);
     void evaluate( const SimTK::State& s,  const OpenSim::Array<double> &aX, Array<double> &rF) override;
     virtual void evaluate( const SimTK::State& s,  Array<double> &rF, const Array<int> &aDerivWRT);
     virtual void evaluate(const double *rY){}